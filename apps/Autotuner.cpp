@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Autotuner.cpp
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <thread>
+#include <utility>
+
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/IGameRules.h>
+
+#include "Autotuner.h"
+#include "Common.h"
+#include "Statistics.h"
+
+namespace Alphadocte {
+
+namespace CLI {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+// each picked template is at least this times smaller than the previous one
+constexpr size_t TEMPLATE_SIZE_RATIO{4};
+constexpr size_t MAX_TUNING_TEMPLATES{3};
+
+using TemplateKey = std::pair<std::string, std::string>; // template and rules
+
+TemplateKey getKey(const TuningMeasure& measure) {
+    return {measure.templateWord, measure.rules};
+}
+
+/*
+ * Thread counts measured : 2, 4, 8, ... below the maximum, then the maximum.
+ */
+std::vector<unsigned int> listThreadCounts(unsigned int maxThreads) {
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int nbThreads = 2; nbThreads < maxThreads; nbThreads *= 2)
+        threadCounts.push_back(nbThreads);
+
+    if (maxThreads > 1)
+        threadCounts.push_back(maxThreads);
+
+    return threadCounts;
+}
+
+}
+
+std::vector<WarmupTemplate> pickTuningTemplates(const Dictionary& dictionary, size_t maxCandidates, bool withWordle) {
+    std::vector<WarmupTemplate> picked;
+    for (auto& firstTemplate : listFirstTemplates(dictionary, withWordle)) {
+        if (firstTemplate.nbCandidates == 0 || firstTemplate.nbCandidates > maxCandidates)
+            continue;
+
+        if (!picked.empty() && firstTemplate.nbCandidates * TEMPLATE_SIZE_RATIO > picked.back().nbCandidates)
+            continue;
+
+        picked.push_back(std::move(firstTemplate));
+        if (std::size(picked) == MAX_TUNING_TEMPLATES)
+            break;
+    }
+
+    return picked;
+}
+
+EntropyMaximizer::Tuning chooseTuning(const std::vector<TuningMeasure>& measures) {
+    using enum EntropyMaximizer::HistogramStrategy;
+    EntropyMaximizer::Tuning tuning;
+
+    // fastest single thread duration of each template
+    std::map<TemplateKey, double> bestDurations;
+    for (const auto& measure : measures) {
+        if (measure.nbThreads != 1)
+            continue;
+
+        auto [it, inserted] = bestDurations.try_emplace(getKey(measure), measure.duration);
+        if (!inserted)
+            it->second = std::min(it->second, measure.duration);
+    }
+
+    if (bestDurations.empty())
+        return tuning;
+
+    // histogram strategy : lowest sum of slowdowns relative to the fastest strategy, ties keep the first strategy
+    double bestSlowdown{};
+    for (auto histogram : {MAP, DENSE, SORTED}) {
+        double slowdown{};
+        size_t nbTemplates{};
+        for (const auto& measure : measures) {
+            if (measure.nbThreads != 1 || measure.histogram != histogram)
+                continue;
+
+            double bestDuration = bestDurations.at(getKey(measure));
+            slowdown += bestDuration > 0 ? measure.duration / bestDuration : 1.0;
+            nbTemplates++;
+        }
+
+        // a strategy must have been measured on every template to be compared
+        if (nbTemplates != std::size(bestDurations))
+            continue;
+
+        if (bestSlowdown == 0 || slowdown < bestSlowdown) {
+            bestSlowdown = slowdown;
+            tuning.histogram = histogram;
+        }
+    }
+
+    // durations of the chosen strategy, by template and thread count
+    std::map<TemplateKey, std::pair<size_t, std::map<unsigned int, double>>> durations;
+    for (const auto& measure : measures) {
+        if (measure.histogram != tuning.histogram || !bestDurations.contains(getKey(measure)))
+            continue;
+
+        auto& [nbPatterns, threadDurations] = durations[getKey(measure)];
+        nbPatterns = measure.nbPatterns;
+        threadDurations[measure.nbThreads] = measure.duration;
+    }
+
+    if (durations.empty())
+        return tuning;
+
+    // templates computing the most hints last
+    std::vector<std::pair<size_t, std::map<unsigned int, double>>> templates;
+    for (auto& [key, templateDurations] : durations)
+        templates.push_back(std::move(templateDurations));
+
+    std::stable_sort(std::begin(templates), std::end(templates),
+            [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    // thread count : fastest on the largest template
+    const auto& largest = templates.back().second;
+    for (const auto& [nbThreads, duration] : largest) {
+        if (duration < largest.at(tuning.nbThreads))
+            tuning.nbThreads = nbThreads;
+    }
+
+    if (tuning.nbThreads == 1)
+        return tuning;
+
+    // parallel threshold : the smallest template from which the threads are always faster
+    auto isFaster = [&tuning](const auto& templateDurations) {
+        auto it = templateDurations.second.find(tuning.nbThreads);
+        return it != std::cend(templateDurations.second) && it->second < templateDurations.second.at(1);
+    };
+
+    auto firstFaster = std::find_if_not(std::rbegin(templates), std::rend(templates), isFaster).base();
+    tuning.minParallelPatterns = firstFaster == std::cbegin(templates) ? 0 : firstFaster->first;
+
+    return tuning;
+}
+
+TuningProfile autotune(std::shared_ptr<Dictionary> dictionary,
+        const AutotuneOptions& options,
+        const AutotuneCallback& onMeasured) {
+    const std::string functionName{"Alphadocte::CLI::autotune(std::shared_ptr<Alphadocte::Dictionary>, const Alphadocte::CLI::AutotuneOptions&, const Alphadocte::CLI::AutotuneCallback&)"};
+    if (!dictionary)
+        throw InvalidArgException("The dictionary must not be null.", functionName);
+    if (options.repetitions == 0)
+        throw InvalidArgException("The number of repetitions must be positive.", functionName);
+
+    auto templates = pickTuningTemplates(*dictionary, options.maxCandidates, options.withWordle);
+    if (templates.empty())
+        throw InvalidArgException("The dictionary has no template with at most " + std::to_string(options.maxCandidates) + " candidates.", functionName);
+
+    TuningProfile profile;
+    profile.nbCores = std::thread::hardware_concurrency();
+
+    unsigned int maxThreads = options.maxThreads == 0 ? std::max(profile.nbCores, 1u) : options.maxThreads;
+    auto threadCounts = listThreadCounts(maxThreads);
+
+    std::map<RulesType, std::shared_ptr<IGameRules>> rules;
+    for (const auto& firstTemplate : templates) {
+        if (!rules.contains(firstTemplate.rulesType))
+            rules.emplace(firstTemplate.rulesType, createRules(firstTemplate.rulesType, dictionary));
+    }
+
+    using enum EntropyMaximizer::HistogramStrategy;
+    const std::vector<EntropyMaximizer::HistogramStrategy> histograms{MAP, DENSE, SORTED};
+    size_t nbToMeasure = std::size(templates) * (std::size(histograms) + std::size(threadCounts));
+
+    auto measure = [&](const WarmupTemplate& firstTemplate, EntropyMaximizer::HistogramStrategy histogram, unsigned int nbThreads) {
+        EntropyMaximizer solver{rules.at(firstTemplate.rulesType)};
+        solver.setTuning(EntropyMaximizer::Tuning{histogram, nbThreads, 0});
+
+        // the median is less sensitive to the noise of other processes
+        std::vector<double> durations;
+        size_t nbPatterns{};
+        for (unsigned int i = 0; i < options.repetitions; i++) {
+            solver.setTemplate(firstTemplate.templateWord);
+            solver.computeNextGuesses(1);
+            durations.push_back(solver.getStats().computeGuessesDuration);
+            nbPatterns = solver.getStats().nbPatternsEvaluated;
+        }
+
+        profile.measures.push_back(TuningMeasure{
+            .templateWord = firstTemplate.templateWord,
+            .rules = std::string(getRulesName(firstTemplate.rulesType)),
+            .nbPatterns = nbPatterns,
+            .histogram = histogram,
+            .nbThreads = nbThreads,
+            .duration = summarize(std::move(durations)).p50
+        });
+
+        if (onMeasured)
+            onMeasured(profile.measures.back(), std::size(profile.measures), nbToMeasure);
+    };
+
+    // the threads are measured with the fastest strategy only
+    for (const auto& firstTemplate : templates) {
+        for (auto histogram : histograms)
+            measure(firstTemplate, histogram, 1);
+    }
+
+    auto histogram = chooseTuning(profile.measures).histogram;
+    for (const auto& firstTemplate : templates) {
+        for (auto nbThreads : threadCounts)
+            measure(firstTemplate, histogram, nbThreads);
+    }
+
+    profile.tuning = chooseTuning(profile.measures);
+    return profile;
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
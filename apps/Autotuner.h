@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Autotuner.h
+ */
+
+#ifndef APPS_AUTOTUNER_H_
+#define APPS_AUTOTUNER_H_
+
+/*
+ * Private header used to measure the implementation choices of the solvers on this machine,
+ * and to choose the fastest ones (see the tune command of alphadocte-cache).
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <Alphadocte/EntropyMaximizer.h>
+
+#include "CacheWarmer.h"
+#include "TuningProfile.h"
+
+namespace Alphadocte {
+
+class Dictionary;
+
+namespace CLI {
+
+/*
+ * Options of an autotuning.
+ */
+struct AutotuneOptions {
+    unsigned int maxThreads{0};  // highest number of threads measured, 0 means one per core
+    size_t maxCandidates{2000};  // templates with more candidates are not measured, to keep the tuning short
+    unsigned int repetitions{3}; // measures of each tuning, the median is kept
+    bool withWordle{true};       // also consider the Wordle template
+};
+
+/*
+ * Called each time a tuning has been measured, with the measure,
+ * the number of measures done so far and the number of measures to do.
+ */
+using AutotuneCallback = std::function<void(const TuningMeasure& measure, size_t nbDone, size_t nbToMeasure)>;
+
+/*
+ * Pick the first templates (see listFirstTemplates) on which the tunings are measured :
+ * the largest template with at most maxCandidates candidates, then templates at least
+ * four times smaller than the previous one, at most three in total.
+ * The largest templates come first.
+ *
+ * Args :
+ * - dictionary : a loaded dictionary
+ * - maxCandidates : the maximum number of candidates of a template
+ * - withWordle : whether the Wordle template can be picked
+ */
+std::vector<WarmupTemplate> pickTuningTemplates(const Dictionary& dictionary, size_t maxCandidates, bool withWordle = true);
+
+/*
+ * Choose the tuning from its measures :
+ * - the histogram strategy with the lowest single thread durations, relatively to the fastest strategy of each template
+ * - the number of threads fastest with this strategy on the template computing the most hints
+ * - the fewest hints from which these threads are faster than a single thread, on this template and all larger ones
+ *
+ * Templates lacking a single thread measure are ignored. Return the default tuning if there are no such measures.
+ */
+EntropyMaximizer::Tuning chooseTuning(const std::vector<TuningMeasure>& measures);
+
+/*
+ * Measure the duration of the best first guess of the EntropyMaximizer solver, on the templates picked by
+ * pickTuningTemplates : first with each histogram strategy on a single thread, then with the fastest strategy
+ * on 2, 4, ... threads up to the maximum, and choose the tuning from these measures (see chooseTuning).
+ *
+ * Args :
+ * - dictionary : a loaded dictionary
+ * - options : the autotuning options
+ * - onMeasured : optional progress callback
+ *
+ * Throws :
+ * - InvalidArgException : if the options are invalid, or the dictionary has no template to measure.
+ */
+TuningProfile autotune(std::shared_ptr<Dictionary> dictionary,
+        const AutotuneOptions& options,
+        const AutotuneCallback& onMeasured = {});
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_AUTOTUNER_H_ */
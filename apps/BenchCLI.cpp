@@ -0,0 +1,392 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: BenchCLI.cpp
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+
+#include <Alphadocte/Alphadocte.h>
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/IGameRules.h>
+#include <Alphadocte/Memory.h>
+#include <Alphadocte/TxtDictionary.h>
+
+#include "CommandLine.h"
+#include "Common.h"
+#include "Json.h"
+#if defined ALPHADOCTE_OS_LINUX
+#include "MetricsHttpServer.h"
+#endif
+#include "PerfCounters.h"
+#include "Simulation.h"
+#include "Statistics.h"
+#include "TuningProfile.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+static const std::string DEFAULT_DICTIONARY = "FR";
+static const std::string DEFAULT_RULES      = "motus";
+static const unsigned long DEFAULT_MAX_GUESSES = 6;
+static const unsigned long DEFAULT_SEED        = 42;
+
+void printUsage(std::string_view programName);
+bool matchesTemplate(std::string_view word, std::string_view templateWord);
+void writeText(std::ostream& os, const CommandLine& args, const std::filesystem::path& dictionaryPath,
+        const IGameRules& rules, size_t nbCandidates, const SimulationResult& result, const PerfCounts& counts);
+void writeJson(std::ostream& os, const CommandLine& args, const std::filesystem::path& dictionaryPath,
+        const IGameRules& rules, size_t nbCandidates, const SimulationResult& result, const PerfCounts& counts);
+void writeCount(std::ostream& os, std::optional<double> count, std::string_view unavailable);
+
+int main(int argc, char* argv[]) {
+    try {
+        CommandLine args{argc, argv};
+        args.checkOptions({"help", "dictionary", "rules", "solver", "template", "sample", "seed",
+                "threads", "max-guesses", "format", "output", "no-shared-first-guess", "memo", "metrics-port", "trace",
+                "perf-counters", "record"});
+
+        if (args.has("help")) {
+            printUsage(args.getProgramName());
+            return 0;
+        }
+
+        // the solvers use the tuning chosen for this machine, see the tune command of alphadocte-cache
+        loadTuning();
+
+        std::string format = args.getString("format", "text");
+        if (format != "text" && format != "json") {
+            throw InvalidArgException("Unknown format " + format + ", expected text or json.", "main(int, char*[])");
+        }
+
+        // the metrics can be scraped during the whole run
+#if defined ALPHADOCTE_OS_LINUX
+        auto metricsServer = startMetricsServer(args);
+#else
+        if (args.has("metrics-port"))
+            throw InvalidArgException("The metrics can only be served on Linux.", "main(int, char*[])");
+#endif
+
+        // the trace is written once the report is
+        TraceRecording trace{args.has("trace") ? std::filesystem::path{args.getString("trace")} : getTracePath()};
+
+        auto dictionaryPath = findDictionary(args.getString("dictionary", DEFAULT_DICTIONARY));
+        if (dictionaryPath.empty()) {
+            std::cerr << "Dictionnaire introuvable : " << args.getString("dictionary", DEFAULT_DICTIONARY) << std::endl;
+            return 1;
+        }
+
+        auto rulesType = parseRulesType(args.getString("rules", DEFAULT_RULES));
+        auto rules = createRules(rulesType, std::make_shared<TxtDictionary>(dictionaryPath),
+                args.getUnsigned("max-guesses", DEFAULT_MAX_GUESSES));
+
+        // Select the solutions
+        std::string templateWord = args.getString("template");
+        std::transform(std::begin(templateWord), std::end(templateWord), std::begin(templateWord), tolower);
+        std::vector<std::string> solutions;
+        for (const auto& word : rules->getDictionary()->getAllWords()) {
+            if (rules->isSolutionValid(word) && (templateWord.empty() || matchesTemplate(word, templateWord)))
+                solutions.push_back(word);
+        }
+        size_t nbCandidates = std::size(solutions);
+
+        unsigned long sample = args.getUnsigned("sample", 0);
+        if (sample > 0 && sample < std::size(solutions)) {
+            // partial Fisher-Yates shuffle, reproducible with the seed
+            boost::mt19937 random(args.getUnsigned("seed", DEFAULT_SEED));
+            for (size_t i = 0; i < sample; i++) {
+                boost::random::uniform_int_distribution<size_t> distribution{i, std::size(solutions) - 1};
+                std::swap(solutions[i], solutions[distribution(random)]);
+            }
+            solutions.resize(sample);
+        }
+
+        if (solutions.empty()) {
+            std::cerr << "Aucune solution ne correspond aux critères demandés." << std::endl;
+            return 1;
+        }
+
+        SimulationOptions options;
+        options.solverName = args.getString("solver", options.solverName);
+        options.nbThreads = args.getUnsigned("threads", 0);
+        options.shareFirstGuess = !args.has("no-shared-first-guess");
+        options.memoCapacity = args.getUnsigned("memo", 0);
+        options.recorder = openRecorder(args.has("record") ? std::filesystem::path{args.getString("record")} : getRecordPath());
+
+        // the counters are opened before the worker threads are created, so that they count them too
+        std::optional<PerfCounters> counters;
+        if (args.has("perf-counters")) {
+            counters.emplace();
+            if (!counters->isAvailable())
+                std::cerr << "Compteurs matériels indisponibles : " << counters->getUnavailableReason() << std::endl;
+        }
+
+        std::cerr << "Simulation de " << std::size(solutions) << " parties..." << std::endl;
+        if (counters)
+            counters->start();
+        auto result = simulateGames(rules, solutions, options);
+        auto counts = counters ? counters->getCounts() : PerfCounts{};
+
+        std::ofstream file;
+        if (args.has("output")) {
+            file.open(args.getString("output"));
+            if (!file) {
+                std::cerr << "Impossible d'écrire dans " << args.getString("output") << std::endl;
+                return 1;
+            }
+        }
+        std::ostream& output = args.has("output") ? file : std::cout;
+
+        if (format == "json") {
+            writeJson(output, args, dictionaryPath, *rules, nbCandidates, result, counts);
+        } else {
+            writeText(output, args, dictionaryPath, *rules, nbCandidates, result, counts);
+        }
+    } catch (const Exception& e) {
+        std::cerr << "Erreur : " << e.what() << std::endl;
+        std::cerr << "Voir --help pour l'utilisation." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+void printUsage(std::string_view programName) {
+    std::cout << "Alphadocte v" << ALPHADOCTE_VERSION_NAME << " : évaluation d'un solver sur un dictionnaire entier." << std::endl;
+    std::cout << std::endl;
+    std::cout << "Utilisation : " << programName << " [options]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options :" << std::endl;
+    std::cout << "  --dictionary=NOM|CHEMIN  dictionnaire utilisé (" << DEFAULT_DICTIONARY << " par défaut)" << std::endl;
+    std::cout << "  --rules=motus|wordle     règles du jeu (" << DEFAULT_RULES << " par défaut)" << std::endl;
+    std::cout << "  --solver=NOM             solver évalué (entropy_maximizer par défaut)" << std::endl;
+    std::cout << "  --template=MODELE        ne jouer que les solutions respectant le modèle (ex: s......)" << std::endl;
+    std::cout << "  --sample=N               ne jouer qu'un échantillon aléatoire de N solutions" << std::endl;
+    std::cout << "  --seed=N                 graine de l'échantillon aléatoire (" << DEFAULT_SEED << " par défaut)" << std::endl;
+    std::cout << "  --threads=N              nombre de threads (un par cœur par défaut)" << std::endl;
+    std::cout << "  --max-guesses=N          nombre maximal d'essais (" << DEFAULT_MAX_GUESSES << " par défaut)" << std::endl;
+    std::cout << "  --no-shared-first-guess  calculer le premier essai dans chaque partie" << std::endl;
+    std::cout << "  --memo=N                 mémoriser les essais de N états du solver, partagés entre les parties" << std::endl;
+    std::cout << "  --format=text|json       format du rapport (text par défaut)" << std::endl;
+    std::cout << "  --output=CHEMIN          écrire le rapport dans un fichier plutôt que sur la sortie standard" << std::endl;
+    std::cout << "  --metrics-port=PORT      servir les métriques au format Prometheus sur http://127.0.0.1:PORT/metrics" << std::endl;
+    std::cout << "                           pendant l'évaluation (Linux uniquement)" << std::endl;
+    std::cout << "  --trace=CHEMIN           écrire les traces des étapes du solver au format Chrome trace" << std::endl;
+    std::cout << "                           (" << TRACE_ENV_VAR << " par défaut, compilation avec ALPHADOCTE_TRACING)" << std::endl;
+    std::cout << "  --perf-counters          compter les cycles, instructions, défauts de cache et erreurs de prédiction" << std::endl;
+    std::cout << "                           de branchement de la simulation (Linux, si le système le permet)" << std::endl;
+    std::cout << "  --record=CHEMIN          enregistrer les appels aux solvers, pour les rejouer avec alphadocte-replay" << std::endl;
+    std::cout << "                           (" << RECORD_ENV_VAR << " par défaut)" << std::endl;
+}
+
+void writeCount(std::ostream& os, std::optional<double> count, std::string_view unavailable) {
+    if (count)
+        os << *count;
+    else
+        os << unavailable;
+}
+
+bool matchesTemplate(std::string_view word, std::string_view templateWord) {
+    if (std::size(word) != std::size(templateWord))
+        return false;
+
+    for (size_t i = 0; i < std::size(word); i++) {
+        if (templateWord[i] != '.' && templateWord[i] != word[i])
+            return false;
+    }
+
+    return true;
+}
+
+void writeText(std::ostream& os, const CommandLine& args, const std::filesystem::path& dictionaryPath,
+        const IGameRules& rules, size_t nbCandidates, const SimulationResult& result, const PerfCounts& counts) {
+    auto latency = summarize(result.turnLatencies);
+    size_t nbLost = result.nbGames - result.nbWon;
+    double meanGuesses{};
+    for (const auto& [nbGuesses, count] : result.guessDistribution) {
+        meanGuesses += nbGuesses * static_cast<double>(count);
+    }
+    meanGuesses = result.nbWon > 0 ? meanGuesses / result.nbWon : 0;
+
+    os << std::fixed << std::setprecision(3);
+    os << "Dictionnaire      : " << dictionaryPath.string() << std::endl;
+    os << "Règles            : " << args.getString("rules", DEFAULT_RULES) << ", " << rules.getMaxGuesses() << " essais maximum" << std::endl;
+    os << "Solver            : " << result.solverName << " v" << result.solverVersion << std::endl;
+    os << "Parties           : " << result.nbGames << " sur " << nbCandidates << " solutions possibles" << std::endl;
+    os << "Threads           : " << result.nbThreads << ", jusqu'à " << result.solverWork.maxSolverThreads
+       << " par calcul du solver" << std::endl;
+    os << std::endl;
+    os << "Distribution du nombre d'essais :" << std::endl;
+    for (const auto& [nbGuesses, count] : result.guessDistribution) {
+        os << "  " << std::setw(2) << nbGuesses << " : " << count << std::endl;
+    }
+    os << "  échecs : " << nbLost << " (" << 100. * nbLost / result.nbGames << " %)" << std::endl;
+    os << "Essais moyens (parties gagnées) : " << meanGuesses << std::endl;
+    os << std::endl;
+    os << "Durée totale      : " << result.wallDuration << " s, soit "
+       << result.nbGames / result.wallDuration << " parties/s" << std::endl;
+    os << "Premiers essais   : " << result.nbTemplates << " modèles en " << result.firstGuessesDuration << " s" << std::endl;
+    os << "Latence par tour  : p50 " << latency.p50 * 1e3 << " ms, p95 " << latency.p95 * 1e3
+       << " ms, p99 " << latency.p99 * 1e3 << " ms (" << latency.count << " tours)" << std::endl;
+
+    const auto& work = result.solverWork;
+    os << "Travail du solver : " << work.nbComputations << " calculs (" << work.nbFromMemo << " par le mémo), "
+       << work.nbGuessesScored << " essais évalués, " << work.nbGuessesPruned << " écartés, "
+       << work.nbPatternsEvaluated << " indices calculés" << std::endl;
+    os << "Durées cumulées   : modèles " << work.setTemplateDuration << " s, indices " << work.addHintDuration
+       << " s, calculs " << work.computeGuessesDuration << " s, mémoire temporaire maximale "
+       << work.peakScratchMemory / 1024. << " Kio" << std::endl;
+    os << "Mémoire retenue   : dictionnaire " << rules.getDictionary()->getRetainedBytes() / 1024. << " Kio, solver "
+       << work.peakRetainedMemory / 1024. << " Kio au maximum, parties " << result.batchRetainedMemory / 1024. << " Kio" << std::endl;
+
+    // the counts cover the whole simulation, whose work is dominated by the evaluation of the hints
+    if (counts.hasCounts()) {
+        auto perPattern = counts.divide(static_cast<double>(work.nbPatternsEvaluated));
+        os << "Compteurs matériels : IPC ";
+        writeCount(os, counts.getIpc(), "-");
+        os << ", par indice calculé : ";
+        writeCount(os, perPattern.get(PerfEvent::CYCLES), "-");
+        os << " cycles, ";
+        writeCount(os, perPattern.get(PerfEvent::INSTRUCTIONS), "-");
+        os << " instructions, ";
+        writeCount(os, perPattern.get(PerfEvent::CACHE_MISSES), "-");
+        os << " défauts de cache, ";
+        writeCount(os, perPattern.get(PerfEvent::BRANCH_MISSES), "-");
+        os << " erreurs de prédiction" << std::endl;
+    }
+
+    // only counted when the executable is built with ALPHADOCTE_COUNT_ALLOCATIONS
+    if (AllocationTracker::isEnabled()) {
+        os << "Allocations par phase :" << std::endl;
+        for (size_t i = 0; i < NB_MEMORY_PHASES; i++) {
+            auto phase = static_cast<MemoryPhase>(i);
+            auto allocations = AllocationTracker::getStats(phase);
+            os << "  " << std::left << std::setw(21) << AllocationTracker::getPhaseName(phase) << std::right << " : "
+               << allocations.nbAllocations << " allocations, " << allocations.allocatedBytes / 1024. << " Kio, pic "
+               << allocations.peakBytes / 1024. << " Kio" << std::endl;
+        }
+    }
+
+    if (args.has("memo")) {
+        const auto& memo = result.memoStats;
+        os << "Mémo              : " << 100. * memo.getHitRate() << " % de succès ("
+           << memo.nbHits + memo.nbCoalesced << " sur " << memo.nbHits + memo.nbCoalesced + memo.nbMisses << ", dont "
+           << memo.nbCoalesced << " en attente d'un calcul en cours), "
+           << memo.nbEntries << " états, " << memo.memoryUsage / 1024. << " Kio, "
+           << memo.nbEvictions << " évictions" << std::endl;
+    }
+}
+
+void writeJson(std::ostream& os, const CommandLine& args, const std::filesystem::path& dictionaryPath,
+        const IGameRules& rules, size_t nbCandidates, const SimulationResult& result, const PerfCounts& counts) {
+    auto latency = summarize(result.turnLatencies);
+    size_t nbLost = result.nbGames - result.nbWon;
+
+    os << std::setprecision(9);
+    os << "{\n";
+    os << "  \"dictionary\": " << quoteJson(dictionaryPath.string()) << ",\n";
+    os << "  \"rules\": " << quoteJson(args.getString("rules", DEFAULT_RULES)) << ",\n";
+    os << "  \"max_guesses\": " << rules.getMaxGuesses() << ",\n";
+    os << "  \"template\": " << quoteJson(args.getString("template")) << ",\n";
+    os << "  \"solver\": {\"name\": " << quoteJson(result.solverName) << ", \"version\": " << result.solverVersion << "},\n";
+    os << "  \"candidates\": " << nbCandidates << ",\n";
+    os << "  \"games\": " << result.nbGames << ",\n";
+    os << "  \"seed\": " << args.getUnsigned("seed", DEFAULT_SEED) << ",\n";
+    os << "  \"threads\": " << result.nbThreads << ",\n";
+    os << "  \"won\": " << result.nbWon << ",\n";
+    os << "  \"failed\": " << nbLost << ",\n";
+    os << "  \"failure_rate\": " << static_cast<double>(nbLost) / result.nbGames << ",\n";
+    os << "  \"guess_distribution\": {";
+    std::string sep;
+    for (const auto& [nbGuesses, count] : result.guessDistribution) {
+        os << sep << '"' << nbGuesses << "\": " << count;
+        sep = ", ";
+    }
+    os << "},\n";
+    os << "  \"wall_time_s\": " << result.wallDuration << ",\n";
+    os << "  \"games_per_second\": " << result.nbGames / result.wallDuration << ",\n";
+    os << "  \"first_guesses\": {\"templates\": " << result.nbTemplates << ", \"time_s\": " << result.firstGuessesDuration << "},\n";
+    os << "  \"turn_latency_ms\": {\"count\": " << latency.count
+       << ", \"mean\": " << latency.mean * 1e3
+       << ", \"p50\": " << latency.p50 * 1e3
+       << ", \"p95\": " << latency.p95 * 1e3
+       << ", \"p99\": " << latency.p99 * 1e3
+       << ", \"max\": " << latency.max * 1e3 << "},\n";
+    os << "  \"solver_work\": {\"computations\": " << result.solverWork.nbComputations
+       << ", \"from_memo\": " << result.solverWork.nbFromMemo
+       << ", \"guesses_scored\": " << result.solverWork.nbGuessesScored
+       << ", \"guesses_pruned\": " << result.solverWork.nbGuessesPruned
+       << ", \"patterns_evaluated\": " << result.solverWork.nbPatternsEvaluated
+       << ", \"max_solver_threads\": " << result.solverWork.maxSolverThreads
+       << ", \"set_template_s\": " << result.solverWork.setTemplateDuration
+       << ", \"add_hint_s\": " << result.solverWork.addHintDuration
+       << ", \"compute_guesses_s\": " << result.solverWork.computeGuessesDuration
+       << ", \"peak_scratch_bytes\": " << result.solverWork.peakScratchMemory << "},\n";
+    os << "  \"retained_memory\": {\"dictionary_bytes\": " << rules.getDictionary()->getRetainedBytes()
+       << ", \"solver_peak_bytes\": " << result.solverWork.peakRetainedMemory
+       << ", \"games_bytes\": " << result.batchRetainedMemory << "},\n";
+    if (counts.hasCounts()) {
+        auto perPattern = counts.divide(static_cast<double>(result.solverWork.nbPatternsEvaluated));
+        os << "  \"hardware_counters\": {\"ipc\": ";
+        writeCount(os, counts.getIpc(), "null");
+        for (size_t i = 0; i < NB_PERF_EVENTS; i++) {
+            auto event = static_cast<PerfEvent>(i);
+            os << ", " << quoteJson(PerfCounters::getEventName(event)) << ": ";
+            writeCount(os, counts.get(event), "null");
+        }
+        os << ", \"per_pattern\": {";
+        for (size_t i = 0; i < NB_PERF_EVENTS; i++) {
+            auto event = static_cast<PerfEvent>(i);
+            os << (i > 0 ? ", " : "") << quoteJson(PerfCounters::getEventName(event)) << ": ";
+            writeCount(os, perPattern.get(event), "null");
+        }
+        os << "}},\n";
+    }
+    if (AllocationTracker::isEnabled()) {
+        os << "  \"allocations\": {";
+        sep.clear();
+        for (size_t i = 0; i < NB_MEMORY_PHASES; i++) {
+            auto phase = static_cast<MemoryPhase>(i);
+            auto allocations = AllocationTracker::getStats(phase);
+            os << sep << quoteJson(AllocationTracker::getPhaseName(phase)) << ": {\"count\": " << allocations.nbAllocations
+               << ", \"bytes\": " << allocations.allocatedBytes
+               << ", \"peak_bytes\": " << allocations.peakBytes << "}";
+            sep = ", ";
+        }
+        os << "},\n";
+    }
+    os << "  \"memo\": {\"capacity\": " << args.getUnsigned("memo", 0)
+       << ", \"hits\": " << result.memoStats.nbHits
+       << ", \"misses\": " << result.memoStats.nbMisses
+       << ", \"coalesced\": " << result.memoStats.nbCoalesced
+       << ", \"hit_rate\": " << result.memoStats.getHitRate()
+       << ", \"entries\": " << result.memoStats.nbEntries
+       << ", \"evictions\": " << result.memoStats.nbEvictions
+       << ", \"memory_bytes\": " << result.memoStats.memoryUsage << "}\n";
+    os << "}" << std::endl;
+}
@@ -0,0 +1,1071 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: BinaryCache.cpp
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/sync/file_lock.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Metrics.h>
+#include <Alphadocte/Trace.h>
+
+#include "BinaryCache.h"
+#include "CacheConfig.h"
+#include "Common.h"
+
+namespace Alphadocte {
+
+namespace CLI {
+
+namespace {
+
+// keep helper functions and file layout local to this translation unit
+
+// count the lookups of the first and second guesses, next to the ones of the solver memo
+void countLookup(bool hit) {
+    static Counter& hits = MetricsRegistry::getGlobal().registerCounter("alphadocte_cache_hits_total",
+            "Number of lookups answered by a cache.", {{"cache", "binary"}});
+    static Counter& misses = MetricsRegistry::getGlobal().registerCounter("alphadocte_cache_misses_total",
+            "Number of lookups not answered by a cache.", {{"cache", "binary"}});
+    (hit ? hits : misses).add();
+}
+
+const char MAGIC[8] = {'A', 'D', 'C', 'A', 'C', 'H', 'E', '\0'};
+const std::uint32_t FORMAT_VERSION = 3;
+const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// header layout
+const std::uint64_t OFFSET_FORMAT_VERSION = 8;
+const std::uint64_t OFFSET_BYTE_ORDER = 12;
+const std::uint64_t OFFSET_SOLVER_VERSION = 16;
+const std::uint64_t OFFSET_NB_WORDS = 20;
+const std::uint64_t OFFSET_CONTENT_HASH = 24;
+const std::uint64_t OFFSET_INDEX_OFFSET = 32;
+const std::uint64_t OFFSET_INDEX_CAPACITY = 40;
+const std::uint64_t OFFSET_NB_RECORDS = 48;
+const std::uint64_t OFFSET_WASTED_SIZE = 56;
+const std::uint64_t OFFSET_PATH_LENGTH = 64;
+const std::uint64_t OFFSET_SOLVER_NAME_LENGTH = 68;
+const std::uint64_t HEADER_FIXED_SIZE = 72; // followed by the dictionary path and the solver name
+
+// index slot : key hash, record offset (0 if empty)
+const std::uint64_t SLOT_SIZE = 16;
+const std::uint64_t MIN_INDEX_CAPACITY = 64;
+
+// record : key length, requested number, number of guesses, last access time,
+// then the padded key, and the guesses as (score, word ID, reserved)
+// the key is either a template, or a book position (see BookPosition::toString())
+const std::uint64_t RECORD_HEADER_SIZE = 16;
+const std::uint64_t OFFSET_RECORD_ACCESS_TIME = 12;
+const std::uint64_t GUESS_SIZE = 16;
+
+// replaced records are only dropped once they take more room than this, and than the other records
+const std::uint64_t MIN_COMPACTION_SIZE = 64 * 1024;
+
+template<typename T>
+T readValue(const char* data, std::uint64_t offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(value));
+    return value;
+}
+
+template<typename T>
+void appendValue(std::string& buffer, T value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T>
+void writeValue(std::string& buffer, std::uint64_t offset, T value) {
+    std::memcpy(buffer.data() + offset, &value, sizeof(value));
+}
+
+std::uint64_t padded(std::uint64_t size) {
+    return (size + 7) & ~std::uint64_t{7};
+}
+
+// access times are seconds since the epoch, records written by older versions have 0
+std::uint32_t currentAccessTime() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(now).count());
+}
+
+// FNV-1a, stable across platforms and runs, unlike std::hash
+std::uint64_t hashKey(std::string_view key) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/*
+ * View on a record of the mapped file.
+ */
+struct RecordView {
+    std::string_view key;
+    std::uint32_t requestedNumber;
+    std::uint32_t nbGuesses;
+    std::uint32_t accessTime;
+    std::uint64_t guessesOffset;
+    std::uint64_t size;           // total size of the record, in bytes
+};
+
+/*
+ * Read the record at the given offset, checking that it fits in the file.
+ *
+ * Throws :
+ * - Exception : if the record does not fit in the file.
+ */
+RecordView readRecord(const char* data, std::uint64_t fileSize, std::uint64_t offset) {
+    if (offset + RECORD_HEADER_SIZE > fileSize) {
+        throw Alphadocte::Exception("Corrupted cache : record out of the file.",
+                "Alphadocte::CLI::readRecord(const char*, std::uint64_t, std::uint64_t)");
+    }
+
+    RecordView record{};
+    auto keyLength = readValue<std::uint32_t>(data, offset);
+    record.requestedNumber = readValue<std::uint32_t>(data, offset + 4);
+    record.nbGuesses = readValue<std::uint32_t>(data, offset + 8);
+    record.accessTime = readValue<std::uint32_t>(data, offset + OFFSET_RECORD_ACCESS_TIME);
+    record.guessesOffset = offset + RECORD_HEADER_SIZE + padded(keyLength);
+    record.size = record.guessesOffset + record.nbGuesses * GUESS_SIZE - offset;
+
+    if (offset + record.size > fileSize) {
+        throw Alphadocte::Exception("Corrupted cache : record out of the file.",
+                "Alphadocte::CLI::readRecord(const char*, std::uint64_t, std::uint64_t)");
+    }
+    record.key = std::string_view{data + offset + RECORD_HEADER_SIZE, keyLength};
+
+    return record;
+}
+
+/*
+ * Exclusive lock on a cache file, between processes and between the threads of this process
+ * (file locks are held by processes, not threads).
+ *
+ * Throws :
+ * - Exception : if the lock file cannot be created or locked.
+ */
+class CacheLock {
+public:
+    explicit CacheLock(const std::filesystem::path& cachePath)
+            : m_threadLock{getMutex()}, m_fileLock{} {
+        auto lockPath = cachePath;
+        lockPath += ".lock";
+
+        try {
+            // the lock file is never removed, others processes may be waiting on it
+            std::ofstream{lockPath, std::ios::app};
+            m_file = boost::interprocess::file_lock{lockPath.string().c_str()};
+            m_fileLock = boost::interprocess::scoped_lock<boost::interprocess::file_lock>{m_file};
+        } catch (const boost::interprocess::interprocess_exception& e) {
+            throw Alphadocte::Exception("Could not lock the cache file " + cachePath.string() + " : " + e.what(),
+                    "Alphadocte::CLI::CacheLock::CacheLock(const std::filesystem::path&)");
+        }
+    }
+
+private:
+    static std::mutex& getMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::unique_lock<std::mutex> m_threadLock;
+    boost::interprocess::file_lock m_file;
+    boost::interprocess::scoped_lock<boost::interprocess::file_lock> m_fileLock;
+};
+
+/*
+ * Position of the index of a cache file, whatever its dictionary and solver.
+ */
+struct FileLayout {
+    std::uint64_t headerSize; // including the dictionary path and the solver name
+    std::uint64_t indexOffset;
+    std::uint64_t indexCapacity;
+};
+
+/*
+ * Read the layout of a mapped cache file, or nothing if it is not a cache file of this format.
+ */
+std::optional<FileLayout> readLayout(const char* data, std::uint64_t size) {
+    if (size < HEADER_FIXED_SIZE
+            || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0
+            || readValue<std::uint32_t>(data, OFFSET_FORMAT_VERSION) != FORMAT_VERSION
+            || readValue<std::uint32_t>(data, OFFSET_BYTE_ORDER) != BYTE_ORDER_MARK)
+        return std::nullopt;
+
+    FileLayout layout{};
+    layout.headerSize = HEADER_FIXED_SIZE + readValue<std::uint32_t>(data, OFFSET_PATH_LENGTH)
+            + readValue<std::uint32_t>(data, OFFSET_SOLVER_NAME_LENGTH);
+    layout.indexOffset = readValue<std::uint64_t>(data, OFFSET_INDEX_OFFSET);
+    layout.indexCapacity = readValue<std::uint64_t>(data, OFFSET_INDEX_CAPACITY);
+
+    if (layout.headerSize > size
+            || layout.indexCapacity == 0 || (layout.indexCapacity & (layout.indexCapacity - 1)) != 0
+            || layout.indexOffset < layout.headerSize
+            || layout.indexOffset + layout.indexCapacity * SLOT_SIZE > size)
+        return std::nullopt;
+
+    return layout;
+}
+
+/*
+ * Call function(hash, offset, record) for each record referenced by an index.
+ * Records out of the mapped file are ignored.
+ *
+ * Throws :
+ * - Exception : if a record is corrupted.
+ */
+template<typename Function>
+void forEachRecord(const char* data, std::uint64_t size, std::uint64_t indexOffset, std::uint64_t indexCapacity,
+        Function function) {
+    for (std::uint64_t slot = 0; slot < indexCapacity; slot++) {
+        auto hash = readValue<std::uint64_t>(data, indexOffset + slot * SLOT_SIZE);
+        auto offset = readValue<std::uint64_t>(data, indexOffset + slot * SLOT_SIZE + 8);
+        if (offset != 0 && offset < size)
+            function(hash, offset, readRecord(data, size, offset));
+    }
+}
+
+/*
+ * Map a whole file for reading, or return an empty region if it cannot be mapped.
+ */
+boost::interprocess::mapped_region mapFile(const std::filesystem::path& path) {
+    try {
+        boost::interprocess::file_mapping file{path.string().c_str(), boost::interprocess::read_only};
+        return boost::interprocess::mapped_region{file, boost::interprocess::read_only};
+    } catch (const boost::interprocess::interprocess_exception&) {
+        return boost::interprocess::mapped_region{};
+    }
+}
+
+/*
+ * Copy the header of a cache file, followed by a new index of the given capacity and the records
+ * referenced by the old index, except those last accessed before minAccessTime.
+ * Records out of the mapped file are ignored.
+ *
+ * Throws :
+ * - Exception : if a record is corrupted.
+ */
+std::string copyRecords(std::string header, const char* data, std::uint64_t size,
+        std::uint64_t oldIndexOffset, std::uint64_t oldIndexCapacity, std::uint64_t indexCapacity,
+        std::uint32_t minAccessTime) {
+    std::string content = std::move(header);
+    content.resize(padded(std::size(content)), '\0');
+
+    std::uint64_t indexOffset = std::size(content);
+    content.resize(indexOffset + indexCapacity * SLOT_SIZE, '\0');
+    std::uint64_t nbRecords{};
+
+    forEachRecord(data, size, oldIndexOffset, oldIndexCapacity,
+            [&](std::uint64_t hash, std::uint64_t offset, const RecordView& record) {
+        if (record.accessTime < minAccessTime)
+            return;
+
+        std::uint64_t slot = hash & (indexCapacity - 1);
+        while (readValue<std::uint64_t>(content.data(), indexOffset + slot * SLOT_SIZE + 8) != 0) {
+            slot = (slot + 1) & (indexCapacity - 1);
+        }
+
+        writeValue(content, indexOffset + slot * SLOT_SIZE, hash);
+        writeValue(content, indexOffset + slot * SLOT_SIZE + 8, static_cast<std::uint64_t>(std::size(content)));
+        content.append(data + offset, record.size);
+        nbRecords++;
+    });
+
+    writeValue(content, OFFSET_INDEX_OFFSET, indexOffset);
+    writeValue(content, OFFSET_INDEX_CAPACITY, indexCapacity);
+    writeValue(content, OFFSET_NB_RECORDS, nbRecords);
+    writeValue(content, OFFSET_WASTED_SIZE, std::uint64_t{0});
+
+    return content;
+}
+
+/*
+ * Replace the cache file by the given content, written to a temporary file and renamed.
+ *
+ * Throws :
+ * - Exception : if the file cannot be written or replaced.
+ */
+void replaceFile(const std::filesystem::path& cachePath, const std::string& content) {
+    auto tmpPath = cachePath;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file{tmpPath, std::ios::binary | std::ios::trunc};
+        file.write(content.data(), static_cast<std::streamsize>(std::size(content)));
+        file.close();
+
+        if (!file) {
+            throw Alphadocte::Exception("Could not write the cache file " + tmpPath.string() + '.',
+                    "Alphadocte::CLI::replaceFile(const std::filesystem::path&, const std::string&)");
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tmpPath, cachePath, error);
+    if (error) {
+        throw Alphadocte::Exception("Could not replace the cache file " + cachePath.string() + " : " + error.message(),
+                "Alphadocte::CLI::replaceFile(const std::filesystem::path&, const std::string&)");
+    }
+}
+
+}
+
+DictionaryIdentity DictionaryIdentity::compute(const std::filesystem::path& dictionaryPath, const Dictionary& dictionary) {
+    if (!dictionary.isLoaded()) {
+        throw Alphadocte::Exception("The dictionary must be loaded.",
+                "Alphadocte::CLI::DictionaryIdentity::compute(const std::filesystem::path&, const Alphadocte::Dictionary&)");
+    }
+
+    std::error_code error;
+    DictionaryIdentity identity;
+    identity.path = std::filesystem::absolute(dictionaryPath, error).string();
+    if (error)
+        identity.path = dictionaryPath.string();
+    identity.contentHash = dictionary.getContentHash();
+    identity.nbWords = static_cast<std::uint32_t>(std::size(dictionary.getAllWords()));
+
+    return identity;
+}
+
+bool operator==(const DictionaryIdentity& lhs, const DictionaryIdentity& rhs) {
+    // the path is only informative, a copy of the dictionary shares the same cache
+    return lhs.contentHash == rhs.contentHash && lhs.nbWords == rhs.nbWords;
+}
+
+BinaryCache::BinaryCache(std::filesystem::path cachePath,
+        std::shared_ptr<const Dictionary> dictionary,
+        DictionaryIdentity identity,
+        std::string solverName,
+        unsigned int solverVersion)
+        : m_cachePath{std::move(cachePath)}, m_dictionary{std::move(dictionary)},
+          m_identity{std::move(identity)}, m_solverName{std::move(solverName)},
+          m_solverVersion{solverVersion}, m_file{}, m_region{},
+          m_indexOffset{}, m_indexCapacity{}, m_nbRecords{}, m_wastedSize{},
+          m_accessedKeys{}, m_accessedKeysMutex{}, m_compaction{} {
+    if (!m_dictionary || !m_dictionary->isLoaded()) {
+        throw Alphadocte::InvalidArgException("The dictionary must be loaded.",
+                "Alphadocte::CLI::BinaryCache::BinaryCache(std::filesystem::path, std::shared_ptr<const Alphadocte::Dictionary>, Alphadocte::CLI::DictionaryIdentity, std::string, unsigned int)");
+    }
+
+    open();
+}
+
+BinaryCache::BinaryCache(BinaryCache &&other)
+        : m_cachePath{std::move(other.m_cachePath)}, m_dictionary{std::move(other.m_dictionary)},
+          m_identity{std::move(other.m_identity)}, m_solverName{std::move(other.m_solverName)},
+          m_solverVersion{other.m_solverVersion}, m_file{std::move(other.m_file)}, m_region{std::move(other.m_region)},
+          m_indexOffset{other.m_indexOffset}, m_indexCapacity{other.m_indexCapacity},
+          m_nbRecords{other.m_nbRecords}, m_wastedSize{other.m_wastedSize},
+          m_accessedKeys{std::move(other.m_accessedKeys)}, m_accessedKeysMutex{}, m_compaction{std::move(other.m_compaction)} {
+}
+
+BinaryCache::~BinaryCache() {
+    try {
+        flushAccessTimes();
+    } catch (const Alphadocte::Exception&) {
+        // access times only order evictions, the cache stays valid without them
+    }
+    waitForCompaction();
+}
+
+BinaryCache& BinaryCache::operator=(BinaryCache &&other) {
+    // a running thread cannot be overwritten, and pending access times refer to the current file
+    try {
+        flushAccessTimes();
+    } catch (const Alphadocte::Exception&) {
+        // see the destructor
+    }
+    waitForCompaction();
+
+    m_cachePath = std::move(other.m_cachePath);
+    m_dictionary = std::move(other.m_dictionary);
+    m_identity = std::move(other.m_identity);
+    m_solverName = std::move(other.m_solverName);
+    m_solverVersion = other.m_solverVersion;
+    m_file = std::move(other.m_file);
+    m_region = std::move(other.m_region);
+    m_indexOffset = other.m_indexOffset;
+    m_indexCapacity = other.m_indexCapacity;
+    m_nbRecords = other.m_nbRecords;
+    m_wastedSize = other.m_wastedSize;
+    m_accessedKeys = std::move(other.m_accessedKeys);
+    m_compaction = std::move(other.m_compaction);
+
+    return *this;
+}
+
+const std::filesystem::path& BinaryCache::getCachePath() const {
+    return m_cachePath;
+}
+
+const DictionaryIdentity& BinaryCache::getDictionaryIdentity() const {
+    return m_identity;
+}
+
+std::string_view BinaryCache::getSolverName() const {
+    return m_solverName;
+}
+
+unsigned int BinaryCache::getSolverVersion() const {
+    return m_solverVersion;
+}
+
+size_t BinaryCache::size() const {
+    return m_nbRecords;
+}
+
+std::uint64_t BinaryCache::getWastedSize() const {
+    return m_wastedSize;
+}
+
+std::vector<std::string> BinaryCache::getTemplates() const {
+    auto templates = getKeys();
+    // book positions are the only keys with spaces
+    std::erase_if(templates, [](const auto& key) { return key.find(' ') != key.npos; });
+    return templates;
+}
+
+std::vector<BookPosition> BinaryCache::getBookPositions() const {
+    std::vector<BookPosition> positions;
+    for (const auto& key : getKeys()) {
+        if (key.find(' ') != key.npos)
+            positions.push_back(BookPosition::parse(key));
+    }
+
+    return positions;
+}
+
+std::vector<std::string> BinaryCache::getKeys() const {
+    std::vector<std::string> keys;
+    if (!m_file)
+        return keys;
+
+    const char* data = static_cast<const char*>(m_region.get_address());
+    for (std::uint64_t slot = 0; slot < m_indexCapacity; slot++) {
+        auto offset = readValue<std::uint64_t>(data, m_indexOffset + slot * SLOT_SIZE + 8);
+        if (offset != 0 && offset < m_region.get_size())
+            keys.emplace_back(readRecord(data, m_region.get_size(), offset).key);
+    }
+
+    return keys;
+}
+
+bool BinaryCache::contains(std::string_view templateWord, unsigned int requestedNumberGuesses) const {
+    auto offset = findRecord(templateWord);
+    if (offset == 0)
+        return false;
+
+    const char* data = static_cast<const char*>(m_region.get_address());
+    return readRecord(data, m_region.get_size(), offset).requestedNumber >= requestedNumberGuesses;
+}
+
+bool BinaryCache::containsSecondGuesses(const BookPosition& position, unsigned int requestedNumberGuesses) const {
+    // same lookup as a template, with the position as key
+    return contains(position.toString(), requestedNumberGuesses);
+}
+
+std::vector<std::pair<std::string, double>> BinaryCache::getTopGuesses(
+        unsigned int requestedNumberGuesses,
+        std::string_view templateWord) const {
+    auto offset = findRecord(templateWord);
+    if (offset == 0) {
+        throw Alphadocte::Exception("Template \"" + std::string(templateWord) + "\" not found in cache.",
+                "Alphadocte::CLI::BinaryCache::getTopGuesses(unsigned int, std::string_view) const");
+    }
+
+    if (auto guesses = readGuesses(offset, requestedNumberGuesses,
+            "Alphadocte::CLI::BinaryCache::getTopGuesses(unsigned int, std::string_view) const"))
+        return std::move(*guesses);
+
+    throw Alphadocte::Exception("Not enough guesses in cache.",
+            "Alphadocte::CLI::BinaryCache::getTopGuesses(unsigned int, std::string_view) const");
+}
+
+std::optional<std::vector<std::pair<std::string, double>>> BinaryCache::findTopGuesses(
+        unsigned int requestedNumberGuesses,
+        std::string_view templateWord) const {
+    auto offset = findRecord(templateWord);
+    if (offset == 0) {
+        countLookup(false);
+        return std::nullopt;
+    }
+
+    auto guesses = readGuesses(offset, requestedNumberGuesses,
+            "Alphadocte::CLI::BinaryCache::findTopGuesses(unsigned int, std::string_view) const");
+    countLookup(guesses.has_value());
+    return guesses;
+}
+
+std::vector<std::pair<std::string, double>> BinaryCache::getSecondGuesses(
+        unsigned int requestedNumberGuesses,
+        const BookPosition& position) const {
+    auto key = position.toString();
+    auto offset = findRecord(key);
+    if (offset == 0) {
+        throw Alphadocte::Exception("Book position \"" + key + "\" not found in cache.",
+                "Alphadocte::CLI::BinaryCache::getSecondGuesses(unsigned int, const Alphadocte::CLI::BookPosition&) const");
+    }
+
+    if (auto guesses = readGuesses(offset, requestedNumberGuesses,
+            "Alphadocte::CLI::BinaryCache::getSecondGuesses(unsigned int, const Alphadocte::CLI::BookPosition&) const"))
+        return std::move(*guesses);
+
+    throw Alphadocte::Exception("Not enough guesses in cache.",
+            "Alphadocte::CLI::BinaryCache::getSecondGuesses(unsigned int, const Alphadocte::CLI::BookPosition&) const");
+}
+
+std::optional<std::vector<std::pair<std::string, double>>> BinaryCache::findSecondGuesses(
+        unsigned int requestedNumberGuesses,
+        const BookPosition& position) const {
+    auto offset = findRecord(position.toString());
+    if (offset == 0) {
+        countLookup(false);
+        return std::nullopt;
+    }
+
+    auto guesses = readGuesses(offset, requestedNumberGuesses,
+            "Alphadocte::CLI::BinaryCache::findSecondGuesses(unsigned int, const Alphadocte::CLI::BookPosition&) const");
+    countLookup(guesses.has_value());
+    return guesses;
+}
+
+void BinaryCache::setTopGuesses(std::string_view templateWord,
+        unsigned int requestedNumberGuesses,
+        const std::vector<std::pair<std::string, double>>& topGuesses) {
+    writeGuesses(templateWord, requestedNumberGuesses, topGuesses,
+            "Alphadocte::CLI::BinaryCache::setTopGuesses(std::string_view, unsigned int, const std::vector<std::pair<std::string, double>>&)");
+}
+
+void BinaryCache::setSecondGuesses(const BookPosition& position,
+        unsigned int requestedNumberGuesses,
+        const std::vector<std::pair<std::string, double>>& secondGuesses) {
+    writeGuesses(position.toString(), requestedNumberGuesses, secondGuesses,
+            "Alphadocte::CLI::BinaryCache::setSecondGuesses(const Alphadocte::CLI::BookPosition&, unsigned int, const std::vector<std::pair<std::string, double>>&)");
+}
+
+std::optional<std::vector<std::pair<std::string, double>>> BinaryCache::readGuesses(std::uint64_t offset,
+        unsigned int requestedNumberGuesses, const std::string& functionName) const {
+    ALPHADOCTE_TRACE_SCOPE("readCache", "cache");
+    const char* data = static_cast<const char*>(m_region.get_address());
+    auto record = readRecord(data, m_region.get_size(), offset);
+
+    if (record.requestedNumber < requestedNumberGuesses)
+        return std::nullopt;
+
+    const auto& words = m_dictionary->getAllWords();
+    std::vector<std::pair<std::string, double>> guesses;
+    auto nbGuesses = std::min(record.nbGuesses, static_cast<std::uint32_t>(requestedNumberGuesses));
+    for (std::uint32_t i = 0; i < nbGuesses; i++) {
+        auto guessOffset = record.guessesOffset + i * GUESS_SIZE;
+        auto score = readValue<double>(data, guessOffset);
+        auto wordId = readValue<std::uint32_t>(data, guessOffset + 8);
+
+        if (wordId >= std::size(words)) {
+            throw Alphadocte::Exception("Corrupted cache : invalid word ID.", functionName);
+        }
+
+        guesses.emplace_back(words[wordId], score);
+    }
+
+    std::lock_guard lock{m_accessedKeysMutex};
+    m_accessedKeys.emplace(record.key);
+    return guesses;
+}
+
+void BinaryCache::writeGuesses(std::string_view key,
+        unsigned int requestedNumberGuesses,
+        const std::vector<std::pair<std::string, double>>& guesses,
+        const std::string& functionName) {
+    ALPHADOCTE_TRACE_SCOPE("writeCache", "cache");
+
+    // Serialize the record
+    std::string record;
+    appendValue(record, static_cast<std::uint32_t>(std::size(key)));
+    appendValue(record, static_cast<std::uint32_t>(requestedNumberGuesses));
+    appendValue(record, static_cast<std::uint32_t>(std::size(guesses)));
+    appendValue(record, currentAccessTime());
+    record.append(key);
+    record.resize(padded(std::size(record)), '\0');
+
+    for (const auto& [guess, score] : guesses) {
+        auto wordId = m_dictionary->findWord(guess);
+        if (!wordId) {
+            throw Alphadocte::InvalidArgException("Guess " + guess + " is not in the dictionary.", functionName);
+        }
+
+        appendValue(record, score);
+        appendValue(record, static_cast<std::uint32_t>(*wordId));
+        appendValue(record, std::uint32_t{0});
+    }
+
+    // the lock is not reentrant, save the pending access times first
+    flushAccessTimes();
+
+    {
+        CacheLock lock{m_cachePath};
+
+        // Start from the latest version of the file, other processes may have written to it
+        open();
+
+        // Make sure there is a valid file, with enough room in the index
+        bool exists = findRecord(key) != 0;
+        if (!m_file) {
+            rebuild(MIN_INDEX_CAPACITY);
+        } else if (!exists && 2 * (m_nbRecords + 1) > m_indexCapacity) {
+            rebuild(2 * m_indexCapacity);
+        }
+
+        // Find the slot of the key, either its current one or the first free one
+        const char* data = static_cast<const char*>(m_region.get_address());
+        auto hash = hashKey(key);
+        std::uint64_t slot = hash & (m_indexCapacity - 1);
+        std::uint64_t replacedSize{};
+        while (true) {
+            auto offset = readValue<std::uint64_t>(data, m_indexOffset + slot * SLOT_SIZE + 8);
+            if (offset == 0)
+                break;
+
+            if (readValue<std::uint64_t>(data, m_indexOffset + slot * SLOT_SIZE) == hash) {
+                auto existingRecord = readRecord(data, m_region.get_size(), offset);
+                if (existingRecord.key == key) {
+                    replacedSize = existingRecord.size;
+                    break;
+                }
+            }
+            slot = (slot + 1) & (m_indexCapacity - 1);
+        }
+
+        // Append the record, then point the slot to it, so that an interrupted write leaves the cache valid
+        // (the mapping must be released before writing, for Windows)
+        auto recordOffset = static_cast<std::uint64_t>(m_region.get_size());
+        auto nbRecords = exists ? m_nbRecords : m_nbRecords + 1;
+        auto wastedSize = m_wastedSize + replacedSize;
+        m_region = boost::interprocess::mapped_region{};
+        m_file.reset();
+
+        std::string slotData;
+        appendValue(slotData, hash);
+        appendValue(slotData, recordOffset);
+
+        std::fstream file{m_cachePath, std::ios::in | std::ios::out | std::ios::binary};
+        file.seekp(static_cast<std::streamoff>(recordOffset));
+        file.write(record.data(), static_cast<std::streamsize>(std::size(record)));
+        file.flush();
+        file.seekp(static_cast<std::streamoff>(m_indexOffset + slot * SLOT_SIZE));
+        file.write(slotData.data(), static_cast<std::streamsize>(std::size(slotData)));
+        file.seekp(static_cast<std::streamoff>(OFFSET_NB_RECORDS));
+        file.write(reinterpret_cast<const char*>(&nbRecords), sizeof(nbRecords));
+        file.write(reinterpret_cast<const char*>(&wastedSize), sizeof(wastedSize));
+        file.close();
+
+        if (!file) {
+            throw Alphadocte::Exception("Could not write the cache file " + m_cachePath.string() + '.', functionName);
+        }
+    }
+
+    open();
+    scheduleCompaction();
+}
+
+size_t BinaryCache::importFrom(const CacheConfig& textCache) {
+    size_t nbImported{};
+
+    for (const auto& solverSection : textCache.getConfig().getRootSection().sections) {
+        if (solverSection.name != CacheConfig::SECTION_SOLVER)
+            continue;
+
+        const Entry* nameEntry = findEntry(solverSection, CacheConfig::ENTRY_SOLVER_NAME);
+        if (!nameEntry || nameEntry->value != m_solverName)
+            continue;
+
+        for (const auto& guessSection : solverSection.sections) {
+            if (guessSection.name == CacheConfig::SECTION_BOOK) {
+                nbImported += importBookSection(textCache, guessSection);
+                continue;
+            }
+
+            std::string templateWord;
+            unsigned long requestedNumber{};
+
+            for (const auto& entry : guessSection.entries) {
+                try {
+                    if (entry.name == CacheConfig::ENTRY_GUESS_TEMPLATE)
+                        templateWord = entry.value;
+                    else if (entry.name == CacheConfig::ENTRY_GUESS_NUMBER)
+                        requestedNumber = std::stoul(entry.value);
+                } catch (const std::logic_error&) {
+                    // invalid number, skipped below
+                }
+            }
+
+            auto guesses = textCache.findTopGuesses(m_solverName, m_solverVersion,
+                    static_cast<unsigned int>(requestedNumber), templateWord);
+            if (!guesses) {
+                // invalid or outdated section, skip it
+                continue;
+            }
+
+            try {
+                setTopGuesses(templateWord, static_cast<unsigned int>(requestedNumber), *guesses);
+                nbImported++;
+            } catch (const Alphadocte::InvalidArgException&) {
+                // guess not in the dictionary, skip this template
+            }
+        }
+    }
+
+    return nbImported;
+}
+
+size_t BinaryCache::importBookSection(const CacheConfig& textCache, const Section& bookSection) {
+    const Entry* positionEntry = findEntry(bookSection, CacheConfig::ENTRY_BOOK_POSITION);
+    const Entry* numberEntry = findEntry(bookSection, CacheConfig::ENTRY_GUESS_NUMBER);
+    if (!positionEntry || !numberEntry)
+        return 0;
+
+    try {
+        auto position = BookPosition::parse(positionEntry->value);
+        auto requestedNumber = static_cast<unsigned int>(std::stoul(numberEntry->value));
+        auto guesses = textCache.findSecondGuesses(m_solverName, m_solverVersion, requestedNumber, position);
+        if (!guesses) {
+            // invalid or outdated section, skip it
+            return 0;
+        }
+
+        setSecondGuesses(position, requestedNumber, *guesses);
+        return 1;
+    } catch (const Alphadocte::Exception&) {
+        // invalid position, or guess not in the dictionary, skip it
+    } catch (const std::logic_error&) {
+        // invalid number, skip it
+    }
+
+    return 0;
+}
+
+void BinaryCache::exportTo(CacheConfig& textCache) const {
+    if (!m_file)
+        return;
+
+    const char* data = static_cast<const char*>(m_region.get_address());
+    for (const auto& templateWord : getTemplates()) {
+        auto record = readRecord(data, m_region.get_size(), findRecord(templateWord));
+        textCache.setTopGuesses(m_solverName, m_solverVersion, templateWord, record.requestedNumber,
+                getTopGuesses(record.requestedNumber, templateWord));
+    }
+
+    for (const auto& position : getBookPositions()) {
+        auto record = readRecord(data, m_region.get_size(), findRecord(position.toString()));
+        textCache.setSecondGuesses(m_solverName, m_solverVersion, position, record.requestedNumber,
+                getSecondGuesses(record.requestedNumber, position));
+    }
+}
+
+void BinaryCache::clear() {
+    waitForCompaction();
+    CacheLock lock{m_cachePath};
+
+    m_region = boost::interprocess::mapped_region{};
+    m_file.reset();
+    m_nbRecords = m_wastedSize = 0;
+    std::lock_guard accessedKeysLock{m_accessedKeysMutex};
+    m_accessedKeys.clear();
+
+    std::error_code error;
+    std::filesystem::remove(m_cachePath, error);
+}
+
+void BinaryCache::reload() {
+    open();
+}
+
+void BinaryCache::compact() {
+    ALPHADOCTE_TRACE_SCOPE("compactCache", "cache");
+    flushAccessTimes();
+    waitForCompaction();
+    compactCacheFile(m_cachePath);
+    open();
+}
+
+void BinaryCache::flushAccessTimes() {
+    std::unordered_set<std::string> accessedKeys;
+    {
+        std::lock_guard lock{m_accessedKeysMutex};
+        std::swap(accessedKeys, m_accessedKeys);
+    }
+
+    if (accessedKeys.empty())
+        return;
+
+    ALPHADOCTE_TRACE_SCOPE("flushAccessTimes", "cache");
+
+    auto accessTime = currentAccessTime();
+    CacheLock lock{m_cachePath};
+
+    // Records may have moved since they were read, find them in the latest version of the file
+    open();
+    std::vector<std::uint64_t> offsets;
+    for (const auto& key : accessedKeys) {
+        auto offset = findRecord(key);
+        if (offset != 0)
+            offsets.push_back(offset);
+    }
+
+    if (offsets.empty())
+        return;
+
+    // Only the access time of the records is overwritten, a record keeps its size
+    // (the mapping must be released before writing, for Windows)
+    m_region = boost::interprocess::mapped_region{};
+    m_file.reset();
+
+    std::fstream file{m_cachePath, std::ios::in | std::ios::out | std::ios::binary};
+    for (auto offset : offsets) {
+        file.seekp(static_cast<std::streamoff>(offset + OFFSET_RECORD_ACCESS_TIME));
+        file.write(reinterpret_cast<const char*>(&accessTime), sizeof(accessTime));
+    }
+    file.close();
+    open();
+
+    if (!file) {
+        throw Alphadocte::Exception("Could not write the cache file " + m_cachePath.string() + '.',
+                "Alphadocte::CLI::BinaryCache::flushAccessTimes()");
+    }
+}
+
+void BinaryCache::waitForCompaction() {
+    if (m_compaction.joinable())
+        m_compaction.join();
+}
+
+void BinaryCache::open() {
+    ALPHADOCTE_TRACE_SCOPE("openCache", "cache");
+    m_region = boost::interprocess::mapped_region{};
+    m_file.reset();
+    m_indexOffset = m_indexCapacity = m_nbRecords = m_wastedSize = 0;
+
+    std::error_code error;
+    auto fileSize = std::filesystem::file_size(m_cachePath, error);
+    if (error || fileSize < HEADER_FIXED_SIZE)
+        return;
+
+    std::unique_ptr<boost::interprocess::file_mapping> file;
+    boost::interprocess::mapped_region region;
+    try {
+        file = std::make_unique<boost::interprocess::file_mapping>(m_cachePath.string().c_str(), boost::interprocess::read_only);
+        region = boost::interprocess::mapped_region{*file, boost::interprocess::read_only};
+    } catch (const boost::interprocess::interprocess_exception&) {
+        // unreadable cache, consider it empty
+        return;
+    }
+
+    const char* data = static_cast<const char*>(region.get_address());
+    auto layout = readLayout(data, region.get_size());
+    if (!layout || readValue<std::uint32_t>(data, OFFSET_SOLVER_VERSION) != m_solverVersion)
+        return;
+
+    DictionaryIdentity identity;
+    identity.nbWords = readValue<std::uint32_t>(data, OFFSET_NB_WORDS);
+    identity.contentHash = readValue<std::uint64_t>(data, OFFSET_CONTENT_HASH);
+
+    auto pathLength = readValue<std::uint32_t>(data, OFFSET_PATH_LENGTH);
+    identity.path = std::string{data + HEADER_FIXED_SIZE, pathLength};
+    std::string_view solverName{data + HEADER_FIXED_SIZE + pathLength, layout->headerSize - HEADER_FIXED_SIZE - pathLength};
+    if (!(identity == m_identity) || solverName != m_solverName)
+        return;
+
+    m_file = std::move(file);
+    m_region = std::move(region);
+    m_indexOffset = layout->indexOffset;
+    m_indexCapacity = layout->indexCapacity;
+    m_nbRecords = readValue<std::uint64_t>(data, OFFSET_NB_RECORDS);
+    m_wastedSize = readValue<std::uint64_t>(data, OFFSET_WASTED_SIZE);
+}
+
+void BinaryCache::rebuild(std::uint64_t indexCapacity) {
+    // Header, the index and the number of records are set while copying records
+    std::string header;
+    header.append(MAGIC, sizeof(MAGIC));
+    appendValue(header, FORMAT_VERSION);
+    appendValue(header, BYTE_ORDER_MARK);
+    appendValue(header, static_cast<std::uint32_t>(m_solverVersion));
+    appendValue(header, m_identity.nbWords);
+    appendValue(header, m_identity.contentHash);
+    appendValue(header, std::uint64_t{0}); // index offset
+    appendValue(header, std::uint64_t{0}); // index capacity
+    appendValue(header, std::uint64_t{0}); // number of records
+    appendValue(header, std::uint64_t{0}); // wasted size
+    appendValue(header, static_cast<std::uint32_t>(std::size(m_identity.path)));
+    appendValue(header, static_cast<std::uint32_t>(std::size(m_solverName)));
+    header.append(m_identity.path);
+    header.append(m_solverName);
+
+    std::string content = copyRecords(std::move(header), static_cast<const char*>(m_region.get_address()),
+            m_file ? m_region.get_size() : 0, m_indexOffset, m_indexCapacity, indexCapacity, 0);
+
+    // Write a temporary file, then replace the cache file
+    m_region = boost::interprocess::mapped_region{};
+    m_file.reset();
+    replaceFile(m_cachePath, content);
+
+    open();
+}
+
+void BinaryCache::scheduleCompaction() {
+    if (!m_file || m_wastedSize < MIN_COMPACTION_SIZE)
+        return;
+
+    std::uint64_t recordsSize = m_region.get_size() - (m_indexOffset + m_indexCapacity * SLOT_SIZE);
+    if (2 * m_wastedSize < recordsSize)
+        return;
+
+    waitForCompaction();
+    m_compaction = std::thread{[cachePath = m_cachePath]() {
+        try {
+            compactCacheFile(cachePath);
+        } catch (const Alphadocte::Exception&) {
+            // compaction only saves room, the cache stays valid without it
+        }
+    }};
+}
+
+std::uint64_t BinaryCache::findRecord(std::string_view key) const {
+    if (!m_file)
+        return 0;
+
+    ALPHADOCTE_TRACE_SCOPE("lookupCache", "cache");
+    const char* data = static_cast<const char*>(m_region.get_address());
+    auto hash = hashKey(key);
+
+    for (std::uint64_t i = 0, slot = hash & (m_indexCapacity - 1); i < m_indexCapacity; i++, slot = (slot + 1) & (m_indexCapacity - 1)) {
+        auto slotOffset = m_indexOffset + slot * SLOT_SIZE;
+        auto offset = readValue<std::uint64_t>(data, slotOffset + 8);
+
+        if (offset == 0 || offset >= m_region.get_size())
+            return 0; // not found, or written by another process since the file was mapped
+
+        if (readValue<std::uint64_t>(data, slotOffset) == hash
+                && readRecord(data, m_region.get_size(), offset).key == key)
+            return offset;
+    }
+
+    return 0;
+}
+
+BinaryCache openSolverCache(const std::filesystem::path& dictionaryPath,
+        std::shared_ptr<const Dictionary> dictionary,
+        std::string solverName,
+        unsigned int solverVersion) {
+    const Dictionary& words = *dictionary; // owned by the cache
+    auto identity = DictionaryIdentity::compute(dictionaryPath, words);
+    BinaryCache cache{getBinaryCachePath(dictionaryPath, solverName), std::move(dictionary),
+            std::move(identity), std::move(solverName), solverVersion};
+
+    auto textCachePath = getTextCachePath(dictionaryPath);
+    std::error_code error;
+    if (cache.size() == 0 && std::filesystem::is_regular_file(textCachePath, error)) {
+        try {
+            Config config;
+            config.loadFromFile(textCachePath);
+            cache.importFrom(CacheConfig{std::move(config), &words});
+        } catch (const Alphadocte::Exception&) {
+            // invalid or outdated text cache, nothing to import
+        }
+    }
+
+    return cache;
+}
+
+std::optional<CacheFileInfo> readCacheFileInfo(const std::filesystem::path& cachePath) {
+    auto region = mapFile(cachePath);
+    const char* data = static_cast<const char*>(region.get_address());
+    auto layout = readLayout(data, region.get_size());
+    if (!layout)
+        return std::nullopt;
+
+    CacheFileInfo info;
+    auto pathLength = readValue<std::uint32_t>(data, OFFSET_PATH_LENGTH);
+    info.identity.path = std::string{data + HEADER_FIXED_SIZE, pathLength};
+    info.identity.nbWords = readValue<std::uint32_t>(data, OFFSET_NB_WORDS);
+    info.identity.contentHash = readValue<std::uint64_t>(data, OFFSET_CONTENT_HASH);
+    info.solverName = std::string{data + HEADER_FIXED_SIZE + pathLength, layout->headerSize - HEADER_FIXED_SIZE - pathLength};
+    info.solverVersion = readValue<std::uint32_t>(data, OFFSET_SOLVER_VERSION);
+    info.fileSize = region.get_size();
+    info.wastedSize = readValue<std::uint64_t>(data, OFFSET_WASTED_SIZE);
+
+    forEachRecord(data, region.get_size(), layout->indexOffset, layout->indexCapacity,
+            [&info](std::uint64_t, std::uint64_t, const RecordView& record) {
+        info.records.push_back({std::string{record.key}, record.accessTime, record.size});
+    });
+
+    return info;
+}
+
+void compactCacheFile(const std::filesystem::path& cachePath, std::uint32_t minAccessTime) {
+    CacheLock lock{cachePath};
+
+    std::string content;
+    {
+        auto region = mapFile(cachePath);
+        const char* data = static_cast<const char*>(region.get_address());
+        auto layout = readLayout(data, region.get_size());
+        if (!layout)
+            return;
+
+        // The index shrinks along with the evicted records, keeping at most half of its slots used
+        std::uint64_t nbKept{};
+        forEachRecord(data, region.get_size(), layout->indexOffset, layout->indexCapacity,
+                [&nbKept, minAccessTime](std::uint64_t, std::uint64_t, const RecordView& record) {
+            if (record.accessTime >= minAccessTime)
+                nbKept++;
+        });
+
+        std::uint64_t indexCapacity = MIN_INDEX_CAPACITY;
+        while (2 * (nbKept + 1) > indexCapacity) {
+            indexCapacity *= 2;
+        }
+
+        content = copyRecords(std::string{data, layout->headerSize}, data, region.get_size(),
+                layout->indexOffset, layout->indexCapacity, indexCapacity, minAccessTime);
+    }
+
+    replaceFile(cachePath, content);
+}
+
+bool removeCacheFile(const std::filesystem::path& cachePath) {
+    CacheLock lock{cachePath};
+
+    std::error_code error;
+    return std::filesystem::remove(cachePath, error);
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
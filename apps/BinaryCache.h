@@ -0,0 +1,459 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: BinaryCache.h
+ */
+
+#ifndef APPS_BINARYCACHE_H_
+#define APPS_BINARYCACHE_H_
+
+/*
+ * Private header providing the binary storage of the solver cache.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace Alphadocte {
+
+class Dictionary;
+
+namespace CLI {
+
+class CacheConfig;
+struct BookPosition;
+struct Section;
+
+/*
+ * Identifies the word list used to compute cached guesses.
+ *
+ * Two dictionaries with the same words share the same identity, whatever their path
+ * or last write time, so that a cache can be copied to another host.
+ */
+struct DictionaryIdentity {
+    std::string path;            // absolute path of the dictionary file, informative only
+    std::uint64_t contentHash{}; // see Dictionary::getContentHash()
+    std::uint32_t nbWords{};
+
+    /*
+     * Compute the identity of a loaded dictionary.
+     *
+     * Throws :
+     * - Exception : if the dictionary is not loaded.
+     */
+    static DictionaryIdentity compute(const std::filesystem::path& dictionaryPath, const Dictionary& dictionary);
+};
+
+bool operator==(const DictionaryIdentity& lhs, const DictionaryIdentity& rhs);
+
+/*
+ * Cache of the top guesses computed by one solver for each template, with one dictionary.
+ * It also holds the opening book : the second guesses for each first template, first guess and hints.
+ *
+ * The cache is stored in a binary file, made of :
+ * - a header, holding the dictionary identity and the solver name and version.
+ *   A cache whose header does not match is considered empty, and is overwritten on the next write.
+ * - an index, ie an open addressing hash table from the template (hashed with FNV-1a)
+ *   to the offset of its record. It is grown by rebuilding the file when half full.
+ * - records, appended at the end of the file : the template (or book position), the number of requested guesses,
+ *   the time of the last lookup, and the (word ID, score) pairs. Word IDs are the indices of the words
+ *   in the dictionary, and scores are stored as is, without loss of precision.
+ *
+ * The file is memory-mapped for reads, so that a lookup only touches the index and one record.
+ * The text format of CacheConfig remains available to import or export the cache.
+ *
+ * Several processes can share a cache file. Writes hold an exclusive lock on "<cache file>.lock",
+ * and start by mapping the latest version of the file, so that records written by other processes
+ * are kept. A new record is appended, then the index points to it, so that an interrupted write
+ * never leaves a corrupted cache. The file is only rewritten as a whole (to grow the index, or to
+ * drop replaced records) into a temporary file, renamed into place.
+ * Readers keep a snapshot of the file, records written since are found after reload().
+ * Lookups only note the records they read, their access times are written by flushAccessTimes(),
+ * on the next write, or on destruction, so that reads never lock the file.
+ *
+ * A cache object is not thread-safe, except for concurrent lookups, but several objects can write to the same file.
+ *
+ * Values are stored in the native byte order, a marker in the header rejects files of another order.
+ */
+class BinaryCache {
+public:
+    /*
+     * Open the cache stored at the given path, or start an empty cache if the file
+     * does not exist or does not match the dictionary or the solver.
+     *
+     * Args :
+     * - cachePath : path of the cache file (created on first write)
+     * - dictionary : the loaded dictionary, used to translate word IDs
+     * - identity : the identity of the dictionary
+     * - solverName : unique identifier of the solver
+     * - solverVersion : version of the solver
+     *
+     * Throws :
+     * - InvalidArgException : if the dictionary is null or not loaded.
+     */
+    BinaryCache(std::filesystem::path cachePath,
+            std::shared_ptr<const Dictionary> dictionary,
+            DictionaryIdentity identity,
+            std::string solverName,
+            unsigned int solverVersion);
+
+    // A memory mapping cannot be copied, access times are flushed and a pending compaction is awaited on destruction
+    virtual ~BinaryCache();
+    BinaryCache(const BinaryCache &other) = delete;
+    BinaryCache(BinaryCache &&other);
+    BinaryCache& operator=(const BinaryCache &other) = delete;
+    BinaryCache& operator=(BinaryCache &&other);
+
+    // Getters
+    const std::filesystem::path& getCachePath() const;
+    const DictionaryIdentity& getDictionaryIdentity() const;
+    std::string_view getSolverName() const;
+    unsigned int getSolverVersion() const;
+
+    /*
+     * Return the number of cached templates and book positions.
+     */
+    size_t size() const;
+
+    /*
+     * Return the cached templates, in no particular order.
+     */
+    std::vector<std::string> getTemplates() const;
+
+    /*
+     * Return the positions of the opening book, in no particular order.
+     */
+    std::vector<BookPosition> getBookPositions() const;
+
+    /*
+     * Return true if the template has been cached, with at least the given number of guesses requested.
+     */
+    bool contains(std::string_view templateWord, unsigned int requestedNumberGuesses = 0) const;
+
+    /*
+     * Return true if the opening book has the position, with at least the given number of guesses requested.
+     */
+    bool containsSecondGuesses(const BookPosition& position, unsigned int requestedNumberGuesses = 0) const;
+
+    // Methods
+    /*
+     * Return the top guesses cached for a template as well as their trust value.
+     *
+     * Args :
+     * - requestedNumberGuesses : the number of guesses wanted.
+     *                            The number of returned guesses can be lower if there are
+     *                            not enough guesses match the template.
+     * - templateWord : the template word that guesses must match.
+     *
+     * Throws :
+     * - Exception : if the template is not cached, if the number of requested guesses
+     *               has not been cached, or if the cache file is corrupted.
+     */
+    std::vector<std::pair<std::string, double>> getTopGuesses(
+            unsigned int requestedNumberGuesses,
+            std::string_view templateWord) const;
+
+    /*
+     * Return the top guesses cached for a template as well as their trust value,
+     * or nothing if the template or the number of requested guesses is not cached.
+     *
+     * Throws :
+     * - Exception : if the cache file is corrupted.
+     */
+    std::optional<std::vector<std::pair<std::string, double>>> findTopGuesses(
+            unsigned int requestedNumberGuesses,
+            std::string_view templateWord) const;
+
+    /*
+     * Cache the top guesses for a template, replacing any previous record of this template,
+     * and write them to the cache file.
+     *
+     * Args :
+     * - templateWord : the template word that guesses must match.
+     * - requestedNumberGuesses : the number of guesses that were requested.
+     * - topGuesses : the top guesses, as well as their trust values.
+     *
+     * Throws :
+     * - InvalidArgException : if a guess is not in the dictionary.
+     * - Exception : if the cache file cannot be written.
+     */
+    void setTopGuesses(std::string_view templateWord,
+            unsigned int requestedNumberGuesses,
+            const std::vector<std::pair<std::string, double>>& topGuesses);
+
+    /*
+     * Return the second guesses of the opening book for a position, as well as their trust value.
+     *
+     * Args :
+     * - requestedNumberGuesses : the number of guesses wanted.
+     * - position : the first template, guess and hints of the game.
+     *
+     * Throws :
+     * - Exception : if the position is not cached, if the number of requested guesses
+     *               has not been cached, or if the cache file is corrupted.
+     */
+    std::vector<std::pair<std::string, double>> getSecondGuesses(
+            unsigned int requestedNumberGuesses,
+            const BookPosition& position) const;
+
+    /*
+     * Return the second guesses of the opening book for a position, as well as their trust value,
+     * or nothing if the position or the number of requested guesses is not cached.
+     *
+     * Throws :
+     * - Exception : if the cache file is corrupted.
+     */
+    std::optional<std::vector<std::pair<std::string, double>>> findSecondGuesses(
+            unsigned int requestedNumberGuesses,
+            const BookPosition& position) const;
+
+    /*
+     * Cache the second guesses of a position of the opening book, replacing any previous record
+     * of this position, and write them to the cache file.
+     *
+     * Args :
+     * - position : the first template, guess and hints of the game.
+     * - requestedNumberGuesses : the number of guesses that were requested.
+     * - secondGuesses : the second guesses, as well as their trust values.
+     *
+     * Throws :
+     * - InvalidArgException : if a guess is not in the dictionary.
+     * - Exception : if the cache file cannot be written.
+     */
+    void setSecondGuesses(const BookPosition& position,
+            unsigned int requestedNumberGuesses,
+            const std::vector<std::pair<std::string, double>>& secondGuesses);
+
+    /*
+     * Import the guesses of this solver from a text cache.
+     * Guesses not in the dictionary, or with an invalid format are skipped.
+     *
+     * Return the number of imported templates and book positions.
+     *
+     * Throws :
+     * - Exception : if the cache file cannot be written.
+     */
+    size_t importFrom(const CacheConfig& textCache);
+
+    /*
+     * Export all cached guesses and the opening book to a text cache.
+     */
+    void exportTo(CacheConfig& textCache) const;
+
+    /*
+     * Remove all cached guesses, and delete the cache file.
+     */
+    void clear();
+
+    /*
+     * Map the latest version of the cache file, to find the records written by other processes.
+     */
+    void reload();
+
+    /*
+     * Rewrite the cache file without the records which have been replaced, and reload it.
+     * This is done automatically in the background once replaced records take more room than
+     * the others, see waitForCompaction().
+     *
+     * Throws :
+     * - Exception : if the cache file cannot be locked or written.
+     */
+    void compact();
+
+    /*
+     * Wait for the end of the background compaction, if one is running.
+     */
+    void waitForCompaction();
+
+    /*
+     * Write the access time of the records read since the last flush to the cache file.
+     *
+     * Throws :
+     * - Exception : if the cache file cannot be locked or written.
+     */
+    void flushAccessTimes();
+
+    /*
+     * Return the number of bytes of the cache file taken by replaced records.
+     */
+    std::uint64_t getWastedSize() const;
+
+private:
+    // Private methods
+    /*
+     * Map the cache file if it exists and matches the dictionary and solver,
+     * otherwise unmap it.
+     */
+    void open();
+
+    /*
+     * Rewrite the cache file with only the current records, using an index
+     * with the given number of slots (power of 2).
+     * The file is written to a temporary path, and then renamed.
+     * The cache file must be locked.
+     */
+    void rebuild(std::uint64_t indexCapacity);
+
+    /*
+     * Start compacting the cache file in the background, if replaced records take enough room.
+     */
+    void scheduleCompaction();
+
+    /*
+     * Return the offset of the record of the key (template or book position), or 0 if not found.
+     */
+    std::uint64_t findRecord(std::string_view key) const;
+
+    /*
+     * Return the keys of all records.
+     */
+    std::vector<std::string> getKeys() const;
+
+    /*
+     * Return the guesses of the record at the given offset,
+     * or nothing if less guesses than requested were cached.
+     */
+    std::optional<std::vector<std::pair<std::string, double>>> readGuesses(std::uint64_t offset,
+            unsigned int requestedNumberGuesses, const std::string& functionName) const;
+
+    /*
+     * Write the record of a key (template or book position), see setTopGuesses.
+     */
+    void writeGuesses(std::string_view key,
+            unsigned int requestedNumberGuesses,
+            const std::vector<std::pair<std::string, double>>& guesses,
+            const std::string& functionName);
+
+    /*
+     * Import a book section of a text cache, return 1 if imported or 0 if skipped.
+     */
+    size_t importBookSection(const CacheConfig& textCache, const Section& bookSection);
+
+    // Fields
+    std::filesystem::path m_cachePath;
+    std::shared_ptr<const Dictionary> m_dictionary;
+    DictionaryIdentity m_identity;
+    std::string m_solverName;
+    unsigned int m_solverVersion;
+
+    // Mapping of the cache file, empty if there is no valid cache file
+    std::unique_ptr<boost::interprocess::file_mapping> m_file;
+    boost::interprocess::mapped_region m_region;
+    std::uint64_t m_indexOffset;
+    std::uint64_t m_indexCapacity;
+    std::uint64_t m_nbRecords;
+    std::uint64_t m_wastedSize;
+
+    // Keys of the records read since the access times were last written, noted by concurrent lookups
+    mutable std::unordered_set<std::string> m_accessedKeys;
+    mutable std::mutex m_accessedKeysMutex;
+
+    // Background compaction, working on the file only
+    std::thread m_compaction;
+};
+
+/*
+ * Open the binary cache of a solver for a dictionary, stored in the application's cache folder.
+ * If it is empty, the guesses of the solver are imported from the text cache
+ * of the dictionary, if there is a valid one.
+ *
+ * Args :
+ * - dictionaryPath : path to the dictionary file
+ * - dictionary : the loaded dictionary
+ * - solverName : unique identifier of the solver
+ * - solverVersion : version of the solver
+ *
+ * Throws :
+ * - std::runtime_error : if the cache folder cannot be found, see getCachePath().
+ * - Exception : if the dictionary identity cannot be computed.
+ */
+BinaryCache openSolverCache(const std::filesystem::path& dictionaryPath,
+        std::shared_ptr<const Dictionary> dictionary,
+        std::string solverName,
+        unsigned int solverVersion);
+
+/*
+ * Record of a cache file, as seen by the eviction of least recently used records.
+ */
+struct CacheRecordInfo {
+    std::string key;             // template or book position
+    std::uint32_t accessTime{};  // seconds since the epoch of the last lookup or write, 0 if unknown
+    std::uint64_t size{};        // in bytes
+};
+
+/*
+ * Summary of a cache file, whatever its dictionary and solver.
+ */
+struct CacheFileInfo {
+    std::string solverName;
+    unsigned int solverVersion{};
+    DictionaryIdentity identity;
+    std::uint64_t fileSize{};
+    std::uint64_t wastedSize{};         // taken by replaced records
+    std::vector<CacheRecordInfo> records;
+};
+
+/*
+ * Read the summary of a cache file, or nothing if it is not a cache file of the current format.
+ *
+ * Throws :
+ * - Exception : if a record is corrupted.
+ */
+std::optional<CacheFileInfo> readCacheFileInfo(const std::filesystem::path& cachePath);
+
+/*
+ * Rewrite a cache file without its replaced records, nor the records last accessed before
+ * minAccessTime, shrinking its index accordingly. Files which are not valid caches are left untouched.
+ *
+ * Args :
+ * - cachePath : path of the cache file, whatever its dictionary and solver
+ * - minAccessTime : oldest access time kept, in seconds since the epoch (0 keeps all records)
+ *
+ * Throws :
+ * - Exception : if the cache file cannot be locked or written, or if a record is corrupted.
+ */
+void compactCacheFile(const std::filesystem::path& cachePath, std::uint32_t minAccessTime = 0);
+
+/*
+ * Delete a cache file once no other process writes to it.
+ * Return true if the file was deleted.
+ *
+ * Throws :
+ * - Exception : if the cache file cannot be locked.
+ */
+bool removeCacheFile(const std::filesystem::path& cachePath);
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_BINARYCACHE_H_ */
@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: CacheBudget.cpp
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <vector>
+
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/TxtDictionary.h>
+
+#include "BinaryCache.h"
+#include "CacheBudget.h"
+#include "CacheConfig.h"
+#include "Config.h"
+
+namespace Alphadocte {
+
+namespace CLI {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+const std::string BINARY_CACHE_EXTENSION{".bin"};
+
+/*
+ * Binary cache of the folder, and the summary of its records.
+ */
+struct BinaryCacheFile {
+    std::filesystem::path path;
+    CacheFileInfo info;
+};
+
+/*
+ * Delete the binary caches of another format or of an outdated solver version,
+ * compact the others, and return the remaining ones.
+ */
+std::vector<BinaryCacheFile> pruneBinaryCaches(const std::vector<std::filesystem::path>& paths,
+        const std::map<std::string, unsigned int, std::less<>>& solverVersions,
+        CacheBudgetResult& result) {
+    std::vector<BinaryCacheFile> caches;
+
+    for (const auto& path : paths) {
+        std::optional<CacheFileInfo> info;
+        try {
+            info = readCacheFileInfo(path);
+        } catch (const Alphadocte::Exception&) {
+            // corrupted cache, deleted below
+        }
+
+        auto solver = info ? solverVersions.find(info->solverName) : solverVersions.end();
+        if (!info || (solver != solverVersions.end() && solver->second != info->solverVersion)) {
+            if (removeCacheFile(path))
+                result.nbRemovedFiles++;
+            continue;
+        }
+
+        if (info->wastedSize > 0) {
+            compactCacheFile(path);
+            info = readCacheFileInfo(path);
+        }
+
+        if (info)
+            caches.push_back(BinaryCacheFile{path, std::move(*info)});
+    }
+
+    return caches;
+}
+
+/*
+ * Check whether a text cache is outdated, ie its dictionary can be loaded and its words changed.
+ * The dictionary is only loaded when its file was touched. A cache whose dictionary cannot be
+ * loaded (eg a cache folder copied from another host, or a moved dictionary) is not outdated.
+ */
+bool isTextCacheOutdated(const Config& config) {
+    try {
+        CacheConfig{config};
+        return false;
+    } catch (const Alphadocte::InvalidArgException&) {
+        // touched or missing dictionary file
+    }
+
+    const Entry* pathEntry = findEntry(config.getRootSection(), CacheConfig::ENTRY_FILE_PATH);
+    TxtDictionary dictionary{pathEntry->value};
+    if (!dictionary.load())
+        return false;
+
+    try {
+        CacheConfig{config, &dictionary};
+        return false;
+    } catch (const Alphadocte::InvalidArgException&) {
+        return true;
+    }
+}
+
+/*
+ * Remove the outdated solver sections of the text caches, and delete the caches of changed dictionaries.
+ * Other files are left untouched.
+ */
+void pruneTextCaches(const std::vector<std::filesystem::path>& paths,
+        const std::map<std::string, unsigned int, std::less<>>& solverVersions,
+        CacheBudgetResult& result) {
+    for (const auto& path : paths) {
+        Config config;
+        try {
+            config.loadFromFile(path);
+        } catch (const Alphadocte::Exception&) {
+            // not a text cache
+            continue;
+        }
+
+        if (!findEntry(config.getRootSection(), CacheConfig::ENTRY_FILE_PATH))
+            continue;
+
+        if (isTextCacheOutdated(config)) {
+            // the cache would be overwritten on the next export
+            std::error_code error;
+            if (std::filesystem::remove(path, error))
+                result.nbRemovedFiles++;
+            continue;
+        }
+
+        auto nbRemoved = CacheConfig::removeOutdatedSolvers(config, solverVersions);
+        if (nbRemoved > 0) {
+            config.writeToFile(path);
+            result.nbRemovedSections += nbRemoved;
+        }
+    }
+}
+
+/*
+ * Evict the least recently used records of the binary caches, until the folder is under the budget.
+ * Records are evicted by access time, so that records used at the same time stay together.
+ */
+void evictRecords(const std::vector<BinaryCacheFile>& caches, std::uint64_t excessSize, CacheBudgetResult& result) {
+    std::vector<const CacheRecordInfo*> records;
+    for (const auto& cache : caches) {
+        for (const auto& record : cache.info.records)
+            records.push_back(&record);
+    }
+
+    std::sort(std::begin(records), std::end(records), [](const auto* lhs, const auto* rhs) {
+        return lhs->accessTime < rhs->accessTime;
+    });
+
+    // Find the last access time to evict
+    std::uint64_t freedSize{};
+    std::optional<std::uint32_t> lastEvictedTime;
+    for (const auto* record : records) {
+        if (freedSize >= excessSize && (!lastEvictedTime || record->accessTime != *lastEvictedTime))
+            break;
+
+        freedSize += record->size;
+        lastEvictedTime = record->accessTime;
+        result.nbEvictedRecords++;
+    }
+
+    if (!lastEvictedTime)
+        return;
+
+    for (const auto& cache : caches) {
+        bool hasEvictedRecords = std::any_of(std::begin(cache.info.records), std::end(cache.info.records),
+                [&lastEvictedTime](const auto& record) { return record.accessTime <= *lastEvictedTime; });
+        if (hasEvictedRecords)
+            compactCacheFile(cache.path, *lastEvictedTime + 1);
+    }
+}
+
+}
+
+std::optional<std::uint64_t> parseCacheSize(std::string_view size) {
+    std::uint64_t value{};
+    auto [end, error] = std::from_chars(size.data(), size.data() + std::size(size), value);
+    if (error != std::errc{} || end == size.data())
+        return std::nullopt;
+
+    std::string_view suffix{end, static_cast<size_t>(size.data() + std::size(size) - end)};
+    unsigned int shift{};
+    if (suffix == "K" || suffix == "k")
+        shift = 10;
+    else if (suffix == "M" || suffix == "m")
+        shift = 20;
+    else if (suffix == "G" || suffix == "g")
+        shift = 30;
+    else if (!suffix.empty())
+        return std::nullopt;
+
+    if (value > (UINT64_MAX >> shift))
+        return std::nullopt;
+
+    return value << shift;
+}
+
+std::optional<std::uint64_t> getCacheBudget() {
+    const char* envValue = std::getenv(CACHE_BUDGET_ENV_VAR.c_str());
+    if (!envValue || *envValue == '\0')
+        return std::nullopt;
+
+    auto budget = parseCacheSize(envValue);
+    if (!budget) {
+        throw Alphadocte::InvalidArgException("Invalid cache budget " + std::string(envValue) + " in " + CACHE_BUDGET_ENV_VAR
+                + ", expected a size such as 200M.", "Alphadocte::CLI::getCacheBudget()");
+    }
+
+    return budget;
+}
+
+std::uint64_t getFolderSize(const std::filesystem::path& folder) {
+    std::uint64_t size{};
+    std::error_code error;
+
+    for (const auto& entry : std::filesystem::directory_iterator{folder, error}) {
+        std::error_code fileError;
+        if (entry.is_regular_file(fileError)) {
+            auto fileSize = entry.file_size(fileError);
+            if (!fileError)
+                size += fileSize;
+        }
+    }
+
+    return size;
+}
+
+CacheBudgetResult compactCacheFolder(const std::filesystem::path& cacheFolder,
+        const std::map<std::string, unsigned int, std::less<>>& solverVersions,
+        std::optional<std::uint64_t> maxSize) {
+    CacheBudgetResult result;
+    result.sizeBefore = getFolderSize(cacheFolder);
+
+    // Text caches are named after their dictionary, without extension (see getTextCachePath())
+    std::vector<std::filesystem::path> binaryPaths;
+    std::vector<std::filesystem::path> textPaths;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator{cacheFolder, error}) {
+        std::error_code fileError;
+        if (!entry.is_regular_file(fileError))
+            continue;
+
+        if (entry.path().extension() == BINARY_CACHE_EXTENSION)
+            binaryPaths.push_back(entry.path());
+        else if (!entry.path().has_extension())
+            textPaths.push_back(entry.path());
+    }
+
+    auto caches = pruneBinaryCaches(binaryPaths, solverVersions, result);
+    pruneTextCaches(textPaths, solverVersions, result);
+
+    auto size = getFolderSize(cacheFolder);
+    if (maxSize && size > *maxSize)
+        evictRecords(caches, size - *maxSize, result);
+
+    result.sizeAfter = getFolderSize(cacheFolder);
+    return result;
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: CacheBudget.h
+ */
+
+#ifndef APPS_CACHEBUDGET_H_
+#define APPS_CACHEBUDGET_H_
+
+/*
+ * Private header keeping the cache folder under a size budget.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Alphadocte {
+
+namespace CLI {
+
+// Environment variable holding the size budget of the cache folder, eg "200M"
+inline const std::string CACHE_BUDGET_ENV_VAR{"ALPHADOCTE_CACHE_BUDGET"};
+
+/*
+ * Results of a compaction of the cache folder.
+ */
+struct CacheBudgetResult {
+    size_t nbRemovedFiles{};    // binary caches of outdated solvers or formats, text caches of changed dictionaries
+    size_t nbRemovedSections{}; // sections of outdated solvers in the text caches
+    size_t nbEvictedRecords{};  // least recently used templates and book positions of the binary caches
+    std::uint64_t sizeBefore{}; // size of the cache folder, in bytes
+    std::uint64_t sizeAfter{};
+};
+
+/*
+ * Parse a size in bytes, with an optional K, M or G suffix (powers of 1024), eg "512K".
+ * Return nothing if the size is invalid.
+ */
+std::optional<std::uint64_t> parseCacheSize(std::string_view size);
+
+/*
+ * Return the size budget of the cache folder set by CACHE_BUDGET_ENV_VAR, or nothing if there is none.
+ *
+ * Throws :
+ * - InvalidArgException : if the variable is set, but is not a valid size (see parseCacheSize).
+ */
+std::optional<std::uint64_t> getCacheBudget();
+
+/*
+ * Return the total size of the files of a folder (not recursive), in bytes.
+ */
+std::uint64_t getFolderSize(const std::filesystem::path& folder);
+
+/*
+ * Compact the cache folder :
+ * - binary caches of another format, or of an outdated solver version, are deleted,
+ *   the others are rewritten without their replaced records,
+ * - sections of outdated solver versions are removed from the text caches,
+ *   and text caches of dictionaries whose words changed are deleted,
+ * - then, if the folder is still larger than the budget, the least recently used templates
+ *   and book positions of all binary caches are evicted until it fits.
+ *
+ * Caches of solvers missing from solverVersions are kept, they may belong to another version
+ * of the application sharing the folder.
+ *
+ * Args :
+ * - cacheFolder : the cache folder, see getCachePath()
+ * - solverVersions : current version of each solver, by solver name (see getSolverVersions())
+ * - maxSize : size budget of the folder, in bytes, or nothing for no eviction
+ *
+ * Throws :
+ * - Exception : if a cache file cannot be locked or written.
+ */
+CacheBudgetResult compactCacheFolder(const std::filesystem::path& cacheFolder,
+        const std::map<std::string, unsigned int, std::less<>>& solverVersions,
+        std::optional<std::uint64_t> maxSize);
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_CACHEBUDGET_H_ */
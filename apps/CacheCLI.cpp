@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: CacheCLI.cpp
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+#include <Alphadocte/Alphadocte.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Solver.h>
+#include <Alphadocte/TxtDictionary.h>
+
+#include "BinaryCache.h"
+#include "Autotuner.h"
+#include "CacheBudget.h"
+#include "CacheConfig.h"
+#include "CacheWarmer.h"
+#include "CommandLine.h"
+#include "Common.h"
+#include "Config.h"
+#include "TuningProfile.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+static const std::string DEFAULT_DICTIONARY = "FR";
+static const std::string DEFAULT_SOLVER     = "entropy_maximizer";
+
+void printUsage(std::string_view programName);
+void printInfo(const BinaryCache& cache);
+void pruneCacheFolder(std::optional<std::uint64_t> maxSize);
+void tuneMachine(std::shared_ptr<Dictionary> dictionary, const AutotuneOptions& options);
+CacheConfig loadTextCache(const std::filesystem::path& dictionaryPath, const Dictionary& dictionary,
+        const std::filesystem::path& textCachePath);
+
+int main(int argc, char* argv[]) {
+    try {
+        CommandLine args{argc, argv};
+        args.checkOptions({"help", "dictionary", "solver", "input", "output", "guesses", "threads", "no-wordle", "max-size", "max-candidates"});
+
+        if (args.has("help")) {
+            printUsage(args.getProgramName());
+            return 0;
+        }
+
+        const auto& positional = args.getPositionalArguments();
+        if (std::size(positional) != 1) {
+            throw InvalidArgException("Expected exactly one command.", "main(int, char*[])");
+        }
+        const std::string& command = positional.front();
+        if (command != "info" && command != "import" && command != "export" && command != "compact" && command != "warm"
+                && command != "book" && command != "prune" && command != "tune") {
+            throw InvalidArgException("Unknown command " + command + ", expected info, import, export, compact, warm, book, prune or tune.", "main(int, char*[])");
+        }
+
+        // the solvers use the tuning chosen for this machine, see the tune command
+        loadTuning();
+
+        // the budget option overrides the environment
+        std::optional<std::uint64_t> maxSize = getCacheBudget();
+        if (args.has("max-size")) {
+            maxSize = parseCacheSize(args.getString("max-size"));
+            if (!maxSize)
+                throw InvalidArgException("Invalid cache size " + args.getString("max-size") + ", expected a size such as 200M.", "main(int, char*[])");
+        }
+
+        // pruning works on the whole cache folder, whatever the dictionary
+        if (command == "prune") {
+            pruneCacheFolder(maxSize);
+            return 0;
+        }
+
+        auto dictionaryPath = findDictionary(args.getString("dictionary", DEFAULT_DICTIONARY));
+        if (dictionaryPath.empty()) {
+            std::cerr << "Dictionnaire introuvable : " << args.getString("dictionary", DEFAULT_DICTIONARY) << std::endl;
+            return 1;
+        }
+
+        auto dictionary = std::make_shared<TxtDictionary>(dictionaryPath);
+        if (!dictionary->load()) {
+            std::cerr << "Impossible de charger le dictionnaire " << dictionaryPath.string() << std::endl;
+            return 1;
+        }
+
+        // tuning measures the solvers on the dictionary, without any cache
+        if (command == "tune") {
+            AutotuneOptions options;
+            options.maxThreads = static_cast<unsigned int>(args.getUnsigned("threads", 0));
+            options.maxCandidates = args.getUnsigned("max-candidates", options.maxCandidates);
+            options.withWordle = !args.has("no-wordle");
+            tuneMachine(dictionary, options);
+            return 0;
+        }
+
+        // the solver is only created to know its version
+        auto solver = createSolver(args.getString("solver", DEFAULT_SOLVER), createRules(RulesType::MOTUS, dictionary));
+        auto identity = DictionaryIdentity::compute(dictionaryPath, *dictionary);
+        BinaryCache cache{getBinaryCachePath(dictionaryPath, solver->getSolverName()), dictionary,
+                std::move(identity), std::string(solver->getSolverName()), solver->getSolverVersion()};
+
+        if (command == "info") {
+            printInfo(cache);
+        } else if (command == "import") {
+            std::filesystem::path input = args.getString("input", getTextCachePath(dictionaryPath).string());
+            Config config;
+            config.loadFromFile(input);
+            auto nbImported = cache.importFrom(CacheConfig{std::move(config), dictionary.get()});
+            std::cout << nbImported << " entrée(s) importée(s) depuis " << input.string() << std::endl;
+        } else if (command == "warm" || command == "book") {
+            WarmupOptions options;
+            options.solverName = args.getString("solver", DEFAULT_SOLVER);
+            options.nbGuesses = static_cast<unsigned int>(args.getUnsigned("guesses", options.nbGuesses));
+            options.nbThreads = static_cast<unsigned int>(args.getUnsigned("threads", 0));
+            options.withWordle = !args.has("no-wordle");
+
+            if (options.nbGuesses == 0)
+                throw InvalidArgException("The number of guesses must be positive.", "main(int, char*[])");
+
+            auto printProgress = [](std::string_view key, std::string_view bestGuess, size_t nbDone, size_t nbToCompute) {
+                std::cout << "[" << nbDone << "/" << nbToCompute << "] " << key << " : " << bestGuess << std::endl;
+            };
+
+            // the opening book starts from the first guesses, compute them first
+            auto result = warmCache(cache, dictionary, options, printProgress);
+            std::cout << result.nbComputed << " modèle(s) calculé(s), " << result.nbCached << " déjà en cache, en "
+                      << result.wallDuration << " s avec " << result.nbThreads << " thread(s)" << std::endl;
+
+            if (command == "book") {
+                result = warmOpeningBook(cache, dictionary, options, printProgress);
+                std::cout << result.nbComputed << " position(s) d'ouverture calculée(s), " << result.nbCached << " déjà en cache, en "
+                          << result.wallDuration << " s avec " << result.nbThreads << " thread(s)" << std::endl;
+            }
+
+            // keep the folder under its budget, the records just computed are the most recently used
+            if (maxSize) {
+                cache.flushAccessTimes();
+                pruneCacheFolder(maxSize);
+            }
+        } else if (command == "compact") {
+            auto wastedSize = cache.getWastedSize();
+            cache.compact();
+            std::cout << wastedSize << " octet(s) libéré(s)" << std::endl;
+        } else {
+            // keep the entries of other solvers when exporting to an existing text cache
+            std::filesystem::path output = args.getString("output", getTextCachePath(dictionaryPath).string());
+            CacheConfig textCache = loadTextCache(dictionaryPath, *dictionary, output);
+            cache.exportTo(textCache);
+            textCache.getConfig().writeToFile(output);
+            std::cout << cache.size() << " entrée(s) exportée(s) vers " << output.string() << std::endl;
+        }
+    } catch (const Exception& e) {
+        std::cerr << "Erreur : " << e.what() << std::endl;
+        std::cerr << "Voir --help pour l'utilisation." << std::endl;
+        return 1;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Erreur : " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+void printUsage(std::string_view programName) {
+    std::cout << "Alphadocte v" << ALPHADOCTE_VERSION_NAME << " : gestion du cache des premiers mots." << std::endl;
+    std::cout << std::endl;
+    std::cout << "Utilisation : " << programName << " COMMANDE [options]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Commandes :" << std::endl;
+    std::cout << "  info                 afficher le contenu du cache binaire" << std::endl;
+    std::cout << "  import               importer un cache texte dans le cache binaire" << std::endl;
+    std::cout << "  export               exporter le cache binaire au format texte" << std::endl;
+    std::cout << "  compact              supprimer du cache binaire les résultats remplacés" << std::endl;
+    std::cout << "  warm                 calculer les premiers mots de tous les modèles du dictionnaire" << std::endl;
+    std::cout << "                       qui ne sont pas encore en cache" << std::endl;
+    std::cout << "  book                 comme warm, puis calculer les deuxièmes mots pour chaque indice" << std::endl;
+    std::cout << "                       possible du premier mot (livre d'ouverture)" << std::endl;
+    std::cout << "  prune                supprimer du dossier de cache les caches obsolètes, puis, au-delà" << std::endl;
+    std::cout << "                       de la taille maximale, les résultats les moins récemment utilisés" << std::endl;
+    std::cout << "  tune                 mesurer les variantes du solver sur quelques modèles du dictionnaire et" << std::endl;
+    std::cout << "                       écrire les plus rapides dans le profil de réglage du dossier de cache," << std::endl;
+    std::cout << "                       utilisé au démarrage par les exécutables (" << TUNING_ENV_VAR << " pour le remplacer," << std::endl;
+    std::cout << "                       par exemple histogram=dense,threads=4,min-parallel=100000, ou none)" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options :" << std::endl;
+    std::cout << "  --dictionary=NOM     nom (FR, EN) ou chemin du dictionnaire (FR par défaut)" << std::endl;
+    std::cout << "  --solver=NOM         solver dont les résultats sont en cache (entropy_maximizer par défaut)" << std::endl;
+    std::cout << "  --input=CHEMIN       cache texte à importer (cache texte du dictionnaire par défaut)" << std::endl;
+    std::cout << "  --output=CHEMIN      cache texte à écrire (cache texte du dictionnaire par défaut)" << std::endl;
+    std::cout << "  --guesses=N          nombre de premiers mots calculés par modèle (10 par défaut, warm et book)" << std::endl;
+    std::cout << "  --threads=N          nombre de threads (un par cœur par défaut, warm et book," << std::endl;
+    std::cout << "                       nombre maximal de threads mesurés par tune)" << std::endl;
+    std::cout << "  --no-wordle          ne pas calculer le modèle de Wordle (warm, book et tune)" << std::endl;
+    std::cout << "  --max-candidates=N   nombre maximal de mots des modèles mesurés (2000 par défaut, tune)" << std::endl;
+    std::cout << "  --max-size=TAILLE    taille maximale du dossier de cache, par exemple 200M (prune, warm et book," << std::endl;
+    std::cout << "                       " << CACHE_BUDGET_ENV_VAR << " par défaut, sans limite sinon)" << std::endl;
+}
+
+void printInfo(const BinaryCache& cache) {
+    const auto& identity = cache.getDictionaryIdentity();
+    std::cout << "Cache : " << cache.getCachePath().string() << std::endl;
+    std::cout << "Dictionnaire : " << identity.path << " (" << identity.nbWords << " mots)" << std::endl;
+    std::cout << "Solver : " << cache.getSolverName() << " v" << cache.getSolverVersion() << std::endl;
+    std::cout << "Modèles en cache : " << std::size(cache.getTemplates()) << std::endl;
+    std::cout << "Positions du livre d'ouverture : " << std::size(cache.getBookPositions()) << std::endl;
+    std::cout << "Résultats remplacés : " << cache.getWastedSize() << " octets" << std::endl;
+
+    std::error_code error;
+    auto fileSize = std::filesystem::file_size(cache.getCachePath(), error);
+    if (!error)
+        std::cout << "Taille du fichier : " << fileSize << " octets" << std::endl;
+}
+
+void pruneCacheFolder(std::optional<std::uint64_t> maxSize) {
+    auto cacheFolder = getCachePath();
+    if (cacheFolder.empty())
+        throw std::runtime_error("Dossier de cache introuvable.");
+
+    auto result = compactCacheFolder(cacheFolder, getSolverVersions(), maxSize);
+    std::cout << result.nbRemovedFiles << " cache(s) obsolète(s) supprimé(s), " << result.nbRemovedSections
+              << " section(s) de solver obsolète(s) supprimée(s), " << result.nbEvictedRecords
+              << " résultat(s) évincé(s)" << std::endl;
+    std::cout << "Taille du dossier de cache : " << result.sizeBefore << " -> " << result.sizeAfter << " octets" << std::endl;
+}
+
+void tuneMachine(std::shared_ptr<Dictionary> dictionary, const AutotuneOptions& options) {
+    auto profile = autotune(dictionary, options, [](const TuningMeasure& measure, size_t nbDone, size_t nbToMeasure) {
+        std::cout << "[" << nbDone << "/" << nbToMeasure << "] " << measure.templateWord << " (" << measure.rules << ", "
+                  << measure.nbPatterns << " indices) : " << getHistogramName(measure.histogram) << ", "
+                  << measure.nbThreads << " thread(s) : " << measure.duration << " s" << std::endl;
+    });
+
+    auto tuningPath = getTuningPath();
+    writeTuningProfile(profile, tuningPath);
+
+    std::cout << "Réglage choisi : histogramme " << getHistogramName(profile.tuning.histogram) << ", "
+              << profile.tuning.nbThreads << " thread(s) à partir de " << profile.tuning.minParallelPatterns << " indices" << std::endl;
+    std::cout << "Profil écrit dans " << tuningPath.string() << std::endl;
+}
+
+CacheConfig loadTextCache(const std::filesystem::path& dictionaryPath, const Dictionary& dictionary,
+        const std::filesystem::path& textCachePath) {
+    std::error_code error;
+    if (std::filesystem::is_regular_file(textCachePath, error)) {
+        try {
+            Config config;
+            config.loadFromFile(textCachePath);
+            return CacheConfig{std::move(config), &dictionary};
+        } catch (const Exception&) {
+            // invalid or outdated text cache, overwrite it
+        }
+    }
+
+    return CacheConfig{dictionaryPath, dictionary};
+}
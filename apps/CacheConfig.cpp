@@ -20,20 +20,57 @@
  */
 
 #include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <system_error>
+#include <utility>
 
 #include "CacheConfig.h"
+#include "Common.h"
 #include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Dictionary.h>
 
 namespace Alphadocte {
 
 namespace CLI {
 
-CacheConfig::CacheConfig(std::filesystem::path dictionaryPath)
+std::string BookPosition::toString() const {
+    return templateWord + ' ' + firstGuess + ' ' + formatHints(hints);
+}
+
+BookPosition BookPosition::parse(std::string_view position) {
+    auto firstSpace = position.find(' ');
+    auto secondSpace = firstSpace == position.npos ? position.npos : position.find(' ', firstSpace + 1);
+    if (secondSpace == position.npos) {
+        throw Alphadocte::InvalidArgException("Book position must contain a template, a guess and hints separated by spaces.",
+                "Alphadocte::CLI::BookPosition::parse(std::string_view)");
+    }
+
+    BookPosition parsed;
+    parsed.templateWord = position.substr(0, firstSpace);
+    parsed.firstGuess = position.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+    parsed.hints = parseHints(position.substr(secondSpace + 1));
+
+    if (std::size(parsed.firstGuess) != std::size(parsed.templateWord) || std::size(parsed.hints) != std::size(parsed.templateWord)) {
+        throw Alphadocte::InvalidArgException("Book position template, guess and hints must have the same length.",
+                "Alphadocte::CLI::BookPosition::parse(std::string_view)");
+    }
+
+    return parsed;
+}
+
+bool operator==(const BookPosition& lhs, const BookPosition& rhs) {
+    return lhs.templateWord == rhs.templateWord && lhs.firstGuess == rhs.firstGuess && lhs.hints == rhs.hints;
+}
+
+CacheConfig::CacheConfig(std::filesystem::path dictionaryPath, const Dictionary& dictionary)
          : m_config{} {
     std::error_code error;
     if (!std::filesystem::is_regular_file(dictionaryPath, error) || error) {
         throw Alphadocte::Exception("Dictionary at " + dictionaryPath.string() + " is not a file.",
-                "Alphadocte::CLI::CacheConfig::CacheConfig(std::filesystem::path)");
+                "Alphadocte::CLI::CacheConfig::CacheConfig(std::filesystem::path, const Alphadocte::Dictionary&)");
     }
 
     auto& root = m_config.getRootSection();
@@ -42,17 +79,18 @@ CacheConfig::CacheConfig(std::filesystem::path dictionaryPath)
 
     if (error) {
         throw Alphadocte::Exception("Could not read last write time of dictionary at " + dictionaryPath.string(),
-                "Alphadocte::CLI::CacheConfig::CacheConfig(std::filesystem::path)");
+                "Alphadocte::CLI::CacheConfig::CacheConfig(std::filesystem::path, const Alphadocte::Dictionary&)");
     }
     root.entries.emplace_back(Entry{ENTRY_FILE_TIMESTAMP, std::to_string(timestamp.time_since_epoch().count())});
+    root.entries.emplace_back(Entry{ENTRY_FILE_HASH, std::to_string(dictionary.getContentHash())});
 }
 
-CacheConfig::CacheConfig(Config config)
+CacheConfig::CacheConfig(Config config, const Dictionary* dictionary)
         : m_config{std::move(config)} {
 
-    if (!isCacheValid()) {
+    if (!isCacheValid(dictionary)) {
         throw Alphadocte::InvalidArgException("Invalid configuration supplied as cache.",
-                "Alphadocte::CLI::CacheConfig::CacheConfig(Alphadocte::CLI:Config)");
+                "Alphadocte::CLI::CacheConfig::CacheConfig(Alphadocte::CLI::Config, const Alphadocte::Dictionary*)");
     }
 }
 
@@ -60,155 +98,207 @@ const Config& CacheConfig::getConfig() const {
     return m_config;
 }
 
-void CacheConfig::setConfig(Config config) {
+void CacheConfig::setConfig(Config config, const Dictionary* dictionary) {
     std::swap(m_config, config);
 
-    if (!isCacheValid()) {
+    if (!isCacheValid(dictionary)) {
         std::swap(m_config, config);
         throw Alphadocte::InvalidArgException("Invalid configuration supplied as cache.",
-                "Alphadocte::CLI::CacheConfig::setConfig(Alphadocte::CLI::Config config)");
+                "Alphadocte::CLI::CacheConfig::setConfig(Alphadocte::CLI::Config, const Alphadocte::Dictionary*)");
     }
 }
 
+size_t CacheConfig::getRetainedBytes() const {
+    return m_config.getRetainedBytes();
+}
+
 std::filesystem::path CacheConfig::getDictionaryPath() const {
-    auto it = std::find_if(
-            std::cbegin(m_config.getRootSection().entries),
-            std::cend(m_config.getRootSection().entries),
-            [](const auto& entry){ return entry.name == ENTRY_FILE_PATH; });
+    std::string reason;
+    if (auto dictPath = findDictionaryPath(&reason))
+        return *dictPath;
 
-    if (it == std::cend(m_config.getRootSection().entries)) {
-        throw Alphadocte::Exception("Missing entry " + ENTRY_FILE_PATH,
-                "Alphadocte::CLI::CacheConfig::getDictionaryPath()");
+    throw Alphadocte::Exception(reason, "Alphadocte::CLI::CacheConfig::getDictionaryPath()");
+}
+
+std::optional<std::filesystem::path> CacheConfig::findDictionaryPath(std::string* reason) const {
+    const Entry* entry = findEntry(m_config.getRootSection(), ENTRY_FILE_PATH);
+
+    if (!entry) {
+        if (reason)
+            *reason = "Missing entry " + ENTRY_FILE_PATH;
+        return std::nullopt;
     }
 
-    std::filesystem::path dictPath{it->value};
+    std::filesystem::path dictPath{entry->value};
 
     if (!dictPath.is_absolute()) {
-        throw Alphadocte::Exception("Value of " + ENTRY_FILE_PATH + " is not an absolute path.",
-                "Alphadocte::CLI::CacheConfig::getDictionaryPath()");
+        if (reason)
+            *reason = "Value of " + ENTRY_FILE_PATH + " is not an absolute path.";
+        return std::nullopt;
     }
 
     return dictPath;
 }
 
 std::filesystem::file_time_type CacheConfig::getDictionaryTimestamp() const {
-    auto it = std::find_if(
-            std::cbegin(m_config.getRootSection().entries),
-            std::cend(m_config.getRootSection().entries),
-            [](const auto& entry){ return entry.name == ENTRY_FILE_TIMESTAMP; });
+    std::string reason;
+    if (auto timestamp = findDictionaryTimestamp(&reason))
+        return *timestamp;
 
-    if (it == std::cend(m_config.getRootSection().entries)) {
-        throw Alphadocte::Exception("Missing entry " + ENTRY_FILE_TIMESTAMP,
-                "Alphadocte::CLI::CacheConfig::getDictionaryTimestamp()");
+    throw Alphadocte::Exception(reason, "Alphadocte::CLI::CacheConfig::getDictionaryTimestamp()");
+}
+
+std::optional<std::filesystem::file_time_type> CacheConfig::findDictionaryTimestamp(std::string* reason) const {
+    const Entry* entry = findEntry(m_config.getRootSection(), ENTRY_FILE_TIMESTAMP);
+
+    if (!entry) {
+        if (reason)
+            *reason = "Missing entry " + ENTRY_FILE_TIMESTAMP;
+        return std::nullopt;
     }
 
-    std::istringstream timeIss{it->value};
+    std::istringstream timeIss{entry->value};
     std::filesystem::file_time_type::rep timeClock;
     timeIss >> timeClock;
 
     if (timeIss.fail()) {
-        throw Exception("Value of " + ENTRY_FILE_TIMESTAMP + " is not a valid timestamp.",
-                "Alphadocte::CLI::CacheConfig::getDictionaryTimestamp()");
+        if (reason)
+            *reason = "Value of " + ENTRY_FILE_TIMESTAMP + " is not a valid timestamp.";
+        return std::nullopt;
     }
 
     return std::filesystem::file_time_type{std::filesystem::file_time_type::duration{timeClock}};
 }
 
+std::uint64_t CacheConfig::getDictionaryHash() const {
+    std::string reason;
+    if (auto hash = findDictionaryHash(&reason))
+        return *hash;
+
+    throw Alphadocte::Exception(reason, "Alphadocte::CLI::CacheConfig::getDictionaryHash()");
+}
+
+std::optional<std::uint64_t> CacheConfig::findDictionaryHash(std::string* reason) const {
+    const Entry* entry = findEntry(m_config.getRootSection(), ENTRY_FILE_HASH);
+
+    if (!entry) {
+        if (reason)
+            *reason = "Missing entry " + ENTRY_FILE_HASH;
+        return std::nullopt;
+    }
+
+    std::istringstream hashIss{entry->value};
+    std::uint64_t hash;
+    hashIss >> hash;
+
+    if (hashIss.fail() || hash == 0) {
+        if (reason)
+            *reason = "Value of " + ENTRY_FILE_HASH + " is not a valid hash.";
+        return std::nullopt;
+    }
+
+    return hash;
+}
+
 namespace {
 
 // keep helper functions local to this translation unit
 
 /*
  * Check if the given solver section is correct.
+ * Messages are only built when a reason is asked, a miss is not an error.
  *
- * Throws:
- * - Alphadocte::Exception if the section is incorrect
+ * Return false, and set the reason if not nullptr, if the section is incorrect.
  */
-void check_solver_section(const Section& solverSection, std::string_view solverName, unsigned int solverVersion, const std::string& functionName) {
-    auto solverVersionIt = std::find_if(
-            std::cbegin(solverSection.entries),
-            std::cend(solverSection.entries),
-            [](const auto& e) { return e.name == CacheConfig::ENTRY_SOLVER_VERSION; }
-    );
+bool check_solver_section(const Section& solverSection, std::string_view solverName, unsigned int solverVersion, std::string* reason) {
+    const Entry* solverVersionEntry = findEntry(solverSection, CacheConfig::ENTRY_SOLVER_VERSION);
 
-    if (solverVersionIt == std::cend(solverSection.entries)) {
-        throw Alphadocte::Exception("Missing entry " + CacheConfig::ENTRY_SOLVER_VERSION + " in section solver " + std::string(solverName) + '.', functionName);
+    if (!solverVersionEntry) {
+        if (reason)
+            *reason = "Missing entry " + CacheConfig::ENTRY_SOLVER_VERSION + " in section solver " + std::string(solverName) + '.';
+        return false;
     }
 
     unsigned long solverVersionParsed{};
-    try {
-        solverVersionParsed = std::stoul(solverVersionIt->value);
-    } catch (const std::exception& e) {
-        throw Alphadocte::Exception("Invalid value for entry " + CacheConfig::ENTRY_SOLVER_VERSION + " : " + solverVersionIt->value + " is not a positive integer.", functionName);
+    auto [end, error] = std::from_chars(solverVersionEntry->value.data(),
+            solverVersionEntry->value.data() + std::size(solverVersionEntry->value), solverVersionParsed);
+
+    if (error != std::errc{} || end == solverVersionEntry->value.data()) {
+        if (reason)
+            *reason = "Invalid value for entry " + CacheConfig::ENTRY_SOLVER_VERSION + " : " + solverVersionEntry->value + " is not a positive integer.";
+        return false;
     }
 
     if (solverVersionParsed != solverVersion) {
-        throw Alphadocte::Exception("Actual solver version is different from entry's " + CacheConfig::ENTRY_SOLVER_VERSION + " : got "
-                + std::to_string(solverVersionParsed) + ", expected " + std::to_string(solverVersion) + '.', functionName);
+        if (reason)
+            *reason = "Actual solver version is different from entry's " + CacheConfig::ENTRY_SOLVER_VERSION + " : got "
+                + std::to_string(solverVersionParsed) + ", expected " + std::to_string(solverVersion) + '.';
+        return false;
     }
-}
 
+    return true;
 }
 
-std::vector<std::pair<std::string, double>> CacheConfig::getTopGuesses(
-        std::string_view solverName,
-        unsigned int solverVersion,
-        unsigned int requestedNumberGuesses,
-        std::string_view templateWord) const {
-
-    std::vector<std::pair<std::string, double>> guesses;
-    const auto& solverSection = getSolverSection(solverName);
-    check_solver_section(solverSection, solverName, solverVersion,
-            "Alphadocte::CLI::CacheConfig::getTopGuesses(std::string_view, unsigned int, unsigned int, std::string_view) const");
-
-    const auto& guessSection = getGuessSection(solverSection, templateWord);
-    auto guessNumberIt = std::find_if(
-            std::cbegin(guessSection.entries),
-            std::cend(guessSection.entries),
-            [](const auto& e) { return e.name == ENTRY_GUESS_NUMBER; }
-    );
-
-    if (guessNumberIt == std::cend(guessSection.entries)) {
-        throw Alphadocte::Exception("Missing entry " + ENTRY_GUESS_NUMBER + " in section guess with template " + std::string(templateWord),
-                "Alphadocte::CLI::CacheConfig::getTopGuesses(std::string_view, unsigned int, unsigned int, std::string_view) const");
+/*
+ * Parse the guesses of a guess or book section.
+ *
+ * Return nothing, and set the reason if not nullptr, if the section is incorrect,
+ * or has less guesses than requested.
+ */
+std::optional<std::vector<std::pair<std::string, double>>> parse_guesses(const Section& section, unsigned int requestedNumberGuesses,
+        std::string_view templateWord, std::string_view sectionDescription, std::string* reason) {
+    const Entry* guessNumberEntry = findEntry(section, CacheConfig::ENTRY_GUESS_NUMBER);
+
+    if (!guessNumberEntry) {
+        if (reason)
+            *reason = "Missing entry " + CacheConfig::ENTRY_GUESS_NUMBER + " in " + std::string(sectionDescription);
+        return std::nullopt;
     }
+
     unsigned long guessNumberParsed{};
-    try {
-        guessNumberParsed = std::stoul(guessNumberIt->value);
-    } catch (const std::exception& e) {
-        throw Alphadocte::Exception("Invalid value for entry " + ENTRY_GUESS_NUMBER + " : " + guessNumberIt->value + " is not a positive integer.",
-                "Alphadocte::CLI::CacheConfig::getTopGuesses(std::string_view, unsigned int, unsigned int, std::string_view) const");
+    auto [end, error] = std::from_chars(guessNumberEntry->value.data(),
+            guessNumberEntry->value.data() + std::size(guessNumberEntry->value), guessNumberParsed);
+
+    if (error != std::errc{} || end == guessNumberEntry->value.data()) {
+        if (reason)
+            *reason = "Invalid value for entry " + CacheConfig::ENTRY_GUESS_NUMBER + " : " + guessNumberEntry->value + " is not a positive integer.";
+        return std::nullopt;
     }
 
     if (guessNumberParsed < requestedNumberGuesses) {
-        throw Alphadocte::Exception(std::string("Not enough guesses in cache."),
-                "Alphadocte::CLI::CacheConfig::getTopGuesses(std::string_view, unsigned int, unsigned int, std::string_view) const");
+        if (reason)
+            *reason = "Not enough guesses in cache.";
+        return std::nullopt;
     }
 
+    std::vector<std::pair<std::string, double>> guesses;
     size_t i = 0;
-    for (const auto& entry : guessSection.entries) {
-        if (entry.name != ENTRY_GUESS_GUESS)
+    for (const auto& entry : section.entries) {
+        if (entry.name != CacheConfig::ENTRY_GUESS_GUESS)
             continue;
 
         size_t spacePos = entry.value.find(' ');
 
         if (spacePos == entry.value.npos) {
-            throw Alphadocte::Exception("Values of entry " + ENTRY_GUESS_GUESS + " must be separated by a space.",
-                    "Alphadocte::CLI::CacheConfig::getTopGuesses(std::string_view, unsigned int, unsigned int, std::string_view) const");
+            if (reason)
+                *reason = "Values of entry " + CacheConfig::ENTRY_GUESS_GUESS + " must be separated by a space.";
+            return std::nullopt;
         }
 
         std::string guessName{entry.value.substr(0, spacePos)};
         std::string guessTrust{entry.value.substr(spacePos)};
 
         if (std::size(guessName) != std::size(templateWord)) {
-            throw Alphadocte::Exception("Guess " + guessName + " does not have the same number of letters as template \"" + std::string(templateWord) + '"' + '.',
-                    "Alphadocte::CLI::CacheConfig::getTopGuesses(std::string_view, unsigned int, unsigned int, std::string_view) const");
+            if (reason)
+                *reason = "Guess " + guessName + " does not have the same number of letters as template \"" + std::string(templateWord) + '"' + '.';
+            return std::nullopt;
         }
 
         std::transform(std::begin(guessName), std::end(guessName), std::begin(guessName), tolower);
         if (!std::all_of(std::cbegin(guessName),std::cend(guessName), islower)) {
-            throw Alphadocte::Exception("Guess " + guessName + " contains invalid characters.",
-                    "Alphadocte::CLI::CacheConfig::getTopGuesses(std::string_view, unsigned int, unsigned int, std::string_view) const");
+            if (reason)
+                *reason = "Guess " + guessName + " contains invalid characters.";
+            return std::nullopt;
         }
 
         bool matchesTemplate{true};
@@ -220,16 +310,18 @@ std::vector<std::pair<std::string, double>> CacheConfig::getTopGuesses(
         }
 
         if (!matchesTemplate) {
-            throw Alphadocte::Exception("Guess " + guessName + " does not match the template \"" + std::string(templateWord) + '"' + '.',
-                    "Alphadocte::CLI::CacheConfig::getTopGuesses(std::string_view, unsigned int, unsigned int, std::string_view) const");
+            if (reason)
+                *reason = "Guess " + guessName + " does not match the template \"" + std::string(templateWord) + '"' + '.';
+            return std::nullopt;
         }
 
-        double trustValue{};
-        try {
-            trustValue = std::stod(guessTrust);
-        } catch (const std::exception& e) {
-            throw Alphadocte::Exception("Guess trust value (" + guessTrust.substr(1) + ") cannot be parsed as a number.",
-                    "Alphadocte::CLI::CacheConfig::getTopGuesses(std::string_view, unsigned int, unsigned int, std::string_view) const");
+        char* trustEnd{};
+        double trustValue = std::strtod(guessTrust.c_str(), &trustEnd);
+
+        if (trustEnd == guessTrust.c_str()) {
+            if (reason)
+                *reason = "Guess trust value (" + guessTrust.substr(1) + ") cannot be parsed as a number.";
+            return std::nullopt;
         }
 
         guesses.emplace_back(std::make_pair(guessName, trustValue));
@@ -241,73 +333,165 @@ std::vector<std::pair<std::string, double>> CacheConfig::getTopGuesses(
     return guesses;
 }
 
+}
+
+std::vector<std::pair<std::string, double>> CacheConfig::getTopGuesses(
+        std::string_view solverName,
+        unsigned int solverVersion,
+        unsigned int requestedNumberGuesses,
+        std::string_view templateWord) const {
+    std::string reason;
+    if (auto guesses = findTopGuesses(solverName, solverVersion, requestedNumberGuesses, templateWord, &reason))
+        return std::move(*guesses);
+
+    throw Alphadocte::Exception(reason,
+            "Alphadocte::CLI::CacheConfig::getTopGuesses(std::string_view, unsigned int, unsigned int, std::string_view) const");
+}
+
+std::optional<std::vector<std::pair<std::string, double>>> CacheConfig::findTopGuesses(
+        std::string_view solverName,
+        unsigned int solverVersion,
+        unsigned int requestedNumberGuesses,
+        std::string_view templateWord,
+        std::string* reason) const {
+
+    const Section* solverSection = findValidSolverSection(solverName, solverVersion, reason);
+    if (!solverSection)
+        return std::nullopt;
+
+    const Section* guessSection = m_config.findSection(*solverSection, SECTION_GUESS, ENTRY_GUESS_TEMPLATE, templateWord);
+    if (!guessSection) {
+        if (reason)
+            *reason = "Guess section with template \"" + std::string(templateWord) + "\" not found.";
+        return std::nullopt;
+    }
+
+    return parse_guesses(*guessSection, requestedNumberGuesses, templateWord,
+            reason ? "section guess with template " + std::string(templateWord) : std::string{}, reason);
+}
+
+std::vector<std::pair<std::string, double>> CacheConfig::getSecondGuesses(
+        std::string_view solverName,
+        unsigned int solverVersion,
+        unsigned int requestedNumberGuesses,
+        const BookPosition& position) const {
+    std::string reason;
+    if (auto guesses = findSecondGuesses(solverName, solverVersion, requestedNumberGuesses, position, &reason))
+        return std::move(*guesses);
+
+    throw Alphadocte::Exception(reason,
+            "Alphadocte::CLI::CacheConfig::getSecondGuesses(std::string_view, unsigned int, unsigned int, const Alphadocte::CLI::BookPosition&) const");
+}
+
+std::optional<std::vector<std::pair<std::string, double>>> CacheConfig::findSecondGuesses(
+        std::string_view solverName,
+        unsigned int solverVersion,
+        unsigned int requestedNumberGuesses,
+        const BookPosition& position,
+        std::string* reason) const {
+
+    const Section* solverSection = findValidSolverSection(solverName, solverVersion, reason);
+    if (!solverSection)
+        return std::nullopt;
+
+    auto positionName = position.toString();
+    const Section* bookSection = m_config.findSection(*solverSection, SECTION_BOOK, ENTRY_BOOK_POSITION, positionName);
+    if (!bookSection) {
+        if (reason)
+            *reason = "Book section with position \"" + positionName + "\" not found.";
+        return std::nullopt;
+    }
+
+    return parse_guesses(*bookSection, requestedNumberGuesses, position.templateWord,
+            reason ? "book section " + positionName : std::string{}, reason);
+}
+
 void CacheConfig::setTopGuesses(std::string solverName,
         unsigned int solverVersion,
         std::string templateWord,
         unsigned int requestedNumberGuesses,
         std::vector<std::pair<std::string, double>> topGuesses) {
 
-    Section& root = m_config.getRootSection();
+    Section& solverSection = prepareSolverSection(solverName, solverVersion);
 
-    Section* solverSection{nullptr};
-    try {
-        solverSection = &getSolverSection(solverName);
-        check_solver_section(*solverSection, solverName, solverVersion,
-                "Alphadocte::CLI::CacheConfig::setTopGuesses(std::string, unsigned int, std::string, unsigned int, std::vector<std::pair<std::string, double>>)");
-    } catch (const Alphadocte::Exception& e) {
-        // invalid solver section, recreating it
-
-        if (solverSection) {
-            // remove invalid section
-            root.sections.erase(std::remove_if(
-                    std::begin(root.sections),
-                    std::end(root.sections),
-                    [solverSection](const auto& section) { return solverSection == &section; }
-            ));
-        }
+    // Fill section
+    Section newGuessSection{SECTION_GUESS, {
+        Entry{ENTRY_GUESS_TEMPLATE, templateWord},
+        Entry{ENTRY_GUESS_NUMBER, std::to_string(requestedNumberGuesses)}
+    }, {}};
 
-        root.sections.emplace_back(Section{});
-        solverSection = &root.sections.back();
-        solverSection->name = SECTION_SOLVER;
-        solverSection->entries.emplace_back(Entry{ENTRY_SOLVER_NAME, solverName});
-        solverSection->entries.emplace_back(Entry{ENTRY_SOLVER_VERSION, std::to_string(solverVersion)});
+    for (const auto& guessPair : topGuesses) {
+        newGuessSection.entries.emplace_back(Entry{ENTRY_GUESS_GUESS, guessPair.first + ' ' + std::to_string(guessPair.second)});
     }
 
-    Section* guessSection{nullptr};
-    try {
-        guessSection = &getGuessSection(*solverSection, templateWord);
-
-        // remove matching section if it exists
-        solverSection->sections.erase(std::remove_if(
-                std::begin(solverSection->sections),
-                std::end(solverSection->sections),
-                [guessSection](const auto& section) { return guessSection == &section; }
-        ));
-    } catch (const Alphadocte::Exception& e) {
-        // guess section does not exist, create it anyway
+    if (Section* guessSection = m_config.findSection(solverSection, SECTION_GUESS, ENTRY_GUESS_TEMPLATE, templateWord)) {
+        // replace matching section in place, its template is unchanged so it stays indexed
+        *guessSection = std::move(newGuessSection);
+    } else {
+        m_config.addSection(solverSection, std::move(newGuessSection));
     }
-    solverSection->sections.emplace_back(Section{});
-    guessSection = &solverSection->sections.back();
+}
+
+void CacheConfig::setSecondGuesses(std::string solverName,
+        unsigned int solverVersion,
+        const BookPosition& position,
+        unsigned int requestedNumberGuesses,
+        std::vector<std::pair<std::string, double>> secondGuesses) {
+
+    Section& solverSection = prepareSolverSection(solverName, solverVersion);
 
     // Fill section
-    guessSection->name = SECTION_GUESS;
-    guessSection->entries.emplace_back(Entry{ENTRY_GUESS_TEMPLATE, templateWord});
-    guessSection->entries.emplace_back(Entry{ENTRY_GUESS_NUMBER, std::to_string(requestedNumberGuesses)});
+    auto positionName = position.toString();
+    Section newBookSection{SECTION_BOOK, {
+        Entry{ENTRY_BOOK_POSITION, positionName},
+        Entry{ENTRY_GUESS_NUMBER, std::to_string(requestedNumberGuesses)}
+    }, {}};
+
+    for (const auto& guessPair : secondGuesses) {
+        newBookSection.entries.emplace_back(Entry{ENTRY_GUESS_GUESS, guessPair.first + ' ' + std::to_string(guessPair.second)});
+    }
 
-    for (const auto& guessPair : topGuesses) {
-        guessSection->entries.emplace_back(Entry{ENTRY_GUESS_GUESS, guessPair.first + ' ' + std::to_string(guessPair.second)});
+    if (Section* bookSection = m_config.findSection(solverSection, SECTION_BOOK, ENTRY_BOOK_POSITION, positionName)) {
+        // replace matching section in place, its position is unchanged so it stays indexed
+        *bookSection = std::move(newBookSection);
+    } else {
+        m_config.addSection(solverSection, std::move(newBookSection));
     }
 }
 
-bool CacheConfig::isCacheValid() const {
-    try {
-        auto filepath = getDictionaryPath();
-        auto timestamp = getDictionaryTimestamp();
+bool CacheConfig::isCacheValid(const Dictionary* dictionary) const {
+    auto filepath = findDictionaryPath();
+    auto timestamp = findDictionaryTimestamp();
 
-        return timestamp == std::filesystem::last_write_time(filepath);
-    } catch (...) {
+    if (!filepath || !timestamp)
         return false;
+
+    // the words of the dictionary in use decide, wherever its file was copied or reinstalled
+    auto hash = findDictionaryHash();
+    if (dictionary && hash)
+        return *hash == dictionary->getContentHash();
+
+    // otherwise, only an untouched dictionary file proves the cache is current
+    std::error_code error;
+    return *timestamp == std::filesystem::last_write_time(*filepath, error) && !error;
+}
+
+size_t CacheConfig::removeOutdatedSolvers(const std::map<std::string, unsigned int, std::less<>>& solverVersions) {
+    return removeOutdatedSolvers(m_config, solverVersions);
+}
+
+size_t CacheConfig::removeOutdatedSolvers(Config& config,
+        const std::map<std::string, unsigned int, std::less<>>& solverVersions) {
+    size_t nbRemoved{};
+    for (const auto& [solverName, solverVersion] : solverVersions) {
+        Section* solverSection = config.findSection(config.getRootSection(), SECTION_SOLVER, ENTRY_SOLVER_NAME, solverName);
+        if (solverSection && !check_solver_section(*solverSection, solverName, solverVersion, nullptr)) {
+            config.removeSection(config.getRootSection(), *solverSection);
+            nbRemoved++;
+        }
     }
+
+    return nbRemoved;
 }
 
 void CacheConfig::setDictionaryPath(std::filesystem::path dictionaryPath) {
@@ -354,86 +538,47 @@ void CacheConfig::setDictionaryTimestamp(std::filesystem::file_time_type diction
 
 }
 
-const Section& CacheConfig::getSolverSection(std::string_view solverName) const {
-    auto it = std::find_if(
-            std::cbegin(m_config.getRootSection().sections),
-            std::cend(m_config.getRootSection().sections),
-            [solverName](const auto& section){ return section.name == SECTION_SOLVER
-                    && std::find_if(
-                            std::cbegin(section.entries),
-                            std::cend(section.entries),
-                            [solverName](const auto& entry) {
-                                return entry.name == ENTRY_SOLVER_NAME && entry.value == solverName;
-                       }) != std::cend(section.entries);
-    });
+Section& CacheConfig::prepareSolverSection(const std::string& solverName, unsigned int solverVersion) {
+    Section& root = m_config.getRootSection();
+    Section* solverSection = findSolverSection(solverName);
 
+    if (solverSection && check_solver_section(*solverSection, solverName, solverVersion, nullptr))
+        return *solverSection;
 
-    if (it == std::cend(m_config.getRootSection().sections)) {
-        throw Alphadocte::Exception("Solver section with name \"" + std::string(solverName) + "\" not found.",
-                "Alphadocte::CLI::CacheConfig::getSolverSection(std::string_view) const");
+    // invalid solver section, recreating it
+    if (solverSection) {
+        // remove invalid section
+        m_config.removeSection(root, *solverSection);
     }
 
-    return *it;
+    return m_config.addSection(root, Section{SECTION_SOLVER, {
+        Entry{ENTRY_SOLVER_NAME, solverName},
+        Entry{ENTRY_SOLVER_VERSION, std::to_string(solverVersion)}
+    }, {}});
 }
 
-Section& CacheConfig::getSolverSection(std::string_view solverName) {
-    // re-use code of const getter
-    return const_cast<Section&>(std::as_const(*this).getSolverSection(solverName));
+const Section* CacheConfig::findSolverSection(std::string_view solverName) const {
+    return m_config.findSection(m_config.getRootSection(), SECTION_SOLVER, ENTRY_SOLVER_NAME, solverName);
 }
 
-const Section& CacheConfig::getGuessSection(const Section& solverSection, std::string_view templateWord) {
-    if (solverSection.name != SECTION_SOLVER) {
-        throw Alphadocte::InvalidArgException("Guess section must be searched inside solver section.",
-                "Alphadocte::CLI::CacheConfig::getGuessSection(const Alphadocte::CLI::Section&, std::string_view)");
-    }
-
-    auto it = std::find_if(
-            std::cbegin(solverSection.sections),
-            std::cend(solverSection.sections),
-            [templateWord](const auto& section){ return section.name == SECTION_GUESS
-                && std::find_if(
-                        std::cbegin(section.entries),
-                        std::cend(section.entries),
-                        [templateWord](const auto& entry) {
-                            return entry.name == ENTRY_GUESS_TEMPLATE && entry.value == templateWord;
-                    }) != std::cend(section.entries);
-    });
-
-    if (it == std::cend(solverSection.sections)) {
-        throw Alphadocte::Exception("Guess section with template \"" + std::string(templateWord) + "\" not found.",
-                "Alphadocte::CLI::CacheConfig::getGuessSection(const Alphadocte::CLI::Section&, std::string_view)");
-    }
-
-    return *it;
+Section* CacheConfig::findSolverSection(std::string_view solverName) {
+    // re-use code of const lookup
+    return const_cast<Section*>(std::as_const(*this).findSolverSection(solverName));
 }
 
-Section& CacheConfig::getGuessSection(Section& solverSection, std::string_view templateWord) {
-    if (solverSection.name != SECTION_SOLVER) {
-        throw Alphadocte::InvalidArgException("Guess section must be searched inside solver section.",
-                "Alphadocte::CLI::CacheConfig::getGuessSection(const Alphadocte::CLI::Section&, std::string_view)");
-    }
+const Section* CacheConfig::findValidSolverSection(std::string_view solverName, unsigned int solverVersion,
+        std::string* reason) const {
+    const Section* solverSection = findSolverSection(solverName);
 
-    auto it = std::find_if(
-            std::begin(solverSection.sections),
-            std::end(solverSection.sections),
-            [templateWord](const auto& section){ return section.name == SECTION_GUESS
-                && std::find_if(
-                        std::cbegin(section.entries),
-                        std::cend(section.entries),
-                        [templateWord](const auto& entry) {
-                            return entry.name == ENTRY_GUESS_TEMPLATE && entry.value == templateWord;
-                    }) != std::cend(section.entries);
-    });
-
-    if (it == std::end(solverSection.sections)) {
-        throw Alphadocte::Exception("Guess section with template \"" + std::string(templateWord) + "\" not found.",
-                "Alphadocte::CLI::CacheConfig::getGuessSection(const Alphadocte::CLI::Section&, std::string_view)");
+    if (!solverSection) {
+        if (reason)
+            *reason = "Solver section with name \"" + std::string(solverName) + "\" not found.";
+        return nullptr;
     }
 
-    return *it;
+    return check_solver_section(*solverSection, solverName, solverVersion, reason) ? solverSection : nullptr;
 }
 
 } /* namespace CLI */
 
 } /* namespace Alphadocte */
-
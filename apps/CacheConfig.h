@@ -22,14 +22,55 @@
 #ifndef APPS_CACHECONFIG_H_
 #define APPS_CACHECONFIG_H_
 
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Alphadocte/Hint.h>
+
 #include "Config.h"
 
 namespace Alphadocte {
 
+class Dictionary;
+
 namespace CLI {
 
+/*
+ * Position of the opening book : the first template of a game,
+ * the first guess played, and the hints it got.
+ */
+struct BookPosition {
+    std::string templateWord;
+    std::string firstGuess;
+    std::vector<HintType> hints;
+
+    /*
+     * Return the position as "<template> <first guess> <hints>", with hints formatted by formatHints.
+     */
+    std::string toString() const;
+
+    /*
+     * Parse a position formatted by toString().
+     *
+     * Throws :
+     * - InvalidArgException : if the position is invalid.
+     */
+    static BookPosition parse(std::string_view position);
+};
+
+bool operator==(const BookPosition& lhs, const BookPosition& rhs);
+
 /*
  * Stores information about a dictionary in a cache.
+ *
+ * Lookups come in two flavours : getters throw an Exception on a miss,
+ * while find* methods return nothing, and only describe the miss if asked to,
+ * since a miss is the normal case while filling the cache.
  */
 class CacheConfig {
 public:
@@ -39,11 +80,12 @@ public:
      *
      * Args :
      * - dictionaryPath : path to the dictionary
+     * - dictionary : the dictionary loaded from dictionaryPath, whose content hash is stored
      *
      * Throws :
      * - Exception if dictionaryPath does not refer to a file.
      */
-    CacheConfig(std::filesystem::path dictionaryPath);
+    CacheConfig(std::filesystem::path dictionaryPath, const Dictionary& dictionary);
 
     /*
      * Load existing cache from a config object.
@@ -51,11 +93,12 @@ public:
      * Args :
      * - config : the data structure holding cache information (must have been loaded,
      *            otherwise it will not be valid).
+     * - dictionary : the dictionary of the cache, if already loaded (see isCacheValid)
      *
      * Throws :
      * - InvalidArgException if config is invalid (ie missing required entries, outdated cache)
      */
-    CacheConfig(Config config);
+    CacheConfig(Config config, const Dictionary* dictionary = nullptr);
 
     // Default constructors/destructor
     virtual ~CacheConfig() = default;
@@ -76,11 +119,18 @@ public:
      *
      * Args :
      * - config : the new config to use (if valid)
+     * - dictionary : the dictionary of the cache, if already loaded (see isCacheValid)
      *
      * Throws :
      * - InvalidArgException : if the config is invalid (as stated by isCacheValid)
      */
-    void setConfig(Config config);
+    void setConfig(Config config, const Dictionary* dictionary = nullptr);
+
+    /*
+     * Return an estimate of the memory retained by the cache on the heap, in bytes,
+     * see Config::getRetainedBytes().
+     */
+    size_t getRetainedBytes() const;
 
     /*
      * Return the path to the dictionary's file.
@@ -90,6 +140,14 @@ public:
      */
     std::filesystem::path getDictionaryPath() const;
 
+    /*
+     * Return the path to the dictionary's file, or nothing if it is missing or invalid.
+     *
+     * Args :
+     * - reason : if not nullptr, receives the reason why no path is returned
+     */
+    std::optional<std::filesystem::path> findDictionaryPath(std::string* reason = nullptr) const;
+
     /*
      * Return the timestamp of the last write access on the dictionary's file.
      *
@@ -98,6 +156,31 @@ public:
      */
     std::filesystem::file_time_type getDictionaryTimestamp() const;
 
+    /*
+     * Return the timestamp of the last write access on the dictionary's file,
+     * or nothing if it is missing or invalid.
+     *
+     * Args :
+     * - reason : if not nullptr, receives the reason why no timestamp is returned
+     */
+    std::optional<std::filesystem::file_time_type> findDictionaryTimestamp(std::string* reason = nullptr) const;
+
+    /*
+     * Return the content hash of the dictionary's words (see Dictionary::getContentHash()).
+     *
+     * Throws :
+     * - Exception : if the config does not have the dictionary hash, or is invalid
+     */
+    std::uint64_t getDictionaryHash() const;
+
+    /*
+     * Return the content hash of the dictionary's words, or nothing if it is missing or invalid.
+     *
+     * Args :
+     * - reason : if not nullptr, receives the reason why no hash is returned
+     */
+    std::optional<std::uint64_t> findDictionaryHash(std::string* reason = nullptr) const;
+
     /*
      * Return the top guesses cached for a template as well as their trust value,
      *  using a particular solver.
@@ -122,6 +205,20 @@ public:
             unsigned int requestedNumberGuesses,
             std::string_view templateWord) const;
 
+    /*
+     * Return the top guesses cached for a template as well as their trust value,
+     * using a particular solver, or nothing if they are not cached (see getTopGuesses).
+     *
+     * Args :
+     * - reason : if not nullptr, receives the reason why no guesses are returned
+     */
+    std::optional<std::vector<std::pair<std::string, double>>> findTopGuesses(
+            std::string_view solverName,
+            unsigned int solverVersion,
+            unsigned int requestedNumberGuesses,
+            std::string_view templateWord,
+            std::string* reason = nullptr) const;
+
     /*
      * Set the top guesses cached for a template as well as their trust value,
      *  using a particular solver.
@@ -147,12 +244,93 @@ public:
             unsigned int requestedNumberGuesses,
             std::vector<std::pair<std::string, double>> topGuesses);
 
+    /*
+     * Return the second guesses cached in the opening book for a position, as well as their trust value,
+     * using a particular solver.
+     *
+     * Args :
+     * - soverName : unique identifier of the solver
+     * - solverVersion : version of the solver, bumped each time the solver algorithm's changes might modify results
+     * - requestedNumberGuesses : the number of guesses wanted.
+     * - position : the first template, guess and hints of the game.
+     *
+     * Throws :
+     * - Exception : if the position for this solver is not found or invalid,
+     *               or if the number of requested guesses have not been cached.
+     */
+    std::vector<std::pair<std::string, double>> getSecondGuesses(
+            std::string_view solverName,
+            unsigned int solverVersion,
+            unsigned int requestedNumberGuesses,
+            const BookPosition& position) const;
+
+    /*
+     * Return the second guesses cached in the opening book for a position, as well as their trust value,
+     * using a particular solver, or nothing if they are not cached (see getSecondGuesses).
+     *
+     * Args :
+     * - reason : if not nullptr, receives the reason why no guesses are returned
+     */
+    std::optional<std::vector<std::pair<std::string, double>>> findSecondGuesses(
+            std::string_view solverName,
+            unsigned int solverVersion,
+            unsigned int requestedNumberGuesses,
+            const BookPosition& position,
+            std::string* reason = nullptr) const;
+
+    /*
+     * Set the second guesses of the opening book for a position, as well as their trust value,
+     * using a particular solver. As with setTopGuesses, an invalid/outdated solver entry is replaced.
+     *
+     * Args :
+     * - soverName : unique identifier of the solver
+     * - solverVersion : version of the solver
+     * - position : the first template, guess and hints of the game.
+     * - requestedNumberGuesses : the number of guesses wanted.
+     * - secondGuesses : the second guesses to be cached, as well as their trust values.
+     */
+    void setSecondGuesses(std::string solverName,
+            unsigned int solverVersion,
+            const BookPosition& position,
+            unsigned int requestedNumberGuesses,
+            std::vector<std::pair<std::string, double>> secondGuesses);
+
     /*
      * Check if the given cache is valid, that is :
      * - it has the required entries (FILE_PATH and FILE_TIMESTAMP)
-     * - it is not outdated
+     * - it is not outdated : the words of the given dictionary match FILE_HASH, or
+     *   when no dictionary is given (or FILE_HASH is missing), the last write time
+     *   of the dictionary file is unchanged
+     *
+     * The dictionary is not read from its file : without a loaded dictionary,
+     * a cache whose dictionary was touched, moved or copied is outdated.
+     *
+     * Args :
+     * - dictionary : the loaded dictionary of the cache, or nullptr
+     */
+    bool isCacheValid(const Dictionary* dictionary = nullptr) const;
+
+    /*
+     * Remove the sections of the given solvers whose version is outdated or invalid.
+     * Sections of other solvers are kept.
+     *
+     * Return the number of removed solver sections.
+     *
+     * Args :
+     * - solverVersions : current version of each solver, by solver name
+     */
+    size_t removeOutdatedSolvers(const std::map<std::string, unsigned int, std::less<>>& solverVersions);
+
+    /*
+     * Same as above, on the content of a text cache which is not checked against its dictionary
+     * (eg when the dictionary cannot be found on this host).
+     *
+     * Args :
+     * - config : the content of the text cache
+     * - solverVersions : current version of each solver, by solver name
      */
-    bool isCacheValid() const;
+    static size_t removeOutdatedSolvers(Config& config,
+            const std::map<std::string, unsigned int, std::less<>>& solverVersions);
 
 
 private:
@@ -171,54 +349,27 @@ private:
     void setDictionaryTimestamp(std::filesystem::file_time_type dictionaryTimestamp);
 
     /*
-     * Return a const reference to the section solver (identified by the solver name).
-     *
-     * Args :
-     * - solverName : identifier of the solver
-     *
-     * Throws :
-     * - Exception : if the solver section is not found
+     * Return the section of the solver (identified by the solver name), or nullptr if there is none.
      */
-    const Section& getSolverSection(std::string_view solverName) const;
+    const Section* findSolverSection(std::string_view solverName) const;
+    Section* findSolverSection(std::string_view solverName);
 
     /*
-     * Return a reference to the section solver (identified by the solver name).
+     * Return the section of the solver if it is valid for this solver version, or nullptr otherwise.
      *
      * Args :
      * - solverName : identifier of the solver
-     *
-     * Throws :
-     * - Exception : if the solver section is not found
-     */
-    Section& getSolverSection(std::string_view solverName);
-
-    /*
-     * Return a const reference to the section guess (which use the given template)
-     * inside a solver section.
-     *
-     * Args :
-     * - solverSection : the solver section which contains the guess section to find
-     * - templateWord : the template word of the guess section to find
-     *
-     * Throws :
-     * - InvalidArgException : if solverSection is not a solver section (invalid section name)
-     * - Exception : if the solver section is not found
+     * - solverVersion : version of the solver
+     * - reason : if not nullptr, receives the reason why no section is returned
      */
-    static const Section& getGuessSection(const Section& solverSection, std::string_view templateWord);
+    const Section* findValidSolverSection(std::string_view solverName, unsigned int solverVersion,
+            std::string* reason) const;
 
     /*
-     * Return a reference to the section guess (which use the given template)
-     * inside a solver section.
-     *
-     * Args :
-     * - solverSection : the solver section which contains the guess section to find
-     * - templateWord : the template word of the guess section to find
-     *
-     * Throws :
-     * - InvalidArgException : if solverSection is not a solver section (invalid section name)
-     * - Exception : if the solver section is not found
+     * Return a reference to the section of the solver, if it is valid for this solver version,
+     * otherwise replace it with an empty solver section.
      */
-    static Section& getGuessSection(Section& solverSection, std::string_view templateWord);
+    Section& prepareSolverSection(const std::string& solverName, unsigned int solverVersion);
 
     // Fields
     Config m_config;
@@ -228,6 +379,7 @@ public:
     // root entries
     inline static const std::string ENTRY_FILE_PATH = "file_path";
     inline static const std::string ENTRY_FILE_TIMESTAMP = "file_timestamp";
+    inline static const std::string ENTRY_FILE_HASH = "file_hash";
 
     // solver section
     inline static const std::string SECTION_SOLVER = "solver_entry";
@@ -239,6 +391,10 @@ public:
     inline static const std::string ENTRY_GUESS_TEMPLATE = "template";
     inline static const std::string ENTRY_GUESS_NUMBER = "requested_number";
     inline static const std::string ENTRY_GUESS_GUESS = "guess";
+
+    // book section, with the same number and guess entries as the guess section
+    inline static const std::string SECTION_BOOK = "book_entry";
+    inline static const std::string ENTRY_BOOK_POSITION = "position";
 };
 
 } /* namespace CLI */
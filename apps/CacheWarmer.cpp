@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: CacheWarmer.cpp
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+
+#include <Alphadocte/Alphadocte.h>
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Game.h>
+#include <Alphadocte/Hint.h>
+#include <Alphadocte/IGameRules.h>
+#include <Alphadocte/Solver.h>
+
+#include "BinaryCache.h"
+#include "CacheConfig.h"
+#include "CacheWarmer.h"
+#include "Parallel.h"
+
+namespace Alphadocte {
+
+namespace CLI {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/*
+ * Create the rules of the given templates, and check that the solver matches the cache.
+ */
+std::map<RulesType, std::shared_ptr<IGameRules>> prepareRules(const BinaryCache& cache,
+        std::shared_ptr<Dictionary> dictionary,
+        const std::vector<WarmupTemplate>& templates,
+        const WarmupOptions& options,
+        const std::string& functionName) {
+    std::map<RulesType, std::shared_ptr<IGameRules>> rules;
+    for (const auto& firstTemplate : templates) {
+        if (!rules.contains(firstTemplate.rulesType))
+            rules.emplace(firstTemplate.rulesType, createRules(firstTemplate.rulesType, dictionary));
+    }
+
+    auto checkSolver = createSolver(options.solverName, std::cbegin(rules)->second);
+    if (checkSolver->getSolverName() != cache.getSolverName() || checkSolver->getSolverVersion() != cache.getSolverVersion()) {
+        throw Alphadocte::InvalidArgException("The cache does not belong to the solver " + options.solverName + '.', functionName);
+    }
+
+    return rules;
+}
+
+}
+
+std::vector<WarmupTemplate> listFirstTemplates(const Dictionary& dictionary, bool withWordle) {
+    // number of words for each pair of length and first letter
+    std::map<std::pair<size_t, char>, size_t> nbWords;
+    size_t nbWordleWords{};
+    for (const auto& word : dictionary.getAllWords()) {
+        if (word.empty())
+            continue;
+
+        nbWords[{std::size(word), word.front()}]++;
+        if (std::size(word) == ALPHADOCTE_WORDLE_DEFAULT_SIZE)
+            nbWordleWords++;
+    }
+
+    std::vector<WarmupTemplate> templates;
+    for (const auto& [key, count] : nbWords) {
+        std::string templateWord(key.first, '.');
+        templateWord.front() = key.second;
+        templates.push_back(WarmupTemplate{std::move(templateWord), RulesType::MOTUS, count});
+    }
+
+    if (withWordle && nbWordleWords > 0)
+        templates.push_back(WarmupTemplate{std::string(ALPHADOCTE_WORDLE_DEFAULT_SIZE, '.'), RulesType::WORDLE, nbWordleWords});
+
+    // start with the longest computations, so that threads finish at the same time
+    std::stable_sort(std::begin(templates), std::end(templates),
+            [](const auto& lhs, const auto& rhs) { return lhs.nbCandidates > rhs.nbCandidates; });
+
+    return templates;
+}
+
+WarmupResult warmCache(BinaryCache& cache,
+        std::shared_ptr<Dictionary> dictionary,
+        const WarmupOptions& options,
+        const WarmupCallback& onComputed) {
+    auto start = Clock::now();
+    WarmupResult result;
+    result.nbThreads = options.nbThreads == 0 ? defaultThreadCount() : options.nbThreads;
+
+    auto templates = listFirstTemplates(*dictionary, options.withWordle);
+    result.nbTemplates = std::size(templates);
+
+    // resume : skip the templates cached by a previous run
+    std::erase_if(templates, [&cache, &options](const auto& firstTemplate) {
+        return cache.contains(firstTemplate.templateWord, options.nbGuesses);
+    });
+    result.nbCached = result.nbTemplates - std::size(templates);
+
+    if (templates.empty()) {
+        result.wallDuration = secondsSince(start);
+        return result;
+    }
+
+    auto rules = prepareRules(cache, dictionary, templates, options,
+            "Alphadocte::CLI::warmCache(Alphadocte::CLI::BinaryCache&, std::shared_ptr<Alphadocte::Dictionary>, const Alphadocte::CLI::WarmupOptions&, const Alphadocte::CLI::WarmupCallback&)");
+
+    // One solver per thread and per rules, solvers keep their own state
+    // and their own threads are capped by the number of threads of the warmup
+    std::vector<std::map<RulesType, std::unique_ptr<Solver>>> solvers(result.nbThreads);
+    std::mutex cacheMutex;
+
+    parallelFor(std::size(templates), result.nbThreads,
+            [&](size_t i, unsigned int thread) {
+        const auto& firstTemplate = templates[i];
+        auto& solver = solvers[thread][firstTemplate.rulesType];
+        if (!solver)
+            solver = createSolver(options.solverName, rules.at(firstTemplate.rulesType), result.nbThreads);
+
+        solver->setTemplate(firstTemplate.templateWord);
+        auto guesses = solver->computeNextGuesses(options.nbGuesses);
+
+        // the cache object is not thread-safe, and writes are appended to the file one at a time anyway
+        std::lock_guard lock{cacheMutex};
+        cache.setTopGuesses(firstTemplate.templateWord, options.nbGuesses, guesses);
+        result.nbComputed++;
+        result.maxSolverThreads = std::max(result.maxSolverThreads, solver->getStats().nbThreads);
+
+        if (onComputed) {
+            onComputed(firstTemplate.templateWord, guesses.empty() ? std::string_view{} : std::string_view{guesses.front().first},
+                    result.nbComputed, std::size(templates));
+        }
+    });
+
+    result.wallDuration = secondsSince(start);
+    return result;
+}
+
+WarmupResult warmOpeningBook(BinaryCache& cache,
+        std::shared_ptr<Dictionary> dictionary,
+        const WarmupOptions& options,
+        const WarmupCallback& onComputed) {
+    auto start = Clock::now();
+    WarmupResult result;
+    result.nbThreads = options.nbThreads == 0 ? defaultThreadCount() : options.nbThreads;
+
+    // the book starts from the best first guess of each cached template
+    auto templates = listFirstTemplates(*dictionary, options.withWordle);
+    std::erase_if(templates, [&cache](const auto& firstTemplate) {
+        auto firstGuesses = cache.findTopGuesses(1, firstTemplate.templateWord);
+        return !firstGuesses || firstGuesses->empty();
+    });
+
+    if (templates.empty()) {
+        result.wallDuration = secondsSince(start);
+        return result;
+    }
+
+    auto rules = prepareRules(cache, dictionary, templates, options,
+            "Alphadocte::CLI::warmOpeningBook(Alphadocte::CLI::BinaryCache&, std::shared_ptr<Alphadocte::Dictionary>, const Alphadocte::CLI::WarmupOptions&, const Alphadocte::CLI::WarmupCallback&)");
+
+    // One solver per thread and per rules, solvers keep their own state
+    // and their own threads are capped by the number of threads of the warmup
+    std::vector<std::map<RulesType, std::unique_ptr<Solver>>> solvers(result.nbThreads);
+    auto getSolver = [&solvers, &rules, &options, &result](unsigned int thread, RulesType rulesType) -> Solver& {
+        auto& solver = solvers[thread][rulesType];
+        if (!solver)
+            solver = createSolver(options.solverName, rules.at(rulesType), result.nbThreads);
+        return *solver;
+    };
+
+    // List the positions : the distinct hints the first guess can get, except the winning ones
+    std::vector<std::vector<std::pair<BookPosition, RulesType>>> templatePositions(std::size(templates));
+    std::mutex cacheMutex;
+    parallelFor(std::size(templates), result.nbThreads, [&](size_t i, unsigned int thread) {
+        const auto& firstTemplate = templates[i];
+        std::string firstGuess;
+        {
+            // the cache object is not thread-safe
+            std::lock_guard lock{cacheMutex};
+            firstGuess = cache.getTopGuesses(1, firstTemplate.templateWord).front().first;
+        }
+
+        Solver& solver = getSolver(thread, firstTemplate.rulesType);
+        solver.setTemplate(firstTemplate.templateWord);
+
+        std::set<HintCode> codes;
+        for (auto solution : solver.getPotentialSolutions()) {
+            if (solution != firstGuess)
+                codes.insert(packHints(Game::computeHints(firstGuess, solution)));
+        }
+
+        for (auto code : codes) {
+            BookPosition position{firstTemplate.templateWord, firstGuess, unpackHints(code, std::size(firstGuess))};
+            templatePositions[i].emplace_back(std::move(position), firstTemplate.rulesType);
+        }
+    });
+
+    std::vector<std::pair<BookPosition, RulesType>> positions;
+    for (auto& entries : templatePositions) {
+        std::move(std::begin(entries), std::end(entries), std::back_inserter(positions));
+    }
+    result.nbTemplates = std::size(positions);
+
+    // resume : skip the positions cached by a previous run
+    std::erase_if(positions, [&cache, &options](const auto& entry) {
+        return cache.containsSecondGuesses(entry.first, options.nbGuesses);
+    });
+    result.nbCached = result.nbTemplates - std::size(positions);
+
+    parallelFor(std::size(positions), result.nbThreads, [&](size_t i, unsigned int thread) {
+        const auto& [position, rulesType] = positions[i];
+
+        Solver& solver = getSolver(thread, rulesType);
+        solver.setTemplate(position.templateWord);
+        solver.addHint(position.firstGuess, position.hints);
+        auto guesses = solver.computeNextGuesses(options.nbGuesses);
+
+        // the cache object is not thread-safe, and writes are appended to the file one at a time anyway
+        std::lock_guard lock{cacheMutex};
+        cache.setSecondGuesses(position, options.nbGuesses, guesses);
+        result.nbComputed++;
+        result.maxSolverThreads = std::max(result.maxSolverThreads, solver.getStats().nbThreads);
+
+        if (onComputed) {
+            onComputed(position.toString(), guesses.empty() ? std::string_view{} : std::string_view{guesses.front().first},
+                    result.nbComputed, std::size(positions));
+        }
+    });
+
+    result.wallDuration = secondsSince(start);
+    return result;
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: CacheWarmer.h
+ */
+
+#ifndef APPS_CACHEWARMER_H_
+#define APPS_CACHEWARMER_H_
+
+/*
+ * Private header used to fill the first guesses cache ahead of time.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Common.h"
+
+namespace Alphadocte {
+
+class Dictionary;
+
+namespace CLI {
+
+class BinaryCache;
+
+/*
+ * A first template, with the rules used to play it.
+ */
+struct WarmupTemplate {
+    std::string templateWord;
+    RulesType rulesType;
+    size_t nbCandidates{}; // number of words matching the template, ie the cost of its computation
+};
+
+/*
+ * Options of a cache warmup.
+ */
+struct WarmupOptions {
+    std::string solverName{"entropy_maximizer"}; // solver computing the guesses, see createSolver
+    unsigned int nbGuesses{10};                  // number of top guesses cached for each template
+    unsigned int nbThreads{0};                   // number of threads, 0 means one per core
+    bool withWordle{true};                       // also compute the Wordle template
+};
+
+/*
+ * Results of a cache warmup.
+ */
+struct WarmupResult {
+    size_t nbTemplates{}; // number of templates supported by the dictionary
+    size_t nbCached{};    // number of templates already cached, which were skipped
+    size_t nbComputed{};  // number of templates computed and written to the cache
+    unsigned int nbThreads{};
+    unsigned int maxSolverThreads{}; // most threads used by a solver for a single computation
+    double wallDuration{}; // duration (s) of the whole warmup
+};
+
+/*
+ * Called each time a template has been computed and written to the cache,
+ * with the template, its best guess, the number of templates computed so far
+ * and the number of templates to compute.
+ * Calls are serialized, but can come from any thread.
+ */
+using WarmupCallback = std::function<void(std::string_view templateWord, std::string_view bestGuess,
+        size_t nbDone, size_t nbToCompute)>;
+
+/*
+ * List the first templates of the games supported by the dictionary :
+ * one Motus template per pair of word length and first letter, and
+ * the Wordle template if the dictionary has words of ALPHADOCTE_WORDLE_DEFAULT_SIZE letters.
+ *
+ * The most expensive templates come first.
+ *
+ * Args :
+ * - dictionary : a loaded dictionary
+ * - withWordle : whether the Wordle template is listed
+ */
+std::vector<WarmupTemplate> listFirstTemplates(const Dictionary& dictionary, bool withWordle = true);
+
+/*
+ * Compute the top guesses of each first template (see listFirstTemplates) not yet in the cache,
+ * in parallel, and write them to the cache as soon as they are computed.
+ * An interrupted warmup thus resumes where it stopped when run again.
+ *
+ * Args :
+ * - cache : the cache to fill, opened for the dictionary and the solver
+ * - dictionary : the dictionary of the cache, loaded
+ * - options : the warmup options
+ * - onComputed : optional progress callback
+ *
+ * Throws :
+ * - InvalidArgException : if the solver is unknown, or does not match the cache.
+ * - Exception : if the cache cannot be written.
+ */
+WarmupResult warmCache(BinaryCache& cache,
+        std::shared_ptr<Dictionary> dictionary,
+        const WarmupOptions& options,
+        const WarmupCallback& onComputed = {});
+
+/*
+ * Fill the opening book of the cache : for each first template whose top guesses are cached
+ * (see warmCache), and for each hints the best first guess can get, compute the second guesses
+ * of the solver, in parallel, and write them to the cache as soon as they are computed.
+ * Positions already in the book are skipped, so that an interrupted run resumes where it stopped.
+ *
+ * The returned result counts book positions instead of templates.
+ *
+ * Args :
+ * - cache : the cache to fill, opened for the dictionary and the solver
+ * - dictionary : the dictionary of the cache, loaded
+ * - options : the warmup options
+ * - onComputed : optional progress callback, called with the position instead of the template
+ *
+ * Throws :
+ * - InvalidArgException : if the solver is unknown, or does not match the cache.
+ * - Exception : if the cache cannot be written.
+ */
+WarmupResult warmOpeningBook(BinaryCache& cache,
+        std::shared_ptr<Dictionary> dictionary,
+        const WarmupOptions& options,
+        const WarmupCallback& onComputed = {});
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_CACHEWARMER_H_ */
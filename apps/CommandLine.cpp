@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: CommandLine.cpp
+ */
+
+#include <charconv>
+
+#include "CommandLine.h"
+#include <Alphadocte/Exceptions.h>
+
+namespace Alphadocte {
+
+namespace CLI {
+
+CommandLine::CommandLine(int argc, const char* const argv[])
+        : m_programName{}, m_options{}, m_positionalArguments{} {
+    if (argc > 0) {
+        m_programName = argv[0];
+    }
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view argument{argv[i]};
+
+        if (!argument.starts_with("--")) {
+            m_positionalArguments.emplace_back(argument);
+            continue;
+        }
+
+        argument.remove_prefix(2);
+        auto equalPos = argument.find('=');
+        std::string name{argument.substr(0, equalPos)};
+        std::string value{equalPos == argument.npos ? std::string_view{} : argument.substr(equalPos + 1)};
+
+        if (name.empty()) {
+            throw Alphadocte::InvalidArgException("Argument " + std::string(argv[i]) + " does not have an option name.",
+                    "Alphadocte::CLI::CommandLine::CommandLine(int, const char* const[])");
+        }
+
+        // last occurrence wins
+        m_options.insert_or_assign(std::move(name), std::move(value));
+    }
+}
+
+const std::string& CommandLine::getProgramName() const {
+    return m_programName;
+}
+
+const std::vector<std::string>& CommandLine::getPositionalArguments() const {
+    return m_positionalArguments;
+}
+
+bool CommandLine::has(std::string_view name) const {
+    return m_options.find(name) != std::cend(m_options);
+}
+
+std::string CommandLine::getString(std::string_view name, std::string defaultValue) const {
+    auto it = m_options.find(name);
+    return it == std::cend(m_options) ? std::move(defaultValue) : it->second;
+}
+
+unsigned long CommandLine::getUnsigned(std::string_view name, unsigned long defaultValue) const {
+    auto it = m_options.find(name);
+
+    if (it == std::cend(m_options))
+        return defaultValue;
+
+    const std::string& value = it->second;
+    unsigned long result{};
+    auto [end, error] = std::from_chars(value.data(), value.data() + std::size(value), result);
+
+    if (value.empty() || error != std::errc{} || end != value.data() + std::size(value)) {
+        throw Alphadocte::InvalidArgException("Value of option --" + it->first + " must be a positive integer, got \"" + value + "\".",
+                "Alphadocte::CLI::CommandLine::getUnsigned(std::string_view, unsigned long) const");
+    }
+
+    return result;
+}
+
+double CommandLine::getDouble(std::string_view name, double defaultValue) const {
+    auto it = m_options.find(name);
+
+    if (it == std::cend(m_options))
+        return defaultValue;
+
+    const std::string& value = it->second;
+    size_t end{};
+    double result{};
+
+    try {
+        result = std::stod(value, &end);
+    } catch (const std::exception& e) {
+        end = 0;
+    }
+
+    if (value.empty() || end != std::size(value)) {
+        throw Alphadocte::InvalidArgException("Value of option --" + it->first + " must be a number, got \"" + value + "\".",
+                "Alphadocte::CLI::CommandLine::getDouble(std::string_view, double) const");
+    }
+
+    return result;
+}
+
+void CommandLine::checkOptions(const std::set<std::string, std::less<>>& allowedNames) const {
+    for (const auto& option : m_options) {
+        if (allowedNames.find(option.first) == std::cend(allowedNames)) {
+            throw Alphadocte::InvalidArgException("Unknown option --" + option.first + ".",
+                    "Alphadocte::CLI::CommandLine::checkOptions(const std::set<std::string, std::less<>>&) const");
+        }
+    }
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
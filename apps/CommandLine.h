@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: CommandLine.h
+ */
+
+#ifndef APPS_COMMANDLINE_H_
+#define APPS_COMMANDLINE_H_
+
+/*
+ * Private header used to parse the arguments of the non-interactive executables.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Alphadocte {
+
+namespace CLI {
+
+/*
+ * Arguments given to a non-interactive executable, either as options ("--name=value"),
+ * flags ("--name", ie an option without value) or positional arguments (anything else).
+ */
+class CommandLine {
+public:
+    /*
+     * Parse the arguments given to main.
+     *
+     * Throws :
+     * - InvalidArgException : if an option does not have a name (eg. "--=value").
+     */
+    CommandLine(int argc, const char* const argv[]);
+
+    // Default constructors/destructor
+    virtual ~CommandLine() = default;
+    CommandLine(const CommandLine &other) = default;
+    CommandLine(CommandLine &&other) = default;
+    CommandLine& operator=(const CommandLine &other) = default;
+    CommandLine& operator=(CommandLine &&other) = default;
+
+    // Getters
+    /*
+     * Return the name used to call the program (ie argv[0]).
+     */
+    const std::string& getProgramName() const;
+
+    /*
+     * Return the arguments which are neither options nor flags, in the order they were given.
+     */
+    const std::vector<std::string>& getPositionalArguments() const;
+
+    /*
+     * Return true if the option or flag has been given.
+     */
+    bool has(std::string_view name) const;
+
+    /*
+     * Return the value of the option, or the default value if it has not been given.
+     * A flag has an empty value.
+     */
+    std::string getString(std::string_view name, std::string defaultValue = {}) const;
+
+    /*
+     * Return the value of the option as a positive integer, or the default value if it has not been given.
+     *
+     * Throws :
+     * - InvalidArgException : if the value is not a positive integer.
+     */
+    unsigned long getUnsigned(std::string_view name, unsigned long defaultValue) const;
+
+    /*
+     * Return the value of the option as a real number, or the default value if it has not been given.
+     *
+     * Throws :
+     * - InvalidArgException : if the value is not a number.
+     */
+    double getDouble(std::string_view name, double defaultValue) const;
+
+    // Methods
+    /*
+     * Check that only known options and flags have been given.
+     *
+     * Throws :
+     * - InvalidArgException : if an option is not in the allowed names.
+     */
+    void checkOptions(const std::set<std::string, std::less<>>& allowedNames) const;
+
+private:
+    // Fields
+    std::string m_programName;
+    std::map<std::string, std::string, std::less<>> m_options;
+    std::vector<std::string> m_positionalArguments;
+};
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_COMMANDLINE_H_ */
@@ -23,10 +23,20 @@
 #include <chrono>
 #include <cstdlib>
 #include <iostream>
+#include <fstream>
 #include <sstream>
 #include <thread>
 
+#include <Alphadocte/EntropyMaximizer.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/FixedSizeDictionary.h>
+#include <Alphadocte/MotusGameRules.h>
+#include <Alphadocte/Trace.h>
+#include <Alphadocte/WordleGameRules.h>
+#include <Alphadocte/WorkloadRecorder.h>
+
 #include "Common.h"
+#include "Parallel.h"
 
 #ifdef ALPHADOCTE_OS_WINDOWS
 #include <windows.h>
@@ -122,6 +132,73 @@ RulesType chooseRules() {
     }
 }
 
+std::string_view getRulesName(RulesType rulesType) {
+    switch (rulesType) {
+    case RulesType::MOTUS:
+        return "motus";
+    case RulesType::WORDLE:
+        return "wordle";
+    default:
+        return "unknown";
+    }
+}
+
+RulesType parseRulesType(std::string_view name) {
+    std::string lowerName{name};
+    std::transform(std::begin(lowerName), std::end(lowerName), std::begin(lowerName), tolower);
+
+    for (RulesType rulesType : {RulesType::MOTUS, RulesType::WORDLE}) {
+        if (lowerName == getRulesName(rulesType))
+            return rulesType;
+    }
+
+    throw Alphadocte::InvalidArgException("Unknown rules " + std::string(name) + ", expected motus or wordle.",
+            "Alphadocte::CLI::parseRulesType(std::string_view)");
+}
+
+std::shared_ptr<IGameRules> createRules(RulesType rulesType, std::shared_ptr<Dictionary> dictionary, unsigned int maxGuesses) {
+    if (rulesType == RulesType::MOTUS) {
+        if (!dictionary->isLoaded() && !dictionary->load()) {
+            throw Alphadocte::Exception("Could not load the dictionary.",
+                    "Alphadocte::CLI::createRules(Alphadocte::CLI::RulesType, std::shared_ptr<Alphadocte::Dictionary>, unsigned int)");
+        }
+        return std::make_shared<MotusGameRules>(std::move(dictionary), maxGuesses);
+    } else if (rulesType == RulesType::WORDLE) {
+        auto wordleDict = std::make_shared<FixedSizeDictionary>(std::move(dictionary), ALPHADOCTE_WORDLE_DEFAULT_SIZE);
+        if (!wordleDict->load()) {
+            throw Alphadocte::Exception("Could not load the dictionary.",
+                    "Alphadocte::CLI::createRules(Alphadocte::CLI::RulesType, std::shared_ptr<Alphadocte::Dictionary>, unsigned int)");
+        }
+        return std::make_shared<WordleGameRules>(std::move(wordleDict), maxGuesses);
+    }
+
+    throw Alphadocte::InvalidArgException("Unknown rules.",
+            "Alphadocte::CLI::createRules(Alphadocte::CLI::RulesType, std::shared_ptr<Alphadocte::Dictionary>, unsigned int)");
+}
+
+std::unique_ptr<Solver> createSolver(std::string_view solverName, std::shared_ptr<IGameRules> rules,
+        unsigned int nbParallelSolvers) {
+    if (solverName == EntropyMaximizer::SOLVER_NAME) {
+        auto solver = std::make_unique<EntropyMaximizer>(std::move(rules));
+
+        // do not nest the threads of the solver in the threads of the caller
+        if (nbParallelSolvers > 1) {
+            auto tuning = solver->getTuning();
+            tuning.nbThreads = std::clamp(defaultThreadCount() / nbParallelSolvers, 1u, tuning.nbThreads);
+            solver->setTuning(tuning);
+        }
+
+        return solver;
+    }
+
+    throw Alphadocte::InvalidArgException("Unknown solver " + std::string(solverName) + '.',
+            "Alphadocte::CLI::createSolver(std::string_view, std::shared_ptr<Alphadocte::IGameRules>, unsigned int)");
+}
+
+std::map<std::string, unsigned int, std::less<>> getSolverVersions() {
+    return {{EntropyMaximizer::SOLVER_NAME, EntropyMaximizer::SOLVER_VERSION}};
+}
+
 std::string askWord(std::string_view prompt, bool emptyAllowed) {
     bool accepted{false};
     std::string word;
@@ -240,6 +317,29 @@ void printHints(std::string_view guess, const std::vector<HintType> hints, int p
     std::cout << colorReset << std::endl;
 }
 
+std::string formatHints(const std::vector<HintType>& hints) {
+    std::string formatted;
+    for (auto hint : hints) {
+        formatted.push_back(hint == HintType::CORRECT ? 'v' : (hint == HintType::MISPLACED ? 'o' : 'x'));
+    }
+
+    return formatted;
+}
+
+std::vector<HintType> parseHints(std::string_view hints) {
+    std::vector<HintType> parsed;
+    for (char c : hints) {
+        if (c != 'v' && c != 'o' && c != 'x') {
+            throw Alphadocte::InvalidArgException("Invalid hint " + std::string(1, c) + ", expected v, o or x.",
+                    "Alphadocte::CLI::parseHints(std::string_view)");
+        }
+
+        parsed.push_back(c == 'v' ? HintType::CORRECT : (c == 'o' ? HintType::MISPLACED : HintType::WRONG));
+    }
+
+    return parsed;
+}
+
 word_size askPositiveInteger(std::string_view prompt, word_size min, word_size max) {
     bool accepted{false};
     unsigned int number;
@@ -492,6 +592,96 @@ std::map<std::string, std::filesystem::path> getAvailableDictionaries() {
     return result;
 }
 
+std::filesystem::path findDictionary(std::string_view nameOrPath) {
+    std::string name{nameOrPath};
+    std::transform(std::begin(name), std::end(name), std::begin(name), toupper);
+
+    auto dictionaries = getAvailableDictionaries();
+    if (auto it = dictionaries.find(name); it != std::cend(dictionaries)) {
+        return it->second;
+    }
+
+    std::error_code error;
+    std::filesystem::path path{nameOrPath};
+    if (std::filesystem::is_regular_file(path, error) && !error) {
+        return std::filesystem::absolute(path);
+    }
+
+    return {};
+}
+
+std::string getDictionaryName(const std::filesystem::path& dictionaryPath) {
+    static const std::string WORDLIST_SUFFIX{"_wordlist"};
+    std::string stem = dictionaryPath.stem().string();
+
+    if (std::size(stem) > std::size(WORDLIST_SUFFIX)
+            && stem.compare(std::size(stem) - std::size(WORDLIST_SUFFIX), std::string::npos, WORDLIST_SUFFIX) == 0) {
+        stem.resize(std::size(stem) - std::size(WORDLIST_SUFFIX));
+    }
+
+    return stem;
+}
+
+std::filesystem::path getTextCachePath(const std::filesystem::path& dictionaryPath) {
+    return getCachePath() / getDictionaryName(dictionaryPath);
+}
+
+std::filesystem::path getBinaryCachePath(const std::filesystem::path& dictionaryPath, std::string_view solverName) {
+    return getCachePath() / (getDictionaryName(dictionaryPath) + '.' + std::string(solverName) + ".bin");
+}
+
+std::filesystem::path getTracePath() {
+    const char* envValue = std::getenv(TRACE_ENV_VAR.c_str());
+    return envValue == nullptr ? std::filesystem::path{} : std::filesystem::path{envValue};
+}
+
+std::filesystem::path getRecordPath() {
+    const char* envValue = std::getenv(RECORD_ENV_VAR.c_str());
+    return envValue == nullptr ? std::filesystem::path{} : std::filesystem::path{envValue};
+}
+
+std::shared_ptr<WorkloadRecorder> openRecorder(const std::filesystem::path& recordPath) {
+    if (recordPath.empty())
+        return nullptr;
+
+    try {
+        return std::make_shared<WorkloadRecorder>(recordPath);
+    } catch (const Alphadocte::Exception&) {
+        std::cerr << "Avertissement : impossible d'enregistrer les appels au solver dans " << recordPath.string() << std::endl;
+        return nullptr;
+    }
+}
+
+TraceRecording::TraceRecording(std::filesystem::path tracePath) : m_tracePath{std::move(tracePath)} {
+    if (m_tracePath.empty())
+        return;
+
+    if (!Tracer::isAvailable()) {
+        std::cerr << "Avertissement : traces indisponibles, la bibliothèque a été compilée sans ALPHADOCTE_TRACING." << std::endl;
+        m_tracePath.clear();
+        return;
+    }
+
+    Tracer::getGlobal().start();
+}
+
+TraceRecording::~TraceRecording() {
+    if (m_tracePath.empty())
+        return;
+
+    auto& tracer = Tracer::getGlobal();
+    tracer.stop();
+
+    std::ofstream file{m_tracePath};
+    if (file)
+        tracer.writeChromeTrace(file);
+
+    if (!file)
+        std::cerr << "Impossible d'écrire les traces dans " << m_tracePath.string() << std::endl;
+    else
+        std::cerr << tracer.getEventCount() << " événement(s) écrit(s) dans " << m_tracePath.string() << std::endl;
+}
+
 #ifdef ALPHADOCTE_OS_WINDOWS
 WinUtf8Terminal::WinUtf8Terminal() : m_originalCp{ GetConsoleOutputCP() } {
     SetConsoleOutputCP(CP_UTF8);
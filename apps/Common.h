@@ -30,6 +30,7 @@
 
 #include <Alphadocte/Hint.h>
 #include <filesystem>
+#include <functional>
 #include <limits>
 #include <map>
 #include <memory>
@@ -49,6 +50,9 @@ namespace Alphadocte {
 
 // forward declarations
 class Dictionary;
+class IGameRules;
+class Solver;
+class WorkloadRecorder;
 
 namespace CLI {
 
@@ -56,6 +60,8 @@ inline const std::string           APP_NAME{"alphadocte"};
 inline const std::string           DICTIONARY_SUFIX{"_wordlist.txt"};
 inline const std::filesystem::path DATA_LOCAL_DIR{"data"};
 inline const word_size             ALPHADOCTE_WORDLE_DEFAULT_SIZE{5};
+inline const std::string           TRACE_ENV_VAR{"ALPHADOCTE_TRACE"};
+inline const std::string           RECORD_ENV_VAR{"ALPHADOCTE_RECORD"};
 
 #if defined ALPHADOCTE_OS_LINUX
 inline const std::string XDG_DATA_ENV_VAR{"XDG_DATA_DIRS"};
@@ -138,6 +144,53 @@ std::filesystem::path chooseDictionary();
  */
 RulesType chooseRules();
 
+/*
+ * Return the name of the rules ("motus" or "wordle"), as accepted by parseRulesType.
+ */
+std::string_view getRulesName(RulesType rulesType);
+
+/*
+ * Return the rules type from its name (case insensitive), as returned by getRulesName.
+ *
+ * Throws :
+ * - InvalidArgException : if the name does not match any rules.
+ */
+RulesType parseRulesType(std::string_view name);
+
+/*
+ * Create the rules of the given type, loading the dictionary if needed.
+ * Wordle rules use the words of ALPHADOCTE_WORDLE_DEFAULT_SIZE letters of the dictionary.
+ *
+ * Args :
+ * - rulesType : the type of the rules
+ * - dictionary : the dictionary used by the rules
+ * - maxGuesses : maximum number of guesses for a game (0 means no limit)
+ *
+ * Throws :
+ * - Exception : if the dictionary cannot be loaded.
+ */
+std::shared_ptr<IGameRules> createRules(RulesType rulesType, std::shared_ptr<Dictionary> dictionary, unsigned int maxGuesses = 6);
+
+/*
+ * Create a solver from its name (see Solver::getSolverName()).
+ *
+ * Args :
+ * - solverName : the name of the solver, eg "entropy_maximizer"
+ * - rules : the rules given to the solver
+ * - nbParallelSolvers : number of solvers the caller runs in parallel, the threads of each solver
+ *   are capped so that they use at most one thread per core altogether
+ *
+ * Throws :
+ * - InvalidArgException : if no solver has this name.
+ */
+std::unique_ptr<Solver> createSolver(std::string_view solverName, std::shared_ptr<IGameRules> rules,
+        unsigned int nbParallelSolvers = 1);
+
+/*
+ * Return the current version of each solver which can be created by createSolver(), by solver name.
+ */
+std::map<std::string, unsigned int, std::less<>> getSolverVersions();
+
 /*
  * Print the hint in a pretty way to the stdout stream (supposed to be viewed in a terminal)
  * Can make a pause between each hint if asked.
@@ -148,6 +201,20 @@ RulesType chooseRules();
  */
 void printHints(std::string_view guess, const std::vector<HintType> hints, int pauseTime = 0.);
 
+/*
+ * Return the hints as typed by the user : one letter per hint,
+ * 'v' for a correct letter, 'o' for a misplaced one, and 'x' for a wrong one.
+ */
+std::string formatHints(const std::vector<HintType>& hints);
+
+/*
+ * Parse hints formatted by formatHints.
+ *
+ * Throws :
+ * - InvalidArgException : if a letter is not a hint.
+ */
+std::vector<HintType> parseHints(std::string_view hints);
+
 /*
  * Return a copy of the path to the application's (read-only) data folder.
  * Use the folder 'data' if present in the working directory,
@@ -194,6 +261,73 @@ std::filesystem::path getCachePath(bool forceRefreshCache = false);
  */
 std::map<std::string, std::filesystem::path> getAvailableDictionaries();
 
+/*
+ * Return the path to a dictionary given either by its name (case insensitive,
+ * see getAvailableDictionaries()) or by the path to its file.
+ * Return an empty path if no dictionary is found.
+ */
+std::filesystem::path findDictionary(std::string_view nameOrPath);
+
+/*
+ * Return the name of a dictionary given the path to its file,
+ * ie its filename without the '_wordlist' suffix nor the extension (eg. "fr" for fr_wordlist.txt).
+ */
+std::string getDictionaryName(const std::filesystem::path& dictionaryPath);
+
+/*
+ * Return the path of the text cache of a dictionary, inside the cache folder.
+ *
+ * Throws :
+ * - std::runtime_error : if the cache folder cannot be found, see getCachePath().
+ */
+std::filesystem::path getTextCachePath(const std::filesystem::path& dictionaryPath);
+
+/*
+ * Return the path of the binary cache of a dictionary for one solver, inside the cache folder.
+ *
+ * Throws :
+ * - std::runtime_error : if the cache folder cannot be found, see getCachePath().
+ */
+std::filesystem::path getBinaryCachePath(const std::filesystem::path& dictionaryPath, std::string_view solverName);
+
+/*
+ * Return the trace file given by the environment variable ALPHADOCTE_TRACE,
+ * or an empty path if it is not set.
+ */
+std::filesystem::path getTracePath();
+
+/*
+ * Return the workload file given by the environment variable ALPHADOCTE_RECORD,
+ * or an empty path if it is not set.
+ */
+std::filesystem::path getRecordPath();
+
+/*
+ * Open a recorder writing the workload of the solvers to the given file (see Solver::setRecorder()).
+ * Return nullptr if the path is empty, or if the file cannot be opened, after printing a warning.
+ */
+std::shared_ptr<WorkloadRecorder> openRecorder(const std::filesystem::path& recordPath);
+
+/*
+ * Record the trace events of the library from its creation to its destruction,
+ * then write them to a file in the Chrome trace format (see Alphadocte::Tracer).
+ * Nothing is recorded if the path is empty, and a warning is printed if the library
+ * was compiled without its trace events.
+ */
+class TraceRecording {
+public:
+    explicit TraceRecording(std::filesystem::path tracePath);
+    ~TraceRecording();
+
+    TraceRecording(const TraceRecording &other) = delete;
+    TraceRecording(TraceRecording &&other) = delete;
+    TraceRecording& operator=(const TraceRecording &other) = delete;
+    TraceRecording& operator=(TraceRecording &&other) = delete;
+
+private:
+    std::filesystem::path m_tracePath;
+};
+
 // Shortcut for hint coloring in the terminal
 template <typename CharT>
 inline std::basic_ostream<CharT>& colorCorrectLetter(std::basic_ostream<CharT>& stream) {
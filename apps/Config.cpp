@@ -20,28 +20,69 @@
  */
 
 #include <algorithm>
+#include <cctype>
 #include <fstream>
-#include <sstream>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 #include "Config.h"
 #include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Memory.h>
 
 namespace {
+/*
+ * Cursor over the lines of a buffer, and over the words of the current line.
+ * Lines and words are views into the buffer, nothing is copied.
+ */
+struct LineReader {
+    std::string_view buffer;
+    size_t nextLinePos{};
+    bool endReached{};
+    std::string_view line{};
+    size_t wordPos{};
+    unsigned int lineNo{};
+    std::string lookahead{}; // first word of the current line, in lowercase
+
+    /*
+     * Move to the next line, return false if the end of the buffer has been reached.
+     */
+    bool nextLine();
+
+    /*
+     * Return the next word of the current line, delimited by whitespaces, or an empty view.
+     */
+    std::string_view nextWord();
+};
+
 // parsing functions declarations
-Alphadocte::CLI::Section parse(std::istream& input);
-Alphadocte::CLI::Section parse_section(std::istream& input, const std::string& lookahead, std::istream& lineStream, unsigned int& lineNo);
-Alphadocte::CLI::Entry parse_entry(const std::string& lookahead, std::string lineRemaining, unsigned int lineNo);
+Alphadocte::CLI::Section parse(std::string_view buffer);
+Alphadocte::CLI::Section parse_section(LineReader& reader);
+Alphadocte::CLI::Entry parse_entry(const LineReader& reader);
 // write functions declarations
 void write_root(std::ostream& output, const Alphadocte::CLI::Section& rootSection);
 void write_section(std::ostream& output, const Alphadocte::CLI::Section& section);
 void write_entry(std::ostream& output, const Alphadocte::CLI::Entry& entry);
+// memory estimation
+size_t getSectionHeapSize(const Alphadocte::CLI::Section& section);
 }
 
 namespace Alphadocte {
 
 namespace CLI {
 
-Config::Config() : m_rootSection{"root", {}, {}} {}
+Config::Config() : m_rootSection{"root", {}, {}}, m_indexes{} {}
+
+Config::Config(const Config &other) : m_rootSection{other.m_rootSection}, m_indexes{} {}
+
+Config& Config::operator=(const Config &other) {
+    m_rootSection = other.m_rootSection;
+    m_indexes.clear();
+    return *this;
+}
 
 const Section& Config::getRootSection() const {
     return m_rootSection;
@@ -53,6 +94,26 @@ Section& Config::getRootSection() {
 
 void Config::setRootSection(Section root) {
     m_rootSection = std::move(root);
+    m_indexes.clear();
+}
+
+size_t Config::getRetainedBytes() const {
+    using Alphadocte::getHeapSize;
+
+    // map and hash map nodes: the value, plus the links to the other nodes (and the cached hash)
+    constexpr size_t mapNodeOverhead = 4 * sizeof(void*);
+    constexpr size_t hashNodeOverhead = sizeof(void*) + sizeof(size_t);
+
+    size_t size = getSectionHeapSize(m_rootSection);
+    for (const auto& [key, index] : m_indexes) {
+        size += sizeof(std::pair<const IndexKey, SectionIndex>) + mapNodeOverhead;
+        size += getHeapSize(std::get<1>(key)) + getHeapSize(std::get<2>(key));
+        size += index.positions.bucket_count() * sizeof(void*);
+        for (const auto& [value, position] : index.positions)
+            size += sizeof(std::pair<const std::string, size_t>) + hashNodeOverhead + getHeapSize(value);
+    }
+
+    return size;
 }
 
 // Methods
@@ -64,8 +125,23 @@ void Config::loadFromFile(const std::filesystem::path& filePath) {
                 "Alphadocte::CLI::Config::loadFromFile(const std::filesystem::path&)");
     }
 
-    std::ifstream fileStream{filePath};
-    setRootSection(parse(fileStream));
+    if (std::filesystem::file_size(filePath, error) == 0 && !error) {
+        // an empty file cannot be mapped
+        setRootSection(parse({}));
+        return;
+    }
+
+    boost::interprocess::mapped_region region;
+    try {
+        boost::interprocess::file_mapping file{filePath.string().c_str(), boost::interprocess::read_only};
+        region = boost::interprocess::mapped_region{file, boost::interprocess::read_only};
+        region.advise(boost::interprocess::mapped_region::advice_sequential);
+    } catch (const boost::interprocess::interprocess_exception& e) {
+        throw Alphadocte::Exception("IO error occurred while reading file " + filePath.string() + " : " + e.what(),
+                "Alphadocte::CLI::Config::loadFromFile(const std::filesystem::path&)");
+    }
+
+    setRootSection(parse(std::string_view{static_cast<const char*>(region.get_address()), region.get_size()}));
 }
 
 void Config::writeToFile(const std::filesystem::path& filePath) const {
@@ -88,6 +164,114 @@ void Config::writeToFile(const std::filesystem::path& filePath) const {
 void Config::clear() {
     m_rootSection.entries.clear();
     m_rootSection.sections.clear();
+    m_indexes.clear();
+}
+
+const Section* Config::findSection(const Section& parent, std::string_view sectionName,
+        std::string_view keyName, std::string_view keyValue) const {
+    // key of a section, ie the value of its first entry named keyName
+    auto getKey = [keyName](const Section& section) -> const std::string* {
+        auto it = std::find_if(std::cbegin(section.entries), std::cend(section.entries),
+                [keyName](const auto& entry) { return entry.name == keyName; });
+        return it != std::cend(section.entries) ? &it->value : nullptr;
+    };
+
+    auto indexIt = m_indexes.find(std::make_tuple(&parent, sectionName, keyName));
+    if (indexIt == std::end(m_indexes)) {
+        indexIt = m_indexes.emplace(IndexKey{&parent, sectionName, keyName}, SectionIndex{}).first;
+    }
+    auto& index = indexIt->second;
+
+    const auto& sections = parent.sections;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (index.indexedData != std::data(sections) || index.indexedSize > std::size(sections)) {
+            // sections have been reallocated or removed, index them again
+            index.positions.clear();
+            index.indexedData = std::data(sections);
+            index.indexedSize = 0;
+        }
+
+        // index appended sections, keeping the first one for each key
+        for (; index.indexedSize < std::size(sections); index.indexedSize++) {
+            const auto& section = sections[index.indexedSize];
+            if (section.name != sectionName)
+                continue;
+
+            if (const auto* key = getKey(section))
+                index.positions.emplace(*key, index.indexedSize);
+        }
+
+        auto it = index.positions.find(keyValue);
+        if (it == std::end(index.positions))
+            return nullptr;
+
+        const auto& section = sections[it->second];
+        const auto* key = getKey(section);
+        if (section.name == sectionName && key && *key == keyValue)
+            return &section;
+
+        // sections have been edited in place, index them again
+        index.indexedData = nullptr;
+    }
+
+    return nullptr;
+}
+
+Section* Config::findSection(Section& parent, std::string_view sectionName,
+        std::string_view keyName, std::string_view keyValue) {
+    // re-use code of const method
+    return const_cast<Section*>(std::as_const(*this).findSection(parent, sectionName, keyName, keyValue));
+}
+
+Section& Config::addSection(Section& parent, Section child) {
+    if (std::size(parent.sections) == parent.sections.capacity()) {
+        // children will be moved, their indexes refer to their current location
+        dropChildIndexes(parent, 0);
+    }
+
+    // indexes of parent follow appended sections
+    parent.sections.emplace_back(std::move(child));
+    return parent.sections.back();
+}
+
+void Config::removeSection(Section& parent, const Section& child) {
+    auto it = std::find_if(std::cbegin(parent.sections), std::cend(parent.sections),
+            [&child](const auto& section) { return &section == &child; });
+
+    if (it == std::cend(parent.sections)) {
+        throw Alphadocte::InvalidArgException("Section " + child.name + " is not a child of section " + parent.name + '.',
+                "Alphadocte::CLI::Config::removeSection(Alphadocte::CLI::Section&, const Alphadocte::CLI::Section&)");
+    }
+
+    // the removed section is destroyed, following children are moved, and their positions shifted
+    auto position = static_cast<size_t>(std::distance(std::cbegin(parent.sections), it));
+    dropSubtreeIndexes(*it);
+    dropChildIndexes(parent, position);
+    std::erase_if(m_indexes, [&parent](const auto& index) { return std::get<0>(index.first) == &parent; });
+
+    parent.sections.erase(it);
+}
+
+void Config::invalidateIndexes() {
+    m_indexes.clear();
+}
+
+void Config::dropChildIndexes(const Section& parent, size_t from) const {
+    const Section* first = std::data(parent.sections) + from;
+    const Section* last = std::data(parent.sections) + std::size(parent.sections);
+    std::less<const Section*> less;
+
+    std::erase_if(m_indexes, [first, last, less](const auto& index) {
+        const Section* indexedParent = std::get<0>(index.first);
+        return !less(indexedParent, first) && less(indexedParent, last);
+    });
+}
+
+void Config::dropSubtreeIndexes(const Section& section) const {
+    std::erase_if(m_indexes, [&section](const auto& index) { return std::get<0>(index.first) == &section; });
+
+    for (const auto& child : section.sections)
+        dropSubtreeIndexes(child);
 }
 
 bool operator==(const Entry& lhs, const Entry& rhs) {
@@ -98,6 +282,18 @@ bool operator==(const Section& lhs, const Section& rhs) {
     return lhs.name == rhs.name && lhs.entries == rhs.entries && rhs.sections == lhs.sections;
 }
 
+const Entry* findEntry(const Section& section, std::string_view name) {
+    auto it = std::find_if(std::cbegin(section.entries), std::cend(section.entries),
+            [name](const auto& entry) { return entry.name == name; });
+
+    return it == std::cend(section.entries) ? nullptr : &*it;
+}
+
+Entry* findEntry(Section& section, std::string_view name) {
+    // re-use code of const lookup
+    return const_cast<Entry*>(findEntry(std::as_const(section), name));
+}
+
 std::ostream& operator<<(std::ostream& os, const Entry& entry) {
     return os << entry.name << '=' << '"' << entry.value << '"';
 }
@@ -131,194 +327,159 @@ namespace {
 using namespace Alphadocte::CLI;
 using namespace std::string_literals;
 
-Section parse(std::istream& input) {
-    std::string lookahead, line;
-    std::istringstream iss;
-    Section root;
-    unsigned int lineNo{1};
+bool LineReader::nextLine() {
+    if (endReached)
+        return false;
+
+    size_t lineEnd = buffer.find(CHAR_NEW_LINE, nextLinePos);
+    if (lineEnd == buffer.npos) {
+        // last line, without line break
+        line = buffer.substr(nextLinePos);
+        endReached = true;
+    } else {
+        line = buffer.substr(nextLinePos, lineEnd - nextLinePos);
+        nextLinePos = lineEnd + 1;
+    }
 
-    root.name = "root";
-    while (input.good()) {
-        iss.clear();
-        lookahead.clear();
+    wordPos = 0;
+    lineNo++;
+
+    // first word is case insensitive
+    auto word = nextWord();
+    lookahead.assign(word);
+    std::transform(std::begin(lookahead), std::end(lookahead), std::begin(lookahead), tolower);
+
+    return true;
+}
 
-        std::getline(input, line);
-        iss.str(line);
-        iss >> lookahead;
+std::string_view LineReader::nextWord() {
+    auto isSpace = [](char c) { return std::isspace(static_cast<unsigned char>(c)); };
 
-        // ignore case for first word of line
-        std::transform(std::begin(lookahead), std::end(lookahead), std::begin(lookahead),tolower);
+    while (wordPos < std::size(line) && isSpace(line[wordPos]))
+        wordPos++;
+
+    size_t wordBegin = wordPos;
+    while (wordPos < std::size(line) && !isSpace(line[wordPos]))
+        wordPos++;
+
+    return line.substr(wordBegin, wordPos - wordBegin);
+}
+
+Section parse(std::string_view buffer) {
+    LineReader reader{buffer};
+    Section root;
+
+    root.name = "root";
+    while (reader.nextLine()) {
+        const auto& lookahead = reader.lookahead;
 
         if (lookahead.empty() || lookahead.front() == CHAR_COMMENT) {
             // Ignore empty or comment lines
-            lineNo++;
         } else if (lookahead == KW_BEGIN_SECTION) {
             // try to parse section
-            root.sections.emplace_back(parse_section(input, lookahead, iss, lineNo));
-            // lineNo is incremented by section parsing
+            root.sections.emplace_back(parse_section(reader));
         } else if (lookahead == KW_END_SECTION) {
-            throw Alphadocte::Exception("Line "s + std::to_string(lineNo) + ": got an end of section outside of a section.",
-                    "<anonymous>::parse(std::istream&)");
-        }
-        else {
+            throw Alphadocte::Exception("Line "s + std::to_string(reader.lineNo) + ": got an end of section outside of a section.",
+                    "<anonymous>::parse(std::string_view)");
+        } else {
             // Default : entry identifier
             // -> try to parse entry
-            auto streamPos = iss.tellg();
-
-            if (streamPos != decltype(iss)::pos_type(-1)) {
-                root.entries.emplace_back(parse_entry(lookahead, line.substr(streamPos), lineNo));
-            }
-            else {
-
-                throw Alphadocte::Exception("Line "s + std::to_string(lineNo) + ": key "s + lookahead + " must have a value associated."s,
-                        "<anonymous>::parse(std::istream&)");
-            }
-
-            lineNo++;
+            root.entries.emplace_back(parse_entry(reader));
         }
     }
 
-    if (input.bad()) {
-        throw Alphadocte::Exception("IO error occurred before reaching end of file.",
-                "<anonymous>::parse(std::istream&)");
-    }
-
     // empty file
     return root;
 }
 
-Section parse_section(std::istream& input, const std::string& lookahead, std::istream& lineStream, unsigned int& lineNo) {
+Section parse_section(LineReader& reader) {
     Section section;
-    unsigned int beginLine{lineNo};
+    unsigned int beginLine{reader.lineNo};
 
     // assume lookahead is KW_BEGIN_SECTION
 
-    if (lineStream.bad()) {
-        throw Alphadocte::Exception("IO error occurred while reading line "s + std::to_string(lineNo) + "."s,
-                "<anonymous>::parse_section(std::istream&, const std::string&, std::istream&, unsigned int&)");
-    }
-
     // Retrieve section name
-    lineStream >> section.name;
+    section.name = reader.nextWord();
 
-    if (lineStream.fail()) {
-        throw Alphadocte::Exception("Line "s + std::to_string(lineNo) + ": expected section name after "s + lookahead + ", got nothing."s,
-                "<anonymous>::parse_section(std::istream&, const std::string&, std::istream&, unsigned int&)");
+    if (section.name.empty()) {
+        throw Alphadocte::Exception("Line "s + std::to_string(reader.lineNo) + ": expected section name after "s + KW_BEGIN_SECTION + ", got nothing."s,
+                "<anonymous>::parse_section(<anonymous>::LineReader&)");
     }
 
     // Make sure nothing comes after section name
-    std::string discarded;
-    lineStream >> discarded;
+    auto discarded = reader.nextWord();
 
     if (!discarded.empty() && discarded.front() != CHAR_COMMENT) {
-        throw Alphadocte::Exception("Line "s + std::to_string(lineNo) + ": got "s + discarded + " after section name, expected nothing."s,
-                "<anonymous>::parse_section(std::istream&, const std::string&, std::istream&, unsigned int&)");
+        throw Alphadocte::Exception("Line "s + std::to_string(reader.lineNo) + ": got "s + std::string(discarded) + " after section name, expected nothing."s,
+                "<anonymous>::parse_section(<anonymous>::LineReader&)");
     }
-    lineNo++;
 
     // Parse section content
-    std::string line, lineLookahead;
-    std::istringstream iss;
-    bool endReached{false};
-    while (input.good()) {
-        iss.clear();
-        lineLookahead.clear();
-
-        std::getline(input, line);
-        iss.str(line);
-        iss >> lineLookahead;
-
-        // ignore case for first word of line
-        std::transform(std::begin(lineLookahead), std::end(lineLookahead), std::begin(lineLookahead), tolower);
+    while (reader.nextLine()) {
+        const auto& lineLookahead = reader.lookahead;
 
         if (lineLookahead.empty() || lineLookahead.front() == CHAR_COMMENT) {
             // Ignore empty or comment lines
-            lineNo++;
         } else if (lineLookahead == KW_END_SECTION) {
             // end current section
-            std::string endSectionName;
-
-            iss >> endSectionName;
+            auto endSectionName = reader.nextWord();
 
             if (endSectionName.empty() || endSectionName.front() == CHAR_COMMENT) {
-                throw Alphadocte::Exception("Line "s + std::to_string(lineNo) + ": missing section name after end."s,
-                        "<anonymous>::parse_section(std::istream&, const std::string&, std::istream&, unsigned int&)");
+                throw Alphadocte::Exception("Line "s + std::to_string(reader.lineNo) + ": missing section name after end."s,
+                        "<anonymous>::parse_section(<anonymous>::LineReader&)");
             } else if (endSectionName != section.name) {
-                throw Alphadocte::Exception("Line "s + std::to_string(lineNo) + ": ending section with a different name (got "s
-                        + endSectionName + ", expected "s + section.name + ")."s,
-                        "<anonymous>::parse_section(std::istream&, const std::string&, std::istream&, unsigned int&)");
+                throw Alphadocte::Exception("Line "s + std::to_string(reader.lineNo) + ": ending section with a different name (got "s
+                        + std::string(endSectionName) + ", expected "s + section.name + ")."s,
+                        "<anonymous>::parse_section(<anonymous>::LineReader&)");
             }
 
-            discarded.clear();
-            iss >> discarded;
+            discarded = reader.nextWord();
 
             if (!discarded.empty() && discarded.front() != CHAR_COMMENT) {
-                throw Alphadocte::Exception("Line "s + std::to_string(lineNo) + ": got "s + discarded + " after section name, expected nothing.",
-                        "<anonymous>::parse_section(std::istream&, const std::string&, std::istream&, unsigned int&)");
+                throw Alphadocte::Exception("Line "s + std::to_string(reader.lineNo) + ": got "s + std::string(discarded) + " after section name, expected nothing.",
+                        "<anonymous>::parse_section(<anonymous>::LineReader&)");
             }
 
-            endReached = true;
-            lineNo++;
-            break;
+            return section;
         } else if (lineLookahead == KW_BEGIN_SECTION) {
             // try to parse section
-            section.sections.emplace_back(parse_section(input, lineLookahead, iss, lineNo));
-            // lineNo is incremented by section parsing
+            section.sections.emplace_back(parse_section(reader));
         } else {
             // Default : entry identifier
             // -> try to parse entry
-            auto streamPos = iss.tellg();
-
-            if (streamPos != decltype(iss)::pos_type(-1)) {
-                section.entries.emplace_back(parse_entry(lineLookahead, line.substr(streamPos), lineNo));
-            }
-            else {
-                throw Alphadocte::Exception("Line "s + std::to_string(lineNo) + ": key "s + lineLookahead + " must have a value associated."s,
-                        "<anonymous>::parse_section(std::istream&, const std::string&, std::istream&, unsigned int&)");
-            }
-
-            lineNo++;
+            section.entries.emplace_back(parse_entry(reader));
         }
     }
 
-    if (input.bad()) {
-        throw Alphadocte::Exception("IO error occurred before reaching end of file."s,
-                "<anonymous>::parse_section(std::istream&, const std::string&, std::istream&, unsigned int&)");
-    } else if (!endReached) {
-        throw Alphadocte::Exception("Reached end of file without closing section "s + section.name + " begun at line "s + std::to_string(beginLine) + '.',
-                "<anonymous>::parse_section(std::istream&, const std::string&, std::istream&, unsigned int&)");
-    }
-
-    return section;
+    throw Alphadocte::Exception("Reached end of file without closing section "s + section.name + " begun at line "s + std::to_string(beginLine) + '.',
+            "<anonymous>::parse_section(<anonymous>::LineReader&)");
 }
 
-Entry parse_entry(const std::string& lookahead, std::string lineRemaining, unsigned int lineNo) {
-    Entry entry;
-
+Entry parse_entry(const LineReader& reader) {
     // assume lookahead is not a reserved keyword
-    entry.name = lookahead;
+    const auto& name = reader.lookahead;
+
+    // the value starts with the whitespace after the key
+    std::string_view lineRemaining = reader.line.substr(reader.wordPos);
 
-    auto commentIt = std::find(std::begin(lineRemaining), std::end(lineRemaining), CHAR_COMMENT);
+    auto commentPos = lineRemaining.find(CHAR_COMMENT);
 
-    if (commentIt != std::end(lineRemaining)) {
+    if (commentPos != lineRemaining.npos) {
         // ignore comment
-        lineRemaining.erase(commentIt, std::end(lineRemaining));
+        lineRemaining = lineRemaining.substr(0, commentPos);
     }
 
     if (std::size(lineRemaining) <= 1) {
-        throw Alphadocte::Exception("Line "s + std::to_string(lineNo) + ": key "s + entry.name + " must have a value associated."s,
-                "<anonymous>::parse_entry(const std::string&, std::string, unsigned int)");
+        throw Alphadocte::Exception("Line "s + std::to_string(reader.lineNo) + ": key "s + name + " must have a value associated."s,
+                "<anonymous>::parse_entry(const <anonymous>::LineReader&)");
     }
 
     if (!std::isblank(static_cast<unsigned char>(lineRemaining.front()))) {
-        throw Alphadocte::Exception("Line "s + std::to_string(lineNo) + ": key "s + entry.name + " must have a space after."s,
-                "<anonymous>::parse_entry(const std::string&, std::string, unsigned int)");
+        throw Alphadocte::Exception("Line "s + std::to_string(reader.lineNo) + ": key "s + name + " must have a space after."s,
+                "<anonymous>::parse_entry(const <anonymous>::LineReader&)");
     }
 
-    lineRemaining.erase(std::begin(lineRemaining));
-    entry.value = std::move(lineRemaining);
-
-    return entry;
+    return Entry{name, std::string(lineRemaining.substr(1))};
 }
 
 // write functions definitions
@@ -365,4 +526,19 @@ void write_entry(std::ostream& output, const Alphadocte::CLI::Entry& entry) {
     output << entry.name << CHAR_DEFAULT_WS << entry.value << CHAR_NEW_LINE;
 }
 
+size_t getSectionHeapSize(const Alphadocte::CLI::Section& section) {
+    using Alphadocte::getHeapSize;
+
+    size_t size = getHeapSize(section.name);
+    size += section.entries.capacity() * sizeof(Alphadocte::CLI::Entry);
+    for (const auto& entry : section.entries)
+        size += getHeapSize(entry.name) + getHeapSize(entry.value);
+
+    size += section.sections.capacity() * sizeof(Alphadocte::CLI::Section);
+    for (const auto& child : section.sections)
+        size += getSectionHeapSize(child);
+
+    return size;
+}
+
 }
@@ -22,9 +22,15 @@
 #ifndef APPS_CONFIG_H_
 #define APPS_CONFIG_H_
 
+#include <cstddef>
 #include <filesystem>
+#include <functional>
+#include <map>
 #include <ostream>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace Alphadocte {
@@ -62,6 +68,12 @@ bool operator==(const Section& lhs, const Section& rhs);
 std::ostream& operator<<(std::ostream& os, const Entry& entry);
 std::ostream& operator<<(std::ostream& os, const Section& section);
 
+/*
+ * Return the first entry of the section with the given name, or nullptr if there is none.
+ */
+const Entry* findEntry(const Section& section, std::string_view name);
+Entry* findEntry(Section& section, std::string_view name);
+
 /*
  * Config file keeping values in a tree-like objects,
  * where nodes are called 'sections' and leaves 'entries'.
@@ -75,16 +87,18 @@ std::ostream& operator<<(std::ostream& os, const Section& section);
  * Thus, a value cannot contain a line break, as this is not needed
  * for this application.
  *
+ * Child sections can be looked up by name and by the value of a key entry
+ * in constant time, see findSection.
  */
 class Config {
 public:
     Config();
 
-    // Default constructors/destructor
+    // Indexes refer to the sections of one config, they are not copied
     virtual ~Config() = default;
-    Config(const Config &other) = default;
+    Config(const Config &other);
     Config(Config &&other) = default;
-    Config& operator=(const Config &other) = default;
+    Config& operator=(const Config &other);
     Config& operator=(Config &&other) = default;
 
     // Getters/setters
@@ -105,6 +119,12 @@ public:
      */
     void setRootSection(Section root);
 
+    /*
+     * Return an estimate of the memory retained by the config on the heap, in bytes:
+     * its sections and entries, and the section indexes built so far.
+     */
+    size_t getRetainedBytes() const;
+
     // Methods
     /*
      * Read the configuration from the given path.
@@ -135,9 +155,87 @@ public:
      */
     void clear();
 
+    /*
+     * Return the first child section of parent with the given name, whose first entry named keyName
+     * has the value keyValue, or nullptr if there is none.
+     *
+     * The children of parent are indexed on the first lookup for a (section name, key name) pair,
+     * next lookups take a constant time. The index stays valid when sections are added or removed
+     * with addSection and removeSection, or appended directly to parent. After any other direct edit
+     * of the sections of parent, or of their key entries, invalidateIndexes must be called.
+     *
+     * Args :
+     * - parent : the root section, or one of its descendants
+     * - sectionName : name of the section to find
+     * - keyName : name of the entry identifying the section
+     * - keyValue : value of this entry
+     */
+    const Section* findSection(const Section& parent, std::string_view sectionName,
+            std::string_view keyName, std::string_view keyValue) const;
+    Section* findSection(Section& parent, std::string_view sectionName,
+            std::string_view keyName, std::string_view keyValue);
+
+    /*
+     * Append a child section to parent, and return a reference to it.
+     *
+     * Args :
+     * - parent : the root section, or one of its descendants
+     * - child : the section to add
+     */
+    Section& addSection(Section& parent, Section child);
+
+    /*
+     * Remove a child section from parent.
+     *
+     * Args :
+     * - parent : the root section, or one of its descendants
+     * - child : a reference to the section to remove, inside parent
+     *
+     * Throws :
+     * - InvalidArgException : if child is not a child section of parent.
+     */
+    void removeSection(Section& parent, const Section& child);
+
+    /*
+     * Drop all section indexes, they will be rebuilt on the next lookups.
+     */
+    void invalidateIndexes();
+
 private:
+    // Private types
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+    };
+
+    /*
+     * Positions of the children of a section, by value of their key entry.
+     * The buffer and the number of indexed children are kept to detect reallocations and appends.
+     */
+    struct SectionIndex {
+        const Section* indexedData{};
+        size_t indexedSize{};
+        std::unordered_map<std::string, size_t, StringHash, std::equal_to<>> positions{};
+    };
+
+    // (parent section, section name, key name)
+    using IndexKey = std::tuple<const Section*, std::string, std::string>;
+
+    // Private methods
+    /*
+     * Drop the indexes of the children of parent, from the given position,
+     * before these children are moved.
+     */
+    void dropChildIndexes(const Section& parent, size_t from) const;
+
+    /*
+     * Drop the indexes of a section and all its descendants, before it is destroyed.
+     */
+    void dropSubtreeIndexes(const Section& section) const;
+
     // Fields
     Section m_rootSection;
+    mutable std::map<IndexKey, SectionIndex, std::less<>> m_indexes;
 };
 
 } /* namespace CLI */
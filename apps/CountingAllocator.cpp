@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: CountingAllocator.cpp
+ */
+
+/*
+ * Replacement of the global operator new and delete, counting the allocations of the executable
+ * (and of the library it uses) in the AllocationTracker of the library, by phase.
+ *
+ * It is only compiled in the executables when ALPHADOCTE_COUNT_ALLOCATIONS is enabled,
+ * since every allocation pays for a header and a few atomic operations.
+ * Over-aligned allocations (std::align_val_t) keep the default operators and are not counted.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <Alphadocte/Memory.h>
+
+using Alphadocte::AllocationTracker;
+using Alphadocte::MemoryPhase;
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+// Stored before each block, its size keeps the block aligned as malloc would
+struct alignas(std::max_align_t) BlockHeader {
+    size_t size;
+    MemoryPhase phase;
+};
+
+void* allocate(size_t size) noexcept {
+    auto* header = static_cast<BlockHeader*>(std::malloc(sizeof(BlockHeader) + (size == 0 ? 1 : size)));
+    if (!header)
+        return nullptr;
+
+    header->size = size;
+    header->phase = AllocationTracker::getCurrentPhase();
+    AllocationTracker::recordAllocation(size, header->phase);
+    return header + 1;
+}
+
+void deallocate(void* ptr) noexcept {
+    if (!ptr)
+        return;
+
+    auto* header = static_cast<BlockHeader*>(ptr) - 1;
+    AllocationTracker::recordDeallocation(header->size, header->phase);
+    std::free(header);
+}
+
+void* allocateOrThrow(size_t size) {
+    void* ptr = allocate(size);
+    while (!ptr) {
+        // give the new handler a chance to free some memory, as the default operator new does
+        auto handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+
+        handler();
+        ptr = allocate(size);
+    }
+
+    return ptr;
+}
+
+// Publish the allocations as soon as the executable starts
+const bool countingEnabled = (AllocationTracker::enable(), true);
+
+}
+
+void* operator new(size_t size) {
+    return allocateOrThrow(size);
+}
+
+void* operator new[](size_t size) {
+    return allocateOrThrow(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocateOrThrow(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocateOrThrow(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* ptr) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    deallocate(ptr);
+}
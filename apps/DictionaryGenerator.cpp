@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: DictionaryGenerator.cpp
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <unordered_set>
+
+#include <boost/random/bernoulli_distribution.hpp>
+#include <boost/random/discrete_distribution.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Hint.h>
+
+#include "DictionaryGenerator.h"
+
+namespace Alphadocte {
+
+namespace CLI {
+
+// give up when this many words in a row were already generated
+static const size_t MAX_CONSECUTIVE_DUPLICATES = 10000;
+
+std::map<word_size, double> parseLengthWeights(std::string_view lengths) {
+    static const char* const FUNCTION_NAME = "Alphadocte::CLI::parseLengthWeights(std::string_view)";
+    std::map<word_size, double> weights;
+
+    auto parseLength = [](std::string_view str) {
+        unsigned long length{};
+        auto [ptr, error] = std::from_chars(str.data(), str.data() + std::size(str), length);
+        if (error != std::errc{} || ptr != str.data() + std::size(str) || length == 0 || length > MAX_PACKED_HINTS) {
+            throw InvalidArgException("Invalid word length " + std::string(str) + '.', FUNCTION_NAME);
+        }
+        return static_cast<word_size>(length);
+    };
+
+    while (!lengths.empty()) {
+        auto itemEnd = lengths.find(',');
+        std::string_view item = lengths.substr(0, itemEnd);
+        lengths = itemEnd == std::string_view::npos ? std::string_view{} : lengths.substr(itemEnd + 1);
+
+        double weight{1.};
+        if (auto colon = item.find(':'); colon != std::string_view::npos) {
+            try {
+                size_t end{};
+                std::string weightStr{item.substr(colon + 1)};
+                weight = std::stod(weightStr, &end);
+                if (end != std::size(weightStr))
+                    throw std::invalid_argument("trailing characters");
+            } catch (const std::logic_error&) {
+                throw InvalidArgException("Invalid weight in " + std::string(item) + '.', FUNCTION_NAME);
+            }
+            item = item.substr(0, colon);
+        }
+
+        if (!(weight >= 0)) {
+            throw InvalidArgException("Weights cannot be negative.", FUNCTION_NAME);
+        }
+
+        word_size first{}, last{};
+        if (auto dash = item.find('-'); dash != std::string_view::npos) {
+            first = parseLength(item.substr(0, dash));
+            last = parseLength(item.substr(dash + 1));
+        } else {
+            first = last = parseLength(item);
+        }
+
+        for (word_size length = first; length <= last; length++) {
+            weights[length] = weight;
+        }
+    }
+
+    if (weights.empty()) {
+        throw InvalidArgException("No word length given.", FUNCTION_NAME);
+    }
+
+    return weights;
+}
+
+std::vector<std::string> generateWords(const GeneratorOptions& options) {
+    static const char* const FUNCTION_NAME = "Alphadocte::CLI::generateWords(const Alphadocte::CLI::GeneratorOptions&)";
+
+    if (!(options.duplicateRate >= 0 && options.duplicateRate <= 1)) {
+        throw InvalidArgException("The duplicate letter rate must be in [0, 1].", FUNCTION_NAME);
+    }
+
+    if (!(options.letterSkew >= 0)) {
+        throw InvalidArgException("The letter skew cannot be negative.", FUNCTION_NAME);
+    }
+
+    std::vector<word_size> lengths;
+    std::vector<double> lengthWeights;
+    for (const auto& [length, weight] : options.lengthWeights) {
+        if (!(weight >= 0) || length == 0) {
+            throw InvalidArgException("Invalid length distribution.", FUNCTION_NAME);
+        }
+
+        if (weight > 0) {
+            lengths.push_back(length);
+            lengthWeights.push_back(weight);
+        }
+    }
+
+    if (lengths.empty() && options.nbWords > 0) {
+        throw InvalidArgException("At least one word length must have a positive weight.", FUNCTION_NAME);
+    }
+
+    std::vector<double> letterWeights;
+    for (size_t rank = 1; rank <= std::size(LETTERS_BY_FREQUENCY); rank++) {
+        letterWeights.push_back(1. / std::pow(static_cast<double>(rank), options.letterSkew));
+    }
+
+    boost::mt19937 random(static_cast<boost::mt19937::result_type>(options.seed));
+    boost::random::discrete_distribution<size_t> lengthDistribution(lengthWeights);
+    boost::random::discrete_distribution<size_t> letterDistribution(letterWeights);
+    boost::random::bernoulli_distribution<double> duplicateDistribution(options.duplicateRate);
+
+    std::unordered_set<std::string> words;
+    words.reserve(options.nbWords);
+    std::string word;
+    size_t consecutiveDuplicates{};
+
+    while (std::size(words) < options.nbWords) {
+        word.resize(lengths[lengthDistribution(random)]);
+
+        for (size_t i = 0; i < std::size(word); i++) {
+            if (i > 0 && duplicateDistribution(random)) {
+                boost::random::uniform_int_distribution<size_t> previous{0, i - 1};
+                word[i] = word[previous(random)];
+            } else {
+                word[i] = LETTERS_BY_FREQUENCY[letterDistribution(random)];
+            }
+        }
+
+        if (words.insert(word).second) {
+            consecutiveDuplicates = 0;
+        } else if (++consecutiveDuplicates >= MAX_CONSECUTIVE_DUPLICATES) {
+            throw Exception("Cannot generate " + std::to_string(options.nbWords) + " distinct words, only "
+                    + std::to_string(std::size(words)) + " found with the given lengths and letters distribution.",
+                    FUNCTION_NAME);
+        }
+    }
+
+    std::vector<std::string> sortedWords(std::begin(words), std::end(words));
+    std::sort(std::begin(sortedWords), std::end(sortedWords));
+
+    return sortedWords;
+}
+
+void writeTxtDictionary(std::ostream& os, const std::vector<std::string>& words) {
+    for (const auto& word : words) {
+        os << word << '\n';
+    }
+    os.flush();
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: DictionaryGenerator.h
+ */
+
+#ifndef APPS_DICTIONARYGENERATOR_H_
+#define APPS_DICTIONARYGENERATOR_H_
+
+/*
+ * Private header used to generate synthetic dictionaries, in order to
+ * measure how the library scales with the size of the dictionary.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Alphadocte/Alphadocte.h>
+
+namespace Alphadocte {
+
+namespace CLI {
+
+// letters sorted by decreasing frequency (in english), used to skew the letter distribution
+inline const std::string_view LETTERS_BY_FREQUENCY{"etaoinshrdlcumwfgypbvkjxqz"};
+
+/*
+ * Parameters of a synthetic dictionary.
+ */
+struct GeneratorOptions {
+    unsigned long seed{42};                             // the same options always generate the same words
+    size_t nbWords{10000};                              // number of distinct words
+    std::map<word_size, double> lengthWeights{{5, 1.}}; // relative probability of each word length
+    double letterSkew{1.};                              // the k-th most frequent letter has a weight 1/k^skew,
+                                                        // ie 0 gives uniform letters
+    double duplicateRate{0.};                           // probability for each letter (but the first)
+                                                        // to repeat a letter already in the word
+};
+
+/*
+ * Parse a length distribution, given as a comma separated list of lengths or ranges of lengths,
+ * with an optional weight (1 by default), eg. "5", "4-9" or "5:2,6-8:1.5".
+ * Lengths are limited to MAX_PACKED_HINTS, so that generated words can be used by every game engine.
+ *
+ * Throws :
+ * - InvalidArgException : if the distribution cannot be parsed, or if a length or weight is invalid.
+ */
+std::map<word_size, double> parseLengthWeights(std::string_view lengths);
+
+/*
+ * Generate sorted distinct words in lower case, according to the options.
+ *
+ * Throws :
+ * - InvalidArgException : if an option is invalid (eg. negative weight or rate not in [0, 1]).
+ * - Exception : if the requested number of distinct words cannot be reached
+ *               (too many words for the allowed lengths).
+ */
+std::vector<std::string> generateWords(const GeneratorOptions& options);
+
+/*
+ * Write the words in the format read by TxtDictionary, ie one word per line.
+ */
+void writeTxtDictionary(std::ostream& os, const std::vector<std::string>& words);
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_DICTIONARYGENERATOR_H_ */
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: GenDictCLI.cpp
+ */
+
+#include <fstream>
+#include <iostream>
+
+#include <Alphadocte/Alphadocte.h>
+#include <Alphadocte/Exceptions.h>
+
+#include "CommandLine.h"
+#include "DictionaryGenerator.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+void printUsage(std::string_view programName);
+
+int main(int argc, char* argv[]) {
+    try {
+        CommandLine args{argc, argv};
+        args.checkOptions({"help", "seed", "count", "lengths", "skew", "duplicate-rate", "format", "output"});
+
+        if (args.has("help")) {
+            printUsage(args.getProgramName());
+            return 0;
+        }
+
+        std::string format = args.getString("format", "txt");
+        if (format != "txt") {
+            throw InvalidArgException("Unknown format " + format + ", only txt is supported.", "main(int, char*[])");
+        }
+
+        GeneratorOptions options;
+        options.seed = args.getUnsigned("seed", options.seed);
+        options.nbWords = args.getUnsigned("count", options.nbWords);
+        if (args.has("lengths"))
+            options.lengthWeights = parseLengthWeights(args.getString("lengths"));
+        options.letterSkew = args.getDouble("skew", options.letterSkew);
+        options.duplicateRate = args.getDouble("duplicate-rate", options.duplicateRate);
+
+        auto words = generateWords(options);
+
+        if (args.has("output")) {
+            std::ofstream file{args.getString("output")};
+            if (!file) {
+                std::cerr << "Impossible d'écrire dans " << args.getString("output") << std::endl;
+                return 1;
+            }
+            writeTxtDictionary(file, words);
+        } else {
+            writeTxtDictionary(std::cout, words);
+        }
+    } catch (const Exception& e) {
+        std::cerr << "Erreur : " << e.what() << std::endl;
+        std::cerr << "Voir --help pour l'utilisation." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+void printUsage(std::string_view programName) {
+    std::cout << "Alphadocte v" << ALPHADOCTE_VERSION_NAME << " : génération de dictionnaires synthétiques reproductibles." << std::endl;
+    std::cout << std::endl;
+    std::cout << "Utilisation : " << programName << " [options]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options :" << std::endl;
+    std::cout << "  --seed=N             graine du générateur (42 par défaut)" << std::endl;
+    std::cout << "  --count=N            nombre de mots distincts (10000 par défaut)" << std::endl;
+    std::cout << "  --lengths=LISTE      distribution des longueurs, ex: 5, 4-9 ou 5:2,6-8:1.5 (5 par défaut)" << std::endl;
+    std::cout << "  --skew=X             biais des fréquences de lettres, la k-ième lettre la plus fréquente" << std::endl;
+    std::cout << "                       a un poids 1/k^X, 0 pour des lettres uniformes (1 par défaut)" << std::endl;
+    std::cout << "  --duplicate-rate=X   probabilité qu'une lettre répète une lettre précédente du mot (0 par défaut)" << std::endl;
+    std::cout << "  --format=txt         format du dictionnaire (txt, seul format disponible)" << std::endl;
+    std::cout << "  --output=CHEMIN      écrire le dictionnaire dans un fichier plutôt que sur la sortie standard" << std::endl;
+}
@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Json.cpp
+ */
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+
+#include <Alphadocte/Exceptions.h>
+
+#include "Json.h"
+
+namespace Alphadocte {
+
+namespace CLI {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+/*
+ * Cursor over the text of a JSON object.
+ */
+class JsonReader {
+public:
+    explicit JsonReader(std::string_view text) : m_text{text}, m_position{} {}
+
+    void skipSpaces() {
+        while (m_position < std::size(m_text) && (m_text[m_position] == ' ' || m_text[m_position] == '\t'
+                || m_text[m_position] == '\n' || m_text[m_position] == '\r'))
+            m_position++;
+    }
+
+    bool atEnd() const {
+        return m_position >= std::size(m_text);
+    }
+
+    char peek() const {
+        return atEnd() ? '\0' : m_text[m_position];
+    }
+
+    void expect(char c) {
+        if (peek() != c)
+            fail(std::string("expected '") + c + '\'');
+        m_position++;
+    }
+
+    bool consume(std::string_view word) {
+        if (m_text.substr(m_position, std::size(word)) != word)
+            return false;
+        m_position += std::size(word);
+        return true;
+    }
+
+    std::string readString() {
+        expect('"');
+        std::string str;
+
+        while (true) {
+            if (atEnd())
+                fail("unterminated string");
+
+            char c = m_text[m_position++];
+            if (c == '"')
+                return str;
+            if (static_cast<unsigned char>(c) < 0x20)
+                fail("control character in string");
+            if (c != '\\') {
+                str.push_back(c);
+                continue;
+            }
+
+            if (atEnd())
+                fail("unterminated string");
+            c = m_text[m_position++];
+            switch (c) {
+            case '"': str.push_back('"'); break;
+            case '\\': str.push_back('\\'); break;
+            case '/': str.push_back('/'); break;
+            case 'b': str.push_back('\b'); break;
+            case 'f': str.push_back('\f'); break;
+            case 'n': str.push_back('\n'); break;
+            case 'r': str.push_back('\r'); break;
+            case 't': str.push_back('\t'); break;
+            case 'u': appendCodePoint(str, readCodePoint()); break;
+            default: fail("invalid escape sequence");
+            }
+        }
+    }
+
+    std::string readNumber() {
+        auto start = m_position;
+        if (peek() == '-')
+            m_position++;
+        while (!atEnd() && ((peek() >= '0' && peek() <= '9') || peek() == '.' || peek() == 'e' || peek() == 'E'
+                || peek() == '+' || peek() == '-'))
+            m_position++;
+
+        std::string number{m_text.substr(start, m_position - start)};
+        double value{};
+        auto [end, error] = std::from_chars(number.data(), number.data() + std::size(number), value);
+        if (number.empty() || error != std::errc{} || end != number.data() + std::size(number))
+            fail("invalid number");
+
+        return number;
+    }
+
+    [[noreturn]] void fail(const std::string& reason) const {
+        throw Alphadocte::InvalidArgException("Invalid JSON object : " + reason + " at position "
+                + std::to_string(m_position) + '.', "Alphadocte::CLI::parseJsonObject(std::string_view)");
+    }
+
+private:
+    std::uint32_t readHexQuad() {
+        if (std::size(m_text) - m_position < 4)
+            fail("invalid unicode escape");
+
+        std::uint32_t value{};
+        auto [end, error] = std::from_chars(m_text.data() + m_position, m_text.data() + m_position + 4, value, 16);
+        if (error != std::errc{} || end != m_text.data() + m_position + 4)
+            fail("invalid unicode escape");
+        m_position += 4;
+
+        return value;
+    }
+
+    std::uint32_t readCodePoint() {
+        auto codePoint = readHexQuad();
+        if (codePoint < 0xD800 || codePoint > 0xDBFF)
+            return codePoint;
+
+        // high surrogate, followed by the low one
+        if (!consume("\\u"))
+            fail("unpaired surrogate");
+        auto low = readHexQuad();
+        if (low < 0xDC00 || low > 0xDFFF)
+            fail("unpaired surrogate");
+
+        return 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+    }
+
+    static void appendCodePoint(std::string& str, std::uint32_t codePoint) {
+        // UTF-8 encoding
+        if (codePoint < 0x80) {
+            str.push_back(static_cast<char>(codePoint));
+        } else if (codePoint < 0x800) {
+            str.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+            str.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else if (codePoint < 0x10000) {
+            str.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+            str.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            str.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else {
+            str.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+            str.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+            str.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            str.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+
+    std::string_view m_text;
+    size_t m_position;
+};
+
+}
+
+std::string quoteJson(std::string_view str) {
+    std::string quoted;
+    quoted.reserve(std::size(str) + 2);
+    quoted.push_back('"');
+
+    for (char c : str) {
+        switch (c) {
+        case '"':
+            quoted += "\\\"";
+            break;
+        case '\\':
+            quoted += "\\\\";
+            break;
+        case '\n':
+            quoted += "\\n";
+            break;
+        case '\r':
+            quoted += "\\r";
+            break;
+        case '\t':
+            quoted += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                // other control characters
+                char buffer[7];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned int>(c));
+                quoted += buffer;
+            } else {
+                quoted.push_back(c);
+            }
+            break;
+        }
+    }
+
+    quoted.push_back('"');
+    return quoted;
+}
+
+bool operator==(const JsonValue& lhs, const JsonValue& rhs) {
+    return lhs.type == rhs.type && lhs.text == rhs.text;
+}
+
+JsonObject parseJsonObject(std::string_view text) {
+    JsonReader reader{text};
+    JsonObject object;
+
+    reader.skipSpaces();
+    reader.expect('{');
+    reader.skipSpaces();
+
+    if (reader.peek() == '}') {
+        reader.expect('}');
+    } else {
+        while (true) {
+            reader.skipSpaces();
+            auto name = reader.readString();
+            reader.skipSpaces();
+            reader.expect(':');
+            reader.skipSpaces();
+
+            JsonValue value;
+            char c = reader.peek();
+            if (c == '"') {
+                value = JsonValue{JsonValue::Type::STRING, reader.readString()};
+            } else if (c == '-' || (c >= '0' && c <= '9')) {
+                value = JsonValue{JsonValue::Type::NUMBER, reader.readNumber()};
+            } else if (reader.consume("true")) {
+                value = JsonValue{JsonValue::Type::BOOLEAN, "true"};
+            } else if (reader.consume("false")) {
+                value = JsonValue{JsonValue::Type::BOOLEAN, "false"};
+            } else if (reader.consume("null")) {
+                value = JsonValue{JsonValue::Type::NULL_VALUE, "null"};
+            } else {
+                reader.fail("expected a string, a number, a boolean or null");
+            }
+            object.insert_or_assign(std::move(name), std::move(value));
+
+            reader.skipSpaces();
+            if (reader.peek() == ',') {
+                reader.expect(',');
+                continue;
+            }
+
+            reader.expect('}');
+            break;
+        }
+    }
+
+    reader.skipSpaces();
+    if (!reader.atEnd())
+        reader.fail("unexpected characters after the object");
+
+    return object;
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Json.h
+ */
+
+#ifndef APPS_JSON_H_
+#define APPS_JSON_H_
+
+/*
+ * Private header providing helpers to write JSON documents, and to read flat JSON objects.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace Alphadocte {
+
+namespace CLI {
+
+/*
+ * Return the given string as a JSON string literal, ie quoted and escaped.
+ */
+std::string quoteJson(std::string_view str);
+
+/*
+ * Value of a member of a flat JSON object.
+ */
+struct JsonValue {
+    enum class Type {
+        STRING,
+        NUMBER,
+        BOOLEAN,
+        NULL_VALUE
+    };
+
+    Type type{Type::NULL_VALUE};
+    std::string text; // the unescaped string, or the number, boolean or null as written
+};
+
+bool operator==(const JsonValue& lhs, const JsonValue& rhs);
+
+using JsonObject = std::map<std::string, JsonValue, std::less<>>;
+
+/*
+ * Parse a flat JSON object, whose members are strings, numbers, booleans or null,
+ * such as a request line. Nested objects and arrays are rejected.
+ * When a member is repeated, the last value is kept.
+ *
+ * Throws :
+ * - InvalidArgException : if the text is not such an object.
+ */
+JsonObject parseJsonObject(std::string_view text);
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_JSON_H_ */
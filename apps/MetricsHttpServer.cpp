@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: MetricsHttpServer.cpp
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Metrics.h>
+
+#include "CommandLine.h"
+#include "MetricsHttpServer.h"
+
+namespace Alphadocte {
+
+namespace CLI {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+// Content type of the Prometheus text format
+const std::string METRICS_CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8";
+
+std::string makeResponse(std::string_view status, std::string_view contentType, std::string_view body) {
+    std::string response = "HTTP/1.1 ";
+    response += status;
+    response += "\r\nContent-Type: ";
+    response += contentType;
+    response += "\r\nContent-Length: " + std::to_string(std::size(body)) + "\r\nConnection: close\r\n\r\n";
+    response += body;
+    return response;
+}
+
+/*
+ * Send the whole buffer, return false if the client disconnected.
+ */
+bool sendAll(int socket, std::string_view data) {
+    while (!data.empty()) {
+        auto sent = ::send(socket, data.data(), std::size(data), MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            return false;
+
+        data.remove_prefix(static_cast<size_t>(sent));
+    }
+
+    return true;
+}
+
+}
+
+MetricsHttpServer::MetricsHttpServer(std::uint16_t port, MetricsRegistry* registry)
+        : m_registry{registry ? *registry : MetricsRegistry::getGlobal()},
+          m_listenSocket{-1}, m_stopPipe{-1, -1}, m_port{port}, m_thread{} {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int reuse = 1;
+    socklen_t addressSize = sizeof(address);
+    m_listenSocket = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listenSocket < 0
+            || ::setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0
+            || ::bind(m_listenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+            || ::listen(m_listenSocket, SOMAXCONN) != 0
+            || ::getsockname(m_listenSocket, reinterpret_cast<sockaddr*>(&address), &addressSize) != 0
+            || ::pipe2(m_stopPipe, O_CLOEXEC) != 0) {
+        std::string reason = std::strerror(errno);
+        if (m_listenSocket >= 0)
+            ::close(m_listenSocket);
+        throw Alphadocte::Exception("Could not listen on port " + std::to_string(port) + " : " + reason,
+                "Alphadocte::CLI::MetricsHttpServer::MetricsHttpServer(std::uint16_t, Alphadocte::MetricsRegistry*)");
+    }
+
+    m_port = ntohs(address.sin_port);
+    m_thread = std::thread{[this]() { run(); }};
+}
+
+MetricsHttpServer::~MetricsHttpServer() {
+    char stopByte = 0;
+    while (::write(m_stopPipe[1], &stopByte, 1) < 0 && errno == EINTR) {}
+    m_thread.join();
+
+    ::close(m_listenSocket);
+    ::close(m_stopPipe[0]);
+    ::close(m_stopPipe[1]);
+}
+
+std::uint16_t MetricsHttpServer::getPort() const {
+    return m_port;
+}
+
+void MetricsHttpServer::run() {
+    pollfd fds[2] = {{m_listenSocket, POLLIN, 0}, {m_stopPipe[0], POLLIN, 0}};
+    while (true) {
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+
+        if (fds[1].revents != 0)
+            return;
+
+        int client = ::accept4(m_listenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0)
+            continue;
+
+        // a slow client cannot hold the server for long
+        timeval timeout{1, 0};
+        ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        answer(client);
+        ::close(client);
+    }
+}
+
+void MetricsHttpServer::answer(int socket) {
+    // read the request line and headers, the body of a GET request is ignored
+    std::string request;
+    while (request.find("\r\n\r\n") == request.npos) {
+        if (std::size(request) > MAX_REQUEST_SIZE) {
+            sendAll(socket, makeResponse("431 Request Header Fields Too Large", "text/plain", "Request too large\n"));
+            return;
+        }
+
+        char chunk[1024];
+        auto received = ::recv(socket, chunk, sizeof(chunk), 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            return;
+
+        request.append(chunk, static_cast<size_t>(received));
+    }
+
+    std::string_view requestLine{request.data(), request.find("\r\n")};
+    auto methodEnd = requestLine.find(' ');
+    auto targetEnd = methodEnd == requestLine.npos ? requestLine.npos : requestLine.find(' ', methodEnd + 1);
+    if (targetEnd == requestLine.npos) {
+        sendAll(socket, makeResponse("400 Bad Request", "text/plain", "Bad request\n"));
+        return;
+    }
+
+    auto method = requestLine.substr(0, methodEnd);
+    auto target = requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+    target = target.substr(0, target.find('?'));
+    if (target != "/metrics") {
+        sendAll(socket, makeResponse("404 Not Found", "text/plain", "Metrics are served on /metrics\n"));
+    } else if (method != "GET" && method != "HEAD") {
+        sendAll(socket, makeResponse("405 Method Not Allowed", "text/plain", "Method not allowed\n"));
+    } else {
+        auto response = makeResponse("200 OK", METRICS_CONTENT_TYPE, m_registry.formatPrometheus());
+        if (method == "HEAD")
+            response.erase(response.find("\r\n\r\n") + 4);
+
+        sendAll(socket, response);
+    }
+}
+
+std::unique_ptr<MetricsHttpServer> startMetricsServer(const CommandLine& args) {
+    if (!args.has("metrics-port"))
+        return nullptr;
+
+    auto port = args.getUnsigned("metrics-port", 0);
+    if (port > UINT16_MAX) {
+        throw Alphadocte::InvalidArgException("Invalid port " + std::to_string(port) + '.',
+                "Alphadocte::CLI::startMetricsServer(const Alphadocte::CLI::CommandLine&)");
+    }
+
+    auto server = std::make_unique<MetricsHttpServer>(static_cast<std::uint16_t>(port));
+    std::clog << "Métriques disponibles sur http://127.0.0.1:" << server->getPort() << "/metrics" << std::endl;
+    return server;
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
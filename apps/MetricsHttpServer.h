@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: MetricsHttpServer.h
+ */
+
+#ifndef APPS_METRICSHTTPSERVER_H_
+#define APPS_METRICSHTTPSERVER_H_
+
+/*
+ * Private header serving metrics over HTTP (POSIX only).
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace Alphadocte {
+
+class MetricsRegistry;
+
+namespace CLI {
+
+class CommandLine;
+
+/*
+ * Minimal HTTP server exposing a metrics registry in the Prometheus text format on GET /metrics.
+ * It only listens on the loopback interface, and serves one request per connection,
+ * from a background thread running from construction to destruction.
+ */
+class MetricsHttpServer {
+public:
+    /*
+     * Listen on a local port, and start serving.
+     *
+     * Args :
+     * - port : TCP port on 127.0.0.1, or 0 to pick a free port (see getPort())
+     * - registry : the metrics served, the global registry by default
+     *
+     * Throws :
+     * - Exception : if the port cannot be listened to.
+     */
+    explicit MetricsHttpServer(std::uint16_t port, MetricsRegistry* registry = nullptr);
+
+    // The thread works on the server, which can be neither copied nor moved
+    virtual ~MetricsHttpServer();
+    MetricsHttpServer(const MetricsHttpServer &other) = delete;
+    MetricsHttpServer(MetricsHttpServer &&other) = delete;
+    MetricsHttpServer& operator=(const MetricsHttpServer &other) = delete;
+    MetricsHttpServer& operator=(MetricsHttpServer &&other) = delete;
+
+    // Getters
+    /*
+     * Return the port listened to.
+     */
+    std::uint16_t getPort() const;
+
+private:
+    // Private methods
+    /*
+     * Accept and answer connections until the server is destroyed.
+     */
+    void run();
+
+    /*
+     * Read a request from a connection, and answer it.
+     */
+    void answer(int socket);
+
+    // Fields
+    MetricsRegistry& m_registry;
+    int m_listenSocket;
+    int m_stopPipe[2];
+    std::uint16_t m_port;
+    std::thread m_thread;
+
+    // Static constants
+public:
+    // longer request headers are rejected
+    static constexpr size_t MAX_REQUEST_SIZE = 8192;
+};
+
+/*
+ * Serve the global registry on the port given by the --metrics-port option, if any,
+ * and print its address on the standard log, which is not mixed with reports. Return nullptr if the option is missing.
+ *
+ * Throws :
+ * - InvalidArgException : if the port is invalid.
+ * - Exception : if the port cannot be listened to.
+ */
+std::unique_ptr<MetricsHttpServer> startMetricsServer(const CommandLine& args);
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_METRICSHTTPSERVER_H_ */
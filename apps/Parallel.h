@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Parallel.h
+ */
+
+#ifndef APPS_PARALLEL_H_
+#define APPS_PARALLEL_H_
+
+/*
+ * Private header providing a simple way to spread work across threads.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Alphadocte {
+
+namespace CLI {
+
+/*
+ * Return the number of threads to use by default, ie the number of cores (at least 1).
+ */
+inline unsigned int defaultThreadCount() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/*
+ * Call task(index, threadIndex) for each index in [0, n), using up to nbThreads threads.
+ * Indices are handed out dynamically, so that tasks of uneven durations are balanced.
+ *
+ * If a task throws, the remaining indices are skipped and
+ * the first exception is rethrown once all threads have stopped.
+ *
+ * Args :
+ * - n : number of tasks
+ * - nbThreads : maximum number of threads (0 means defaultThreadCount())
+ * - task : function called as task(size_t index, unsigned int threadIndex)
+ */
+template<typename Task>
+void parallelFor(size_t n, unsigned int nbThreads, Task&& task) {
+    if (nbThreads == 0)
+        nbThreads = defaultThreadCount();
+
+    nbThreads = static_cast<unsigned int>(std::min<size_t>(nbThreads, std::max<size_t>(n, 1)));
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto worker = [&](unsigned int threadIndex) {
+        for (size_t i = next++; i < n && !failed; i = next++) {
+            try {
+                task(i, threadIndex);
+            } catch (...) {
+                std::lock_guard lock{errorMutex};
+                if (!error)
+                    error = std::current_exception();
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < nbThreads; t++) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0); // current thread also works
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_PARALLEL_H_ */
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: PerfCounters.cpp
+ */
+
+#include <cerrno>
+#include <cstring>
+
+#include <Alphadocte/Alphadocte.h>
+#if defined ALPHADOCTE_OS_LINUX
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "PerfCounters.h"
+
+namespace Alphadocte {
+
+namespace CLI {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+#if defined ALPHADOCTE_OS_LINUX
+const std::array<std::uint64_t, NB_PERF_EVENTS> EVENT_CONFIGS{
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+/*
+ * Open a hardware counter of the calling thread, return -1 and set errno on failure.
+ */
+int openCounter(std::uint64_t config) {
+    perf_event_attr attributes{};
+    attributes.size = sizeof(attributes);
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.config = config;
+    attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attributes.inherit = 1;        // count the worker threads as well
+    attributes.exclude_kernel = 1; // allowed with perf_event_paranoid up to 2
+    attributes.exclude_hv = 1;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+#endif
+
+}
+
+// PerfCounts
+std::optional<double> PerfCounts::get(PerfEvent event) const {
+    return counts[static_cast<size_t>(event)];
+}
+
+std::optional<double> PerfCounts::getIpc() const {
+    auto cycles = get(PerfEvent::CYCLES);
+    auto instructions = get(PerfEvent::INSTRUCTIONS);
+    if (!cycles || !instructions || *cycles <= 0)
+        return std::nullopt;
+
+    return *instructions / *cycles;
+}
+
+PerfCounts PerfCounts::divide(double nbUnits) const {
+    PerfCounts result;
+    if (nbUnits <= 0)
+        return result;
+
+    for (size_t i = 0; i < NB_PERF_EVENTS; i++) {
+        if (counts[i])
+            result.counts[i] = *counts[i] / nbUnits;
+    }
+
+    return result;
+}
+
+void PerfCounts::add(const PerfCounts& other) {
+    for (size_t i = 0; i < NB_PERF_EVENTS; i++) {
+        if (other.counts[i])
+            counts[i] = counts[i].value_or(0) + *other.counts[i];
+    }
+}
+
+bool PerfCounts::hasCounts() const {
+    for (const auto& count : counts) {
+        if (count)
+            return true;
+    }
+
+    return false;
+}
+
+// PerfCounters
+PerfCounters::PerfCounters() : m_fds{}, m_startReadings{}, m_unavailableReason{} {
+    m_fds.fill(-1);
+
+#if defined ALPHADOCTE_OS_LINUX
+    for (size_t i = 0; i < NB_PERF_EVENTS; i++) {
+        m_fds[i] = openCounter(EVENT_CONFIGS[i]);
+        if (m_fds[i] < 0 && m_unavailableReason.empty()) {
+            m_unavailableReason = std::string(getEventName(static_cast<PerfEvent>(i))) + " : " + std::strerror(errno);
+            if (errno == EACCES || errno == EPERM)
+                m_unavailableReason += " (voir /proc/sys/kernel/perf_event_paranoid)";
+            else if (errno == ENOENT || errno == EOPNOTSUPP)
+                m_unavailableReason += " (compteur non fourni par le processeur ou la machine virtuelle)";
+        }
+    }
+#else
+    m_unavailableReason = "compteurs matériels disponibles sur Linux uniquement";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#if defined ALPHADOCTE_OS_LINUX
+    for (int fd : m_fds) {
+        if (fd >= 0)
+            close(fd);
+    }
+#endif
+}
+
+bool PerfCounters::isAvailable() const {
+    for (int fd : m_fds) {
+        if (fd >= 0)
+            return true;
+    }
+
+    return false;
+}
+
+const std::string& PerfCounters::getUnavailableReason() const {
+    return m_unavailableReason;
+}
+
+std::string_view PerfCounters::getEventName(PerfEvent event) {
+    switch (event) {
+    case PerfEvent::CYCLES:
+        return "cycles";
+    case PerfEvent::INSTRUCTIONS:
+        return "instructions";
+    case PerfEvent::CACHE_MISSES:
+        return "cache_misses";
+    default:
+        return "branch_misses";
+    }
+}
+
+void PerfCounters::start() {
+    // the counters of the threads which exited are added to the parent counters and cannot be reset,
+    // so the region is measured as a difference between two readings
+    for (size_t i = 0; i < NB_PERF_EVENTS; i++) {
+        m_startReadings[i] = readCounter(i);
+    }
+}
+
+PerfCounts PerfCounters::getCounts() const {
+    PerfCounts result;
+
+    for (size_t i = 0; i < NB_PERF_EVENTS; i++) {
+        auto reading = readCounter(i);
+        const auto& startReading = m_startReadings[i];
+        if (!reading || !startReading)
+            continue;
+
+        double value = static_cast<double>(reading->value - startReading->value);
+        auto timeEnabled = reading->timeEnabled - startReading->timeEnabled;
+        auto timeRunning = reading->timeRunning - startReading->timeRunning;
+
+        // the kernel shares the hardware counters when there are too many events, extrapolate the count
+        if (timeRunning == 0) {
+            if (timeEnabled > 0)
+                continue; // the counter never ran during the region
+
+            value = 0;
+        } else if (timeRunning < timeEnabled) {
+            value *= static_cast<double>(timeEnabled) / static_cast<double>(timeRunning);
+        }
+
+        result.counts[i] = value;
+    }
+
+    return result;
+}
+
+std::optional<PerfCounters::Reading> PerfCounters::readCounter(size_t event) const {
+#if defined ALPHADOCTE_OS_LINUX
+    if (m_fds[event] < 0)
+        return std::nullopt;
+
+    // value, time enabled and time running, as requested by the read format
+    std::uint64_t values[3]{};
+    if (::read(m_fds[event], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)))
+        return std::nullopt;
+
+    return Reading{values[0], values[1], values[2]};
+#else
+    static_cast<void>(event);
+    return std::nullopt;
+#endif
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
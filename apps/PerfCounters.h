@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: PerfCounters.h
+ */
+
+#ifndef APPS_PERFCOUNTERS_H_
+#define APPS_PERFCOUNTERS_H_
+
+/*
+ * Private header providing hardware performance counters (Linux perf_event_open),
+ * used by the benchmark executables to tell compute-bound from memory-bound code.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Alphadocte {
+
+namespace CLI {
+
+/*
+ * Hardware events counted by PerfCounters.
+ */
+enum class PerfEvent {
+    CYCLES,
+    INSTRUCTIONS,
+    CACHE_MISSES,
+    BRANCH_MISSES
+};
+
+inline constexpr size_t NB_PERF_EVENTS = 4;
+
+/*
+ * Counts of the hardware events over a measured region.
+ * An event has no count if its counter is unavailable.
+ */
+struct PerfCounts {
+    std::array<std::optional<double>, NB_PERF_EVENTS> counts{};
+
+    /*
+     * Return the count of an event, or nothing if it is unavailable.
+     */
+    std::optional<double> get(PerfEvent event) const;
+
+    /*
+     * Return the number of instructions per cycle, or nothing if either is unavailable.
+     */
+    std::optional<double> getIpc() const;
+
+    /*
+     * Return the counts divided by the given number of units (eg operations),
+     * or unavailable counts if there is no unit.
+     */
+    PerfCounts divide(double nbUnits) const;
+
+    /*
+     * Add the counts of another region, an event is unavailable only if it is in both.
+     */
+    void add(const PerfCounts& other);
+
+    /*
+     * Return true if at least one event was counted.
+     */
+    bool hasCounts() const;
+};
+
+/*
+ * Hardware counters of the calling thread, and of the threads it creates while they are open.
+ *
+ * Counters the system does not provide (eg virtual machines, containers, a restrictive
+ * /proc/sys/kernel/perf_event_paranoid, or another OS than Linux) are simply unavailable,
+ * see getUnavailableReason(). User space only is counted.
+ */
+class PerfCounters {
+public:
+    // Constructors
+    /*
+     * Open the counters of the calling thread.
+     */
+    PerfCounters();
+
+    // Counters are file descriptors owned by this object
+    virtual ~PerfCounters();
+    PerfCounters(const PerfCounters &other) = delete;
+    PerfCounters(PerfCounters &&other) = delete;
+    PerfCounters& operator=(const PerfCounters &other) = delete;
+    PerfCounters& operator=(PerfCounters &&other) = delete;
+
+    // Getters/Setters
+    /*
+     * Return true if at least one counter could be opened.
+     */
+    bool isAvailable() const;
+
+    /*
+     * Return why the first unavailable counter could not be opened, or an empty string.
+     */
+    const std::string& getUnavailableReason() const;
+
+    /*
+     * Return the name of an event, as used in the reports, eg "cache_misses".
+     */
+    static std::string_view getEventName(PerfEvent event);
+
+    // Methods
+    /*
+     * Start measuring a region.
+     */
+    void start();
+
+    /*
+     * Return the counts since the last call to start(), scaled if the kernel had to multiplex the counters.
+     * The counters keep running, they can be read several times for the same region.
+     */
+    PerfCounts getCounts() const;
+
+private:
+    struct Reading {
+        std::uint64_t value{};
+        std::uint64_t timeEnabled{};
+        std::uint64_t timeRunning{};
+    };
+
+    // Private methods
+    std::optional<Reading> readCounter(size_t event) const;
+
+    // Fields
+    std::array<int, NB_PERF_EVENTS> m_fds;
+    std::array<std::optional<Reading>, NB_PERF_EVENTS> m_startReadings;
+    std::string m_unavailableReason;
+};
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_PERFCOUNTERS_H_ */
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: ReplayCLI.cpp
+ */
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <tuple>
+
+#include <Alphadocte/Alphadocte.h>
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/IGameRules.h>
+#include <Alphadocte/TxtDictionary.h>
+
+#include "CommandLine.h"
+#include "Common.h"
+#include "Json.h"
+#include "Statistics.h"
+#include "TuningProfile.h"
+#include "WorkloadReplay.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+void printUsage(std::string_view programName);
+RulesProvider findRecordedRules(std::vector<std::filesystem::path> dictionaryPaths);
+void writeText(std::ostream& os, const std::filesystem::path& workloadPath, const ReplayOptions& options, const ReplayResult& result);
+void writeJson(std::ostream& os, const std::filesystem::path& workloadPath, const ReplayOptions& options, const ReplayResult& result);
+std::string joinGuesses(const std::vector<std::string>& guesses);
+
+int main(int argc, char* argv[]) {
+    try {
+        CommandLine args{argc, argv};
+        args.checkOptions({"help", "dictionary", "repetitions", "compare", "format", "output"});
+
+        if (args.has("help")) {
+            printUsage(args.getProgramName());
+            return 0;
+        }
+
+        // the solvers use the tuning chosen for this machine, see the tune command of alphadocte-cache
+        loadTuning();
+
+        const auto& positional = args.getPositionalArguments();
+        if (std::size(positional) != 1) {
+            throw InvalidArgException("Expected exactly one workload file.", "main(int, char*[])");
+        }
+        std::filesystem::path workloadPath = positional.front();
+
+        std::string format = args.getString("format", "text");
+        if (format != "text" && format != "json") {
+            throw InvalidArgException("Unknown format " + format + ", expected text or json.", "main(int, char*[])");
+        }
+
+        ReplayOptions options;
+        options.repetitions = static_cast<unsigned int>(args.getUnsigned("repetitions", options.repetitions));
+        options.compare = args.has("compare");
+
+        // the recorded dictionaries are recognized by their content
+        std::vector<std::filesystem::path> dictionaryPaths;
+        if (args.has("dictionary")) {
+            auto dictionaryPath = findDictionary(args.getString("dictionary"));
+            if (dictionaryPath.empty()) {
+                std::cerr << "Dictionnaire introuvable : " << args.getString("dictionary") << std::endl;
+                return 1;
+            }
+            dictionaryPaths.push_back(std::move(dictionaryPath));
+        } else {
+            for (auto& [name, path] : getAvailableDictionaries())
+                dictionaryPaths.push_back(std::move(path));
+        }
+
+        auto games = loadWorkload(workloadPath);
+        std::cerr << "Rejeu de " << std::size(games) << " partie(s)..." << std::endl;
+        auto result = replayWorkload(games, findRecordedRules(std::move(dictionaryPaths)), options);
+
+        std::ofstream file;
+        if (args.has("output")) {
+            file.open(args.getString("output"));
+            if (!file) {
+                std::cerr << "Impossible d'écrire dans " << args.getString("output") << std::endl;
+                return 1;
+            }
+        }
+        std::ostream& output = args.has("output") ? file : std::cout;
+
+        if (format == "json") {
+            writeJson(output, workloadPath, options, result);
+        } else {
+            writeText(output, workloadPath, options, result);
+        }
+
+        if (!result.mismatches.empty()) {
+            std::cerr << "Les essais rejoués diffèrent des essais enregistrés." << std::endl;
+            return 2;
+        }
+    } catch (const Exception& e) {
+        std::cerr << "Erreur : " << e.what() << std::endl;
+        std::cerr << "Voir --help pour l'utilisation." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+void printUsage(std::string_view programName) {
+    std::cout << "Alphadocte v" << ALPHADOCTE_VERSION_NAME << " : rejeu des appels enregistrés aux solvers." << std::endl;
+    std::cout << std::endl;
+    std::cout << "Utilisation : " << programName << " FICHIER [options]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Le fichier est enregistré par alphadocte-solver, alphadocte-bench ou alphadocte-solverd" << std::endl;
+    std::cout << "(variable d'environnement " << RECORD_ENV_VAR << " ou option --record)." << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options :" << std::endl;
+    std::cout << "  --dictionary=NOM|CHEMIN  dictionnaire des parties (reconnu parmi les dictionnaires installés par défaut)" << std::endl;
+    std::cout << "  --repetitions=N          nombre de rejeux de l'ensemble des parties (1 par défaut)" << std::endl;
+    std::cout << "  --compare                comparer les essais calculés aux essais enregistrés, et échouer" << std::endl;
+    std::cout << "                           (code 2) s'ils diffèrent" << std::endl;
+    std::cout << "  --format=text|json       format du rapport (text par défaut)" << std::endl;
+    std::cout << "  --output=CHEMIN          écrire le rapport dans un fichier plutôt que sur la sortie standard" << std::endl;
+}
+
+RulesProvider findRecordedRules(std::vector<std::filesystem::path> dictionaryPaths) {
+    // dictionaries are loaded on demand, and rules created once per dictionary, rules type and maximum number of guesses
+    auto dictionaries = std::make_shared<std::map<std::filesystem::path, std::shared_ptr<Dictionary>>>();
+    auto rulesCache = std::make_shared<std::map<std::tuple<std::filesystem::path, std::string, unsigned int>, std::shared_ptr<IGameRules>>>();
+
+    return [dictionaryPaths = std::move(dictionaryPaths), dictionaries, rulesCache](const RecordedGame& game) {
+        std::shared_ptr<IGameRules> found;
+        if (game.rules != getRulesName(RulesType::MOTUS) && game.rules != getRulesName(RulesType::WORDLE))
+            return found;
+
+        auto rulesType = parseRulesType(game.rules);
+        for (const auto& path : dictionaryPaths) {
+            auto& rules = (*rulesCache)[{path, game.rules, game.maxGuesses}];
+            if (!rules) {
+                auto& dictionary = (*dictionaries)[path];
+                if (!dictionary)
+                    dictionary = std::make_shared<TxtDictionary>(path);
+
+                try {
+                    rules = createRules(rulesType, dictionary, game.maxGuesses);
+                } catch (const Exception&) {
+                    continue; // unreadable dictionary, try the next ones
+                }
+            }
+
+            if (rules->getDictionary()->getContentHash() == game.contentHash)
+                return rules;
+        }
+
+        return found;
+    };
+}
+
+void writeText(std::ostream& os, const std::filesystem::path& workloadPath, const ReplayOptions& options, const ReplayResult& result) {
+    auto durations = summarize(result.computeDurations);
+
+    os << std::fixed << std::setprecision(3);
+    os << "Enregistrement     : " << workloadPath.string() << std::endl;
+    os << "Parties rejouées   : " << result.nbGames << std::endl;
+    os << "Parties ignorées   : " << result.nbSkippedGames << " (dictionnaire ou règles introuvables)" << std::endl;
+    os << "Calculs            : " << result.nbComputations << " par rejeu, " << options.repetitions << " rejeu(x)" << std::endl;
+    os << std::endl;
+    os << "Durée enregistrée  : " << result.recordedDuration << " s" << std::endl;
+    os << "Durée rejouée      : " << result.replayedDuration << " s (moyenne des rejeux)";
+    if (result.recordedDuration > 0)
+        os << ", soit " << result.replayedDuration / result.recordedDuration << " fois la durée enregistrée";
+    os << std::endl;
+    os << "Durée d'un calcul  : moyenne " << durations.mean * 1e3 << " ms, p50 " << durations.p50 * 1e3
+       << " ms, p95 " << durations.p95 * 1e3 << " ms, max " << durations.max * 1e3 << " ms" << std::endl;
+
+    if (!options.compare)
+        return;
+
+    os << std::endl;
+    os << "Différences        : " << std::size(result.mismatches) << std::endl;
+    for (const auto& mismatch : result.mismatches) {
+        os << "  partie " << mismatch.gameId << ", appel " << mismatch.step << " : " << joinGuesses(mismatch.expected)
+           << " enregistré, " << joinGuesses(mismatch.actual) << " rejoué" << std::endl;
+    }
+}
+
+void writeJson(std::ostream& os, const std::filesystem::path& workloadPath, const ReplayOptions& options, const ReplayResult& result) {
+    auto durations = summarize(result.computeDurations);
+
+    os << std::setprecision(9);
+    os << "{\n";
+    os << "  \"workload\": " << quoteJson(workloadPath.string()) << ",\n";
+    os << "  \"games\": " << result.nbGames << ",\n";
+    os << "  \"skipped_games\": " << result.nbSkippedGames << ",\n";
+    os << "  \"computations\": " << result.nbComputations << ",\n";
+    os << "  \"repetitions\": " << options.repetitions << ",\n";
+    os << "  \"recorded_s\": " << result.recordedDuration << ",\n";
+    os << "  \"replayed_s\": " << result.replayedDuration << ",\n";
+    os << "  \"compute_ms\": {\"count\": " << durations.count
+       << ", \"mean\": " << durations.mean * 1e3
+       << ", \"p50\": " << durations.p50 * 1e3
+       << ", \"p95\": " << durations.p95 * 1e3
+       << ", \"p99\": " << durations.p99 * 1e3
+       << ", \"max\": " << durations.max * 1e3 << "},\n";
+    os << "  \"compared\": " << (options.compare ? "true" : "false") << ",\n";
+    os << "  \"mismatches\": [";
+    for (size_t i = 0; i < std::size(result.mismatches); i++) {
+        const auto& mismatch = result.mismatches[i];
+        os << (i > 0 ? ", " : "") << "{\"game\": " << mismatch.gameId << ", \"step\": " << mismatch.step
+           << ", \"expected\": " << quoteJson(joinGuesses(mismatch.expected))
+           << ", \"actual\": " << quoteJson(joinGuesses(mismatch.actual)) << "}";
+    }
+    os << "]\n";
+    os << "}" << std::endl;
+}
+
+std::string joinGuesses(const std::vector<std::string>& guesses) {
+    if (guesses.empty())
+        return "-";
+
+    std::string joined;
+    for (const auto& guess : guesses)
+        joined += (joined.empty() ? "" : ",") + guess;
+
+    return joined;
+}
@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: SessionManager.cpp
+ */
+
+#include <algorithm>
+#include <iterator>
+
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/IGameRules.h>
+#include <Alphadocte/Memory.h>
+#include <Alphadocte/Solver.h>
+
+#include "Common.h"
+#include "SessionManager.h"
+
+namespace Alphadocte {
+
+namespace CLI {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+/*
+ * Return the next word of a state, and move the state past it.
+ */
+std::string_view nextWord(std::string_view& state) {
+    auto end = state.find(' ');
+    auto word = state.substr(0, end);
+    state.remove_prefix(end == state.npos ? std::size(state) : end + 1);
+    return word;
+}
+
+}
+
+SessionManager::SessionManager(SolverFactory solverFactory, size_t memoryBudget)
+        : m_solverFactory{std::move(solverFactory)}, m_memoryBudget{memoryBudget}, m_sessions{}, m_usage{},
+          m_nextSessionId{1}, m_residentSize{}, m_stateSize{}, m_mutex{} {
+    if (!m_solverFactory) {
+        throw Alphadocte::InvalidArgException("The solver factory cannot be empty.",
+                "Alphadocte::CLI::SessionManager::SessionManager(Alphadocte::CLI::SessionManager::SolverFactory, size_t)");
+    }
+}
+
+size_t SessionManager::getMemoryBudget() const {
+    return m_memoryBudget;
+}
+
+size_t SessionManager::getSessionCount() const {
+    std::lock_guard lock{m_mutex};
+    return std::size(m_sessions);
+}
+
+size_t SessionManager::getResidentSessionCount() const {
+    std::lock_guard lock{m_mutex};
+    return std::size(m_usage);
+}
+
+size_t SessionManager::getMemoryUsage() const {
+    std::lock_guard lock{m_mutex};
+    return m_residentSize + m_stateSize;
+}
+
+std::optional<SessionInfo> SessionManager::findSessionInfo(std::uint64_t sessionId) const {
+    std::lock_guard lock{m_mutex};
+    auto found = m_sessions.find(sessionId);
+    if (found == m_sessions.end())
+        return std::nullopt;
+
+    const auto& session = *found->second;
+    return SessionInfo{sessionId, session.usage != m_usage.end(), session.solverSize + session.stateSize};
+}
+
+std::vector<SessionInfo> SessionManager::getSessionInfos() const {
+    std::vector<SessionInfo> infos;
+    {
+        std::lock_guard lock{m_mutex};
+        infos.reserve(std::size(m_sessions));
+        for (const auto& [sessionId, session] : m_sessions)
+            infos.push_back(SessionInfo{sessionId, session->usage != m_usage.end(), session->solverSize + session->stateSize});
+    }
+
+    std::sort(std::begin(infos), std::end(infos), [](const auto& lhs, const auto& rhs) { return lhs.id < rhs.id; });
+    return infos;
+}
+
+std::uint64_t SessionManager::createSession(std::shared_ptr<IGameRules> rules, std::string templateWord) {
+    auto session = std::make_shared<Session>();
+    session->rules = std::move(rules);
+    session->solver = m_solverFactory(session->rules);
+    session->solver->setTemplate(std::move(templateWord));
+    session->state = session->solver->getTemplate();
+
+    std::lock_guard sessionLock{session->mutex};
+    std::uint64_t sessionId;
+    {
+        std::lock_guard lock{m_mutex};
+        sessionId = m_nextSessionId++;
+        session->usage = m_usage.end();
+        m_sessions.emplace(sessionId, session);
+    }
+
+    release(sessionId, *session);
+    return sessionId;
+}
+
+size_t SessionManager::addHint(std::uint64_t sessionId, std::string_view guess, const std::vector<HintType>& hints) {
+    auto session = getSession(sessionId);
+    std::lock_guard sessionLock{session->mutex};
+    if (!session->solver)
+        restore(*session);
+
+    try {
+        session->solver->addHint(guess, hints);
+    } catch (...) {
+        release(sessionId, *session);
+        throw;
+    }
+
+    session->state += ' ';
+    session->state += guess;
+    session->state += ' ' + formatHints(hints);
+    auto nbSolutions = std::size(session->solver->getPotentialSolutions());
+    release(sessionId, *session);
+    return nbSolutions;
+}
+
+void SessionManager::useSession(std::uint64_t sessionId, const std::function<void(const Solver&, std::string_view)>& function) {
+    auto session = getSession(sessionId);
+    std::lock_guard sessionLock{session->mutex};
+    if (!session->solver)
+        restore(*session);
+
+    try {
+        function(*session->solver, session->state);
+    } catch (...) {
+        release(sessionId, *session);
+        throw;
+    }
+
+    release(sessionId, *session);
+}
+
+bool SessionManager::endSession(std::uint64_t sessionId) {
+    std::shared_ptr<Session> session;
+
+    std::lock_guard lock{m_mutex};
+    auto found = m_sessions.find(sessionId);
+    if (found == m_sessions.end())
+        return false;
+
+    // the solver is freed with the last request of the session
+    session = std::move(found->second);
+    m_sessions.erase(found);
+    session->ended = true;
+    m_residentSize -= session->solverSize;
+    m_stateSize -= session->stateSize;
+    if (session->usage != m_usage.end()) {
+        m_usage.erase(session->usage);
+        session->usage = m_usage.end();
+    }
+
+    return true;
+}
+
+size_t SessionManager::evictIdleSessions() {
+    size_t nbEvicted = 0;
+
+    std::lock_guard lock{m_mutex};
+    for (auto it = std::begin(m_usage); it != std::end(m_usage);) {
+        auto& session = *m_sessions.at(*it++);
+        std::unique_lock sessionLock{session.mutex, std::try_to_lock};
+        if (sessionLock) {
+            evict(session);
+            nbEvicted++;
+        }
+    }
+
+    return nbEvicted;
+}
+
+std::shared_ptr<SessionManager::Session> SessionManager::getSession(std::uint64_t sessionId) const {
+    std::lock_guard lock{m_mutex};
+    auto session = m_sessions.find(sessionId);
+    if (session == m_sessions.end()) {
+        throw Alphadocte::InvalidArgException("Unknown session " + std::to_string(sessionId) + '.',
+                "Alphadocte::CLI::SessionManager::getSession(std::uint64_t) const");
+    }
+
+    return session->second;
+}
+
+void SessionManager::restore(Session& session) const {
+    std::string_view state{session.state};
+    auto solver = m_solverFactory(session.rules);
+
+    // the game is already recorded, replaying it must not record it again
+    auto recorder = solver->getRecorder();
+    solver->setRecorder(nullptr);
+    solver->setTemplate(std::string(nextWord(state)));
+
+    while (!state.empty()) {
+        auto guess = nextWord(state);
+        solver->addHint(guess, parseHints(nextWord(state)));
+    }
+
+    if (recorder)
+        solver->setRecorder(std::move(recorder), session.recordedGame);
+
+    session.solver = std::move(solver);
+}
+
+void SessionManager::release(std::uint64_t sessionId, Session& session) {
+    // sizes are computed before locking, they only depend on the session
+    auto solverSize = session.solver ? session.solver->getRetainedBytes() : 0;
+    auto stateSize = computeStateSize(session);
+
+    std::lock_guard lock{m_mutex};
+    if (session.ended)
+        return;
+
+    m_residentSize = m_residentSize - session.solverSize + solverSize;
+    m_stateSize = m_stateSize - session.stateSize + stateSize;
+    session.solverSize = solverSize;
+    session.stateSize = stateSize;
+
+    // most recently used first
+    if (session.usage != m_usage.end())
+        m_usage.splice(std::begin(m_usage), m_usage, session.usage);
+    else
+        session.usage = m_usage.insert(std::begin(m_usage), sessionId);
+
+    if (m_memoryBudget == 0)
+        return;
+
+    // evict the least recently used idle sessions, the sessions handling a request are skipped
+    auto next = std::end(m_usage);
+    while (m_residentSize > m_memoryBudget && next != std::begin(m_usage)) {
+        auto candidate = std::prev(next);
+        if (*candidate == sessionId) {
+            next = candidate;
+            continue;
+        }
+
+        auto& candidateSession = *m_sessions.at(*candidate);
+        std::unique_lock candidateLock{candidateSession.mutex, std::try_to_lock};
+        if (candidateLock)
+            evict(candidateSession);
+        else
+            next = candidate;
+    }
+}
+
+void SessionManager::evict(Session& session) {
+    session.recordedGame = session.solver->getRecordedGame();
+    m_residentSize -= session.solverSize;
+    session.solverSize = 0;
+    session.solver.reset();
+    m_usage.erase(session.usage);
+    session.usage = m_usage.end();
+}
+
+size_t SessionManager::computeStateSize(const Session& session) {
+    // shared pointer control block (counters and vtable), hash table node (next pointer, key and value)
+    size_t size = sizeof(Session) + 3 * sizeof(void*) + sizeof(void*) + sizeof(std::uint64_t) + sizeof(std::shared_ptr<Session>);
+    return size + getHeapSize(session.state);
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
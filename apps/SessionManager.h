@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: SessionManager.h
+ */
+
+#ifndef APPS_SESSIONMANAGER_H_
+#define APPS_SESSIONMANAGER_H_
+
+/*
+ * Private header managing the memory of the solver daemon's game sessions.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <Alphadocte/Hint.h>
+
+namespace Alphadocte {
+
+class IGameRules;
+class Solver;
+
+namespace CLI {
+
+/*
+ * Memory used by a session.
+ */
+struct SessionInfo {
+    std::uint64_t id{};
+    bool resident{};      // whether its solver is in memory, or must be restored on the next request
+    size_t memoryUsage{}; // approximate number of bytes used by the session, its solver included
+};
+
+/*
+ * Game sessions kept under a memory budget.
+ *
+ * The solver of a session holds its potential guesses and solutions, which can take
+ * hundreds of kilobytes for large dictionaries. Each session also keeps its state as a compact
+ * replayable list : "<template> <guess> <hints> <guess> <hints>...", with hints formatted by formatHints,
+ * so that the first three words of a session with one hint are its BookPosition.
+ *
+ * When the resident solvers use more memory than the budget, the least recently used idle
+ * solvers are evicted, leaving only their state. An evicted session is restored on its next
+ * request, by replaying its template and hints on a new solver.
+ *
+ * The manager can be used from several threads : requests of different sessions run in parallel,
+ * while the requests of one session are serialized.
+ */
+class SessionManager {
+public:
+    /*
+     * Create the solver of a session, without template.
+     */
+    using SolverFactory = std::function<std::unique_ptr<Solver>(std::shared_ptr<IGameRules>)>;
+
+    // Constructors
+    /*
+     * Create a manager without sessions.
+     *
+     * Args :
+     * - solverFactory : creates the solvers of the sessions
+     * - memoryBudget : maximum number of bytes used by the resident solvers, 0 for no limit.
+     *                  The budget can be exceeded by the sessions currently handling a request.
+     *
+     * Throws :
+     * - InvalidArgException : if solverFactory is empty.
+     */
+    SessionManager(SolverFactory solverFactory, size_t memoryBudget);
+
+    // Sessions hold locks, the manager can be neither copied nor moved
+    virtual ~SessionManager() = default;
+    SessionManager(const SessionManager &other) = delete;
+    SessionManager(SessionManager &&other) = delete;
+    SessionManager& operator=(const SessionManager &other) = delete;
+    SessionManager& operator=(SessionManager &&other) = delete;
+
+    // Getters
+    size_t getMemoryBudget() const;
+
+    /*
+     * Return the number of sessions, resident or not.
+     */
+    size_t getSessionCount() const;
+
+    /*
+     * Return the number of sessions whose solver is in memory.
+     */
+    size_t getResidentSessionCount() const;
+
+    /*
+     * Return the approximate number of bytes used by all the sessions.
+     */
+    size_t getMemoryUsage() const;
+
+    /*
+     * Return the memory used by a session, or nothing if there is no such session.
+     */
+    std::optional<SessionInfo> findSessionInfo(std::uint64_t sessionId) const;
+
+    /*
+     * Return the memory used by each session, by increasing session number.
+     */
+    std::vector<SessionInfo> getSessionInfos() const;
+
+    // Methods
+    /*
+     * Start a session, and return its number.
+     *
+     * Args :
+     * - rules : the rules of the game, shared by the sessions
+     * - templateWord : the template of the solution
+     *
+     * Throws :
+     * - InvalidArgException : if the template is invalid.
+     */
+    std::uint64_t createSession(std::shared_ptr<IGameRules> rules, std::string templateWord);
+
+    /*
+     * Add a hint to a session, restoring it first if needed (see Solver::addHint()),
+     * and return the number of potential solutions left.
+     *
+     * Throws :
+     * - InvalidArgException : if there is no such session, or if the guess or hints are invalid.
+     */
+    size_t addHint(std::uint64_t sessionId, std::string_view guess, const std::vector<HintType>& hints);
+
+    /*
+     * Call a function with the solver of a session, restoring it first if needed.
+     * The session is locked during the call.
+     *
+     * Args :
+     * - sessionId : the session number
+     * - function : function called with the solver, and the state of the session (see the class description)
+     *
+     * Throws :
+     * - InvalidArgException : if there is no such session.
+     * - any exception thrown by function
+     */
+    void useSession(std::uint64_t sessionId, const std::function<void(const Solver&, std::string_view)>& function);
+
+    /*
+     * End a session. Return false if there is no such session.
+     */
+    bool endSession(std::uint64_t sessionId);
+
+    /*
+     * Evict the solvers of all the idle sessions, and return the number of evicted solvers.
+     */
+    size_t evictIdleSessions();
+
+private:
+    struct Session {
+        std::shared_ptr<IGameRules> rules;
+        std::string state;                        // template and hints, see the class description
+        std::unique_ptr<Solver> solver;           // nullptr once evicted
+        std::uint64_t recordedGame{};             // id of the game in the recorder of the evicted solver, 0 if none
+
+        // accounted memory and position in m_usage (m_usage.end() if evicted), guarded by m_mutex
+        size_t solverSize{};
+        size_t stateSize{};
+        std::list<std::uint64_t>::iterator usage;
+        bool ended{};                             // removed from m_sessions
+
+        std::mutex mutex;                         // serializes the requests of the session, guards state and solver
+    };
+
+    // Private methods
+    /*
+     * Return the session with the given number.
+     *
+     * Throws :
+     * - InvalidArgException : if there is no such session.
+     */
+    std::shared_ptr<Session> getSession(std::uint64_t sessionId) const;
+
+    /*
+     * Restore the solver of an evicted session. Its mutex must be held.
+     */
+    void restore(Session& session) const;
+
+    /*
+     * Account for the solver of a session after a request, and evict other sessions if the budget is exceeded.
+     * The session's mutex must be held.
+     */
+    void release(std::uint64_t sessionId, Session& session);
+
+    /*
+     * Evict the solver of a session. Both m_mutex and the session's mutex must be held.
+     */
+    void evict(Session& session);
+
+    static size_t computeStateSize(const Session& session);
+
+    // Fields
+    SolverFactory m_solverFactory;
+    size_t m_memoryBudget;
+
+    std::unordered_map<std::uint64_t, std::shared_ptr<Session>> m_sessions;
+    std::list<std::uint64_t> m_usage;   // resident sessions, most recently used first
+    std::uint64_t m_nextSessionId;
+    size_t m_residentSize;              // memory of the resident solvers
+    size_t m_stateSize;                 // memory of the sessions without their solvers
+    mutable std::mutex m_mutex;         // guards all the fields above, and the accounting of each session
+};
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_SESSIONMANAGER_H_ */
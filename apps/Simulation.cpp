@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Simulation.cpp
+ */
+
+#include <algorithm>
+#include <chrono>
+
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Game.h>
+#include <Alphadocte/GameBatch.h>
+#include <Alphadocte/IGameRules.h>
+#include <Alphadocte/Solver.h>
+#include <Alphadocte/SolverMemo.h>
+
+#include "Common.h"
+#include "Parallel.h"
+#include "Simulation.h"
+
+namespace Alphadocte {
+
+namespace CLI {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Add the work of the last computation of a solver
+void addComputation(SolverWork& work, const Solver& solver) {
+    auto stats = solver.getStats();
+    work.nbComputations++;
+    work.nbFromMemo += stats.fromMemo ? 1 : 0;
+    work.nbGuessesScored += stats.nbGuessesScored;
+    work.nbGuessesPruned += stats.nbGuessesPruned;
+    work.nbPatternsEvaluated += stats.nbPatternsEvaluated;
+    work.maxSolverThreads = std::max(work.maxSolverThreads, stats.nbThreads);
+    work.computeGuessesDuration += stats.computeGuessesDuration;
+    work.peakScratchMemory = std::max(work.peakScratchMemory, stats.peakScratchMemory);
+    work.peakRetainedMemory = std::max(work.peakRetainedMemory, solver.getRetainedBytes());
+}
+
+// Add the work of another thread
+void addWork(SolverWork& work, const SolverWork& other) {
+    work.nbComputations += other.nbComputations;
+    work.nbFromMemo += other.nbFromMemo;
+    work.nbGuessesScored += other.nbGuessesScored;
+    work.nbGuessesPruned += other.nbGuessesPruned;
+    work.nbPatternsEvaluated += other.nbPatternsEvaluated;
+    work.maxSolverThreads = std::max(work.maxSolverThreads, other.maxSolverThreads);
+    work.setTemplateDuration += other.setTemplateDuration;
+    work.addHintDuration += other.addHintDuration;
+    work.computeGuessesDuration += other.computeGuessesDuration;
+    work.peakScratchMemory = std::max(work.peakScratchMemory, other.peakScratchMemory);
+    work.peakRetainedMemory = std::max(work.peakRetainedMemory, other.peakRetainedMemory);
+}
+
+}
+
+SimulationResult simulateGames(std::shared_ptr<IGameRules> rules,
+        const std::vector<std::string>& solutions,
+        const SimulationOptions& options) {
+    if (rules && rules->getMaxGuesses() == 0) {
+        throw Alphadocte::Exception("Cannot simulate games without a limit on the number of guesses.",
+                "Alphadocte::CLI::simulateGames(std::shared_ptr<Alphadocte::IGameRules>, const std::vector<std::string>&, const Alphadocte::CLI::SimulationOptions&)");
+    }
+
+    auto start = Clock::now();
+    GameBatch batch{rules, std::size(solutions)};
+    SimulationResult result;
+    result.nbThreads = options.nbThreads == 0 ? defaultThreadCount() : options.nbThreads;
+    result.nbGames = std::size(solutions);
+
+    // Start the games and find their first template
+    std::vector<std::string> templates(std::size(solutions));
+    Game game{rules};
+    for (size_t i = 0; i < std::size(solutions); i++) {
+        batch.setSolution(i, batch.getWordId(solutions[i]));
+        game.setWord(solutions[i]);
+        templates[i] = rules->getTemplate(game);
+    }
+
+    // One solver per thread, solvers keep their own state but share the memo,
+    // and their own threads are capped by the number of threads of the simulation
+    std::shared_ptr<SolverMemo> memo;
+    if (options.memoCapacity > 0)
+        memo = std::make_shared<SolverMemo>(options.memoCapacity);
+
+    std::vector<std::unique_ptr<Solver>> solvers;
+    for (unsigned int t = 0; t < result.nbThreads; t++) {
+        solvers.emplace_back(createSolver(options.solverName, rules, result.nbThreads));
+        solvers.back()->setMemo(memo);
+        solvers.back()->setRecorder(options.recorder);
+    }
+    result.solverName = solvers.front()->getSolverName();
+    result.solverVersion = solvers.front()->getSolverVersion();
+
+    // each thread sums the work of its solver
+    std::vector<SolverWork> work(result.nbThreads);
+
+    // First guesses only depend on the template, compute them once per template
+    std::map<std::string, std::string> firstGuesses;
+    if (options.shareFirstGuess) {
+        for (const auto& templateWord : templates) {
+            firstGuesses.emplace(templateWord, std::string{});
+        }
+
+        std::vector<std::map<std::string, std::string>::iterator> entries;
+        for (auto it = std::begin(firstGuesses); it != std::end(firstGuesses); it++) {
+            entries.push_back(it);
+        }
+
+        auto firstStart = Clock::now();
+        parallelFor(std::size(entries), result.nbThreads, [&entries, &solvers, &work](size_t i, unsigned int thread) {
+            Solver& solver = *solvers[thread];
+            solver.setTemplate(entries[i]->first);
+            work[thread].setTemplateDuration += solver.getStats().setTemplateDuration;
+            entries[i]->second = solver.computeNextGuess();
+            addComputation(work[thread], solver);
+        });
+        result.firstGuessesDuration = secondsSince(firstStart);
+        result.nbTemplates = std::size(firstGuesses);
+    }
+
+    // Play the games
+    std::vector<std::vector<double>> latencies(result.nbThreads);
+    parallelFor(std::size(solutions), result.nbThreads,
+            [&batch, &templates, &firstGuesses, &solvers, &latencies, &work](size_t i, unsigned int thread) {
+        Solver& solver = *solvers[thread];
+        solver.setTemplate(templates[i]);
+        work[thread].setTemplateDuration += solver.getStats().setTemplateDuration;
+
+        std::string guess;
+        if (auto it = firstGuesses.find(templates[i]); it != std::cend(firstGuesses)) {
+            guess = it->second;
+        } else {
+            auto turnStart = Clock::now();
+            guess = solver.computeNextGuess();
+            latencies[thread].push_back(secondsSince(turnStart));
+            addComputation(work[thread], solver);
+        }
+
+        while (!guess.empty() && !batch.isOver(i)) {
+            HintCode hints = batch.tryGuess(i, batch.getWordId(guess));
+
+            if (batch.isOver(i))
+                break;
+
+            auto turnStart = Clock::now();
+            solver.addHint(guess, unpackHints(hints, std::size(guess)));
+            work[thread].addHintDuration += solver.getStats().addHintDuration;
+            guess = solver.computeNextGuess();
+            latencies[thread].push_back(secondsSince(turnStart));
+            addComputation(work[thread], solver);
+        }
+        // an empty guess means the solver gave up, ie the game is lost
+    });
+
+    for (size_t i = 0; i < std::size(solutions); i++) {
+        if (batch.isWon(i)) {
+            result.nbWon++;
+            result.guessDistribution[batch.getNbGuess(i)]++;
+        }
+    }
+
+    for (const auto& threadLatencies : latencies) {
+        result.turnLatencies.insert(std::end(result.turnLatencies), std::cbegin(threadLatencies), std::cend(threadLatencies));
+    }
+
+    for (const auto& threadWork : work) {
+        addWork(result.solverWork, threadWork);
+    }
+
+    if (memo)
+        result.memoStats = memo->getStats();
+
+    result.batchRetainedMemory = batch.getRetainedBytes();
+    result.wallDuration = secondsSince(start);
+
+    return result;
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Simulation.h
+ */
+
+#ifndef APPS_SIMULATION_H_
+#define APPS_SIMULATION_H_
+
+/*
+ * Private header used to play whole games with a solver, in order to evaluate it.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Alphadocte/SolverMemo.h>
+
+namespace Alphadocte {
+
+class IGameRules;
+class WorkloadRecorder;
+
+namespace CLI {
+
+/*
+ * Options of a simulation.
+ */
+struct SimulationOptions {
+    std::string solverName{"entropy_maximizer"}; // solver used to play, see createSolver
+    unsigned int nbThreads{0};                   // number of threads, 0 means one per core
+    bool shareFirstGuess{true};                  // compute the first guess once per template,
+                                                 // instead of once per game
+    size_t memoCapacity{0};                      // number of solver states memoized and shared by all the games,
+                                                 // 0 disables the memo
+    std::shared_ptr<WorkloadRecorder> recorder;  // records the calls of every solver, nullptr for none
+};
+
+/*
+ * Work done by the solvers of a simulation, summed over their calls (see Alphadocte::Solver::Stats).
+ * Durations are in seconds.
+ */
+struct SolverWork {
+    size_t nbComputations{};         // calls to computeNextGuesses
+    size_t nbFromMemo{};             // computations answered by the memo
+    size_t nbGuessesScored{};
+    size_t nbGuessesPruned{};
+    size_t nbPatternsEvaluated{};
+    unsigned int maxSolverThreads{}; // most threads used by a single computation
+    double setTemplateDuration{};
+    double addHintDuration{};
+    double computeGuessesDuration{};
+    size_t peakScratchMemory{};      // highest peak of a single computation
+    size_t peakRetainedMemory{};     // highest memory retained by a solver after a computation
+};
+
+/*
+ * Results of a simulation.
+ */
+struct SimulationResult {
+    std::string solverName;
+    unsigned int solverVersion{};
+    unsigned int nbThreads{};
+    size_t nbGames{};
+    size_t nbWon{};
+    std::map<unsigned int, size_t> guessDistribution; // number of guesses -> number of games won with it
+    std::vector<double> turnLatencies;                // duration (s) of the solver's work for each turn
+                                                      // (adding the hints and computing the next guess),
+                                                      // excluding the shared first guesses
+    size_t nbTemplates{};                             // number of distinct first templates
+    double firstGuessesDuration{};                    // total duration (s) of the shared first guesses computation
+    double wallDuration{};                            // duration (s) of the whole simulation
+    SolverMemo::Stats memoStats;                      // usage of the memo, empty if it is disabled
+    SolverWork solverWork;                            // work of the solvers, shared first guesses included
+    size_t batchRetainedMemory{};                     // memory retained by the guesses and hints of the games
+};
+
+/*
+ * Play one game per solution with the given solver, until each game is won or lost.
+ * The solver always plays its best guess.
+ *
+ * Args :
+ * - rules : the rules of the games, the solutions must be valid solutions for those rules
+ * - solutions : the solutions of the games
+ * - options : the simulation options
+ *
+ * Throws :
+ * - InvalidArgException : if a solution is invalid, or if the solver is unknown.
+ * - Exception : if the rules do not limit the number of guesses.
+ */
+SimulationResult simulateGames(std::shared_ptr<IGameRules> rules,
+        const std::vector<std::string>& solutions,
+        const SimulationOptions& options);
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_SIMULATION_H_ */
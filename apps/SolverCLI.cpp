@@ -23,16 +23,21 @@
 #include <cmath>
 #include <iostream>
 #include <iomanip>
+#include <optional>
 
 #include <Alphadocte/EntropyMaximizer.h>
 #include <Alphadocte/Exceptions.h>
 #include <Alphadocte/FixedSizeDictionary.h>
+#include <Alphadocte/Memory.h>
 #include <Alphadocte/MotusGameRules.h>
 #include <Alphadocte/TxtDictionary.h>
 #include <Alphadocte/WordleGameRules.h>
 
-#include "Common.h"
+#include "BinaryCache.h"
 #include "CacheConfig.h"
+#include "CommandLine.h"
+#include "Common.h"
+#include "TuningProfile.h"
 
 using namespace Alphadocte;
 using namespace Alphadocte::CLI;
@@ -43,8 +48,31 @@ static const int NUMBER_OF_GUESS_DIGITS = 1+floor(log10(NUMBER_OF_GUESS));
 
 std::string askGuess(std::string_view templateWord, std::string_view defaultGuess);
 std::vector<HintType> askHints(word_size n);
+void printUsage(std::string_view programName);
+void printStats(const Solver& solver, const Dictionary& dictionary);
+
+int main(int argc, char* argv[]) {
+    bool showStats{false};
+    try {
+        CommandLine args{argc, argv};
+        args.checkOptions({"help", "stats"});
+
+        if (args.has("help")) {
+            printUsage(args.getProgramName());
+            return 0;
+        }
 
-int main() {
+        // the solvers use the tuning chosen for this machine, see the tune command of alphadocte-cache
+        loadTuning();
+
+        showStats = args.has("stats");
+    } catch (const Exception& e) {
+        std::cerr << "Erreur : " << e.what() << std::endl;
+        std::cerr << "Voir --help pour l'utilisation." << std::endl;
+        return 1;
+    }
+
+    TraceRecording trace{getTracePath()};
     std::cout << "Bienvenue sur le mode solver de Alphadocte v" << ALPHADOCTE_VERSION_NAME;
     std::cout << " (logiciel libre sous licence GPLv3+)." << std::endl;
 
@@ -67,20 +95,6 @@ int main() {
         return 1;
     }
 
-    CacheConfig cache{dictionaryPath};
-    std::string stem = dictionaryPath.stem().string();
-    std::string dict_name = stem.substr(0, std::size(stem) - std::size(std::string("_wordlist")));
-    std::filesystem::path configPath = getCachePath() / dict_name;
-    try {
-        Config config;
-        config.loadFromFile(configPath);
-        cache.setConfig(std::move(config));
-    } catch (const Alphadocte::Exception& e) {
-        std::cout << "Avertissement : impossible de charger le cache du dictionnaire. Obligation de faire les calculs de zéro." << std::endl;
-        std::cout << "Raison: " << e.what() << std::endl;
-        std::cout << std::endl;
-    }
-
     RulesType rulesType = chooseRules();
     std::shared_ptr<IGameRules> rules;
 
@@ -103,8 +117,18 @@ int main() {
     }
 
     EntropyMaximizer solver{rules};
+    solver.setRecorder(openRecorder(getRecordPath()));
     std::string templateWord;
 
+    std::optional<BinaryCache> cache;
+    try {
+        cache.emplace(openSolverCache(dictionaryPath, dictionary, std::string(solver.getSolverName()), solver.getSolverVersion()));
+    } catch (const std::exception& e) {
+        std::cout << "Avertissement : impossible d'ouvrir le cache du dictionnaire. Obligation de faire les calculs de zéro." << std::endl;
+        std::cout << "Raison: " << e.what() << std::endl;
+        std::cout << std::endl;
+    }
+
     if (rulesType == RulesType::MOTUS) {
         word_size wordSize = askPositiveInteger("Entrez le nombre de lettres : ");
         std::string firstLetterWord;
@@ -131,38 +155,62 @@ int main() {
     solver.setTemplate(templateWord);
     bool playing{true};
     bool first{true};
+    std::optional<BookPosition> bookPosition; // set for the second turn, see the opening book of the cache
 
     std::cout << std::setprecision(DECIMAL_PRECISION) << std::fixed;
     std::cout << std::endl;
 
     while (playing) {
         std::vector<std::pair<std::string,double>> guesses;
+        std::optional<std::vector<std::pair<std::string,double>>> cachedGuesses;
 
         if (first) {
-            try {
-                guesses = cache.getTopGuesses(
-                        solver.getSolverName(),
-                        solver.getSolverVersion(),
-                        NUMBER_OF_GUESS,
-                        solver.getTemplate()
-                );
-            } catch (const Exception& e) {
+            if (cache)
+                cachedGuesses = cache->findTopGuesses(NUMBER_OF_GUESS, solver.getTemplate());
+
+            if (cachedGuesses) {
+                guesses = std::move(*cachedGuesses);
+            } else {
                 std::cout << "Premier mot pas dans le cache." << std::endl;
                 std::cout << "Calcul du premier mot, cela va prendre du temps..." << std::endl;
                 std::cout << std::endl;
                 guesses = solver.computeNextGuesses(NUMBER_OF_GUESS);
+                if (showStats)
+                    printStats(solver, *dictionary);
 
                 // Save guesses in cache for next games
-                cache.setTopGuesses("entropy_maximizer", 1, templateWord, NUMBER_OF_GUESS, guesses);
-                cache.getConfig().writeToFile(configPath);
+                try {
+                    if (cache)
+                        cache->setTopGuesses(solver.getTemplate(), NUMBER_OF_GUESS, guesses);
+                } catch (const Exception& e) {
+                    std::cout << "Avertissement : impossible d'écrire dans le cache." << std::endl;
+                    std::cout << "Raison: " << e.what() << std::endl;
+                }
             }
             first = false;
         }
+        else if (bookPosition && cache
+                && (cachedGuesses = cache->findSecondGuesses(NUMBER_OF_GUESS, *bookPosition))) {
+            guesses = std::move(*cachedGuesses);
+            bookPosition.reset();
+        }
         else {
             std::cout << "Calcul du prochain mot à tenter." << std::endl;
             std::cout << "Encore " << std::size(solver.getPotentialSolutions()) << " solutions potentielles, soit " << solver.computeCurrentEntropy() << " bits." << std::endl;
             std::cout << "Veuillez patienter..." << std::endl;
             guesses = solver.computeNextGuesses(NUMBER_OF_GUESS);
+            if (showStats)
+                printStats(solver, *dictionary);
+
+            // Save the second guesses in the opening book for next games
+            try {
+                if (cache && bookPosition && !guesses.empty())
+                    cache->setSecondGuesses(*bookPosition, NUMBER_OF_GUESS, guesses);
+            } catch (const Exception& e) {
+                std::cout << "Avertissement : impossible d'écrire dans le cache." << std::endl;
+                std::cout << "Raison: " << e.what() << std::endl;
+            }
+            bookPosition.reset();
         }
         std::cout << std::endl;
 
@@ -190,10 +238,58 @@ int main() {
         std::cout << "Information réellement obtenue : " << solver.computeActualEntropy(guess, hints) << std::endl;
         solver.addHint(guess, hints);
 
+        // the opening book only holds the second turn
+        if (solver.getHints().size() == 1 && std::size(guess) == std::size(templateWord))
+            bookPosition = BookPosition{templateWord, guess, hints};
+        else
+            bookPosition.reset();
+
         std::cout << std::endl;
     }
 }
 
+void printUsage(std::string_view programName) {
+    std::cout << "Alphadocte v" << ALPHADOCTE_VERSION_NAME << " : aide à la résolution d'une partie." << std::endl;
+    std::cout << std::endl;
+    std::cout << "Utilisation : " << programName << " [options]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options :" << std::endl;
+    std::cout << "  --stats              afficher le travail du solver après chaque calcul (solutions, essais" << std::endl;
+    std::cout << "                       évalués et écartés, indices calculés, durées, mémoire temporaire)" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Variable d'environnement :" << std::endl;
+    std::cout << "  " << TRACE_ENV_VAR << "     écrire les traces des étapes du solver dans ce fichier" << std::endl;
+    std::cout << "  " << RECORD_ENV_VAR << "    enregistrer les appels au solver dans ce fichier, pour les rejouer" << std::endl;
+    std::cout << "                       avec alphadocte-replay" << std::endl;
+}
+
+void printStats(const Solver& solver, const Dictionary& dictionary) {
+    auto stats = solver.getStats();
+    std::cout << "Statistiques du solver :" << std::endl;
+    std::cout << "  solutions potentielles : " << stats.nbSolutions << " sur " << stats.nbGuesses << " essais possibles" << std::endl;
+    std::cout << "  essais évalués         : " << stats.nbGuessesScored << ", écartés : " << stats.nbGuessesPruned
+              << (stats.fromMemo ? " (mémo)" : "") << std::endl;
+    std::cout << "  indices calculés       : " << stats.nbPatternsEvaluated << " avec " << stats.nbThreads << " thread(s)" << std::endl;
+    std::cout << "  durées                 : modèle " << stats.setTemplateDuration * 1e3 << " ms, indice "
+              << stats.addHintDuration * 1e3 << " ms, calcul " << stats.computeGuessesDuration * 1e3 << " ms" << std::endl;
+    std::cout << "  mémoire temporaire     : " << stats.peakScratchMemory / 1024. << " Kio" << std::endl;
+    std::cout << "  mémoire retenue        : solver " << solver.getRetainedBytes() / 1024. << " Kio, dictionnaire "
+              << dictionary.getRetainedBytes() / 1024. << " Kio" << std::endl;
+
+    // only counted when the executable is built with ALPHADOCTE_COUNT_ALLOCATIONS
+    if (!AllocationTracker::isEnabled())
+        return;
+
+    std::cout << "Allocations par phase :" << std::endl;
+    for (size_t i = 0; i < NB_MEMORY_PHASES; i++) {
+        auto phase = static_cast<MemoryPhase>(i);
+        auto allocations = AllocationTracker::getStats(phase);
+        std::cout << "  " << std::left << std::setw(23) << AllocationTracker::getPhaseName(phase) << std::right << ": "
+                  << allocations.nbAllocations << " allocation(s), " << allocations.allocatedBytes / 1024. << " Kio, pic "
+                  << allocations.peakBytes / 1024. << " Kio" << std::endl;
+    }
+}
+
 std::string askGuess(std::string_view templateWord, std::string_view defaultGuess) {
     std::string guess;
     bool accepted{false};
@@ -232,8 +328,6 @@ std::string askGuess(std::string_view templateWord, std::string_view defaultGues
 }
 
 std::vector<HintType> askHints(word_size n) {
-    std::vector<HintType> hintVector;
-
     std::cout << "Une lettre par indice, dans l'ordre donné, avec :" << std::endl;
     std::cout << "v pour lettre bien placée (vert sur Wordle, rouge sur Motus)" << std::endl;
     std::cout << "o pour lettre mal placée  (jaune sur Wordle, rond jaune sur Motus)" << std::endl;
@@ -246,7 +340,7 @@ std::vector<HintType> askHints(word_size n) {
         std::transform(std::begin(hints), std::end(hints), std::begin(hints), tolower);
 
         if (hints.empty()) {
-            return hintVector;
+            return {};
         } else if (std::size(hints) != n) {
             std::cout << "Erreur: pas le bon nombre d'indices (doit être " << n << ")." << std::endl;
         } else if (std::any_of(std::cbegin(hints), std::cend(hints), [](char c){ return c != 'v' && c != 'o' && c != 'x'; })) {
@@ -256,9 +350,5 @@ std::vector<HintType> askHints(word_size n) {
         }
     }
 
-    for (char c : hints) {
-        hintVector.push_back(c == 'v' ? HintType::CORRECT : (c == 'o' ? HintType::MISPLACED : HintType::WRONG));
-    }
-
-    return hintVector;
+    return parseHints(hints);
 }
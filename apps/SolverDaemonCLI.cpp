@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: SolverDaemonCLI.cpp
+ */
+
+#include <csignal>
+#include <iostream>
+#include <sstream>
+
+#include <Alphadocte/Alphadocte.h>
+#include <Alphadocte/Exceptions.h>
+
+#include "CacheBudget.h"
+#include "CommandLine.h"
+#include "Common.h"
+#include "MetricsHttpServer.h"
+#include "SolverService.h"
+#include "TuningProfile.h"
+#include "UnixSocketServer.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+static const std::string SOCKET_FILE_NAME = "solverd.sock";
+
+// server stopped by SIGINT and SIGTERM
+static UnixSocketServer* runningServer = nullptr;
+
+void printUsage(std::string_view programName);
+void stopServer(int signal);
+
+int main(int argc, char* argv[]) {
+    try {
+        CommandLine args{argc, argv};
+        args.checkOptions({"help", "socket", "solver", "memo", "no-cache", "preload", "memory", "metrics-port", "record"});
+
+        if (args.has("help")) {
+            printUsage(args.getProgramName());
+            return 0;
+        }
+
+        // the solvers use the tuning chosen for this machine, see the tune command of alphadocte-cache
+        loadTuning();
+
+        SolverServiceOptions options;
+        options.solverName = args.getString("solver", options.solverName);
+        options.memoCapacity = args.getUnsigned("memo", options.memoCapacity);
+        options.useCache = !args.has("no-cache");
+        if (args.has("memory")) {
+            auto budget = parseCacheSize(args.getString("memory"));
+            if (!budget)
+                throw InvalidArgException("Invalid memory size " + args.getString("memory") + ", expected a size such as 256M.", "main(int, char*[])");
+
+            options.sessionMemoryBudget = static_cast<size_t>(*budget);
+        }
+        options.recorder = openRecorder(args.has("record") ? std::filesystem::path{args.getString("record")} : getRecordPath());
+        SolverService service{options};
+        auto metricsServer = startMetricsServer(args);
+
+        // Load the dictionaries ahead of the first sessions
+        std::istringstream preloaded{args.getString("preload")};
+        std::string dictionary;
+        while (std::getline(preloaded, dictionary, ',')) {
+            if (!dictionary.empty()) {
+                service.preload(dictionary);
+                std::cout << "Dictionnaire chargé : " << dictionary << std::endl;
+            }
+        }
+
+        std::filesystem::path socketPath = args.has("socket") ? std::filesystem::path{args.getString("socket")}
+                                                              : getCachePath() / SOCKET_FILE_NAME;
+        UnixSocketServer server{socketPath, [&service](std::string_view request) {
+            return service.handleRequest(request);
+        }};
+
+        runningServer = &server;
+        std::signal(SIGINT, stopServer);
+        std::signal(SIGTERM, stopServer);
+
+        std::cout << "Alphadocte v" << ALPHADOCTE_VERSION_NAME << " : en écoute sur " << socketPath.string() << std::endl;
+        server.run();
+
+        runningServer = nullptr;
+        service.flushCaches();
+        std::cout << "Arrêt du service." << std::endl;
+    } catch (const Exception& e) {
+        std::cerr << "Erreur : " << e.what() << std::endl;
+        std::cerr << "Voir --help pour l'utilisation." << std::endl;
+        return 1;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Erreur : " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+void printUsage(std::string_view programName) {
+    std::cout << "Alphadocte v" << ALPHADOCTE_VERSION_NAME << " : service de résolution sur socket Unix." << std::endl;
+    std::cout << std::endl;
+    std::cout << "Utilisation : " << programName << " [options]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Chaque ligne reçue est une requête JSON, à laquelle le service répond par une ligne JSON :" << std::endl;
+    std::cout << "  {\"op\":\"new_session\",\"dictionary\":\"FR\",\"rules\":\"motus\",\"template\":\"a......\"}" << std::endl;
+    std::cout << "  {\"op\":\"add_hint\",\"session\":1,\"guess\":\"abaisse\",\"hints\":\"vxoxxvx\"}" << std::endl;
+    std::cout << "  {\"op\":\"top\",\"session\":1,\"n\":10}" << std::endl;
+    std::cout << "  {\"op\":\"end_session\",\"session\":1}" << std::endl;
+    std::cout << "  {\"op\":\"stats\"}" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options :" << std::endl;
+    std::cout << "  --socket=CHEMIN      chemin de la socket (" << SOCKET_FILE_NAME << " du dossier de cache par défaut)" << std::endl;
+    std::cout << "  --solver=NOM         solver des parties (entropy_maximizer par défaut)" << std::endl;
+    std::cout << "  --memo=N             nombre d'états mémorisés, partagés par les parties (10000 par défaut, 0 pour désactiver)" << std::endl;
+    std::cout << "  --memory=TAILLE      mémoire maximale des solvers des parties, par exemple 256M (256M par défaut, 0 pour" << std::endl;
+    std::cout << "                       ne pas limiter) : au-delà, les parties inactives sont réduites à leurs indices" << std::endl;
+    std::cout << "  --no-cache           ne pas utiliser le cache des premiers mots" << std::endl;
+    std::cout << "  --metrics-port=PORT  servir les métriques au format Prometheus sur http://127.0.0.1:PORT/metrics" << std::endl;
+    std::cout << "  --preload=NOMS       dictionnaires chargés au démarrage, séparés par des virgules (ex. FR,EN)" << std::endl;
+    std::cout << "  --record=CHEMIN      enregistrer les appels aux solvers des parties, pour les rejouer avec" << std::endl;
+    std::cout << "                       alphadocte-replay (" << RECORD_ENV_VAR << " par défaut)" << std::endl;
+}
+
+void stopServer(int /* signal */) {
+    if (runningServer)
+        runningServer->stop();
+}
@@ -0,0 +1,443 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: SolverService.cpp
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/IGameRules.h>
+#include <Alphadocte/Memory.h>
+#include <Alphadocte/Solver.h>
+#include <Alphadocte/TxtDictionary.h>
+
+#include "SolverService.h"
+
+namespace Alphadocte {
+
+namespace CLI {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+using Guesses = std::vector<std::pair<std::string, double>>;
+
+const unsigned int DEFAULT_NUMBER_OF_GUESSES = 10;
+
+/*
+ * Return a string member of the request, or the default value if it is missing.
+ *
+ * Throws :
+ * - InvalidArgException : if the member is missing without default value, or is not a string.
+ */
+std::string getStringMember(const JsonObject& request, std::string_view name,
+        std::optional<std::string> defaultValue = std::nullopt) {
+    auto member = request.find(name);
+    if (member == request.end()) {
+        if (defaultValue)
+            return std::move(*defaultValue);
+
+        throw Alphadocte::InvalidArgException("Missing member " + std::string(name) + '.',
+                "Alphadocte::CLI::getStringMember(const Alphadocte::CLI::JsonObject&, std::string_view, std::optional<std::string>)");
+    }
+
+    if (member->second.type != JsonValue::Type::STRING) {
+        throw Alphadocte::InvalidArgException("Member " + std::string(name) + " must be a string.",
+                "Alphadocte::CLI::getStringMember(const Alphadocte::CLI::JsonObject&, std::string_view, std::optional<std::string>)");
+    }
+
+    return member->second.text;
+}
+
+/*
+ * Return a non-negative integer member of the request, or the default value if it is missing.
+ *
+ * Throws :
+ * - InvalidArgException : if the member is missing without default value, or is not a non-negative integer.
+ */
+std::uint64_t getUnsignedMember(const JsonObject& request, std::string_view name,
+        std::optional<std::uint64_t> defaultValue = std::nullopt) {
+    auto member = request.find(name);
+    if (member == request.end()) {
+        if (defaultValue)
+            return *defaultValue;
+
+        throw Alphadocte::InvalidArgException("Missing member " + std::string(name) + '.',
+                "Alphadocte::CLI::getUnsignedMember(const Alphadocte::CLI::JsonObject&, std::string_view, std::optional<std::uint64_t>)");
+    }
+
+    const auto& text = member->second.text;
+    std::uint64_t value{};
+    auto [end, error] = std::from_chars(text.data(), text.data() + std::size(text), value);
+    if (member->second.type != JsonValue::Type::NUMBER || error != std::errc{} || end != text.data() + std::size(text)) {
+        throw Alphadocte::InvalidArgException("Member " + std::string(name) + " must be a non-negative integer.",
+                "Alphadocte::CLI::getUnsignedMember(const Alphadocte::CLI::JsonObject&, std::string_view, std::optional<std::uint64_t>)");
+    }
+
+    return value;
+}
+
+/*
+ * Format a value as it was received.
+ */
+std::string formatJsonValue(const JsonValue& value) {
+    return value.type == JsonValue::Type::STRING ? quoteJson(value.text) : value.text;
+}
+
+/*
+ * Format a score with the shortest representation read back as the same value.
+ */
+std::string formatScore(double score) {
+    char buffer[32];
+    auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), score);
+    return error == std::errc{} ? std::string(buffer, end) : "0";
+}
+
+std::string toLower(std::string str) {
+    std::transform(std::begin(str), std::end(str), std::begin(str),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return str;
+}
+
+/*
+ * Return the opening book position of a session state, if the session is on its second turn.
+ * A state with one hint is formatted as a book position, see SessionManager.
+ */
+std::optional<BookPosition> findBookPosition(std::string_view state) {
+    if (std::count(std::begin(state), std::end(state), ' ') != 2)
+        return std::nullopt;
+
+    try {
+        return BookPosition::parse(state);
+    } catch (const Alphadocte::InvalidArgException&) {
+        return std::nullopt;
+    }
+}
+
+}
+
+SolverService::SolverService(SolverServiceOptions options)
+        : m_options{std::move(options)}, m_memo{}, m_resources{}, m_resourcesMutex{},
+          m_sessions{[this](std::shared_ptr<IGameRules> rules) {
+                  auto solver = createSolver(m_options.solverName, std::move(rules));
+                  solver->setMemo(m_memo);
+                  solver->setRecorder(m_options.recorder);
+                  return solver;
+              }, m_options.sessionMemoryBudget} {
+    auto solverVersions = getSolverVersions();
+    if (solverVersions.find(m_options.solverName) == solverVersions.end()) {
+        throw Alphadocte::InvalidArgException("Unknown solver " + m_options.solverName + '.',
+                "Alphadocte::CLI::SolverService::SolverService(Alphadocte::CLI::SolverServiceOptions)");
+    }
+
+    if (m_options.memoCapacity > 0)
+        m_memo = std::make_shared<SolverMemo>(m_options.memoCapacity);
+}
+
+const SolverServiceOptions& SolverService::getOptions() const {
+    return m_options;
+}
+
+size_t SolverService::getSessionCount() const {
+    return m_sessions.getSessionCount();
+}
+
+const SessionManager& SolverService::getSessions() const {
+    return m_sessions;
+}
+
+std::shared_ptr<SolverMemo> SolverService::getMemo() const {
+    return m_memo;
+}
+
+std::string SolverService::handleRequest(std::string_view request) {
+    std::string idMember;
+    std::string members;
+
+    try {
+        auto object = parseJsonObject(request);
+        if (auto id = object.find("id"); id != object.end())
+            idMember = "\"id\":" + formatJsonValue(id->second) + ',';
+
+        auto operation = getStringMember(object, "op");
+        if (operation == "new_session") {
+            newSession(object, members);
+        } else if (operation == "add_hint") {
+            addHint(object, members);
+        } else if (operation == "top") {
+            topGuesses(object, members);
+        } else if (operation == "end_session") {
+            endSession(object, members);
+        } else if (operation == "stats") {
+            stats(object, members);
+        } else {
+            throw Alphadocte::InvalidArgException("Unknown operation " + operation
+                    + ", expected new_session, add_hint, top, end_session or stats.",
+                    "Alphadocte::CLI::SolverService::handleRequest(std::string_view)");
+        }
+    } catch (const std::exception& e) {
+        // library and service errors alike are reported to the client, which keeps its connection
+        return '{' + idMember + "\"ok\":false,\"error\":" + quoteJson(e.what()) + '}';
+    }
+
+    return '{' + idMember + "\"ok\":true" + members + '}';
+}
+
+void SolverService::preload(std::string_view dictionaryNameOrPath) {
+    getResources(dictionaryNameOrPath);
+}
+
+void SolverService::flushCaches() {
+    std::vector<std::shared_ptr<Resources>> resources;
+    {
+        std::lock_guard lock{m_resourcesMutex};
+        for (const auto& [path, dictionaryResources] : m_resources)
+            resources.push_back(dictionaryResources);
+    }
+
+    for (const auto& dictionaryResources : resources) {
+        std::lock_guard lock{dictionaryResources->mutex};
+        try {
+            if (dictionaryResources->cache)
+                dictionaryResources->cache->flushAccessTimes();
+        } catch (const Alphadocte::Exception&) {
+            // access times only order evictions
+        }
+    }
+}
+
+std::shared_ptr<SolverService::Resources> SolverService::getResources(std::string_view dictionaryNameOrPath) {
+    auto dictionaryPath = findDictionary(dictionaryNameOrPath);
+    if (dictionaryPath.empty()) {
+        throw Alphadocte::InvalidArgException("Unknown dictionary " + std::string(dictionaryNameOrPath) + '.',
+                "Alphadocte::CLI::SolverService::getResources(std::string_view)");
+    }
+
+    std::error_code error;
+    auto absolutePath = std::filesystem::absolute(dictionaryPath, error);
+    auto key = (error ? dictionaryPath : absolutePath).string();
+
+    // dictionaries are loaded once, other sessions wait for it
+    std::lock_guard lock{m_resourcesMutex};
+    if (auto found = m_resources.find(key); found != m_resources.end())
+        return found->second;
+
+    auto resources = std::make_shared<Resources>();
+    resources->dictionaryPath = dictionaryPath;
+    resources->dictionary = std::make_shared<TxtDictionary>(dictionaryPath);
+    if (!resources->dictionary->load()) {
+        throw Alphadocte::Exception("Could not load the dictionary " + dictionaryPath.string() + '.',
+                "Alphadocte::CLI::SolverService::getResources(std::string_view)");
+    }
+
+    if (m_options.useCache) {
+        try {
+            resources->cache.emplace(openSolverCache(dictionaryPath, resources->dictionary, m_options.solverName,
+                    getSolverVersions().at(m_options.solverName)));
+        } catch (const std::exception&) {
+            // sessions compute their guesses from scratch
+        }
+    }
+
+    m_resources.emplace(std::move(key), resources);
+    return resources;
+}
+
+std::shared_ptr<SolverService::Resources> SolverService::getResources(const IGameRules& rules) {
+    // only a few dictionaries are loaded, with one rules object per rules type
+    std::lock_guard lock{m_resourcesMutex};
+    for (const auto& [path, resources] : m_resources) {
+        std::lock_guard rulesLock{resources->mutex};
+        for (const auto& [rulesType, dictionaryRules] : resources->rules) {
+            if (dictionaryRules.get() == &rules)
+                return resources;
+        }
+    }
+
+    throw Alphadocte::Exception("The rules were not created by the service.",
+            "Alphadocte::CLI::SolverService::getResources(const Alphadocte::IGameRules&)");
+}
+
+void SolverService::newSession(const JsonObject& request, std::string& response) {
+    auto resources = getResources(getStringMember(request, "dictionary"));
+    auto rulesType = parseRulesType(getStringMember(request, "rules", std::string(getRulesName(RulesType::MOTUS))));
+    auto templateWord = getStringMember(request, "template",
+            rulesType == RulesType::WORDLE ? std::string(ALPHADOCTE_WORDLE_DEFAULT_SIZE, '.') : std::string());
+    if (templateWord.empty()) {
+        throw Alphadocte::InvalidArgException("Missing member template.",
+                "Alphadocte::CLI::SolverService::newSession(const Alphadocte::CLI::JsonObject&, std::string&)");
+    }
+
+    std::shared_ptr<IGameRules> rules;
+    {
+        std::lock_guard lock{resources->mutex};
+        rules = resources->rules[rulesType];
+        if (!rules) {
+            rules = createRules(rulesType, resources->dictionary);
+            resources->rules[rulesType] = rules;
+        }
+    }
+
+    auto sessionId = m_sessions.createSession(std::move(rules), std::move(templateWord));
+    response += ",\"session\":" + std::to_string(sessionId);
+    m_sessions.useSession(sessionId, [&response](const Solver& solver, std::string_view /* state */) {
+        response += ",\"solutions\":" + std::to_string(std::size(solver.getPotentialSolutions()));
+    });
+}
+
+void SolverService::addHint(const JsonObject& request, std::string& response) {
+    auto sessionId = getUnsignedMember(request, "session");
+    auto guess = toLower(getStringMember(request, "guess"));
+    auto hints = parseHints(toLower(getStringMember(request, "hints")));
+
+    auto nbSolutions = m_sessions.addHint(sessionId, guess, hints);
+    response += ",\"solutions\":" + std::to_string(nbSolutions);
+}
+
+void SolverService::topGuesses(const JsonObject& request, std::string& response) {
+    auto sessionId = getUnsignedMember(request, "session");
+    auto nbGuesses = getUnsignedMember(request, "n", DEFAULT_NUMBER_OF_GUESSES);
+    if (nbGuesses == 0 || nbGuesses > UINT32_MAX) {
+        throw Alphadocte::InvalidArgException("The number of guesses must be positive.",
+                "Alphadocte::CLI::SolverService::topGuesses(const Alphadocte::CLI::JsonObject&, std::string&)");
+    }
+    auto n = static_cast<unsigned int>(nbGuesses);
+
+    std::optional<Guesses> guesses;
+    std::string source;
+    m_sessions.useSession(sessionId, [this, n, &guesses, &source](const Solver& solver, std::string_view state) {
+        auto& resources = *getResources(*solver.getRules());
+        bool firstTurn = solver.getHints().empty();
+        auto bookPosition = findBookPosition(state);
+
+        // The first guesses and the opening book come from the cache, as in alphadocte-solver
+        if (firstTurn || bookPosition) {
+            std::lock_guard cacheLock{resources.mutex};
+            try {
+                if (resources.cache && firstTurn) {
+                    guesses = resources.cache->findTopGuesses(n, solver.getTemplate());
+                    source = "cache";
+                } else if (resources.cache) {
+                    guesses = resources.cache->findSecondGuesses(n, *bookPosition);
+                    source = "book";
+                }
+            } catch (const Alphadocte::Exception&) {
+                // corrupted cache, compute the guesses
+                guesses.reset();
+            }
+        }
+
+        if (!guesses) {
+            guesses = solver.computeNextGuesses(n);
+            source = "solver";
+
+            // Save them for the next sessions
+            if ((firstTurn || bookPosition) && !guesses->empty()) {
+                std::lock_guard cacheLock{resources.mutex};
+                try {
+                    if (resources.cache && firstTurn)
+                        resources.cache->setTopGuesses(solver.getTemplate(), n, *guesses);
+                    else if (resources.cache)
+                        resources.cache->setSecondGuesses(*bookPosition, n, *guesses);
+                } catch (const Alphadocte::Exception&) {
+                    // the cache is only an optimization
+                }
+            }
+        }
+    });
+
+    response += ",\"source\":" + quoteJson(source) + ",\"guesses\":[";
+    for (size_t i = 0; i < std::size(*guesses); i++) {
+        const auto& [word, score] = (*guesses)[i];
+        response += (i > 0 ? ",{\"word\":" : "{\"word\":") + quoteJson(word) + ",\"score\":" + formatScore(score) + '}';
+    }
+    response += ']';
+}
+
+void SolverService::endSession(const JsonObject& request, std::string& /* response */) {
+    auto sessionId = getUnsignedMember(request, "session");
+    if (!m_sessions.endSession(sessionId)) {
+        throw Alphadocte::InvalidArgException("Unknown session " + std::to_string(sessionId) + '.',
+                "Alphadocte::CLI::SolverService::endSession(const Alphadocte::CLI::JsonObject&, std::string&)");
+    }
+}
+
+size_t SolverService::getDictionariesRetainedBytes() {
+    std::vector<std::shared_ptr<Resources>> resources;
+    {
+        std::lock_guard lock{m_resourcesMutex};
+        for (const auto& [path, dictionaryResources] : m_resources)
+            resources.push_back(dictionaryResources);
+    }
+
+    size_t size{};
+    for (const auto& dictionaryResources : resources) {
+        size += dictionaryResources->dictionary->getRetainedBytes();
+
+        // the Wordle rules use their own dictionary, made of the words of the right size
+        std::lock_guard lock{dictionaryResources->mutex};
+        for (const auto& [rulesType, rules] : dictionaryResources->rules) {
+            if (rules->getDictionary() != dictionaryResources->dictionary)
+                size += rules->getDictionary()->getRetainedBytes();
+        }
+    }
+
+    return size;
+}
+
+void SolverService::stats(const JsonObject& request, std::string& response) {
+    if (request.find("session") == request.end()) {
+        response += ",\"sessions\":" + std::to_string(m_sessions.getSessionCount())
+                + ",\"resident\":" + std::to_string(m_sessions.getResidentSessionCount())
+                + ",\"memory\":" + std::to_string(m_sessions.getMemoryUsage())
+                + ",\"budget\":" + std::to_string(m_sessions.getMemoryBudget())
+                + ",\"dictionaries\":" + std::to_string(getDictionariesRetainedBytes());
+
+        // only counted when the daemon is built with ALPHADOCTE_COUNT_ALLOCATIONS, flattened to keep the response flat
+        if (AllocationTracker::isEnabled()) {
+            for (size_t i = 0; i < NB_MEMORY_PHASES; i++) {
+                auto phase = static_cast<MemoryPhase>(i);
+                auto allocations = AllocationTracker::getStats(phase);
+                std::string suffix{AllocationTracker::getPhaseName(phase)};
+                response += ",\"allocations_" + suffix + "\":" + std::to_string(allocations.nbAllocations)
+                        + ",\"allocated_bytes_" + suffix + "\":" + std::to_string(allocations.currentBytes)
+                        + ",\"allocated_bytes_peak_" + suffix + "\":" + std::to_string(allocations.peakBytes);
+            }
+        }
+        return;
+    }
+
+    auto sessionId = getUnsignedMember(request, "session");
+    auto info = m_sessions.findSessionInfo(sessionId);
+    if (!info) {
+        throw Alphadocte::InvalidArgException("Unknown session " + std::to_string(sessionId) + '.',
+                "Alphadocte::CLI::SolverService::stats(const Alphadocte::CLI::JsonObject&, std::string&)");
+    }
+
+    response += ",\"session\":" + std::to_string(sessionId) + ",\"resident\":" + (info->resident ? "true" : "false")
+            + ",\"memory\":" + std::to_string(info->memoryUsage);
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: SolverService.h
+ */
+
+#ifndef APPS_SOLVERSERVICE_H_
+#define APPS_SOLVERSERVICE_H_
+
+/*
+ * Private header providing the game sessions of the solver daemon.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <Alphadocte/SolverMemo.h>
+
+#include "BinaryCache.h"
+#include "CacheConfig.h"
+#include "Common.h"
+#include "Json.h"
+#include "SessionManager.h"
+
+namespace Alphadocte {
+
+class Dictionary;
+class IGameRules;
+class Solver;
+class WorkloadRecorder;
+
+namespace CLI {
+
+/*
+ * Options of the solver service.
+ */
+struct SolverServiceOptions {
+    std::string solverName{"entropy_maximizer"}; // solver of every session, see createSolver
+    size_t memoCapacity{10000};                  // number of solver states memoized and shared by all the sessions,
+                                                 // 0 disables the memo
+    bool useCache{true};                         // look up and fill the binary cache of each dictionary
+    size_t sessionMemoryBudget{256 << 20};       // number of bytes of the resident solvers, 0 for no limit
+                                                 // (see SessionManager)
+    std::shared_ptr<WorkloadRecorder> recorder;  // records the calls of every session, nullptr for none
+};
+
+/*
+ * Solver sessions sharing resident resources : dictionaries, rules, binary caches and the solver memo
+ * are loaded once, on the first session which needs them, and kept until the service is destroyed.
+ *
+ * Requests and responses are flat JSON objects, one per line (see handleRequest()).
+ * Each request names its operation in the "op" member, and may hold an "id" member, repeated in the response :
+ * - new_session : "dictionary" (name or path, see findDictionary), "rules" ("motus" or "wordle",
+ *                 motus by default) and "template" (eg "a......", "....." by default for wordle).
+ *                 Responds with the "session" number and the number of potential "solutions".
+ * - add_hint : "session", "guess" and "hints" (one letter per hint, see formatHints).
+ *              Responds with the number of potential "solutions" left.
+ * - top : "session" and the number "n" of guesses wanted (10 by default).
+ *         Responds with the "guesses", each one with its "word" and "score", and their "source" :
+ *         "cache" for the first guesses, "book" for the opening book, or "solver".
+ * - end_session : "session".
+ * - stats : without "session", responds with the number of "sessions", the number of "resident" sessions,
+ *           and the "memory" they use against the "budget", in bytes.
+ *           With a "session", responds whether it is "resident", and the "memory" it uses.
+ * Responses have an "ok" member, and an "error" message when it is false.
+ *
+ * Requests can be handled concurrently : requests of different sessions run in parallel,
+ * while the requests of one session are serialized.
+ * Idle sessions are evicted to a compact form when their solvers exceed the memory budget,
+ * and restored on their next request.
+ */
+class SolverService {
+public:
+    /*
+     * Start a service without sessions.
+     *
+     * Throws :
+     * - InvalidArgException : if the solver is unknown.
+     */
+    explicit SolverService(SolverServiceOptions options = {});
+
+    // Sessions hold locks, the service can be neither copied nor moved
+    virtual ~SolverService() = default;
+    SolverService(const SolverService &other) = delete;
+    SolverService(SolverService &&other) = delete;
+    SolverService& operator=(const SolverService &other) = delete;
+    SolverService& operator=(SolverService &&other) = delete;
+
+    // Getters
+    const SolverServiceOptions& getOptions() const;
+
+    /*
+     * Return the number of open sessions.
+     */
+    size_t getSessionCount() const;
+
+    /*
+     * Return the open sessions.
+     */
+    const SessionManager& getSessions() const;
+
+    /*
+     * Return the memo shared by the sessions, or nullptr if it is disabled.
+     */
+    std::shared_ptr<SolverMemo> getMemo() const;
+
+    // Methods
+    /*
+     * Handle a request line, and return the response line, without the trailing newline.
+     * Errors, including invalid requests, are reported in the response.
+     */
+    std::string handleRequest(std::string_view request);
+
+    /*
+     * Load the resources of a dictionary ahead of the first session using it.
+     *
+     * Throws :
+     * - InvalidArgException : if the dictionary cannot be found.
+     * - Exception : if the dictionary cannot be loaded.
+     */
+    void preload(std::string_view dictionaryNameOrPath);
+
+    /*
+     * Write the access times of the binary caches (see BinaryCache::flushAccessTimes()).
+     * Errors are ignored, the caches stay valid without them.
+     */
+    void flushCaches();
+
+private:
+    /*
+     * Resident resources of a dictionary.
+     */
+    struct Resources {
+        std::filesystem::path dictionaryPath;
+        std::shared_ptr<Dictionary> dictionary;
+        std::map<RulesType, std::shared_ptr<IGameRules>> rules; // created on first use, guarded by mutex
+        std::optional<BinaryCache> cache;                       // guarded by mutex, a cache is not thread-safe
+        std::mutex mutex;
+    };
+
+    // Private methods
+    /*
+     * Return the resources of a dictionary, loading them if needed.
+     */
+    std::shared_ptr<Resources> getResources(std::string_view dictionaryNameOrPath);
+
+    /*
+     * Return the resources holding the rules of a session.
+     *
+     * Throws :
+     * - Exception : if the rules were not created by the service.
+     */
+    std::shared_ptr<Resources> getResources(const IGameRules& rules);
+
+    /*
+     * Return the memory retained by the loaded dictionaries, see Dictionary::getRetainedBytes().
+     */
+    size_t getDictionariesRetainedBytes();
+
+    // Request handlers, appending the members of the response
+    void newSession(const JsonObject& request, std::string& response);
+    void addHint(const JsonObject& request, std::string& response);
+    void topGuesses(const JsonObject& request, std::string& response);
+    void endSession(const JsonObject& request, std::string& response);
+    void stats(const JsonObject& request, std::string& response);
+
+    // Fields
+    SolverServiceOptions m_options;
+    std::shared_ptr<SolverMemo> m_memo;
+
+    std::map<std::string, std::shared_ptr<Resources>, std::less<>> m_resources; // by absolute dictionary path
+    std::mutex m_resourcesMutex;
+
+    SessionManager m_sessions;
+};
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_SOLVERSERVICE_H_ */
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Statistics.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "Statistics.h"
+
+namespace Alphadocte {
+
+namespace CLI {
+
+double percentile(const std::vector<double>& sortedSamples, double p) {
+    if (sortedSamples.empty())
+        return 0;
+
+    // nearest-rank: smallest sample such that at least p% of the samples are lower or equal
+    double rank = std::ceil(std::clamp(p, 0., 100.) / 100. * std::size(sortedSamples));
+    size_t index = rank < 1 ? 0 : static_cast<size_t>(rank) - 1;
+
+    return sortedSamples[std::min(index, std::size(sortedSamples) - 1)];
+}
+
+SampleSummary summarize(std::vector<double> samples) {
+    SampleSummary summary;
+
+    if (samples.empty())
+        return summary;
+
+    std::sort(std::begin(samples), std::end(samples));
+
+    summary.count = std::size(samples);
+    summary.min = samples.front();
+    summary.max = samples.back();
+    summary.mean = std::accumulate(std::cbegin(samples), std::cend(samples), 0.) / summary.count;
+
+    if (summary.count > 1) {
+        double squares{};
+        for (double sample : samples) {
+            squares += (sample - summary.mean) * (sample - summary.mean);
+        }
+        summary.stddev = std::sqrt(squares / (summary.count - 1));
+    }
+
+    summary.p50 = percentile(samples, 50);
+    summary.p95 = percentile(samples, 95);
+    summary.p99 = percentile(samples, 99);
+
+    return summary;
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
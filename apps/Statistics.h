@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Statistics.h
+ */
+
+#ifndef APPS_STATISTICS_H_
+#define APPS_STATISTICS_H_
+
+/*
+ * Private header providing statistical summaries of measurements,
+ * used by the benchmark executables.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <cstddef>
+#include <vector>
+
+namespace Alphadocte {
+
+namespace CLI {
+
+/*
+ * Statistical summary of a set of samples.
+ */
+struct SampleSummary {
+    size_t count{};
+    double min{};
+    double max{};
+    double mean{};
+    double stddev{}; // sample standard deviation, 0 if less than two samples
+    double p50{};    // median
+    double p95{};
+    double p99{};
+};
+
+/*
+ * Return the p-th percentile (p in [0, 100]) of sorted samples, using the nearest-rank method.
+ * Return 0 if there are no samples.
+ */
+double percentile(const std::vector<double>& sortedSamples, double p);
+
+/*
+ * Compute the statistical summary of the given samples.
+ * All fields are 0 if there are no samples.
+ */
+SampleSummary summarize(std::vector<double> samples);
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_STATISTICS_H_ */
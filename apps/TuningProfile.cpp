@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: TuningProfile.cpp
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include <Alphadocte/Exceptions.h>
+
+#include "Common.h"
+#include "Config.h"
+#include "TuningProfile.h"
+
+using namespace std::literals;
+
+namespace Alphadocte {
+
+namespace CLI {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+const std::string SECTION_MEASURE{"measure"};
+const std::string ENTRY_FORMAT_VERSION{"format_version"};
+const std::string ENTRY_CORES{"cores"};
+const std::string ENTRY_HISTOGRAM{"histogram"};
+const std::string ENTRY_THREADS{"threads"};
+const std::string ENTRY_MIN_PARALLEL{"min_parallel_patterns"};
+const std::string ENTRY_TEMPLATE{"template"};
+const std::string ENTRY_RULES{"rules"};
+const std::string ENTRY_PATTERNS{"patterns"};
+const std::string ENTRY_DURATION{"duration"};
+
+const std::string READ_FUNCTION{"Alphadocte::CLI::readTuningProfile(const std::filesystem::path&)"};
+
+const Entry& getEntry(const Section& section, std::string_view name) {
+    const Entry* entry = findEntry(section, name);
+    if (!entry)
+        throw Exception("Missing entry "s + std::string(name) + " in section " + section.name + '.', READ_FUNCTION);
+
+    return *entry;
+}
+
+template <typename T>
+T getNumber(const Section& section, std::string_view name) {
+    const auto& value = getEntry(section, name).value;
+    T result{};
+    auto [end, error] = std::from_chars(value.data(), value.data() + std::size(value), result);
+    if (value.empty() || error != std::errc{} || end != value.data() + std::size(value))
+        throw Exception("Invalid value " + value + " of entry " + std::string(name) + '.', READ_FUNCTION);
+
+    return result;
+}
+
+EntropyMaximizer::HistogramStrategy getHistogram(const Section& section) {
+    try {
+        return parseHistogramStrategy(getEntry(section, ENTRY_HISTOGRAM).value);
+    } catch (const InvalidArgException& e) {
+        throw Exception(e.what(), READ_FUNCTION);
+    }
+}
+
+template <typename T>
+std::string toString(T value) {
+    std::ostringstream stream;
+    stream << value;
+    return stream.str();
+}
+
+}
+
+std::string_view getHistogramName(EntropyMaximizer::HistogramStrategy histogram) {
+    switch (histogram) {
+    case EntropyMaximizer::HistogramStrategy::MAP:
+        return "map";
+    case EntropyMaximizer::HistogramStrategy::DENSE:
+        return "dense";
+    case EntropyMaximizer::HistogramStrategy::SORTED:
+        return "sorted";
+    }
+
+    return "unknown";
+}
+
+EntropyMaximizer::HistogramStrategy parseHistogramStrategy(std::string_view name) {
+    std::string lowerName{name};
+    std::transform(std::begin(lowerName), std::end(lowerName), std::begin(lowerName),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    using enum EntropyMaximizer::HistogramStrategy;
+    for (auto histogram : {MAP, DENSE, SORTED}) {
+        if (lowerName == getHistogramName(histogram))
+            return histogram;
+    }
+
+    throw InvalidArgException("Unknown histogram strategy " + std::string(name) + ", expected map, dense or sorted.",
+            "Alphadocte::CLI::parseHistogramStrategy(std::string_view)");
+}
+
+std::filesystem::path getTuningPath() {
+    auto cacheFolder = getCachePath();
+    if (cacheFolder.empty())
+        throw std::runtime_error("Dossier de cache introuvable.");
+
+    return cacheFolder / TUNING_FILE_NAME;
+}
+
+void writeTuningProfile(const TuningProfile& profile, const std::filesystem::path& path) {
+    Config config;
+    auto& root = config.getRootSection();
+    root.entries = {
+        {ENTRY_FORMAT_VERSION, std::to_string(TUNING_FORMAT_VERSION)},
+        {ENTRY_CORES, std::to_string(profile.nbCores)},
+        {ENTRY_HISTOGRAM, std::string(getHistogramName(profile.tuning.histogram))},
+        {ENTRY_THREADS, std::to_string(profile.tuning.nbThreads)},
+        {ENTRY_MIN_PARALLEL, std::to_string(profile.tuning.minParallelPatterns)}
+    };
+
+    for (const auto& measure : profile.measures) {
+        config.addSection(root, Section{SECTION_MEASURE, {
+            {ENTRY_TEMPLATE, measure.templateWord},
+            {ENTRY_RULES, measure.rules},
+            {ENTRY_PATTERNS, std::to_string(measure.nbPatterns)},
+            {ENTRY_HISTOGRAM, std::string(getHistogramName(measure.histogram))},
+            {ENTRY_THREADS, std::to_string(measure.nbThreads)},
+            {ENTRY_DURATION, toString(measure.duration)}
+        }, {}});
+    }
+
+    config.writeToFile(path);
+}
+
+TuningProfile readTuningProfile(const std::filesystem::path& path) {
+    Config config;
+    config.loadFromFile(path);
+    const auto& root = config.getRootSection();
+
+    if (getNumber<unsigned int>(root, ENTRY_FORMAT_VERSION) != TUNING_FORMAT_VERSION)
+        throw Exception("Unsupported format version of the tuning profile " + path.string() + '.', READ_FUNCTION);
+
+    TuningProfile profile;
+    profile.nbCores = getNumber<unsigned int>(root, ENTRY_CORES);
+    profile.tuning.histogram = getHistogram(root);
+    profile.tuning.nbThreads = getNumber<unsigned int>(root, ENTRY_THREADS);
+    profile.tuning.minParallelPatterns = getNumber<size_t>(root, ENTRY_MIN_PARALLEL);
+    if (profile.tuning.nbThreads == 0)
+        throw Exception("The number of threads of the tuning profile must be positive.", READ_FUNCTION);
+
+    for (const auto& section : root.sections) {
+        if (section.name != SECTION_MEASURE)
+            continue;
+
+        profile.measures.push_back(TuningMeasure{
+            .templateWord = getEntry(section, ENTRY_TEMPLATE).value,
+            .rules = getEntry(section, ENTRY_RULES).value,
+            .nbPatterns = getNumber<size_t>(section, ENTRY_PATTERNS),
+            .histogram = getHistogram(section),
+            .nbThreads = getNumber<unsigned int>(section, ENTRY_THREADS),
+            .duration = getNumber<double>(section, ENTRY_DURATION)
+        });
+    }
+
+    return profile;
+}
+
+EntropyMaximizer::Tuning parseTuningOverride(std::string_view text, EntropyMaximizer::Tuning tuning) {
+    const std::string functionName{"Alphadocte::CLI::parseTuningOverride(std::string_view, Alphadocte::EntropyMaximizer::Tuning)"};
+
+    std::istringstream settings{std::string(text)};
+    std::string setting;
+    while (std::getline(settings, setting, ',')) {
+        if (setting.empty())
+            continue;
+
+        auto separator = setting.find('=');
+        std::string key = setting.substr(0, separator);
+        std::string value = separator == std::string::npos ? ""s : setting.substr(separator + 1);
+
+        if (key == "histogram") {
+            tuning.histogram = parseHistogramStrategy(value);
+            continue;
+        }
+
+        size_t number{};
+        auto [end, error] = std::from_chars(value.data(), value.data() + std::size(value), number);
+        if (value.empty() || error != std::errc{} || end != value.data() + std::size(value))
+            throw InvalidArgException("Invalid tuning setting " + setting + ", expected a positive integer.", functionName);
+
+        if (key == "threads") {
+            if (number == 0)
+                throw InvalidArgException("Invalid tuning setting " + setting + ", the number of threads must be positive.", functionName);
+
+            tuning.nbThreads = static_cast<unsigned int>(number);
+        } else if (key == "min-parallel") {
+            tuning.minParallelPatterns = number;
+        } else {
+            throw InvalidArgException("Invalid tuning setting " + setting + ", expected histogram, threads or min-parallel.", functionName);
+        }
+    }
+
+    return tuning;
+}
+
+EntropyMaximizer::Tuning loadTuning() {
+    const char* envValue = std::getenv(TUNING_ENV_VAR.c_str());
+    std::string_view tuningOverride = envValue ? envValue : "";
+    EntropyMaximizer::Tuning tuning;
+
+    // the profile is ignored on another machine, or when explicitly asked to
+    if (tuningOverride != "none") {
+        std::filesystem::path profilePath;
+        try {
+            profilePath = getTuningPath();
+        } catch (const std::runtime_error&) {
+            // no cache folder, hence no profile
+        }
+
+        std::error_code error;
+        if (!profilePath.empty() && std::filesystem::is_regular_file(profilePath, error)) {
+            try {
+                auto profile = readTuningProfile(profilePath);
+                if (profile.nbCores == std::thread::hardware_concurrency()) {
+                    tuning = profile.tuning;
+                } else {
+                    std::cerr << "Avertissement : profil de réglage " << profilePath.string() << " ignoré, écrit pour "
+                              << profile.nbCores << " cœur(s)." << std::endl;
+                }
+            } catch (const Exception& e) {
+                std::cerr << "Avertissement : profil de réglage " << profilePath.string() << " ignoré : " << e.what() << std::endl;
+            }
+        }
+    }
+
+    if (!tuningOverride.empty() && tuningOverride != "none") {
+        try {
+            tuning = parseTuningOverride(tuningOverride, tuning);
+        } catch (const InvalidArgException& e) {
+            std::cerr << "Avertissement : " << TUNING_ENV_VAR << " ignorée : " << e.what() << std::endl;
+        }
+    }
+
+    EntropyMaximizer::setDefaultTuning(tuning);
+    return tuning;
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: TuningProfile.h
+ */
+
+#ifndef APPS_TUNINGPROFILE_H_
+#define APPS_TUNINGPROFILE_H_
+
+/*
+ * Private header used to store the tuning chosen for the machine (see the tune command of alphadocte-cache),
+ * and to give it to the solvers at the start of the executables.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Alphadocte/EntropyMaximizer.h>
+
+namespace Alphadocte {
+
+namespace CLI {
+
+// Environment variable overriding the tuning profile, eg "histogram=dense,threads=4" (see parseTuningOverride)
+inline const std::string TUNING_ENV_VAR{"ALPHADOCTE_TUNING"};
+inline const std::string TUNING_FILE_NAME{"tuning.txt"};
+inline const unsigned int TUNING_FORMAT_VERSION{1};
+
+/*
+ * Duration of the computation of the best guess of a first template, with one tuning.
+ */
+struct TuningMeasure {
+    std::string templateWord;
+    std::string rules;  // "motus" or "wordle", see getRulesName
+    size_t nbPatterns{}; // hints computed, ie potential guesses times potential solutions
+    EntropyMaximizer::HistogramStrategy histogram{EntropyMaximizer::HistogramStrategy::MAP};
+    unsigned int nbThreads{1};
+    double duration{};   // median duration (s)
+};
+
+/*
+ * Tuning chosen for a machine, with the measures it was chosen from.
+ */
+struct TuningProfile {
+    EntropyMaximizer::Tuning tuning;
+    unsigned int nbCores{}; // hardware threads of the machine, see std::thread::hardware_concurrency()
+    std::vector<TuningMeasure> measures;
+};
+
+/*
+ * Return the name of a histogram strategy ("map", "dense" or "sorted"), as accepted by parseHistogramStrategy.
+ */
+std::string_view getHistogramName(EntropyMaximizer::HistogramStrategy histogram);
+
+/*
+ * Return the histogram strategy from its name (case insensitive), as returned by getHistogramName.
+ *
+ * Throws :
+ * - InvalidArgException : if the name does not match any strategy.
+ */
+EntropyMaximizer::HistogramStrategy parseHistogramStrategy(std::string_view name);
+
+/*
+ * Return the path of the tuning profile, inside the cache folder.
+ *
+ * Throws :
+ * - std::runtime_error : if the cache folder cannot be found, see getCachePath().
+ */
+std::filesystem::path getTuningPath();
+
+/*
+ * Write the tuning profile to a file, in the config format (see Config).
+ *
+ * Throws :
+ * - Exception : if the file cannot be written.
+ */
+void writeTuningProfile(const TuningProfile& profile, const std::filesystem::path& path);
+
+/*
+ * Read a tuning profile written by writeTuningProfile.
+ *
+ * Throws :
+ * - Exception : if the file cannot be read, or is not a valid profile.
+ */
+TuningProfile readTuningProfile(const std::filesystem::path& path);
+
+/*
+ * Apply a manual override to a tuning, given as comma separated "key=value" settings :
+ * "histogram" (see parseHistogramStrategy), "threads" and "min-parallel" (see EntropyMaximizer::Tuning).
+ * Settings which are not given keep their value.
+ *
+ * Throws :
+ * - InvalidArgException : if a setting is unknown or invalid.
+ */
+EntropyMaximizer::Tuning parseTuningOverride(std::string_view text, EntropyMaximizer::Tuning tuning);
+
+/*
+ * Set the default tuning of the solvers (see EntropyMaximizer::setDefaultTuning()) at the start of an executable :
+ * the tuning profile of the cache folder, if it was written for a machine with as many cores,
+ * then the override of TUNING_ENV_VAR, where "none" ignores the profile.
+ * An invalid profile or override is ignored, after printing a warning.
+ *
+ * Return the tuning set.
+ */
+EntropyMaximizer::Tuning loadTuning();
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_TUNINGPROFILE_H_ */
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: UnixSocketServer.cpp
+ */
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <Alphadocte/Exceptions.h>
+
+#include "UnixSocketServer.h"
+
+namespace Alphadocte {
+
+namespace CLI {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+/*
+ * Fill the address of a socket path.
+ *
+ * Throws :
+ * - Exception : if the path does not fit in the address.
+ */
+sockaddr_un makeAddress(const std::filesystem::path& socketPath) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    auto path = socketPath.string();
+    if (std::size(path) >= sizeof(address.sun_path)) {
+        throw Alphadocte::Exception("Socket path too long : " + path + '.',
+                "Alphadocte::CLI::makeAddress(const std::filesystem::path&)");
+    }
+    std::memcpy(address.sun_path, path.c_str(), std::size(path) + 1);
+
+    return address;
+}
+
+/*
+ * Send the whole buffer, return false if the client disconnected.
+ */
+bool sendAll(int socket, std::string_view data) {
+    while (!data.empty()) {
+        auto sent = ::send(socket, data.data(), std::size(data), MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            return false;
+
+        data.remove_prefix(static_cast<size_t>(sent));
+    }
+
+    return true;
+}
+
+}
+
+UnixSocketServer::UnixSocketServer(std::filesystem::path socketPath, Handler handler)
+        : m_socketPath{std::move(socketPath)}, m_handler{std::move(handler)},
+          m_listenSocket{-1}, m_stopPipe{-1, -1}, m_clients{}, m_clientsMutex{} {
+    auto address = makeAddress(m_socketPath);
+
+    // A socket file nobody listens to is left by a server which did not stop cleanly
+    std::error_code error;
+    if (std::filesystem::exists(m_socketPath, error)) {
+        int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool running = probe >= 0 && ::connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+        if (probe >= 0)
+            ::close(probe);
+
+        if (running) {
+            throw Alphadocte::Exception("A server is already listening on " + m_socketPath.string() + '.',
+                    "Alphadocte::CLI::UnixSocketServer::UnixSocketServer(std::filesystem::path, Alphadocte::CLI::UnixSocketServer::Handler)");
+        }
+        std::filesystem::remove(m_socketPath, error);
+    }
+
+    m_listenSocket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listenSocket < 0
+            || ::bind(m_listenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+            || ::listen(m_listenSocket, SOMAXCONN) != 0
+            || ::pipe2(m_stopPipe, O_CLOEXEC) != 0) {
+        std::string reason = std::strerror(errno);
+        if (m_listenSocket >= 0)
+            ::close(m_listenSocket);
+        throw Alphadocte::Exception("Could not listen on " + m_socketPath.string() + " : " + reason,
+                "Alphadocte::CLI::UnixSocketServer::UnixSocketServer(std::filesystem::path, Alphadocte::CLI::UnixSocketServer::Handler)");
+    }
+}
+
+UnixSocketServer::~UnixSocketServer() {
+    // run() has joined the clients, unless it was never called
+    stop();
+    {
+        std::lock_guard lock{m_clientsMutex};
+        for (auto& client : m_clients) {
+            if (client->socket >= 0)
+                ::shutdown(client->socket, SHUT_RDWR);
+        }
+    }
+    for (auto& client : m_clients) {
+        if (client->thread.joinable())
+            client->thread.join();
+    }
+
+    ::close(m_listenSocket);
+    ::close(m_stopPipe[0]);
+    ::close(m_stopPipe[1]);
+
+    std::error_code error;
+    std::filesystem::remove(m_socketPath, error);
+}
+
+const std::filesystem::path& UnixSocketServer::getSocketPath() const {
+    return m_socketPath;
+}
+
+void UnixSocketServer::run() {
+    pollfd fds[2] = {{m_listenSocket, POLLIN, 0}, {m_stopPipe[0], POLLIN, 0}};
+
+    while (true) {
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (fds[1].revents != 0)
+            break;
+        if ((fds[0].revents & POLLIN) == 0)
+            continue;
+
+        int socket = ::accept4(m_listenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (socket < 0)
+            continue;
+
+        reapClients();
+
+        std::lock_guard lock{m_clientsMutex};
+        auto& client = m_clients.emplace_back(std::make_unique<Client>());
+        client->socket = socket;
+        client->done = false;
+        client->thread = std::thread{[this, &client = *client]() { serve(client); }};
+    }
+
+    // Disconnect the clients, their threads end on the next read
+    {
+        std::lock_guard lock{m_clientsMutex};
+        for (auto& client : m_clients) {
+            if (client->socket >= 0)
+                ::shutdown(client->socket, SHUT_RDWR);
+        }
+    }
+
+    for (auto& client : m_clients)
+        client->thread.join();
+    m_clients.clear();
+}
+
+void UnixSocketServer::stop() {
+    // write is async-signal-safe, a full pipe already stops the server
+    char byte{};
+    [[maybe_unused]] auto written = ::write(m_stopPipe[1], &byte, 1);
+}
+
+void UnixSocketServer::serve(Client& client) {
+    std::string buffer;
+    char chunk[4096];
+
+    while (true) {
+        // Answer the complete lines received so far
+        size_t lineStart{};
+        size_t lineEnd;
+        bool connected{true};
+        while (connected && (lineEnd = buffer.find('\n', lineStart)) != buffer.npos) {
+            std::string_view line{buffer.data() + lineStart, lineEnd - lineStart};
+            lineStart = lineEnd + 1;
+            if (!line.empty() && line.back() == '\r')
+                line.remove_suffix(1);
+            if (line.empty())
+                continue;
+
+            connected = sendAll(client.socket, m_handler(line) + '\n');
+        }
+        buffer.erase(0, lineStart);
+
+        if (!connected)
+            break;
+
+        if (std::size(buffer) > MAX_REQUEST_SIZE)
+            break;
+
+        auto received = ::recv(client.socket, chunk, sizeof(chunk), 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            break;
+
+        buffer.append(chunk, static_cast<size_t>(received));
+    }
+
+    std::lock_guard lock{m_clientsMutex};
+    ::close(client.socket);
+    client.socket = -1;
+    client.done = true;
+}
+
+void UnixSocketServer::reapClients() {
+    std::lock_guard lock{m_clientsMutex};
+    std::erase_if(m_clients, [](auto& client) {
+        if (!client->done)
+            return false;
+
+        client->thread.join();
+        return true;
+    });
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: UnixSocketServer.h
+ */
+
+#ifndef APPS_UNIXSOCKETSERVER_H_
+#define APPS_UNIXSOCKETSERVER_H_
+
+/*
+ * Private header providing a line-based server over a Unix domain socket (POSIX only).
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Alphadocte {
+
+namespace CLI {
+
+/*
+ * Server answering newline-delimited requests on a Unix domain socket.
+ * Each client is served by its own thread, which answers each request line, in order,
+ * with the line returned by the handler. Empty lines are ignored.
+ *
+ * The handler is called concurrently by the client threads, and must not throw.
+ */
+class UnixSocketServer {
+public:
+    using Handler = std::function<std::string(std::string_view request)>;
+
+    /*
+     * Listen on the socket path. A socket file left by a server which is not running anymore is replaced.
+     *
+     * Args :
+     * - socketPath : path of the socket file, removed on destruction
+     * - handler : returns the response line (without the newline) of a request line
+     *
+     * Throws :
+     * - Exception : if the path is too long, is used by a running server, or if the socket cannot be created.
+     */
+    UnixSocketServer(std::filesystem::path socketPath, Handler handler);
+
+    // Threads work on the server, which can be neither copied nor moved
+    virtual ~UnixSocketServer();
+    UnixSocketServer(const UnixSocketServer &other) = delete;
+    UnixSocketServer(UnixSocketServer &&other) = delete;
+    UnixSocketServer& operator=(const UnixSocketServer &other) = delete;
+    UnixSocketServer& operator=(UnixSocketServer &&other) = delete;
+
+    // Getters
+    const std::filesystem::path& getSocketPath() const;
+
+    // Methods
+    /*
+     * Accept and serve clients until stop() is called, then disconnect them and wait for their threads.
+     */
+    void run();
+
+    /*
+     * Make run() return. Can be called from any thread, or from a signal handler.
+     */
+    void stop();
+
+private:
+    /*
+     * Client connection, and the thread serving it.
+     */
+    struct Client {
+        int socket;                         // -1 once closed, guarded by m_clientsMutex
+        std::atomic<bool> done;
+        std::thread thread;
+    };
+
+    // Private methods
+    /*
+     * Answer the requests of a client until it disconnects.
+     */
+    void serve(Client& client);
+
+    /*
+     * Join the threads of the disconnected clients.
+     */
+    void reapClients();
+
+    // Fields
+    std::filesystem::path m_socketPath;
+    Handler m_handler;
+    int m_listenSocket;
+    int m_stopPipe[2];
+
+    std::vector<std::unique_ptr<Client>> m_clients;
+    std::mutex m_clientsMutex;
+
+    // Static constants
+public:
+    // longer requests are rejected, and their client disconnected
+    static constexpr size_t MAX_REQUEST_SIZE = 1024 * 1024;
+};
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_UNIXSOCKETSERVER_H_ */
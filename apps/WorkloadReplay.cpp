@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: WorkloadReplay.cpp
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string_view>
+
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/IGameRules.h>
+#include <Alphadocte/Solver.h>
+#include <Alphadocte/WorkloadRecorder.h>
+
+#include "Common.h"
+#include "WorkloadReplay.h"
+
+using namespace std::literals;
+
+namespace Alphadocte {
+
+namespace CLI {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+const std::string PARSE_FUNCTION{"Alphadocte::CLI::parseWorkload(std::istream&)"};
+
+[[noreturn]] void throwLineError(size_t lineNo, const std::string& reason) {
+    throw Exception("Line "s + std::to_string(lineNo) + ": " + reason, PARSE_FUNCTION);
+}
+
+// Check that the whole line was read
+void checkLineEnd(std::istringstream& words, size_t lineNo) {
+    if (!words)
+        throwLineError(lineNo, "missing or invalid field.");
+
+    std::string discarded;
+    if (words >> discarded)
+        throwLineError(lineNo, "got " + discarded + " after the last field, expected nothing.");
+}
+
+std::vector<std::string> splitGuesses(const std::string& guesses) {
+    std::vector<std::string> result;
+    if (guesses == "-")
+        return result;
+
+    std::istringstream stream{guesses};
+    std::string guess;
+    while (std::getline(stream, guess, ','))
+        result.push_back(std::move(guess));
+
+    return result;
+}
+
+}
+
+std::vector<RecordedGame> parseWorkload(std::istream& input) {
+    std::string line;
+    size_t lineNo{1};
+
+    // header
+    std::string header;
+    unsigned int version{};
+    if (!std::getline(input, line) || !(std::istringstream{line} >> header >> version) || header != WorkloadRecorder::HEADER)
+        throwLineError(lineNo, "expected the header "s + std::string(WorkloadRecorder::HEADER) + " and its version.");
+    if (version != WorkloadRecorder::FORMAT_VERSION)
+        throwLineError(lineNo, "unsupported format version " + std::to_string(version) + '.');
+
+    std::map<std::uint64_t, RecordedGame> games;
+    while (std::getline(input, line)) {
+        lineNo++;
+        std::istringstream words{line};
+        std::string kind;
+        std::uint64_t gameId{};
+        if (!(words >> kind))
+            continue; // empty line
+
+        if (!(words >> gameId))
+            throwLineError(lineNo, "expected a game id after " + kind + '.');
+
+        if (kind == "game") {
+            RecordedGame game;
+            game.id = gameId;
+            words >> game.solverName >> game.solverVersion >> game.rules >> game.maxGuesses
+                  >> game.nbWords >> game.contentHash >> game.templateWord;
+            checkLineEnd(words, lineNo);
+
+            if (!games.emplace(gameId, std::move(game)).second)
+                throwLineError(lineNo, "game " + std::to_string(gameId) + " is already defined.");
+            continue;
+        }
+
+        auto itGame = games.find(gameId);
+        if (itGame == std::end(games))
+            throwLineError(lineNo, "unknown game " + std::to_string(gameId) + '.');
+
+        RecordedStep step;
+        if (kind == "hint") {
+            step.type = RecordedStep::Type::HINT;
+            words >> step.guess >> step.hints;
+            checkLineEnd(words, lineNo);
+
+            try {
+                unpackHints(step.hints, static_cast<word_size>(std::size(step.guess)));
+            } catch (const InvalidArgException& e) {
+                throwLineError(lineNo, "invalid hints for " + step.guess + " (" + e.what() + ").");
+            }
+        } else if (kind == "compute") {
+            std::string guesses;
+            step.type = RecordedStep::Type::COMPUTE;
+            words >> step.n >> step.duration >> guesses;
+            checkLineEnd(words, lineNo);
+            step.guesses = splitGuesses(guesses);
+        } else {
+            throwLineError(lineNo, "unknown call " + kind + ", expected game, hint or compute.");
+        }
+
+        itGame->second.steps.push_back(std::move(step));
+    }
+
+    std::vector<RecordedGame> result;
+    result.reserve(std::size(games));
+    for (auto& [id, game] : games)
+        result.push_back(std::move(game));
+
+    return result;
+}
+
+std::vector<RecordedGame> loadWorkload(const std::filesystem::path& path) {
+    std::ifstream file{path};
+    if (!file) {
+        throw Exception("Cannot open the workload file " + path.string() + '.',
+                "Alphadocte::CLI::loadWorkload(const std::filesystem::path&)");
+    }
+
+    return parseWorkload(file);
+}
+
+ReplayResult replayWorkload(const std::vector<RecordedGame>& games, const RulesProvider& getRules,
+        const ReplayOptions& options) {
+    const std::string functionName{"Alphadocte::CLI::replayWorkload(const std::vector<Alphadocte::CLI::RecordedGame>&, "
+            "const Alphadocte::CLI::RulesProvider&, const Alphadocte::CLI::ReplayOptions&)"};
+    if (options.repetitions == 0)
+        throw InvalidArgException("The number of repetitions must be positive.", functionName);
+
+    // resolve the rules once, so that every repetition replays the same games
+    std::vector<std::pair<const RecordedGame*, std::shared_ptr<IGameRules>>> playable;
+    ReplayResult result;
+    for (const auto& game : games) {
+        auto rules = getRules(game);
+        if (!rules || rules->getDictionary()->getContentHash() != game.contentHash) {
+            result.nbSkippedGames++;
+            continue;
+        }
+
+        playable.emplace_back(&game, std::move(rules));
+    }
+    result.nbGames = std::size(playable);
+
+    double totalDuration{};
+    for (unsigned int repetition = 0; repetition < options.repetitions; repetition++) {
+        for (const auto& [game, rules] : playable) {
+            auto solver = createSolver(game->solverName, rules);
+
+            try {
+                solver->setTemplate(game->templateWord);
+                for (size_t i = 0; i < std::size(game->steps); i++) {
+                    const auto& step = game->steps[i];
+                    if (step.type == RecordedStep::Type::HINT) {
+                        solver->addHint(step.guess, unpackHints(step.hints, static_cast<word_size>(std::size(step.guess))));
+                        continue;
+                    }
+
+                    auto start = std::chrono::steady_clock::now();
+                    auto guesses = solver->computeNextGuesses(step.n);
+                    double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    totalDuration += duration;
+                    result.computeDurations.push_back(duration);
+
+                    if (repetition > 0)
+                        continue;
+
+                    result.nbComputations++;
+                    result.recordedDuration += step.duration;
+                    if (!options.compare)
+                        continue;
+
+                    std::vector<std::string> actual;
+                    for (auto& [guess, trust] : guesses)
+                        actual.push_back(std::move(guess));
+
+                    if (actual != step.guesses)
+                        result.mismatches.push_back(ReplayMismatch{game->id, i, step.guesses, std::move(actual)});
+                }
+            } catch (const Exception& e) {
+                throw Exception("Cannot replay game " + std::to_string(game->id) + ": " + e.what(), functionName);
+            }
+        }
+    }
+
+    result.replayedDuration = totalDuration / options.repetitions;
+    return result;
+}
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
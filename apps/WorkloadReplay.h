@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: WorkloadReplay.h
+ */
+
+#ifndef APPS_WORKLOADREPLAY_H_
+#define APPS_WORKLOADREPLAY_H_
+
+/*
+ * Private header used to read a workload recorded by a WorkloadRecorder, and to replay it.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Alphadocte/Hint.h>
+
+namespace Alphadocte {
+
+class IGameRules;
+
+namespace CLI {
+
+/*
+ * A call recorded during a game : either a hint added to the solver, or a computation of its next guesses.
+ */
+struct RecordedStep {
+    enum class Type {
+        HINT,
+        COMPUTE
+    };
+
+    Type type{Type::HINT};
+    std::string guess;                // HINT : the guess
+    HintCode hints{};                 // HINT : its hints, packed
+    size_t n{};                       // COMPUTE : the number of guesses requested
+    double duration{};                // COMPUTE : the recorded duration (s)
+    std::vector<std::string> guesses; // COMPUTE : the recorded guesses
+};
+
+/*
+ * A game recorded by a WorkloadRecorder, with its calls in their order.
+ */
+struct RecordedGame {
+    std::uint64_t id{};
+    std::string solverName;
+    unsigned int solverVersion{};
+    std::string rules;          // "motus", "wordle" or "other"
+    unsigned int maxGuesses{};
+    size_t nbWords{};           // number of words of the dictionary
+    std::uint64_t contentHash{}; // content hash of the dictionary
+    std::string templateWord;
+    std::vector<RecordedStep> steps;
+};
+
+/*
+ * Parse a workload written by a WorkloadRecorder, games being sorted by id.
+ *
+ * Throws :
+ * - Exception : if the workload is invalid, with the line of the error.
+ */
+std::vector<RecordedGame> parseWorkload(std::istream& input);
+
+/*
+ * Parse the workload file at the given path, see parseWorkload(std::istream&).
+ *
+ * Throws :
+ * - Exception : if the file cannot be read, or is invalid.
+ */
+std::vector<RecordedGame> loadWorkload(const std::filesystem::path& path);
+
+/*
+ * Options of a replay.
+ */
+struct ReplayOptions {
+    unsigned int repetitions{1}; // number of times the whole workload is replayed
+    bool compare{false};         // compare the guesses with the recorded ones
+};
+
+/*
+ * A computation whose guesses differ from the recorded ones.
+ */
+struct ReplayMismatch {
+    std::uint64_t gameId{};
+    size_t step{};                     // index of the step in the game
+    std::vector<std::string> expected; // recorded guesses
+    std::vector<std::string> actual;   // replayed guesses
+};
+
+/*
+ * Results of a replay.
+ */
+struct ReplayResult {
+    size_t nbGames{};                     // number of games replayed
+    size_t nbSkippedGames{};              // games skipped, as their rules or dictionary were not available
+    size_t nbComputations{};              // computations replayed by each repetition
+    double recordedDuration{};            // total recorded duration (s) of the computations replayed
+    double replayedDuration{};            // total replayed duration (s) of the computations, averaged over the repetitions
+    std::vector<double> computeDurations; // duration (s) of each replayed computation, for all repetitions
+    std::vector<ReplayMismatch> mismatches; // only filled when comparing, from the first repetition
+};
+
+/*
+ * Return the rules to replay a game with, or nullptr to skip it.
+ * Rules must use a dictionary whose content hash is the recorded one, or the game is skipped.
+ */
+using RulesProvider = std::function<std::shared_ptr<IGameRules>(const RecordedGame&)>;
+
+/*
+ * Replay the games with new solvers created from their recorded names (see createSolver),
+ * and measure the duration of each computation.
+ * The solver versions are not checked : replaying a workload with a newer build is the point.
+ *
+ * Args :
+ * - games : the recorded games
+ * - getRules : provides the rules of each game
+ * - options : the replay options
+ *
+ * Throws :
+ * - InvalidArgException : if the number of repetitions is 0, or a solver is unknown.
+ * - Exception : if a game cannot be replayed, eg an invalid hint, with its id.
+ */
+ReplayResult replayWorkload(const std::vector<RecordedGame>& games, const RulesProvider& getRules,
+        const ReplayOptions& options = {});
+
+} /* namespace CLI */
+
+} /* namespace Alphadocte */
+
+#endif /* APPS_WORKLOADREPLAY_H_ */
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Baseline.cpp
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#include <Alphadocte/Exceptions.h>
+
+#include "Baseline.h"
+#include "../apps/Config.h"
+
+namespace Alphadocte {
+
+namespace Benchmarks {
+
+static const std::string SECTION_BENCHMARK = "benchmark";
+static const std::string ENTRY_NAME = "name";
+static const std::string ENTRY_DATASET = "dataset";
+static const std::string ENTRY_OPS_PER_SECOND = "ops_per_second";
+
+// use the fastest sample, which is the least sensitive to the noise of other processes
+static double getOpsPerSecond(const BenchmarkResult& result) {
+    return result.timePerOp.min > 0 ? 1e9 / result.timePerOp.min : 0.;
+}
+
+void writeBaseline(const std::vector<BenchmarkResult>& results, const std::filesystem::path& path) {
+    CLI::Config config;
+
+    for (const auto& result : results) {
+        std::ostringstream opsPerSecond;
+        opsPerSecond << std::setprecision(6) << getOpsPerSecond(result);
+
+        config.getRootSection().sections.push_back(CLI::Section{
+            .name = SECTION_BENCHMARK,
+            .entries = {
+                CLI::Entry{ENTRY_NAME, result.name},
+                CLI::Entry{ENTRY_DATASET, result.dataset},
+                CLI::Entry{ENTRY_OPS_PER_SECOND, opsPerSecond.str()}
+            },
+            .sections = {}
+        });
+    }
+
+    config.writeToFile(path);
+}
+
+std::vector<BaselineComparison> compareToBaseline(const std::vector<BenchmarkResult>& results,
+        const std::filesystem::path& path, double tolerance) {
+    if (tolerance < 0 || tolerance >= 1) {
+        throw InvalidArgException("The tolerance must be in [0, 1).",
+                "Alphadocte::Benchmarks::compareToBaseline(const std::vector<Alphadocte::Benchmarks::BenchmarkResult>&, const std::filesystem::path&, double)");
+    }
+
+    CLI::Config config;
+    config.loadFromFile(path);
+
+    // (name, dataset) -> ops per second
+    std::map<std::pair<std::string, std::string>, double> baseline;
+    for (const auto& section : config.getRootSection().sections) {
+        if (section.name != SECTION_BENCHMARK)
+            continue;
+
+        std::string name, dataset, opsPerSecond;
+        for (const auto& entry : section.entries) {
+            if (entry.name == ENTRY_NAME)
+                name = entry.value;
+            else if (entry.name == ENTRY_DATASET)
+                dataset = entry.value;
+            else if (entry.name == ENTRY_OPS_PER_SECOND)
+                opsPerSecond = entry.value;
+        }
+
+        try {
+            baseline[{name, dataset}] = std::stod(opsPerSecond);
+        } catch (const std::logic_error&) {
+            throw Exception("Invalid throughput for benchmark " + name + ' ' + dataset + " in baseline " + path.string() + '.',
+                    "Alphadocte::Benchmarks::compareToBaseline(const std::vector<Alphadocte::Benchmarks::BenchmarkResult>&, const std::filesystem::path&, double)");
+        }
+    }
+
+    std::vector<BaselineComparison> comparisons;
+    for (const auto& result : results) {
+        BaselineComparison comparison{
+            .name = result.name,
+            .dataset = result.dataset,
+            .baselineOpsPerSecond = 0,
+            .currentOpsPerSecond = getOpsPerSecond(result),
+            .regressed = false
+        };
+
+        if (auto it = baseline.find({result.name, result.dataset}); it != std::cend(baseline)) {
+            comparison.baselineOpsPerSecond = it->second;
+            comparison.regressed = comparison.currentOpsPerSecond < (1 - tolerance) * it->second;
+        }
+
+        comparisons.push_back(std::move(comparison));
+    }
+
+    return comparisons;
+}
+
+void writeComparisons(std::ostream& os, const std::vector<BaselineComparison>& comparisons) {
+    size_t nameWidth{9};
+    for (const auto& comparison : comparisons) {
+        nameWidth = std::max(nameWidth, std::size(comparison.name) + std::size(comparison.dataset) + 1);
+    }
+
+    os << std::left << std::setw(static_cast<int>(nameWidth)) << "benchmark" << std::right
+       << std::setw(16) << "baseline ops/s" << std::setw(16) << "ops/s" << std::setw(10) << "ratio" << "  statut" << std::endl;
+
+    for (const auto& comparison : comparisons) {
+        os << std::left << std::setw(static_cast<int>(nameWidth)) << (comparison.name + ' ' + comparison.dataset) << std::right
+           << std::fixed << std::setprecision(1)
+           << std::setw(16) << comparison.baselineOpsPerSecond
+           << std::setw(16) << comparison.currentOpsPerSecond
+           << std::setprecision(3) << std::setw(10);
+
+        if (comparison.baselineOpsPerSecond > 0) {
+            os << comparison.currentOpsPerSecond / comparison.baselineOpsPerSecond
+               << (comparison.regressed ? "  RÉGRESSION" : "  ok") << std::endl;
+        } else {
+            os << "-" << "  nouveau" << std::endl;
+        }
+    }
+}
+
+} /* namespace Benchmarks */
+
+} /* namespace Alphadocte */
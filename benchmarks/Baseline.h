@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Baseline.h
+ */
+
+#ifndef BENCHMARKS_BASELINE_H_
+#define BENCHMARKS_BASELINE_H_
+
+/*
+ * Comparison of benchmark results with a baseline, used by the performance regression test.
+ * The baseline is stored with the config file format of the CLI executables,
+ * one "benchmark" section per result.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+
+namespace Alphadocte {
+
+namespace Benchmarks {
+
+/*
+ * Comparison of a benchmark with its baseline.
+ */
+struct BaselineComparison {
+    std::string name;
+    std::string dataset;
+    double baselineOpsPerSecond{};  // 0 if the benchmark is not in the baseline
+    double currentOpsPerSecond{};
+    bool regressed{};               // true if the current throughput is below the tolerance
+};
+
+/*
+ * Write the peak throughput (ie of the fastest sample) of the results as a baseline file.
+ *
+ * Throws :
+ * - Exception : if the file cannot be written.
+ */
+void writeBaseline(const std::vector<BenchmarkResult>& results, const std::filesystem::path& path);
+
+/*
+ * Compare the peak throughput of the results with the baseline.
+ * Benchmarks of the baseline which have not been run are ignored.
+ *
+ * Args :
+ * - results : the benchmark results
+ * - path : the baseline file
+ * - tolerance : the maximal accepted relative loss of throughput, in [0, 1)
+ *
+ * Throws :
+ * - Exception : if the baseline cannot be read or is invalid.
+ * - InvalidArgException : if the tolerance is not in [0, 1).
+ */
+std::vector<BaselineComparison> compareToBaseline(const std::vector<BenchmarkResult>& results,
+        const std::filesystem::path& path, double tolerance);
+
+/*
+ * Write the comparisons as a human-readable table.
+ */
+void writeComparisons(std::ostream& os, const std::vector<BaselineComparison>& comparisons);
+
+} /* namespace Benchmarks */
+
+} /* namespace Alphadocte */
+
+#endif /* BENCHMARKS_BASELINE_H_ */
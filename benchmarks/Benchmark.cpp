@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Benchmark.cpp
+ */
+
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+
+#include <Alphadocte/Alphadocte.h>
+#include <Alphadocte/Exceptions.h>
+
+#include "Benchmark.h"
+#include "../apps/Json.h"
+
+namespace Alphadocte {
+
+namespace Benchmarks {
+
+using Clock = std::chrono::steady_clock;
+
+static std::string formatDuration(double ns);
+static std::string formatCount(std::optional<double> count);
+static std::string formatJsonCount(std::optional<double> count);
+static std::string getCompilerName();
+static std::string getCurrentDate();
+
+BenchmarkRunner::BenchmarkRunner(BenchmarkOptions options) : m_options{std::move(options)}, m_results{}, m_counters{} {
+    if (m_options.repetitions == 0) {
+        throw InvalidArgException("At least one repetition is needed.",
+                "Alphadocte::Benchmarks::BenchmarkRunner::BenchmarkRunner(Alphadocte::Benchmarks::BenchmarkOptions)");
+    }
+
+    if (m_options.perfCounters)
+        m_counters = std::make_shared<CLI::PerfCounters>();
+}
+
+const BenchmarkOptions& BenchmarkRunner::getOptions() const {
+    return m_options;
+}
+
+const std::vector<BenchmarkResult>& BenchmarkRunner::getResults() const {
+    return m_results;
+}
+
+std::shared_ptr<const CLI::PerfCounters> BenchmarkRunner::getPerfCounters() const {
+    return m_counters;
+}
+
+bool BenchmarkRunner::isSelected(std::string_view name, std::string_view dataset) const {
+    std::string fullName{name};
+    fullName += ' ';
+    fullName += dataset;
+
+    return fullName.find(m_options.filter) != std::string::npos;
+}
+
+void BenchmarkRunner::run(std::string name, std::string dataset, size_t opsPerIteration, const std::function<void()>& function,
+        size_t patternsPerOp) {
+    if (!isSelected(name, dataset))
+        return;
+
+    // warm-up, while calibrating the number of iterations per sample
+    size_t iterations{1};
+    auto warmupStart = Clock::now();
+    while (true) {
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; i++) {
+            function();
+        }
+        auto end = Clock::now();
+
+        if (end - start < m_options.minSampleTime) {
+            iterations *= 2;
+        } else if (end - warmupStart >= m_options.warmup) {
+            break;
+        }
+    }
+
+    std::vector<double> samples;
+    samples.reserve(m_options.repetitions);
+    CLI::PerfCounts counts;
+    for (unsigned int r = 0; r < m_options.repetitions; r++) {
+        if (m_counters)
+            m_counters->start();
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; i++) {
+            function();
+        }
+        std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        if (m_counters)
+            counts.add(m_counters->getCounts());
+        samples.push_back(elapsed.count() / static_cast<double>(iterations * opsPerIteration));
+    }
+
+    addResult(std::move(name), std::move(dataset), iterations, opsPerIteration, std::move(samples), patternsPerOp, counts);
+}
+
+void BenchmarkRunner::runWithSetup(std::string name, std::string dataset, size_t opsPerIteration,
+        const std::function<void()>& setup, const std::function<void()>& function) {
+    if (!isSelected(name, dataset))
+        return;
+
+    // warm-up
+    auto warmupStart = Clock::now();
+    do {
+        setup();
+        function();
+    } while (Clock::now() - warmupStart < m_options.warmup);
+
+    std::vector<double> samples;
+    samples.reserve(m_options.repetitions);
+    CLI::PerfCounts counts;
+    for (unsigned int r = 0; r < m_options.repetitions; r++) {
+        setup();
+        if (m_counters)
+            m_counters->start();
+        auto start = Clock::now();
+        function();
+        std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        if (m_counters)
+            counts.add(m_counters->getCounts());
+        samples.push_back(elapsed.count() / static_cast<double>(opsPerIteration));
+    }
+
+    addResult(std::move(name), std::move(dataset), 1, opsPerIteration, std::move(samples), 0, counts);
+}
+
+void BenchmarkRunner::writeText(std::ostream& os) const {
+    size_t nameWidth{9};
+    for (const auto& result : m_results) {
+        nameWidth = std::max(nameWidth, std::size(result.name) + std::size(result.dataset) + 1);
+    }
+
+    os << std::left << std::setw(static_cast<int>(nameWidth)) << "benchmark" << std::right
+       << std::setw(12) << "mean" << std::setw(12) << "p50" << std::setw(12) << "p95"
+       << std::setw(12) << "stddev" << std::setw(14) << "ops/s" << std::endl;
+
+    for (const auto& result : m_results) {
+        const auto& time = result.timePerOp;
+        std::ostringstream opsPerSecond;
+        opsPerSecond << std::fixed << std::setprecision(0) << (time.p50 > 0 ? 1e9 / time.p50 : 0.);
+
+        os << std::left << std::setw(static_cast<int>(nameWidth)) << (result.name + ' ' + result.dataset) << std::right
+           << std::setw(12) << formatDuration(time.mean)
+           << std::setw(12) << formatDuration(time.p50)
+           << std::setw(12) << formatDuration(time.p95)
+           << std::setw(12) << formatDuration(time.stddev)
+           << std::setw(14) << opsPerSecond.str() << std::endl;
+    }
+
+    if (std::none_of(std::cbegin(m_results), std::cend(m_results), [](const auto& r) { return r.countsPerOp.hasCounts(); }))
+        return;
+
+    // hardware events, per operation then per hint pattern evaluated
+    os << std::endl;
+    os << std::left << std::setw(static_cast<int>(nameWidth)) << "benchmark" << std::right
+       << std::setw(8) << "IPC" << std::setw(12) << "cycles/op" << std::setw(12) << "instr/op"
+       << std::setw(15) << "cache-miss/op" << std::setw(16) << "branch-miss/op"
+       << std::setw(20) << "cache-miss/pattern" << std::setw(21) << "branch-miss/pattern" << std::endl;
+
+    for (const auto& result : m_results) {
+        if (!result.countsPerOp.hasCounts())
+            continue;
+
+        const auto& perOp = result.countsPerOp;
+        auto perPattern = perOp.divide(static_cast<double>(result.patternsPerOp));
+        os << std::left << std::setw(static_cast<int>(nameWidth)) << (result.name + ' ' + result.dataset) << std::right
+           << std::setw(8) << formatCount(perOp.getIpc())
+           << std::setw(12) << formatCount(perOp.get(CLI::PerfEvent::CYCLES))
+           << std::setw(12) << formatCount(perOp.get(CLI::PerfEvent::INSTRUCTIONS))
+           << std::setw(15) << formatCount(perOp.get(CLI::PerfEvent::CACHE_MISSES))
+           << std::setw(16) << formatCount(perOp.get(CLI::PerfEvent::BRANCH_MISSES))
+           << std::setw(20) << formatCount(perPattern.get(CLI::PerfEvent::CACHE_MISSES))
+           << std::setw(21) << formatCount(perPattern.get(CLI::PerfEvent::BRANCH_MISSES)) << std::endl;
+    }
+}
+
+void BenchmarkRunner::writeJson(std::ostream& os, std::string_view label) const {
+    os << std::setprecision(9);
+    os << "{\n";
+    os << "  \"label\": " << CLI::quoteJson(label) << ",\n";
+    os << "  \"date\": " << CLI::quoteJson(getCurrentDate()) << ",\n";
+    os << "  \"version\": " << CLI::quoteJson(ALPHADOCTE_VERSION_NAME) << ",\n";
+    os << "  \"compiler\": " << CLI::quoteJson(getCompilerName()) << ",\n";
+    os << "  \"build_type\": " << CLI::quoteJson(ALPHADOCTE_BENCHMARKS_BUILD_TYPE) << ",\n";
+    os << "  \"options\": {\"repetitions\": " << m_options.repetitions
+       << ", \"warmup_ms\": " << std::chrono::duration<double, std::milli>(m_options.warmup).count()
+       << ", \"min_sample_ms\": " << std::chrono::duration<double, std::milli>(m_options.minSampleTime).count()
+       << ", \"seed\": " << m_options.seed << "},\n";
+    os << "  \"benchmarks\": [";
+
+    std::string sep = "\n";
+    for (const auto& result : m_results) {
+        const auto& time = result.timePerOp;
+        os << sep << "    {\"name\": " << CLI::quoteJson(result.name)
+           << ", \"dataset\": " << CLI::quoteJson(result.dataset)
+           << ", \"iterations\": " << result.iterations
+           << ", \"ops_per_iteration\": " << result.opsPerIteration
+           << ", \"ops_per_second\": " << (time.p50 > 0 ? 1e9 / time.p50 : 0.)
+           << ", \"ns_per_op\": {\"samples\": " << time.count
+           << ", \"mean\": " << time.mean
+           << ", \"stddev\": " << time.stddev
+           << ", \"min\": " << time.min
+           << ", \"p50\": " << time.p50
+           << ", \"p95\": " << time.p95
+           << ", \"p99\": " << time.p99
+           << ", \"max\": " << time.max << '}';
+
+        if (result.countsPerOp.hasCounts()) {
+            const auto& perOp = result.countsPerOp;
+            os << ", \"counters_per_op\": {\"ipc\": " << formatJsonCount(perOp.getIpc());
+            for (size_t i = 0; i < CLI::NB_PERF_EVENTS; i++) {
+                auto event = static_cast<CLI::PerfEvent>(i);
+                os << ", " << CLI::quoteJson(CLI::PerfCounters::getEventName(event)) << ": " << formatJsonCount(perOp.get(event));
+            }
+            os << '}';
+
+            if (result.patternsPerOp > 0) {
+                auto perPattern = perOp.divide(static_cast<double>(result.patternsPerOp));
+                os << ", \"patterns_per_op\": " << result.patternsPerOp
+                   << ", \"counters_per_pattern\": {\"cache_misses\": " << formatJsonCount(perPattern.get(CLI::PerfEvent::CACHE_MISSES))
+                   << ", \"branch_misses\": " << formatJsonCount(perPattern.get(CLI::PerfEvent::BRANCH_MISSES)) << '}';
+            }
+        }
+
+        os << '}';
+        sep = ",\n";
+    }
+
+    os << "\n  ]\n";
+    os << "}" << std::endl;
+}
+
+void BenchmarkRunner::addResult(std::string name, std::string dataset, size_t iterations,
+        size_t opsPerIteration, std::vector<double> samples, size_t patternsPerOp, const CLI::PerfCounts& counts) {
+    double nbOps = static_cast<double>(std::size(samples) * iterations * opsPerIteration);
+    m_results.push_back(BenchmarkResult{
+        .name = std::move(name),
+        .dataset = std::move(dataset),
+        .iterations = iterations,
+        .opsPerIteration = opsPerIteration,
+        .timePerOp = CLI::summarize(std::move(samples)),
+        .patternsPerOp = patternsPerOp,
+        .countsPerOp = counts.divide(nbOps)
+    });
+}
+
+std::vector<std::string> pickWords(const std::vector<std::string>& words, size_t n, unsigned long seed) {
+    std::vector<std::string> picked;
+    if (words.empty())
+        return picked;
+
+    boost::mt19937 random(static_cast<boost::mt19937::result_type>(seed));
+    boost::random::uniform_int_distribution<size_t> distribution{0, std::size(words) - 1};
+    for (size_t i = 0; i < n; i++) {
+        picked.push_back(words[distribution(random)]);
+    }
+
+    return picked;
+}
+
+static std::string formatDuration(double ns) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+
+    if (ns < 1e3) {
+        oss << ns << " ns";
+    } else if (ns < 1e6) {
+        oss << ns / 1e3 << " us";
+    } else if (ns < 1e9) {
+        oss << ns / 1e6 << " ms";
+    } else {
+        oss << ns / 1e9 << " s";
+    }
+
+    return oss.str();
+}
+
+static std::string formatCount(std::optional<double> count) {
+    if (!count)
+        return "-";
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << *count;
+    return oss.str();
+}
+
+static std::string formatJsonCount(std::optional<double> count) {
+    if (!count)
+        return "null";
+
+    std::ostringstream oss;
+    oss << std::setprecision(9) << *count;
+    return oss.str();
+}
+
+static std::string getCompilerName() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+static std::string getCurrentDate() {
+    std::time_t now = std::time(nullptr);
+    char buffer[32]{};
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buffer;
+}
+
+} /* namespace Benchmarks */
+
+} /* namespace Alphadocte */
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Benchmark.h
+ */
+
+#ifndef BENCHMARKS_BENCHMARK_H_
+#define BENCHMARKS_BENCHMARK_H_
+
+/*
+ * Minimal microbenchmark harness used by alphadocte-benchmarks.
+ *
+ * This is NOT a part of the library.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../apps/PerfCounters.h"
+#include "../apps/Statistics.h"
+
+namespace Alphadocte {
+
+class Dictionary;
+class IGameRules;
+
+namespace Benchmarks {
+
+/*
+ * Prevent the compiler from optimizing away a computed value.
+ */
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/*
+ * Word list on which the benchmarks are run, with the rules used by the solver benchmarks.
+ */
+struct Dataset {
+    std::string name;                       // unique name, used in the results
+    std::filesystem::path path;             // path of the word list
+    std::shared_ptr<Dictionary> dictionary; // loaded dictionary (restricted to 5 letters words for Wordle)
+    std::shared_ptr<IGameRules> rules;      // rules used by the solvers
+};
+
+/*
+ * Options of a benchmark run.
+ */
+struct BenchmarkOptions {
+    std::string filter{};           // only run benchmarks whose "name dataset" contains this
+    unsigned int repetitions{20};   // number of measured samples
+    std::chrono::nanoseconds warmup{std::chrono::milliseconds{100}};        // minimal warm-up duration
+    std::chrono::nanoseconds minSampleTime{std::chrono::milliseconds{10}};  // minimal duration of a sample
+    unsigned long seed{42};         // seed used to pick the inputs
+    bool perfCounters{false};       // count the hardware events of the measured samples, if available
+};
+
+/*
+ * Result of a benchmark. Durations are in nanoseconds per operation.
+ */
+struct BenchmarkResult {
+    std::string name;               // benchmark name, eg "game/computeHints"
+    std::string dataset;            // dataset name, or empty if the benchmark does not depend on a dataset
+    size_t iterations{};            // number of iterations per sample
+    size_t opsPerIteration{};       // number of operations per iteration
+    CLI::SampleSummary timePerOp;   // duration of an operation, in ns
+    size_t patternsPerOp{};         // number of hint patterns evaluated by an operation, 0 if irrelevant
+    CLI::PerfCounts countsPerOp;    // hardware events per operation, over all the samples (empty without counters)
+};
+
+/*
+ * Run benchmarks and collect their results.
+ */
+class BenchmarkRunner {
+public:
+    explicit BenchmarkRunner(BenchmarkOptions options);
+
+    // Default constructors/destructor
+    virtual ~BenchmarkRunner() = default;
+    BenchmarkRunner(const BenchmarkRunner &other) = default;
+    BenchmarkRunner(BenchmarkRunner &&other) = default;
+    BenchmarkRunner& operator=(const BenchmarkRunner &other) = default;
+    BenchmarkRunner& operator=(BenchmarkRunner &&other) = default;
+
+    // Getters
+    const BenchmarkOptions& getOptions() const;
+    const std::vector<BenchmarkResult>& getResults() const;
+
+    /*
+     * Return the hardware counters, or nullptr if they were not requested.
+     * The counters may be unavailable, see CLI::PerfCounters::isAvailable().
+     */
+    std::shared_ptr<const CLI::PerfCounters> getPerfCounters() const;
+
+    // Methods
+    /*
+     * Return true if the benchmark is selected by the filter.
+     */
+    bool isSelected(std::string_view name, std::string_view dataset) const;
+
+    /*
+     * Measure the given function, if selected by the filter.
+     *
+     * The function is first called repeatedly for the warm-up duration,
+     * which also calibrates the number of iterations per sample so that each sample
+     * lasts at least the minimal sample time. Then the configured number of samples is measured.
+     *
+     * Args :
+     * - name : the benchmark name
+     * - dataset : the dataset name, may be empty
+     * - opsPerIteration : the number of operations done by one call of the function,
+     *                     used to report the time per operation
+     * - function : the measured function
+     * - patternsPerOp : the number of hint patterns evaluated by one operation, used to report
+     *                   the hardware events per pattern (0 if irrelevant)
+     */
+    void run(std::string name, std::string dataset, size_t opsPerIteration, const std::function<void()>& function,
+            size_t patternsPerOp = 0);
+
+    /*
+     * Measure a function which needs a fresh state for each call, if selected by the filter.
+     * setup is called before each call of function, and is not measured.
+     * Each sample is then a single iteration.
+     */
+    void runWithSetup(std::string name, std::string dataset, size_t opsPerIteration,
+            const std::function<void()>& setup, const std::function<void()>& function);
+
+    /*
+     * Write the results as a human-readable table.
+     */
+    void writeText(std::ostream& os) const;
+
+    /*
+     * Write the results as a JSON document, with the run's metadata.
+     *
+     * Args :
+     * - label : an arbitrary label identifying the run (eg. a commit), may be empty
+     */
+    void writeJson(std::ostream& os, std::string_view label) const;
+
+private:
+    void addResult(std::string name, std::string dataset, size_t iterations,
+            size_t opsPerIteration, std::vector<double> samples, size_t patternsPerOp, const CLI::PerfCounts& counts);
+
+    // Fields
+    BenchmarkOptions m_options;
+    std::vector<BenchmarkResult> m_results;
+    std::shared_ptr<CLI::PerfCounters> m_counters; // nullptr if not requested
+};
+
+/*
+ * Pick n words at random (with replacement) among the given words, in a reproducible way.
+ * Return an empty vector if there is no word to pick from.
+ */
+std::vector<std::string> pickWords(const std::vector<std::string>& words, size_t n, unsigned long seed);
+
+// Benchmark suites, each one runs the benchmarks of a module over the given datasets
+void runGameBenchmarks(BenchmarkRunner& runner, const std::vector<Dataset>& datasets);
+void runDictionaryBenchmarks(BenchmarkRunner& runner, const std::vector<Dataset>& datasets);
+void runSolverBenchmarks(BenchmarkRunner& runner, const std::vector<Dataset>& datasets);
+void runConfigBenchmarks(BenchmarkRunner& runner, const std::vector<std::filesystem::path>& configFiles);
+void runPerfBenchmarks(BenchmarkRunner& runner, const std::vector<Dataset>& datasets); // regression test workloads
+void runWorkloadBenchmarks(BenchmarkRunner& runner, const std::vector<Dataset>& datasets,
+        const std::filesystem::path& workloadPath); // recorded workload, see WorkloadRecorder
+
+} /* namespace Benchmarks */
+
+} /* namespace Alphadocte */
+
+#endif /* BENCHMARKS_BENCHMARK_H_ */
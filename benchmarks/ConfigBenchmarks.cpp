@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: ConfigBenchmarks.cpp
+ */
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../apps/Config.h"
+
+namespace Alphadocte {
+
+namespace Benchmarks {
+
+void runConfigBenchmarks(BenchmarkRunner& runner, const std::vector<std::filesystem::path>& configFiles) {
+    for (const auto& path : configFiles) {
+        CLI::Config config;
+        runner.run("config/loadFromFile", path.stem().string(), 1, [&config, &path]() {
+            config.loadFromFile(path);
+            doNotOptimize(config.getRootSection());
+        });
+
+        // look up every guess section by its template, as the cache does
+        std::vector<std::pair<const CLI::Section*, std::string>> lookups;
+        for (const auto& solverSection : config.getRootSection().sections) {
+            for (const auto& guessSection : solverSection.sections) {
+                for (const auto& entry : guessSection.entries) {
+                    if (entry.name == "template")
+                        lookups.emplace_back(&solverSection, entry.value);
+                }
+            }
+        }
+
+        if (std::empty(lookups))
+            continue;
+
+        runner.run("config/findSection", path.stem().string(), std::size(lookups), [&config, &lookups]() {
+            for (const auto& [solverSection, templateWord] : lookups)
+                doNotOptimize(config.findSection(*solverSection, "guess_entry", "template", templateWord));
+        });
+    }
+}
+
+} /* namespace Benchmarks */
+
+} /* namespace Alphadocte */
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: DictionaryBenchmarks.cpp
+ */
+
+#include <memory>
+#include <optional>
+#include <set>
+
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/TxtDictionary.h>
+
+#include "Benchmark.h"
+
+namespace Alphadocte {
+
+namespace Benchmarks {
+
+static const size_t NB_QUERIES = 1024;
+
+void runDictionaryBenchmarks(BenchmarkRunner& runner, const std::vector<Dataset>& datasets) {
+    std::set<std::filesystem::path> loadedFiles;
+
+    for (const auto& dataset : datasets) {
+        const auto& dictionary = *dataset.dictionary;
+
+        // half of the queries are known words, the other half are altered words (most likely unknown)
+        auto queries = pickWords(dictionary.getAllWords(), NB_QUERIES, runner.getOptions().seed);
+        for (size_t i = 1; i < std::size(queries); i += 2) {
+            queries[i].back() = queries[i].back() == 'z' ? 'a' : queries[i].back() + 1;
+        }
+
+        runner.run("dictionary/contains", dataset.name, std::size(queries), [&dictionary, &queries]() {
+            for (const auto& word : queries) {
+                bool found = dictionary.contains(word);
+                doNotOptimize(found);
+            }
+        });
+
+        // several datasets may share the same file, only measure its loading once
+        if (!loadedFiles.insert(dataset.path).second)
+            continue;
+
+        // a dictionary can only be loaded once, thus use a new instance for each sample
+        std::optional<TxtDictionary> txtDictionary;
+        runner.runWithSetup("dictionary/load", dataset.path.stem().string(), 1, [&txtDictionary, &dataset]() {
+            txtDictionary.emplace(dataset.path);
+        }, [&txtDictionary]() {
+            bool loaded = txtDictionary->load();
+            doNotOptimize(loaded);
+        });
+    }
+}
+
+} /* namespace Benchmarks */
+
+} /* namespace Alphadocte */
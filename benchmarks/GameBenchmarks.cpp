@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: GameBenchmarks.cpp
+ */
+
+#include <map>
+
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/Game.h>
+#include <Alphadocte/Hint.h>
+
+#include "Benchmark.h"
+
+namespace Alphadocte {
+
+namespace Benchmarks {
+
+static const size_t NB_PAIRS = 1024;
+
+/*
+ * Pick pairs of words of the same size, used as (guess, solution).
+ */
+static std::vector<std::pair<std::string, std::string>> pickPairs(const Dictionary& dictionary, unsigned long seed) {
+    std::map<size_t, std::vector<std::string>> wordsBySize;
+    for (const auto& word : dictionary.getAllWords()) {
+        wordsBySize[std::size(word)].push_back(word);
+    }
+
+    std::vector<std::pair<std::string, std::string>> pairs;
+    auto solutions = pickWords(dictionary.getAllWords(), NB_PAIRS, seed);
+    for (size_t i = 0; i < std::size(solutions); i++) {
+        auto guess = pickWords(wordsBySize[std::size(solutions[i])], 1, seed + i);
+        pairs.emplace_back(std::move(guess.front()), std::move(solutions[i]));
+    }
+
+    return pairs;
+}
+
+void runGameBenchmarks(BenchmarkRunner& runner, const std::vector<Dataset>& datasets) {
+    for (const auto& dataset : datasets) {
+        auto pairs = pickPairs(*dataset.dictionary, runner.getOptions().seed);
+        if (pairs.empty())
+            continue;
+
+        runner.run("game/computeHints", dataset.name, std::size(pairs), [&pairs]() {
+            for (const auto& [guess, solution] : pairs) {
+                auto hints = Game::computeHints(guess, solution);
+                doNotOptimize(hints);
+            }
+        }, 1);
+
+        runner.run("game/computeHintCode", dataset.name, std::size(pairs), [&pairs]() {
+            for (const auto& [guess, solution] : pairs) {
+                auto code = Game::computeHintCode(guess, solution);
+                doNotOptimize(code);
+            }
+        }, 1);
+
+        // check whether other words match the hints given by a guess,
+        // words are taken from the next pair so that they are usually not the solution
+        std::vector<std::vector<HintType>> hints;
+        for (const auto& [guess, solution] : pairs) {
+            hints.push_back(Game::computeHints(guess, solution));
+        }
+
+        runner.run("hint/matches", dataset.name, std::size(pairs), [&pairs, &hints]() {
+            for (size_t i = 0; i < std::size(pairs); i++) {
+                const auto& word = pairs[(i + 1) % std::size(pairs)].second;
+                bool match = matches(word, pairs[i].first, hints[i]);
+                doNotOptimize(match);
+            }
+        }, 1);
+    }
+}
+
+} /* namespace Benchmarks */
+
+} /* namespace Alphadocte */
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: MainBenchmarks.cpp
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/FixedSizeDictionary.h>
+#include <Alphadocte/MotusGameRules.h>
+#include <Alphadocte/TxtDictionary.h>
+#include <Alphadocte/WordleGameRules.h>
+
+#include "Baseline.h"
+#include "Benchmark.h"
+#include "../apps/CommandLine.h"
+#include "../apps/Common.h"
+#include "../apps/Config.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::Benchmarks;
+
+static const unsigned int MAX_GUESSES = 6;
+static const word_size WORDLE_SIZE = 5;
+static const size_t NB_SYNTHETIC_TEMPLATES = 2000;
+static const double DEFAULT_TOLERANCE = 0.5;
+static const std::string SYNTHETIC_CACHE_NAME = "alphadocte_synthetic_cache";
+
+void printUsage(std::string_view programName);
+std::vector<Dataset> loadDatasets(const std::filesystem::path& dataDir, const std::filesystem::path& testDataDir,
+        const std::filesystem::path& extraWordList);
+std::filesystem::path writeSyntheticCache(const std::vector<Dataset>& datasets, unsigned long seed);
+
+int main(int argc, char* argv[]) {
+    try {
+        CLI::CommandLine args{argc, argv};
+        args.checkOptions({"help", "filter", "repetitions", "warmup-ms", "min-sample-ms", "seed",
+                "format", "output", "label", "data-dir", "test-data-dir", "baseline", "tolerance", "write-baseline", "wordlist", "trace",
+                "perf-counters", "workload"});
+
+        if (args.has("help")) {
+            printUsage(args.getProgramName());
+            return 0;
+        }
+
+        BenchmarkOptions options;
+        options.filter = args.getString("filter");
+        options.repetitions = static_cast<unsigned int>(args.getUnsigned("repetitions", options.repetitions));
+        options.warmup = std::chrono::milliseconds{args.getUnsigned("warmup-ms", 100)};
+        options.minSampleTime = std::chrono::milliseconds{args.getUnsigned("min-sample-ms", 10)};
+        options.seed = args.getUnsigned("seed", options.seed);
+        options.perfCounters = args.has("perf-counters");
+
+        std::string format = args.getString("format", "text");
+        if (format != "text" && format != "json") {
+            throw InvalidArgException("Unknown format " + format + ", expected text or json.", "main(int, char*[])");
+        }
+
+        std::filesystem::path dataDir = args.getString("data-dir", ALPHADOCTE_BENCHMARKS_DATA_DIR);
+        std::filesystem::path testDataDir = args.getString("test-data-dir", ALPHADOCTE_BENCHMARKS_TEST_DATA_DIR);
+        auto datasets = loadDatasets(dataDir, testDataDir, args.getString("wordlist"));
+
+        CLI::TraceRecording trace{args.has("trace") ? std::filesystem::path{args.getString("trace")} : CLI::getTracePath()};
+        BenchmarkRunner runner{options};
+        if (auto counters = runner.getPerfCounters(); counters && !counters->isAvailable()) {
+            std::cerr << "Compteurs matériels indisponibles, mesures sans compteurs : " << counters->getUnavailableReason() << std::endl;
+        }
+        runGameBenchmarks(runner, datasets);
+        runDictionaryBenchmarks(runner, datasets);
+        runSolverBenchmarks(runner, datasets);
+        std::vector<std::filesystem::path> configFiles{
+            testDataDir / "config" / "example_config.txt",
+            testDataDir / "config" / "cache_config.txt"
+        };
+        // only write the synthetic cache when its benchmarks are selected
+        if (runner.isSelected("config/loadFromFile", SYNTHETIC_CACHE_NAME) || runner.isSelected("config/findSection", SYNTHETIC_CACHE_NAME))
+            configFiles.push_back(writeSyntheticCache(datasets, options.seed));
+        runConfigBenchmarks(runner, configFiles);
+        runPerfBenchmarks(runner, datasets);
+        if (args.has("workload"))
+            runWorkloadBenchmarks(runner, datasets, args.getString("workload"));
+
+        std::ofstream file;
+        if (args.has("output")) {
+            file.open(args.getString("output"));
+            if (!file) {
+                std::cerr << "Impossible d'écrire dans " << args.getString("output") << std::endl;
+                return 1;
+            }
+        }
+        std::ostream& output = args.has("output") ? file : std::cout;
+
+        if (format == "json") {
+            runner.writeJson(output, args.getString("label"));
+        } else {
+            runner.writeText(output);
+        }
+
+        if (args.has("write-baseline")) {
+            writeBaseline(runner.getResults(), args.getString("write-baseline"));
+            std::cerr << "Référence écrite dans " << args.getString("write-baseline") << std::endl;
+        }
+
+        if (args.has("baseline")) {
+            auto comparisons = compareToBaseline(runner.getResults(), args.getString("baseline"),
+                    args.getDouble("tolerance", DEFAULT_TOLERANCE));
+            std::cout << std::endl;
+            writeComparisons(std::cout, comparisons);
+
+            if (std::any_of(std::cbegin(comparisons), std::cend(comparisons), [](const auto& c) { return c.regressed; })) {
+                std::cerr << "Régression de performances par rapport à " << args.getString("baseline") << std::endl;
+                return 2;
+            }
+        }
+    } catch (const Exception& e) {
+        std::cerr << "Erreur : " << e.what() << std::endl;
+        std::cerr << "Voir --help pour l'utilisation." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+void printUsage(std::string_view programName) {
+    std::cout << "Microbenchmarks de la bibliothèque Alphadocte." << std::endl;
+    std::cout << std::endl;
+    std::cout << "Utilisation : " << programName << " [options]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options :" << std::endl;
+    std::cout << "  --filter=TEXTE         ne lancer que les benchmarks dont le nom (suivi du jeu de données) contient ce texte" << std::endl;
+    std::cout << "  --repetitions=N        nombre de mesures par benchmark (20 par défaut)" << std::endl;
+    std::cout << "  --warmup-ms=N          durée minimale de la chauffe, en ms (100 par défaut)" << std::endl;
+    std::cout << "  --min-sample-ms=N      durée minimale d'une mesure, en ms (10 par défaut)" << std::endl;
+    std::cout << "  --seed=N               graine utilisée pour choisir les entrées (42 par défaut)" << std::endl;
+    std::cout << "  --format=text|json     format des résultats (text par défaut)" << std::endl;
+    std::cout << "  --output=CHEMIN        écrire les résultats dans un fichier plutôt que sur la sortie standard" << std::endl;
+    std::cout << "  --label=TEXTE          étiquette ajoutée aux résultats JSON (ex: un commit)" << std::endl;
+    std::cout << "  --data-dir=CHEMIN      dossier des listes de mots fournies" << std::endl;
+    std::cout << "  --test-data-dir=CHEMIN dossier des données de test" << std::endl;
+    std::cout << "  --wordlist=CHEMIN      liste de mots supplémentaire (ex: générée par alphadocte-gendict)" << std::endl;
+    std::cout << "  --baseline=CHEMIN      comparer les débits à ceux du fichier de référence, échouer en cas de régression" << std::endl;
+    std::cout << "  --tolerance=X          perte relative de débit acceptée par rapport à la référence (" << DEFAULT_TOLERANCE << " par défaut)" << std::endl;
+    std::cout << "  --write-baseline=CHEMIN écrire les débits mesurés comme nouvelle référence" << std::endl;
+    std::cout << "  --trace=CHEMIN         écrire les traces des étapes mesurées au format Chrome trace" << std::endl;
+    std::cout << "                         (compilation avec ALPHADOCTE_TRACING)" << std::endl;
+    std::cout << "  --perf-counters        compter les cycles, instructions, défauts de cache et erreurs de prédiction" << std::endl;
+    std::cout << "                         de branchement des mesures (Linux, si le système le permet)" << std::endl;
+    std::cout << "  --workload=CHEMIN      rejouer un enregistrement des appels aux solvers (voir alphadocte-replay)" << std::endl;
+}
+
+std::vector<Dataset> loadDatasets(const std::filesystem::path& dataDir, const std::filesystem::path& testDataDir,
+        const std::filesystem::path& extraWordList) {
+    std::vector<Dataset> datasets;
+
+    auto addDataset = [&datasets](std::string name, std::filesystem::path path, bool motus, bool wordle) {
+        if (!std::filesystem::is_regular_file(path)) {
+            std::cerr << "Liste de mots absente, ignorée : " << path.string() << std::endl;
+            return;
+        }
+
+        auto dictionary = std::make_shared<TxtDictionary>(path);
+        if (!dictionary->load()) {
+            throw Exception("Could not load the dictionary " + path.string() + '.',
+                    "loadDatasets(const std::filesystem::path&, const std::filesystem::path&, const std::filesystem::path&)");
+        }
+
+        if (motus) {
+            datasets.push_back(Dataset{
+                .name = name + "_motus",
+                .path = path,
+                .dictionary = dictionary,
+                .rules = std::make_shared<MotusGameRules>(dictionary, MAX_GUESSES)
+            });
+        }
+
+        if (wordle) {
+            auto wordleDictionary = std::make_shared<FixedSizeDictionary>(dictionary, WORDLE_SIZE);
+            if (!wordleDictionary->load()) {
+                throw Exception("Could not load the dictionary " + path.string() + '.',
+                        "loadDatasets(const std::filesystem::path&, const std::filesystem::path&, const std::filesystem::path&)");
+            }
+
+            datasets.push_back(Dataset{
+                .name = name + "_wordle",
+                .path = path,
+                .dictionary = wordleDictionary,
+                .rules = std::make_shared<WordleGameRules>(wordleDictionary, MAX_GUESSES)
+            });
+        }
+    };
+
+    addDataset("test", testDataDir / "motus_test_wordlist.txt", true, false);
+    addDataset("test", testDataDir / "wordle_test_wordlist.txt", false, true);
+    addDataset("en", dataDir / "en_wordlist.txt", true, true);
+    addDataset("fr", dataDir / "fr_wordlist.txt", true, true);
+
+    // eg. a synthetic dictionary from alphadocte-gendict, to measure how the library scales
+    if (!extraWordList.empty())
+        addDataset(extraWordList.stem().string(), extraWordList, true, true);
+
+    return datasets;
+}
+
+/*
+ * Write a cache config file as big as a well filled real one (one entry per template),
+ * and return its path.
+ */
+std::filesystem::path writeSyntheticCache(const std::vector<Dataset>& datasets, unsigned long seed) {
+    std::vector<std::string> words;
+    for (const auto& dataset : datasets) {
+        words.insert(std::end(words), std::cbegin(dataset.dictionary->getAllWords()), std::cend(dataset.dictionary->getAllWords()));
+    }
+
+    CLI::Section solverSection{
+        .name = "solver_entry",
+        .entries = {CLI::Entry{"solver_name", "entropy_maximizer"}, CLI::Entry{"solver_version", "1"}},
+        .sections = {}
+    };
+
+    auto picked = pickWords(words, 3 * NB_SYNTHETIC_TEMPLATES, seed);
+    for (size_t i = 0; i + 2 < std::size(picked); i += 3) {
+        solverSection.sections.push_back(CLI::Section{
+            .name = "guess_entry",
+            .entries = {
+                CLI::Entry{"template", picked[i].substr(0, 1) + std::string(std::size(picked[i]) - 1, '.')},
+                CLI::Entry{"requested_number", "3"},
+                CLI::Entry{"guess", picked[i] + " 7.654206"},
+                CLI::Entry{"guess", picked[i + 1] + " 7.544587"},
+                CLI::Entry{"guess", picked[i + 2] + " 7.533810"}
+            },
+            .sections = {}
+        });
+    }
+
+    CLI::Config config;
+    config.getRootSection().entries = {CLI::Entry{"file_path", "synthetic"}, CLI::Entry{"file_timestamp", "0"}};
+    config.getRootSection().sections.push_back(std::move(solverSection));
+
+    auto path = std::filesystem::temp_directory_path() / (SYNTHETIC_CACHE_NAME + ".txt");
+    config.writeToFile(path);
+
+    return path;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: PerfBenchmarks.cpp
+ */
+
+#include <optional>
+#include <set>
+
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/EntropyMaximizer.h>
+#include <Alphadocte/Game.h>
+#include <Alphadocte/IGameRules.h>
+#include <Alphadocte/TxtDictionary.h>
+
+#include "Benchmark.h"
+#include "../apps/Simulation.h"
+
+namespace Alphadocte {
+
+namespace Benchmarks {
+
+// Workloads whose first turn would need more (guess, solution) pairs are skipped,
+// so that the regression test remains short enough (eg. Wordle with the whole english dictionary)
+static const size_t MAX_FIRST_TURN_PAIRS = 5'000'000;
+static const size_t NB_SIMULATED_GAMES = 4;
+
+void runPerfBenchmarks(BenchmarkRunner& runner, const std::vector<Dataset>& datasets) {
+    for (const auto& dataset : datasets) {
+        // the first guess is expensive to prepare, skip the datasets excluded by the filter
+        if (!runner.isSelected("perf/firstGuess", dataset.name) && !runner.isSelected("perf/simulatedGame", dataset.name))
+            continue;
+
+        const auto& rules = dataset.rules;
+
+        // always the same game, for a given seed
+        std::vector<std::string> solutions;
+        for (const auto& word : pickWords(dataset.dictionary->getAllWords(), 4 * NB_SIMULATED_GAMES, runner.getOptions().seed)) {
+            if (std::size(solutions) < NB_SIMULATED_GAMES && rules->isSolutionValid(word))
+                solutions.push_back(word);
+        }
+        if (solutions.empty())
+            continue;
+
+        Game game{rules};
+        game.setWord(solutions.front());
+        std::string templateWord = rules->getTemplate(game);
+
+        EntropyMaximizer solver{rules};
+        solver.setTemplate(templateWord);
+        if (std::size(solver.getPotentialGuesses()) * std::size(solver.getPotentialSolutions()) > MAX_FIRST_TURN_PAIRS)
+            continue;
+
+        runner.runWithSetup("perf/firstGuess", dataset.name, 1, [&solver, &templateWord]() {
+            solver.setTemplate(templateWord);
+        }, [&solver]() {
+            auto guess = solver.computeNextGuess();
+            doNotOptimize(guess);
+        });
+
+        CLI::SimulationOptions options;
+        options.nbThreads = 1;
+        options.shareFirstGuess = false;
+        runner.run("perf/simulatedGame", dataset.name, std::size(solutions), [&rules, &solutions, &options]() {
+            auto result = CLI::simulateGames(rules, solutions, options);
+            doNotOptimize(result);
+        });
+    }
+
+    std::set<std::filesystem::path> loadedFiles;
+    for (const auto& dataset : datasets) {
+        if (!runner.isSelected("perf/dictionaryLoad", dataset.path.stem().string()) || !loadedFiles.insert(dataset.path).second)
+            continue;
+
+        std::optional<TxtDictionary> txtDictionary;
+        runner.runWithSetup("perf/dictionaryLoad", dataset.path.stem().string(), 1, [&txtDictionary, &dataset]() {
+            txtDictionary.emplace(dataset.path);
+        }, [&txtDictionary]() {
+            bool loaded = txtDictionary->load();
+            doNotOptimize(loaded);
+        });
+    }
+}
+
+} /* namespace Benchmarks */
+
+} /* namespace Alphadocte */
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: SolverBenchmarks.cpp
+ */
+
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/EntropyMaximizer.h>
+#include <Alphadocte/Game.h>
+#include <Alphadocte/IGameRules.h>
+
+#include "Benchmark.h"
+
+namespace Alphadocte {
+
+namespace Benchmarks {
+
+static const size_t NB_GAMES = 16;
+static const size_t NB_ENTROPY_GUESSES = 16;
+
+void runSolverBenchmarks(BenchmarkRunner& runner, const std::vector<Dataset>& datasets) {
+    for (const auto& dataset : datasets) {
+        const auto& rules = dataset.rules;
+        const auto& allWords = dataset.dictionary->getAllWords();
+        unsigned long seed = runner.getOptions().seed;
+
+        // games used as inputs, with their solutions and templates
+        std::vector<std::string> solutions;
+        for (const auto& word : pickWords(allWords, 4 * NB_GAMES, seed)) {
+            if (std::size(solutions) < NB_GAMES && rules->isSolutionValid(word))
+                solutions.push_back(word);
+        }
+        if (solutions.empty())
+            continue;
+
+        std::vector<std::string> templates;
+        Game game{rules};
+        for (const auto& solution : solutions) {
+            game.setWord(solution);
+            templates.push_back(rules->getTemplate(game));
+        }
+
+        EntropyMaximizer solver{rules};
+        runner.run("solver/setTemplate", dataset.name, std::size(templates), [&solver, &templates]() {
+            for (const auto& templateWord : templates) {
+                solver.setTemplate(templateWord);
+            }
+        });
+
+        // first hints of each game, given by a random valid guess
+        std::vector<EntropyMaximizer> solvers(std::size(solutions), EntropyMaximizer{rules});
+        std::vector<std::string> guesses;
+        std::vector<std::vector<HintType>> hints;
+        for (size_t i = 0; i < std::size(solutions); i++) {
+            solvers[i].setTemplate(templates[i]);
+            std::vector<std::string> potentialGuesses(std::cbegin(solvers[i].getPotentialGuesses()),
+                                                      std::cend(solvers[i].getPotentialGuesses()));
+            guesses.push_back(pickWords(potentialGuesses, 1, seed + i).front());
+            hints.push_back(Game::computeHints(guesses[i], solutions[i]));
+        }
+
+        runner.runWithSetup("solver/addHint", dataset.name, std::size(solvers), [&solvers, &templates]() {
+            for (size_t i = 0; i < std::size(solvers); i++) {
+                solvers[i].setTemplate(templates[i]);
+            }
+        }, [&solvers, &guesses, &hints]() {
+            for (size_t i = 0; i < std::size(solvers); i++) {
+                solvers[i].addHint(guesses[i], hints[i]);
+            }
+        });
+
+        // expected entropy of guesses at the start of the first game
+        solver.setTemplate(templates.front());
+        std::vector<std::string> potentialGuesses(std::cbegin(solver.getPotentialGuesses()),
+                                                  std::cend(solver.getPotentialGuesses()));
+        auto entropyGuesses = pickWords(potentialGuesses, NB_ENTROPY_GUESSES, seed);
+
+        runner.run("entropy/computeExpectedEntropy", dataset.name, std::size(entropyGuesses), [&solver, &entropyGuesses]() {
+            for (const auto& guess : entropyGuesses) {
+                double entropy = solver.computeExpectedEntropy(guess);
+                doNotOptimize(entropy);
+            }
+        }, std::size(solver.getPotentialSolutions())); // one hint pattern per potential solution
+    }
+}
+
+} /* namespace Benchmarks */
+
+} /* namespace Alphadocte */
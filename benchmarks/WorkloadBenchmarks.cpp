@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: WorkloadBenchmarks.cpp
+ */
+
+#include <iostream>
+
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/IGameRules.h>
+#include <Alphadocte/WordleGameRules.h>
+
+#include "Benchmark.h"
+#include "../apps/WorkloadReplay.h"
+
+namespace Alphadocte {
+
+namespace Benchmarks {
+
+void runWorkloadBenchmarks(BenchmarkRunner& runner, const std::vector<Dataset>& datasets,
+        const std::filesystem::path& workloadPath) {
+    auto games = CLI::loadWorkload(workloadPath);
+
+    // replay each game with the dataset of the same dictionary and rules
+    CLI::RulesProvider getRules = [&datasets](const CLI::RecordedGame& game) {
+        std::shared_ptr<IGameRules> found;
+        for (const auto& dataset : datasets) {
+            bool wordle = dynamic_cast<const WordleGameRules*>(dataset.rules.get()) != nullptr;
+            if ((game.rules == "wordle") == wordle && dataset.dictionary->getContentHash() == game.contentHash) {
+                found = dataset.rules;
+                break;
+            }
+        }
+        return found;
+    };
+
+    auto result = CLI::replayWorkload(games, getRules);
+    if (result.nbSkippedGames > 0) {
+        std::cerr << result.nbSkippedGames << " partie(s) de " << workloadPath.string()
+                  << " ignorée(s), dictionnaire ou règles absents des jeux de données" << std::endl;
+    }
+    if (result.nbComputations == 0)
+        return;
+
+    runner.run("replay/workload", workloadPath.stem().string(), result.nbComputations, [&games, &getRules]() {
+        CLI::replayWorkload(games, getRules);
+    });
+}
+
+} /* namespace Benchmarks */
+
+} /* namespace Alphadocte */
@@ -25,3 +25,23 @@ if (NOT DEFINED COMPILE_WITH_EXTRA_WARNING)
   message(STATUS "Do not compile with extra warning since COMPILE_WITH_EXTRA_WARNING was not defined.")
   SET(COMPILE_WITH_EXTRA_WARNING OFF CACHE BOOL "Add compiler flags to emit more warning messages." FORCE)
 endif()
+
+# Build the benchmarks by default
+if (NOT DEFINED ALPHADOCTE_BUILD_BENCHMARKS)
+  SET(ALPHADOCTE_BUILD_BENCHMARKS ON CACHE BOOL "Build the microbenchmarks executable (not installed)." FORCE)
+endif()
+
+# Do not register the performance regression test by default, its baseline depends on the machine
+if (NOT DEFINED ALPHADOCTE_PERF_TESTS)
+  SET(ALPHADOCTE_PERF_TESTS OFF CACHE BOOL "Register the perf test, comparing the benchmarks to the baseline of the repository." FORCE)
+endif()
+
+# Do not compile the trace events of the library by default
+if (NOT DEFINED ALPHADOCTE_TRACING)
+  SET(ALPHADOCTE_TRACING OFF CACHE BOOL "Compile the trace events of the library (Chrome trace format)." FORCE)
+endif()
+
+# Do not count the allocations of the executables by default
+if (NOT DEFINED ALPHADOCTE_COUNT_ALLOCATIONS)
+  SET(ALPHADOCTE_COUNT_ALLOCATIONS OFF CACHE BOOL "Replace the global operator new of the executables to count their allocations by phase." FORCE)
+endif()
@@ -18,7 +18,7 @@ if (ALPHADOCTE_OS_LINUX)
     DESTINATION ${CMAKE_INSTALL_DATADIR}/alphadocte)
     
   # Install targets (library and executables)
-  install(TARGETS alphadocte alphadocte-player alphadocte-solver)
+  install(TARGETS alphadocte alphadocte-player alphadocte-solver alphadocte-solverd alphadocte-bench alphadocte-cache alphadocte-replay)
 elseif(ALPHADOCTE_OS_WINDOWS)
   # Install (read-only) data, ie wordlists
   install(
@@ -26,7 +26,7 @@ elseif(ALPHADOCTE_OS_WINDOWS)
     DESTINATION data)
 
   # Install targets (library and executables)
-  install(TARGETS alphadocte alphadocte-player alphadocte-solver RUNTIME DESTINATION ".")
+  install(TARGETS alphadocte alphadocte-player alphadocte-solver alphadocte-bench alphadocte-cache alphadocte-replay RUNTIME DESTINATION ".")
   set(CMAKE_INSTALL_SYSTEM_RUNTIME_DESTINATION ".")
   
   if (MINGW)
@@ -50,7 +50,7 @@ elseif(ALPHADOCTE_OS_WINDOWS)
           RESOLVED_DEPENDENCIES_VAR deps_resolved
           UNRESOLVED_DEPENDENCIES_VAR deps_unresolved
           LIBRARIES "$<TARGET_FILE:alphadocte>"
-          EXECUTABLES "$<TARGET_FILE:alphadocte-player>" "$<TARGET_FILE:alphadocte-solver>"
+          EXECUTABLES "$<TARGET_FILE:alphadocte-player>" "$<TARGET_FILE:alphadocte-solver>" "$<TARGET_FILE:alphadocte-bench>" "$<TARGET_FILE:alphadocte-cache>"
           DIRECTORIES $ENV{PATH}
           # include MinGW64 system libs
           PRE_INCLUDE_REGEXES [=[^libgcc.*\.dll$]=] [=[^libstdc\+\+-[0-9]+\.dll$]=] [=[libwinpthread-[0-9]+.dll$]=]
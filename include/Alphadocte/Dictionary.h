@@ -22,7 +22,10 @@
 #ifndef DICTIONARY_H_
 #define DICTIONARY_H_
 
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <boost/random/uniform_int.hpp>
@@ -52,6 +55,21 @@ public:
      */
     const std::vector<std::string>& getAllWords() const;
 
+    /*
+     * Return a hash of the dictionary words, computed when the dictionary is loaded.
+     * It only depends on the words, not on their source (path, timestamp or order of
+     * the words in the file), so that it identifies the same word list on any host.
+     *
+     * Return 0 if #load() has not been called or has failed.
+     */
+    std::uint64_t getContentHash() const;
+
+    /*
+     * Return the approximate number of bytes retained by the dictionary, ie by its words,
+     * excluding the objects it shares (eg the source dictionary of a FixedSizeDictionary).
+     */
+    virtual size_t getRetainedBytes() const;
+
     // Methods
     /*
      * Draw a random word from all the dictionary words, with an uniform probability.
@@ -77,6 +95,12 @@ public:
      */
     bool contains(std::string_view word) const;
 
+    /*
+     * Return the index of the given word in #getAllWords(), or nothing if it is not inside the dictionary.
+     * Use binary search (O(log(n) complexity with n = std::size(word)).
+     */
+    std::optional<size_t> findWord(std::string_view word) const;
+
     // Abstract methods
     /*
      * Load the dictionary words. If already loaded, this function does nothing and returns false.
@@ -90,11 +114,17 @@ public:
      */
     virtual bool isLoaded() const = 0;
 
-    // Fields
 protected:
+    /*
+     * Compute the content hash of the words, must be called once they are loaded.
+     */
+    void updateContentHash();
+
+    // Fields
     std::vector<std::string> m_words;           // vector of words of the dictionary, sorted.
     boost::uniform_int<size_t> m_distribution;  // distribution to draw a random word from the dictionary,
                                                 // must be updated if number of words changes
+    std::uint64_t m_contentHash{};              // hash of the words, must be updated if words change
 };
 
 } /* namespace Alphadocte */
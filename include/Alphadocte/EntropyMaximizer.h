@@ -22,6 +22,10 @@
 #ifndef ENTROPYMAXIMIZER_H_
 #define ENTROPYMAXIMIZER_H_
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include <Alphadocte/Solver.h>
 
 namespace Alphadocte {
@@ -34,6 +38,28 @@ namespace Alphadocte {
  */
 class EntropyMaximizer : public Solver {
 public:
+    /*
+     * How the hints of a guess are counted to compute its expected entropy.
+     * All the strategies give the same entropies, only their speed differs.
+     */
+    enum class HistogramStrategy {
+        MAP,    // hint vectors (see Game::computeHints) counted in a map
+        DENSE,  // packed hints (see Game::computeHintCode) counted in an array of every possible code,
+                // or SORTED if the words have more than DENSE_HISTOGRAM_MAX_LETTERS letters
+        SORTED  // packed hints sorted, then counted
+    };
+
+    /*
+     * Implementation choices, depending on the machine (vector width, cache sizes and core count),
+     * see #setTuning().
+     */
+    struct Tuning {
+        HistogramStrategy histogram{HistogramStrategy::MAP};
+        unsigned int nbThreads{1};       // threads scoring the guesses
+        size_t minParallelPatterns{0};   // a single thread scores the guesses when they would compute
+                                         // less hints than this (potential guesses times potential solutions)
+    };
+
     /*
      * Initialize the entropy maximizer solver.
      *
@@ -80,11 +106,46 @@ public:
      * For this class, trust is the expected entropy (in bits) revealed by the guess.
      * The higher this number is, the more likely good the guess is.
      *
+     * The guesses are looked up in the solver's memo first, if any, and stored in it once computed.
+     * Solvers sharing the memo wait for each other rather than computing the same state twice
+     * (see SolverMemo::findOrCompute()).
+     *
+     * The work done is reported by getStats(): the guesses are scored by the threads of the tuning
+     * (see #setTuning()), and none are when the memo answers or when at most one solution is left.
+     *
      * Throws:
      * - Exception : if the template has not been initiated.
      */
     std::vector<std::pair<std::string, double>> computeNextGuesses(size_t n) const override;
 
+    // Getters/Setters
+    /*
+     * Return the tuning used by the solver.
+     */
+    Tuning getTuning() const;
+
+    /*
+     * Set the tuning used by the solver, which does not change its guesses.
+     *
+     * Throws:
+     * - InvalidArgException : if the number of threads is 0.
+     */
+    void setTuning(const Tuning& tuning);
+
+    /*
+     * Return the tuning given to the solvers when they are created.
+     */
+    static Tuning getDefaultTuning();
+
+    /*
+     * Set the tuning given to the solvers created from now on, eg the one chosen for the machine
+     * (see the tune command of alphadocte-cache). Thread safe.
+     *
+     * Throws:
+     * - InvalidArgException : if the number of threads is 0.
+     */
+    static void setDefaultTuning(const Tuning& tuning);
+
     //  Own methods
     /*
      * Compute the actual entropy (in bits) revealed by the guess,
@@ -123,6 +184,49 @@ public:
      * Returns an arbitrary negative value if there is no potential solution in the dictionary.
      */
     double computeCurrentEntropy() const;
+
+    // Static constants
+    // see Solver::getSolverName() and Solver::getSolverVersion()
+    inline static const std::string SOLVER_NAME = "entropy_maximizer";
+    static constexpr unsigned int SOLVER_VERSION = 1;
+    // longest words counted by a dense histogram, of 3^10 counters
+    static constexpr size_t DENSE_HISTOGRAM_MAX_LETTERS = 10;
+
+private:
+    // Private methods
+    /*
+     * Compute the next guesses, see computeNextGuesses(), which measures this call.
+     */
+    std::vector<std::pair<std::string, double>> findNextGuesses(size_t n) const;
+
+    /*
+     * Score every potential guess, and return the n best ones, without looking at the memo.
+     * There must be at least two potential solutions.
+     */
+    std::vector<std::pair<std::string, double>> rankGuesses(size_t n) const;
+
+    /*
+     * Buffers reused by a thread to count the hints of several guesses.
+     */
+    struct HintCounts {
+        std::vector<std::uint32_t> counts; // DENSE : count of each hint code, reset after each guess
+        std::vector<HintCode> codes;       // DENSE : codes seen, SORTED : every code
+    };
+
+    /*
+     * Same as computeExpectedEntropy(std::string_view), counting the hints with the given strategy,
+     * and also giving the number of distinct hints the guess can reveal.
+     */
+    double computeExpectedEntropy(std::string_view guess, HistogramStrategy strategy, HintCounts& hintCounts,
+            size_t& nbPatterns) const;
+
+    /*
+     * Return the strategy actually used to count the hints of the current template, see HistogramStrategy.
+     */
+    HistogramStrategy getHistogramStrategy() const;
+
+    // Fields
+    Tuning m_tuning;
 };
 
 } /* namespace Alphadocte */
@@ -169,6 +169,24 @@ public:
      */
     static std::vector<HintType> computeHints(std::string_view word, std::string_view solution);
 
+    /*
+     * Compute the packed hints generated by the guess word given the solution,
+     * ie the same result as packHints(computeHints(word, solution)).
+     *
+     * Unlike computeHints, it does not allocate memory nor check if
+     * the words are made of lower-case letters, which must be ensured by the caller
+     * (eg. by using words from a dictionary).
+     *
+     * Args :
+     * - word : the word used as guess
+     * - solution : the word used as solution
+     *
+     * Throws:
+     * - InvalidArgException : if words do not have the same size,
+     *                         or are longer than MAX_PACKED_HINTS.
+     */
+    static HintCode computeHintCode(std::string_view word, std::string_view solution);
+
     /*
      * Return a string representing a pattern for a new guess,
      * based on the given set of hints (ie results from previous result).
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: GameBatch.h
+ */
+
+#ifndef GAMEBATCH_H_
+#define GAMEBATCH_H_
+
+#include <Alphadocte/Hint.h>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Alphadocte/Alphadocte.h>
+
+namespace Alphadocte {
+
+class Dictionary;
+class IGameRules;
+
+/*
+ * Set of games sharing the same rules, stored in a structure-of-arrays form
+ * so that thousands of games can be simulated without any heap allocation per game.
+ *
+ * Words (solutions and guesses) are identified by their index in the words
+ * of the rules' dictionary (see #getWordId()), and hints are packed into HintCode.
+ *
+ * A game is started as soon as its solution is set, and follows the same rules
+ * as Game::tryGuess (valid guesses, maximum number of guesses).
+ *
+ * Games are independent from each other: different games can be played
+ * concurrently from different threads, as long as a game is used by only one thread
+ * and the batch itself is not reset meanwhile.
+ */
+class GameBatch {
+public:
+    // Identifier of a word, ie its index in the dictionary's words
+    typedef std::uint32_t word_id;
+
+    // Identifier meaning that no word has been set
+    static constexpr word_id NO_WORD = std::numeric_limits<word_id>::max();
+
+    // Constructors
+    /*
+     * Create a batch of games sharing the same rules, none of them being started.
+     * All the memory used by the games is allocated by the constructor.
+     *
+     * Args :
+     * - rules : pointer to the rules of the games
+     * - nbGames : number of games in the batch
+     * - turnCapacity : maximum number of guesses stored for a game, only used (and required)
+     *                  if the rules do not limit the number of guesses.
+     *
+     * Throws:
+     * - InvalidArgException : if rules is a nullptr, if the dictionary has too many words
+     *                         to be identified by a word_id, or if the rules have no limit
+     *                         on the number of guesses and turnCapacity is 0.
+     */
+    GameBatch(std::shared_ptr<IGameRules> rules, size_t nbGames, unsigned int turnCapacity = 0);
+
+    // Default constructors/destructor
+    virtual ~GameBatch() = default;
+    GameBatch(const GameBatch &other) = default;
+    GameBatch(GameBatch &&other) = default;
+    GameBatch& operator=(const GameBatch &other) = default;
+    GameBatch& operator=(GameBatch &&other) = default;
+
+    // Getters/Setters
+    /*
+     * Return the number of games in the batch.
+     */
+    size_t size() const;
+
+    /*
+     * Return the maximum number of guesses that can be tried in a game.
+     */
+    unsigned int getTurnCapacity() const;
+
+    /*
+     * Return the approximate number of bytes retained by the batch, ie by the state
+     * and the guesses and hints of its games, excluding the shared rules and dictionary.
+     */
+    size_t getRetainedBytes() const;
+
+    /*
+     * Return a shared pointer to the rules defined for the games.
+     * Guaranteed to be not nullptr.
+     */
+    std::shared_ptr<const IGameRules> getRules() const;
+
+    /*
+     * Return the words that can be identified by a word_id, ie the dictionary's words.
+     */
+    const std::vector<std::string>& getWords() const;
+
+    /*
+     * Return the word identified by the given id.
+     *
+     * Throws:
+     * - InvalidArgException : if the id does not identify a word.
+     */
+    std::string_view getWord(word_id id) const;
+
+    /*
+     * Return the identifier of the given word.
+     *
+     * Throws:
+     * - InvalidArgException : if the word is not in the dictionary.
+     */
+    word_id getWordId(std::string_view word) const;
+
+    /*
+     * Return the identifier of the given word, or nothing if it is not in the dictionary.
+     */
+    std::optional<word_id> findWordId(std::string_view word) const;
+
+    /*
+     * Return the solution of a game, or NO_WORD if it has not been set.
+     */
+    word_id getSolution(size_t game) const;
+
+    /*
+     * Set the solution of a game, which resets it and starts it.
+     *
+     * Args:
+     * - game : index of the game in the batch
+     * - solution : identifier of the word to be guessed
+     *
+     * Throws:
+     * - InvalidArgException : if game is out of range, or if the word is not a valid solution
+     */
+    void setSolution(size_t game, word_id solution);
+
+    /*
+     * Return true if the game has started, ie if its solution has been set.
+     */
+    bool hasStarted(size_t game) const;
+
+    /*
+     * Return true if the game is over (either lost or won).
+     * If the rules do not limit the number of guesses, the game is lost
+     * once the turn capacity is reached.
+     */
+    bool isOver(size_t game) const;
+
+    /*
+     * Return true if the game is over and have been won
+     */
+    bool isWon(size_t game) const;
+
+    /*
+     * Return the total number of guesses tried in a game.
+     */
+    unsigned int getNbGuess(size_t game) const;
+
+    /*
+     * Return the guess tried at the given turn (starting from 0) of a game.
+     *
+     * Throws:
+     * - InvalidArgException : if game or turn are out of range.
+     */
+    word_id getGuess(size_t game, unsigned int turn) const;
+
+    /*
+     * Return the packed hints revealed at the given turn (starting from 0) of a game.
+     *
+     * Throws:
+     * - InvalidArgException : if game or turn are out of range.
+     */
+    HintCode getHints(size_t game, unsigned int turn) const;
+
+    /*
+     * Return the number of games which are over, respectively won.
+     */
+    size_t countOver() const;
+    size_t countWon() const;
+
+    // Methods
+    /*
+     * Reset a game, cleaning its guesses and its solution.
+     */
+    void reset(size_t game);
+
+    /*
+     * Reset all the games of the batch.
+     */
+    void reset();
+
+    /*
+     * Try a new guess in a game, returning the packed hints generated by it.
+     *
+     * Throw an Exception if game state is invalid (ie game over or not started),
+     * or if the guess is not valid for this game.
+     * Throw an InvalidArgException if game is out of range.
+     *
+     * A successful try results in winningHintCode(size of the solution),
+     * which can also be checked with the isWon() method.
+     *
+     * Args :
+     * - game : index of the game in the batch
+     * - guess : identifier of the word used as guess
+     */
+    HintCode tryGuess(size_t game, word_id guess);
+
+private:
+    void checkGame(size_t game, const char* functionName) const;
+
+    // Fields
+    std::shared_ptr<IGameRules> m_rules;          // cannot be null
+    std::shared_ptr<const Dictionary> m_dictionary; // keep the words alive, cannot be null
+    unsigned int m_turnCapacity;
+
+    // one element per game
+    std::vector<word_id> m_solutions;
+    std::vector<unsigned int> m_nbGuesses;
+    std::vector<unsigned char> m_won;             // not a vector<bool>, so that games can be updated concurrently
+
+    // m_turnCapacity elements per game
+    std::vector<word_id> m_guesses;
+    std::vector<HintCode> m_hints;
+};
+
+} /* namespace Alphadocte */
+
+#endif /* GAMEBATCH_H_ */
@@ -22,10 +22,13 @@
 #ifndef HINT_H_
 #define HINT_H_
 
+#include <cstdint>
 #include <string_view>
 #include <ostream>
 #include <vector>
 
+#include <Alphadocte/Alphadocte.h>
+
 namespace Alphadocte {
 
 /*
@@ -37,7 +40,46 @@ enum class HintType : char {
     CORRECT    // the letter is in the solution, and in this position
 };
 
+/*
+ * Hint vector packed into an integer, where each hint is a base-3 digit
+ * (WRONG = 0, MISPLACED = 1, CORRECT = 2), the first letter being the most significant digit.
+ * Therefore, comparing two codes of hint vectors of the same size
+ * is the same as comparing the hint vectors in lexical order.
+ */
+typedef std::uint64_t HintCode;
+
+// Maximum number of hints that can be packed in a HintCode (3^40 < 2^64)
+inline constexpr word_size MAX_PACKED_HINTS = 40;
+
 std::ostream& operator<<(std::ostream& os, HintType hintType);
+
+/*
+ * Pack a hint vector into a single integer (see HintCode).
+ *
+ * Throws:
+ * - InvalidArgException : if there are more than MAX_PACKED_HINTS hints.
+ */
+HintCode packHints(const std::vector<HintType>& hints);
+
+/*
+ * Unpack a hint code into a hint vector of the given size.
+ *
+ * Args :
+ * - code : the packed hints
+ * - size : the number of hints packed in the code, ie the number of letters of the guess
+ *
+ * Throws:
+ * - InvalidArgException : if size is greater than MAX_PACKED_HINTS, or if the code
+ *                         does not fit in size hints.
+ */
+std::vector<HintType> unpackHints(HintCode code, word_size size);
+
+/*
+ * Return the code of a hint vector of the given size made of only HintType::CORRECT,
+ * ie the code revealed by a winning guess.
+ */
+HintCode winningHintCode(word_size size);
+
 /*
  * Check if the given word is compatible with the given hints associated with a previous hint,
  * ie if the word could be the solution based on a previous guess.
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Memory.h
+ */
+
+#ifndef MEMORY_H_
+#define MEMORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Alphadocte {
+
+/*
+ * Return the number of bytes a string allocated on the heap,
+ * or 0 if its characters fit in the string object itself.
+ */
+size_t getHeapSize(const std::string& str);
+
+/*
+ * Phases of the library to which allocations are attributed, see AllocationTracker.
+ */
+enum class MemoryPhase {
+    OTHER,            // outside of the phases below
+    DICTIONARY_LOAD,
+    SET_TEMPLATE,
+    ADD_HINT,
+    COMPUTE_GUESSES
+};
+
+inline constexpr size_t NB_MEMORY_PHASES = 5;
+
+/*
+ * Allocations attributed to a phase, or to the whole process.
+ * The memory is attributed to the phase which allocated it, even when freed later.
+ */
+struct AllocationStats {
+    std::uint64_t nbAllocations{};
+    std::uint64_t allocatedBytes{}; // total of the allocations
+    std::uint64_t currentBytes{};   // allocated and not freed yet
+    std::uint64_t peakBytes{};      // highest value of currentBytes
+};
+
+/*
+ * Counter of the allocations of the process, by phase of the library.
+ *
+ * It is opt-in: the library only marks its phases (see AllocationPhase), and an application
+ * counts its allocations by replacing the global operator new and delete with ones calling
+ * recordAllocation() and recordDeallocation(), then enable().
+ * Recording is lock-free and never allocates.
+ */
+class AllocationTracker {
+public:
+    AllocationTracker() = delete;
+
+    // Getters/Setters
+    /*
+     * Return whether the allocations are counted, ie enable() has been called.
+     */
+    static bool isEnabled();
+
+    /*
+     * Return the phase of the current thread.
+     */
+    static MemoryPhase getCurrentPhase();
+
+    /*
+     * Return the allocations attributed to a phase.
+     */
+    static AllocationStats getStats(MemoryPhase phase);
+
+    /*
+     * Return the allocations of all the phases, the peak being the one of the whole process.
+     */
+    static AllocationStats getTotalStats();
+
+    /*
+     * Return the name of a phase, as used in the labels of the metrics, eg "set_template".
+     */
+    static std::string_view getPhaseName(MemoryPhase phase);
+
+    // Methods
+    /*
+     * Mark the allocations as counted, and publish them in the global metrics registry
+     * (alphadocte_allocations_total, alphadocte_allocated_bytes_total, alphadocte_allocated_bytes
+     * and alphadocte_allocated_bytes_peak, by phase). Does nothing if already enabled.
+     */
+    static void enable();
+
+    /*
+     * Count an allocation, or the deallocation of memory allocated during the given phase.
+     */
+    static void recordAllocation(size_t size, MemoryPhase phase);
+    static void recordDeallocation(size_t size, MemoryPhase phase);
+};
+
+/*
+ * Attribute the allocations of the current thread to a phase, until destroyed.
+ * Nested phases restore the enclosing one.
+ */
+class AllocationPhase {
+public:
+    explicit AllocationPhase(MemoryPhase phase);
+    ~AllocationPhase();
+
+    AllocationPhase(const AllocationPhase &other) = delete;
+    AllocationPhase(AllocationPhase &&other) = delete;
+    AllocationPhase& operator=(const AllocationPhase &other) = delete;
+    AllocationPhase& operator=(AllocationPhase &&other) = delete;
+
+private:
+    MemoryPhase m_previous;
+};
+
+} /* namespace Alphadocte */
+
+#endif /* MEMORY_H_ */
@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Metrics.h
+ */
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Alphadocte {
+
+/*
+ * Labels distinguishing the metrics of a family, as (name, value) pairs, eg {{"phase", "add_hint"}}.
+ */
+typedef std::vector<std::pair<std::string, std::string>> MetricLabels;
+
+/*
+ * Monotonic counter, which can be updated from any thread without locking.
+ */
+class Counter {
+public:
+    // Constructors
+    Counter() = default;
+
+    // Counters are registered once and referenced, not copied
+    virtual ~Counter() = default;
+    Counter(const Counter &other) = delete;
+    Counter(Counter &&other) = delete;
+    Counter& operator=(const Counter &other) = delete;
+    Counter& operator=(Counter &&other) = delete;
+
+    // Getters/Setters
+    std::uint64_t getValue() const;
+
+    // Methods
+    void add(std::uint64_t value = 1);
+
+private:
+    std::atomic<std::uint64_t> m_value{};
+};
+
+/*
+ * Value which can go up and down (eg a number of bytes), updated from any thread without locking.
+ */
+class Gauge {
+public:
+    // Constructors
+    Gauge() = default;
+
+    // Gauges are registered once and referenced, not copied
+    virtual ~Gauge() = default;
+    Gauge(const Gauge &other) = delete;
+    Gauge(Gauge &&other) = delete;
+    Gauge& operator=(const Gauge &other) = delete;
+    Gauge& operator=(Gauge &&other) = delete;
+
+    // Getters/Setters
+    std::int64_t getValue() const;
+    void set(std::int64_t value);
+
+    // Methods
+    void add(std::int64_t value);
+
+private:
+    std::atomic<std::int64_t> m_value{};
+};
+
+/*
+ * Distribution of observed values, counted in fixed buckets.
+ * It can be updated from any thread without locking.
+ */
+class Histogram {
+public:
+    // Constructors
+    /*
+     * Create an empty histogram.
+     *
+     * Args:
+     * - bounds : upper bound of each bucket, in strictly increasing order.
+     *            A last bucket holds the values above the last bound.
+     *
+     * Throws:
+     * - InvalidArgException : if the bounds are empty or not strictly increasing.
+     */
+    explicit Histogram(std::vector<double> bounds);
+
+    // Histograms are registered once and referenced, not copied
+    virtual ~Histogram() = default;
+    Histogram(const Histogram &other) = delete;
+    Histogram(Histogram &&other) = delete;
+    Histogram& operator=(const Histogram &other) = delete;
+    Histogram& operator=(Histogram &&other) = delete;
+
+    // Getters/Setters
+    const std::vector<double>& getBounds() const;
+
+    /*
+     * Return the number of values observed in each bucket (not cumulated),
+     * the last one holding the values above the last bound.
+     */
+    std::vector<std::uint64_t> getBucketCounts() const;
+
+    /*
+     * Return the sum of the observed values.
+     */
+    double getSum() const;
+
+    // Methods
+    void observe(double value);
+
+    /*
+     * Return the bounds of latency histograms, from 10 µs to 100 s, in seconds.
+     */
+    static std::vector<double> getLatencyBounds();
+
+private:
+    std::vector<double> m_bounds;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_buckets; // one more than the bounds
+    std::atomic<double> m_sum;
+};
+
+/*
+ * Observe the time spent in a scope, in seconds, when destroyed.
+ */
+class LatencyTimer {
+public:
+    explicit LatencyTimer(Histogram& histogram);
+    ~LatencyTimer();
+
+    LatencyTimer(const LatencyTimer &other) = delete;
+    LatencyTimer(LatencyTimer &&other) = delete;
+    LatencyTimer& operator=(const LatencyTimer &other) = delete;
+    LatencyTimer& operator=(LatencyTimer &&other) = delete;
+
+private:
+    Histogram& m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/*
+ * Registry of named counters and histograms.
+ *
+ * Metrics are registered once, usually by the code updating them, which then keeps
+ * a reference to them : registering takes a lock, while updates do not.
+ * The registry can be exported in the Prometheus text format.
+ */
+class MetricsRegistry {
+public:
+    // Constructors
+    MetricsRegistry() = default;
+
+    // Registered metrics are referenced, the registry can be neither copied nor moved
+    virtual ~MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry &other) = delete;
+    MetricsRegistry(MetricsRegistry &&other) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry &other) = delete;
+    MetricsRegistry& operator=(MetricsRegistry &&other) = delete;
+
+    // Methods
+    /*
+     * Return the counter with the given name and labels, registering it on the first call.
+     *
+     * Args:
+     * - name : name of the metric family, eg "alphadocte_guesses_scored_total"
+     * - help : description of the family, kept from the first registration
+     * - labels : labels of the counter in its family
+     *
+     * Throws:
+     * - InvalidArgException : if the name or a label name is invalid, or if the family holds another type of metrics.
+     */
+    Counter& registerCounter(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    /*
+     * Return the gauge with the given name and labels, registering it on the first call.
+     *
+     * Throws:
+     * - InvalidArgException : if the name or a label name is invalid, or if the family holds another type of metrics.
+     */
+    Gauge& registerGauge(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    /*
+     * Return the histogram with the given name and labels, registering it on the first call.
+     * The bounds are only used by the first call.
+     *
+     * Throws:
+     * - InvalidArgException : if the name or a label name is invalid, if the family holds another type of metrics,
+     *                         or if the bounds are invalid (see Histogram::Histogram())
+     */
+    Histogram& registerHistogram(const std::string& name, const std::string& help, std::vector<double> bounds,
+            const MetricLabels& labels = {});
+
+    /*
+     * Add a function called before formatting the metrics, to update gauges
+     * from the state of an object (eg its memory usage).
+     *
+     * Return the id of the collector, see #removeCollector().
+     */
+    size_t addCollector(std::function<void()> collector);
+
+    /*
+     * Remove a collector, once this returns it is no longer called.
+     * Does nothing if the id is unknown.
+     */
+    void removeCollector(size_t collectorId);
+
+    /*
+     * Return the metrics in the Prometheus text exposition format (version 0.0.4),
+     * families sorted by name. The collectors are called first.
+     */
+    std::string formatPrometheus() const;
+
+    /*
+     * Return the registry holding the metrics of the library (see LibraryMetrics),
+     * to which applications can add their own metrics.
+     */
+    static MetricsRegistry& getGlobal();
+
+private:
+    enum class MetricType {
+        COUNTER,
+        GAUGE,
+        HISTOGRAM
+    };
+
+    struct Family {
+        MetricType type;
+        std::string help;
+        std::map<std::string, std::unique_ptr<Counter>> counters;     // by formatted labels
+        std::map<std::string, std::unique_ptr<Gauge>> gauges;         // by formatted labels
+        std::map<std::string, std::unique_ptr<Histogram>> histograms; // by formatted labels
+    };
+
+    // Private methods
+    /*
+     * Return the family of the given name, creating it if needed. m_mutex must be held.
+     *
+     * Throws:
+     * - InvalidArgException : if the name is invalid, or if the family holds another type of metrics.
+     */
+    Family& getFamily(const std::string& name, const std::string& help, MetricType type);
+
+    // Fields
+    std::map<std::string, Family> m_families;
+    mutable std::mutex m_mutex; // guards the registration, not the updates
+    std::map<size_t, std::function<void()>> m_collectors;
+    size_t m_nextCollectorId{};
+    mutable std::mutex m_collectorsMutex; // guards the collectors, held while they are called
+};
+
+/*
+ * Metrics updated by the library, registered in the global registry.
+ */
+struct LibraryMetrics {
+    Counter& patternsEvaluated;  // hints computed to score the guesses
+    Counter& guessesScored;
+    Counter& solutionsFiltered;  // potential solutions removed by a template or a hint
+    Counter& memoHits;           // lookups of the solver memo, see SolverMemo
+    Counter& memoMisses;
+    Counter& dictionaryLoads;
+    Histogram& setTemplateLatency;
+    Histogram& addHintLatency;
+    Histogram& computeGuessesLatency;
+    Histogram& dictionaryLoadLatency;
+
+    /*
+     * Return the metrics of the library, registering them on the first call.
+     */
+    static LibraryMetrics& get();
+};
+
+} /* namespace Alphadocte */
+
+#endif /* METRICS_H_ */
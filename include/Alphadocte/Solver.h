@@ -23,6 +23,7 @@
 #define SOLVER_H_
 
 #include <Alphadocte/Hint.h>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -33,12 +34,33 @@ namespace Alphadocte {
 
 // Forward declarations
 class IGameRules;
+class SolverMemo;
+class WorkloadRecorder;
 
 /*
  * Base class defining the requirements of a solver.
  */
 class Solver {
 public:
+    /*
+     * Work done by the solver during its last calls, see #getStats().
+     * Durations are in seconds.
+     */
+    struct Stats {
+        size_t nbSolutions{};            // potential solutions, after the last setTemplate or addHint
+        size_t nbGuesses{};              // potential guesses, after the last setTemplate
+        double setTemplateDuration{};    // duration of the last setTemplate
+        double addHintDuration{};        // duration of the last addHint
+        double computeGuessesDuration{}; // duration of the last computeNextGuesses
+        size_t nbGuessesScored{};        // potential guesses scored by the last computeNextGuesses
+        size_t nbGuessesPruned{};        // potential guesses it skipped while scoring the others, 0 if it does not prune
+                                         // (a computation answered without scoring has nbGuessesScored == 0)
+        size_t nbPatternsEvaluated{};    // hints it computed to score the guesses
+        bool fromMemo{};                 // whether it was answered by the memo
+        unsigned int nbThreads{};        // threads it used to score the guesses, 0 if none were scored
+        size_t peakScratchMemory{};      // approximate peak number of bytes of its temporary structures
+    };
+
     // Constructos
     /*
      * Base constructor initializing the solver;
@@ -132,6 +154,67 @@ public:
      */
     unsigned int getSolverVersion() const;
 
+    /*
+     * Return the memo used to reuse the guesses of previously seen states,
+     * or nullptr if the solver does not use any memo.
+     */
+    std::shared_ptr<SolverMemo> getMemo() const;
+
+    /*
+     * Set the memo used by #computeNextGuesses(size_t) to reuse the guesses of previously seen states,
+     * and store the ones it computes. It can be shared with other solvers.
+     * The nullptr disables the memo.
+     *
+     * Args:
+     * - memo : the memo used by the solver
+     */
+    void setMemo(std::shared_ptr<SolverMemo> memo);
+
+    /*
+     * Return the recorder logging the calls made to the solver, or nullptr if they are not recorded.
+     */
+    std::shared_ptr<WorkloadRecorder> getRecorder() const;
+
+    /*
+     * Set the recorder logging the template, hints and computations of the following games,
+     * and of the current one if a template is already set. It can be shared with other solvers.
+     * The nullptr disables the recording.
+     *
+     * Args:
+     * - recorder : the recorder used by the solver
+     */
+    void setRecorder(std::shared_ptr<WorkloadRecorder> recorder);
+
+    /*
+     * Set the recorder, continuing a game it has already recorded instead of recording the current game again :
+     * only the following hints and computations are recorded, under the given id.
+     * Used to rebuild a solver whose template and hints are already in the recorder.
+     *
+     * Args:
+     * - recorder : the recorder used by the solver
+     * - recordedGame : the id of the current game in the recorder (see #getRecordedGame()), 0 to record nothing
+     *                  until the next template
+     */
+    void setRecorder(std::shared_ptr<WorkloadRecorder> recorder, std::uint64_t recordedGame);
+
+    /*
+     * Return the id of the current game in the recorder (see WorkloadRecorder::recordGame()), or 0 if it is not recorded.
+     */
+    std::uint64_t getRecordedGame() const;
+
+    /*
+     * Return a snapshot of the work done by the last calls to setTemplate, addHint
+     * and computeNextGuesses, which is reset with the solver.
+     * Solvers only fill the fields relevant to their algorithm.
+     */
+    Stats getStats() const;
+
+    /*
+     * Return the approximate number of bytes retained by the solver, ie by its template,
+     * hints and candidates, excluding the shared rules, dictionary and memo.
+     */
+    virtual size_t getRetainedBytes() const;
+
     // Methods
     /*
      * Compute the next guess suggested by the solver.
@@ -181,6 +264,22 @@ protected:
 
     void populateSolutions();
 
+    /*
+     * Return the stats updated by computeNextGuesses, which is const.
+     * A solver is used by a single thread at a time, so does its stats.
+     */
+    Stats& getMutableStats() const;
+
+    /*
+     * Record a call to computeNextGuesses, if the solver has a recorder (see #setRecorder()).
+     *
+     * Args:
+     * - n : the number of guesses requested
+     * - guesses : the guesses returned
+     * - duration : the duration of the call, in seconds
+     */
+    void recordComputation(size_t n, const std::vector<std::pair<std::string, double>>& guesses, double duration) const;
+
     // Fields
 private:
     std::shared_ptr<IGameRules> m_rules;                   // cannot be nullptr
@@ -190,6 +289,10 @@ private:
     std::vector<std::string_view> m_potentialSolutions;
     std::string m_solverName;
     unsigned int m_solverVersion;
+    std::shared_ptr<SolverMemo> m_memo;                    // can be nullptr
+    std::shared_ptr<WorkloadRecorder> m_recorder;          // can be nullptr
+    std::uint64_t m_recordedGame;                          // id of the current game in the recorder, 0 if none
+    mutable Stats m_stats;
 };
 
 } /* namespace Alphadocte */
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: SolverMemo.h
+ */
+
+#ifndef SOLVERMEMO_H_
+#define SOLVERMEMO_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Alphadocte {
+
+class Solver;
+
+/*
+ * Bounded memo of the guesses computed by solvers, indexed by the solver state:
+ * the solver (name and version), the rules, the dictionary, the template and the hints.
+ * Hints are a set of (guess, hints) pairs, so the state does not depend on
+ * the order in which the guesses were played.
+ *
+ * When the memo is full, the least recently used state is evicted.
+ *
+ * The memo can be shared by several solvers, even from different threads,
+ * see Solver::setMemo(). Solvers computing the same state at the same time
+ * share a single computation, see #findOrCompute().
+ */
+class SolverMemo {
+public:
+    typedef std::vector<std::pair<std::string, double>> Guesses;
+
+    /*
+     * Usage statistics of a memo, since its creation or the last call to #clear().
+     */
+    struct Stats {
+        size_t nbHits{};      // lookups answered by the memo
+        size_t nbMisses{};    // lookups that were not
+        size_t nbCoalesced{}; // lookups that waited for another solver computing the same state
+        size_t nbEvictions{}; // states dropped because the memo was full
+        size_t nbEntries{};   // states currently stored
+        size_t memoryUsage{}; // approximate number of bytes used by the stored states
+
+        /*
+         * Return the ratio of lookups answered by the memo, coalesced lookups included,
+         * or 0 if there was no lookup.
+         */
+        double getHitRate() const;
+    };
+
+    // Constructors
+    /*
+     * Create an empty memo.
+     *
+     * Args:
+     * - capacity : maximum number of states stored
+     *
+     * Throws:
+     * - InvalidArgException : if capacity is 0
+     */
+    explicit SolverMemo(size_t capacity);
+
+    // A memo is shared through a pointer, not copied
+    virtual ~SolverMemo() = default;
+    SolverMemo(const SolverMemo &other) = delete;
+    SolverMemo(SolverMemo &&other) = delete;
+    SolverMemo& operator=(const SolverMemo &other) = delete;
+    SolverMemo& operator=(SolverMemo &&other) = delete;
+
+    // Getters/Setters
+    /*
+     * Return the maximum number of states stored.
+     */
+    size_t getCapacity() const;
+
+    /*
+     * Return the usage statistics of the memo.
+     */
+    Stats getStats() const;
+
+    // Methods
+    /*
+     * Return the canonical representation of the solver's current state,
+     * used as a key by the memo.
+     *
+     * Throws:
+     * - Exception : if the template of the solver has not been initiated.
+     */
+    static std::string computeStateKey(const Solver& solver);
+
+    /*
+     * Look for the n best guesses of a state.
+     *
+     * Args:
+     * - stateKey : the state, see #computeStateKey()
+     * - n : the number of guesses wanted
+     *
+     * Return the guesses, as returned by Solver::computeNextGuesses(n),
+     * or nothing if they are not known.
+     */
+    std::optional<Guesses> find(const std::string& stateKey, size_t n);
+
+    /*
+     * Store the n best guesses of a state, replacing the state's previous guesses
+     * unless they already answer to n.
+     *
+     * Args:
+     * - stateKey : the state, see #computeStateKey()
+     * - n : the number of guesses that were requested
+     * - guesses : the guesses returned by Solver::computeNextGuesses(n)
+     */
+    void insert(const std::string& stateKey, size_t n, const Guesses& guesses);
+
+    /*
+     * Return the n best guesses of a state, computing them if they are not known.
+     *
+     * Concurrent calls for the same state are coalesced : while a solver computes a state,
+     * the solvers asking for as many guesses or less wait for its result, instead of
+     * computing the state again. The result is then stored as by #insert().
+     *
+     * Args:
+     * - stateKey : the state, see #computeStateKey()
+     * - n : the number of guesses wanted
+     * - compute : computes the n best guesses of the state, as Solver::computeNextGuesses(n)
+     *
+     * Throws:
+     * - any exception thrown by compute, in the computing solver as well as in the waiting ones
+     */
+    Guesses findOrCompute(const std::string& stateKey, size_t n, const std::function<Guesses()>& compute);
+
+    /*
+     * Remove all the states, and reset the statistics.
+     * States being computed are stored once computed.
+     */
+    void clear();
+
+private:
+    /*
+     * Computation of a state in progress, see #findOrCompute().
+     */
+    struct Flight {
+        size_t nbRequested;
+        bool done{};
+        Guesses guesses;
+        std::exception_ptr error;
+        std::condition_variable finished;
+    };
+
+    struct Entry {
+        size_t nbRequested;                            // number of guesses requested when computed
+        Guesses guesses;
+        std::list<const std::string*>::iterator usage; // position in m_usage
+    };
+
+    // Private methods, called with m_mutex held
+    /*
+     * Return the n best guesses of a stored state, counting a hit, or nothing.
+     */
+    std::optional<Guesses> lookup(const std::string& stateKey, size_t n);
+
+    /*
+     * Store the guesses of a state, see #insert().
+     */
+    void store(const std::string& stateKey, size_t n, const Guesses& guesses);
+
+    static size_t computeMemoryUsage(const std::string& stateKey, const Entry& entry);
+
+    // Fields
+    size_t m_capacity;
+    std::unordered_map<std::string, Entry> m_entries;
+    std::list<const std::string*> m_usage; // keys of m_entries, most recently used first
+    std::unordered_map<std::string, std::shared_ptr<Flight>> m_flights; // states being computed
+    Stats m_stats;
+    mutable std::mutex m_mutex;            // guards all the other fields
+};
+
+} /* namespace Alphadocte */
+
+#endif /* SOLVERMEMO_H_ */
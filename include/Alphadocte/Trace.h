@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Trace.h
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <Alphadocte/Alphadocte.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace Alphadocte {
+
+/*
+ * Recorder of the trace events of all threads, written in the Chrome trace event format,
+ * which can be opened in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * The library records its phases with ALPHADOCTE_TRACE_SCOPE, only when compiled
+ * with ALPHADOCTE_TRACING (see isAvailable()).
+ * Each thread records its events in its own buffer, shown as its own track.
+ * The buffer of an exited thread is taken over by the next new thread, so that
+ * the short-lived threads of a worker slot share a track and buffers stay bounded.
+ */
+class Tracer {
+public:
+    // A completed scope, names are string literals
+    struct Event {
+        const char* name;
+        const char* category;
+        std::chrono::steady_clock::time_point begin;
+        std::chrono::steady_clock::time_point end;
+    };
+
+    // Tracer is a single global instance
+    virtual ~Tracer() = default;
+    Tracer(const Tracer &other) = delete;
+    Tracer(Tracer &&other) = delete;
+    Tracer& operator=(const Tracer &other) = delete;
+    Tracer& operator=(Tracer &&other) = delete;
+
+    // Getters/Setters
+    /*
+     * Return whether the library was compiled with its trace events.
+     * Otherwise, only the scopes opened by the caller are recorded.
+     */
+    static constexpr bool isAvailable() {
+#if defined ALPHADOCTE_TRACING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /*
+     * Return whether events are being recorded, ie between start() and stop().
+     */
+    bool isRecording() const;
+
+    /*
+     * Return the number of events recorded by all threads.
+     */
+    size_t getEventCount() const;
+
+    // Methods
+    /*
+     * Discard the previous events, as well as the buffers of exited threads, and start recording.
+     */
+    void start();
+
+    /*
+     * Stop recording, the events are kept until the next start().
+     */
+    void stop();
+
+    /*
+     * Record an event for the current thread, if recording.
+     */
+    void record(const Event& event);
+
+    /*
+     * Write the events, as a JSON object with a "traceEvents" array.
+     * Times are in microseconds since start(), and each thread is a track of the process.
+     */
+    void writeChromeTrace(std::ostream& stream) const;
+
+    /*
+     * Return the tracer shared by the whole process.
+     */
+    static Tracer& getGlobal();
+
+private:
+    // Events of one thread, the mutex is only contended while writing the trace
+    struct ThreadBuffer {
+        size_t trackId;
+        std::vector<Event> events;
+        std::mutex mutex;
+    };
+
+    // Constructors
+    Tracer() = default;
+
+    // Private methods
+    ThreadBuffer& getThreadBuffer();
+
+    // Fields
+    std::atomic<bool> m_recording{false};
+    std::chrono::steady_clock::time_point m_start;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers; // kept after their thread exits, until start()
+    std::vector<size_t> m_freeTrackIds;                   // of the dropped buffers, reused smallest first
+    mutable std::mutex m_mutex;                           // guards m_buffers, m_freeTrackIds and m_start
+};
+
+/*
+ * Record the time spent in a scope, as an event of the global tracer, when destroyed.
+ * Nothing is recorded if the tracer is not recording when the scope is opened.
+ */
+class TraceScope {
+public:
+    /*
+     * Args:
+     * - name : name of the event, must be a string literal
+     * - category : category of the event (eg "solver", "cache"), must be a string literal
+     */
+    TraceScope(const char* name, const char* category);
+    ~TraceScope();
+
+    TraceScope(const TraceScope &other) = delete;
+    TraceScope(TraceScope &&other) = delete;
+    TraceScope& operator=(const TraceScope &other) = delete;
+    TraceScope& operator=(TraceScope &&other) = delete;
+
+private:
+    const char* m_name;
+    const char* m_category;
+    bool m_recording;
+    std::chrono::steady_clock::time_point m_begin;
+};
+
+} /* namespace Alphadocte */
+
+// Trace the enclosing scope, compiled to nothing without ALPHADOCTE_TRACING
+#define ALPHADOCTE_TRACE_CONCAT_(a, b) a##b
+#define ALPHADOCTE_TRACE_CONCAT(a, b) ALPHADOCTE_TRACE_CONCAT_(a, b)
+#if defined ALPHADOCTE_TRACING
+#define ALPHADOCTE_TRACE_SCOPE(name, category) \
+    ::Alphadocte::TraceScope ALPHADOCTE_TRACE_CONCAT(alphadocteTraceScope, __LINE__){name, category}
+#else
+#define ALPHADOCTE_TRACE_SCOPE(name, category) static_cast<void>(0)
+#endif
+
+#endif /* TRACE_H_ */
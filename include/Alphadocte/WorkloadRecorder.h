@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: WorkloadRecorder.h
+ */
+
+#ifndef WORKLOADRECORDER_H_
+#define WORKLOADRECORDER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <Alphadocte/Hint.h>
+
+namespace Alphadocte {
+
+class Solver;
+
+/*
+ * Log of the calls made to solvers, so that a slow game can be replayed exactly
+ * (see the alphadocte-replay executable).
+ *
+ * The log is a text file, one call per line, whose words are separated by a space:
+ * - the header "alphadocte-workload" followed by the format version,
+ * - "game", when a template is set: the game id, the solver name and version, the rules
+ *   ("motus", "wordle" or "other"), their maximum number of guesses, the number of words
+ *   and the content hash of their dictionary (see Dictionary::getContentHash()), and the template,
+ * - "hint": the game id, the guess and its hints packed as by packHints(),
+ * - "compute": the game id, the number of guesses requested, the duration in seconds,
+ *   and the guesses returned, separated by commas ("-" if there is none).
+ *
+ * A recorder can be shared by several solvers, even from different threads, see Solver::setRecorder().
+ * Write errors are ignored, recording never makes a solver fail.
+ */
+class WorkloadRecorder {
+public:
+    static constexpr std::string_view HEADER = "alphadocte-workload";
+    static constexpr unsigned int FORMAT_VERSION = 1;
+
+    // Constructors
+    /*
+     * Create a recorder writing to a file, replacing its content.
+     *
+     * Throws:
+     * - Exception : if the file cannot be opened.
+     */
+    explicit WorkloadRecorder(const std::filesystem::path& path);
+
+    /*
+     * Create a recorder writing to a stream, which must outlive the recorder.
+     */
+    explicit WorkloadRecorder(std::ostream& output);
+
+    // A recorder is shared through a pointer, not copied
+    virtual ~WorkloadRecorder();
+    WorkloadRecorder(const WorkloadRecorder &other) = delete;
+    WorkloadRecorder(WorkloadRecorder &&other) = delete;
+    WorkloadRecorder& operator=(const WorkloadRecorder &other) = delete;
+    WorkloadRecorder& operator=(WorkloadRecorder &&other) = delete;
+
+    // Getters/Setters
+    /*
+     * Return the number of games recorded so far.
+     */
+    std::uint64_t getGameCount() const;
+
+    // Methods
+    /*
+     * Record a new game, from the current template of the solver, and return its id.
+     */
+    std::uint64_t recordGame(const Solver& solver);
+
+    /*
+     * Record a hint added to the solver playing a game.
+     */
+    void recordHint(std::uint64_t gameId, std::string_view guess, const std::vector<HintType>& hints);
+
+    /*
+     * Record a call to Solver::computeNextGuesses(n) during a game.
+     *
+     * Args:
+     * - gameId : the game, as returned by #recordGame()
+     * - n : the number of guesses requested
+     * - duration : the duration of the call, in seconds
+     * - guesses : the guesses returned
+     */
+    void recordComputation(std::uint64_t gameId, size_t n, double duration,
+            const std::vector<std::pair<std::string, double>>& guesses);
+
+    /*
+     * Write the buffered calls to the file or stream.
+     */
+    void flush();
+
+private:
+    // Fields
+    std::ofstream m_file;    // unused when writing to a stream
+    std::ostream* m_output;  // m_file, or the stream given
+    std::uint64_t m_nbGames;
+    mutable std::mutex m_mutex; // guards all the other fields
+};
+
+} /* namespace Alphadocte */
+
+#endif /* WORKLOADRECORDER_H_ */
@@ -20,7 +20,9 @@
  */
 
 #include <Alphadocte/Dictionary.h>
+#include <Alphadocte/Memory.h>
 #include <algorithm>
+#include <iterator>
 
 
 
@@ -30,9 +32,52 @@ const std::vector<std::string>& Dictionary::getAllWords() const {
     return m_words;
 }
 
+std::uint64_t Dictionary::getContentHash() const {
+    return m_contentHash;
+}
+
+size_t Dictionary::getRetainedBytes() const {
+    size_t size = sizeof(Dictionary) + m_words.capacity() * sizeof(std::string);
+    for (const auto& word : m_words)
+        size += getHeapSize(word);
+
+    return size;
+}
+
 bool Dictionary::contains(std::string_view word) const {
     return std::binary_search(std::cbegin(m_words), std::cend(m_words), word);
 }
 
+std::optional<size_t> Dictionary::findWord(std::string_view word) const {
+    auto it = std::lower_bound(std::cbegin(m_words), std::cend(m_words), word);
+
+    if (it == std::cend(m_words) || *it != word)
+        return std::nullopt;
+
+    return static_cast<size_t>(std::distance(std::cbegin(m_words), it));
+}
+
+void Dictionary::updateContentHash() {
+    if (m_words.empty()) {
+        m_contentHash = 0;
+        return;
+    }
+
+    // FNV-1a of the sorted words, each followed by a line break, stable across platforms and runs
+    std::uint64_t hash = 14695981039346656037ull;
+    auto addByte = [&hash](unsigned char c) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    };
+
+    for (const auto& word : m_words) {
+        for (char c : word)
+            addByte(static_cast<unsigned char>(c));
+        addByte('\n');
+    }
+
+    m_contentHash = hash;
+}
+
 } /* namespace Alphadocte */
 
@@ -24,10 +24,18 @@
 #include <Alphadocte/Exceptions.h>
 #include <Alphadocte/Game.h>
 #include <Alphadocte/IGameRules.h>
+#include <Alphadocte/Memory.h>
+#include <Alphadocte/Metrics.h>
+#include <Alphadocte/SolverMemo.h>
+#include <Alphadocte/Trace.h>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <exception>
 #include <map>
+#include <mutex>
 #include <numeric>
+#include <thread>
 #include <vector>
 
 
@@ -53,8 +61,23 @@ bool operator<(const std::vector<Alphadocte::HintType>& lhs, const std::vector<A
 
 namespace Alphadocte {
 
+namespace {
+
+// keep helper functions local to this translation unit
+
+std::mutex defaultTuningMutex;
+EntropyMaximizer::Tuning defaultTuning; // guarded by defaultTuningMutex
+
+void checkTuning(const EntropyMaximizer::Tuning& tuning, const std::string& functionName) {
+    if (tuning.nbThreads == 0) {
+        throw InvalidArgException("the number of threads must be strictly positive.", functionName);
+    }
+}
+
+}
+
 EntropyMaximizer::EntropyMaximizer(std::shared_ptr<IGameRules> rules)
-        : Solver(rules, "entropy_maximizer", 1) {}
+        : Solver(rules, SOLVER_NAME, SOLVER_VERSION), m_tuning{getDefaultTuning()} {}
 
 std::string EntropyMaximizer::computeNextGuess() const {
     auto guessEntropy = computeNextGuesses(1);
@@ -68,6 +91,25 @@ std::string EntropyMaximizer::computeNextGuess() const {
 }
 
 std::vector<std::pair<std::string, double>> EntropyMaximizer::computeNextGuesses(size_t n) const {
+    LatencyTimer timer{LibraryMetrics::get().computeGuessesLatency};
+    ALPHADOCTE_TRACE_SCOPE("computeNextGuesses", "solver");
+    AllocationPhase allocationPhase{MemoryPhase::COMPUTE_GUESSES};
+    auto start = std::chrono::steady_clock::now();
+
+    auto& stats = getMutableStats();
+    // every guess is scored, the solver does not prune any
+    stats.nbGuessesScored = stats.nbGuessesPruned = stats.nbPatternsEvaluated = stats.peakScratchMemory = 0;
+    stats.nbThreads = 0;
+    stats.fromMemo = false;
+
+    auto entropies = findNextGuesses(n);
+
+    stats.computeGuessesDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    recordComputation(n, entropies, stats.computeGuessesDuration);
+    return entropies;
+}
+
+std::vector<std::pair<std::string, double>> EntropyMaximizer::findNextGuesses(size_t n) const {
     std::vector<std::pair<std::string, double>> entropies;
 
     auto templateWord = getTemplate();
@@ -88,41 +130,39 @@ std::vector<std::pair<std::string, double>> EntropyMaximizer::computeNextGuesses
         return entropies;
     }
 
-    const auto& guesses = getPotentialGuesses();
+    // reuse the guesses of an already seen state, or of a state being computed by another solver
+    if (auto memo = getMemo()) {
+        bool computed{false};
+        auto guesses = memo->findOrCompute(SolverMemo::computeStateKey(*this), n, [this, n, &computed]() {
+            computed = true;
+            return rankGuesses(n);
+        });
 
-    // evaluate all guesses
-    double expectedEntropy{};
-    for (const auto& guess : guesses) {
-        expectedEntropy = computeExpectedEntropy(guess);
+        getMutableStats().fromMemo = !computed;
+        return guesses;
+    }
 
-        // insert guess in the sorted array (sort by descending order of entropy,
-        // and favor potential solutions in case of equality)
-        bool inserted{false};
-        for (auto it = std::begin(entropies); it != std::end(entropies); it++) {
-            if (it->second < expectedEntropy) {
-                // this guess has a better entropy than the next guess in array
-                inserted = true;
-                entropies.insert(it, std::make_pair(std::string(guess), expectedEntropy));
-                break;
-            } else if (it->second == expectedEntropy &&
-                    std::find(std::cbegin(solutions), std::cend(solutions), guess) != std::cend(solutions)) {
-                // this guess has the same entropy than the next guess in array,
-                // but this is also a potential solution -> prioritizes it
-                inserted = true;
-                entropies.insert(it, std::make_pair(std::string(guess), expectedEntropy));
-                break;
-            }
-        }
+    return rankGuesses(n);
+}
 
-        if (!inserted) {
-            entropies.emplace_back(std::make_pair(guess, expectedEntropy));
-        }
-    }
+EntropyMaximizer::Tuning EntropyMaximizer::getTuning() const {
+    return m_tuning;
+}
 
-    // keep only top n entries, or less if array is smaller
-    entropies.erase(std::begin(entropies) + std::min(n, std::size(entropies)), std::end(entropies));
+void EntropyMaximizer::setTuning(const Tuning& tuning) {
+    checkTuning(tuning, "Alphadocte::EntropyMaximizer::setTuning(const Alphadocte::EntropyMaximizer::Tuning&)");
+    m_tuning = tuning;
+}
 
-    return entropies;
+EntropyMaximizer::Tuning EntropyMaximizer::getDefaultTuning() {
+    std::lock_guard lock{defaultTuningMutex};
+    return defaultTuning;
+}
+
+void EntropyMaximizer::setDefaultTuning(const Tuning& tuning) {
+    checkTuning(tuning, "Alphadocte::EntropyMaximizer::setDefaultTuning(const Alphadocte::EntropyMaximizer::Tuning&)");
+    std::lock_guard lock{defaultTuningMutex};
+    defaultTuning = tuning;
 }
 
 double EntropyMaximizer::computeActualEntropy(std::string_view guess, const std::vector<HintType>& hints) const {
@@ -144,24 +184,74 @@ double EntropyMaximizer::computeActualEntropy(std::string_view guess, const std:
 }
 
 double EntropyMaximizer::computeExpectedEntropy(std::string_view guess) const {
-    std::map<std::vector<HintType>, size_t> occurrences;
+    size_t nbPatterns{};
+    HintCounts hintCounts;
+    return computeExpectedEntropy(guess, getHistogramStrategy(), hintCounts, nbPatterns);
+}
 
-    for (std::string_view solution : getPotentialSolutions()) {
-        std::vector<HintType> hints = Game::computeHints(guess, solution);
+double EntropyMaximizer::computeExpectedEntropy(std::string_view guess, HistogramStrategy strategy, HintCounts& hintCounts,
+        size_t& nbPatterns) const {
+    const auto& solutions = getPotentialSolutions();
+    LibraryMetrics::get().patternsEvaluated.add(std::size(solutions));
 
-        try {
-            occurrences.at(hints)++;
-        } catch (const std::out_of_range& e) {
-            // first occurrence found
-            occurrences.emplace(hints, 1);
+    // every strategy sums the hints in their lexical order (the order of the hint codes),
+    // so that they compute exactly the same entropies
+    double entropy{};
+    double n = static_cast<double>(std::size(solutions));
+    auto addOccurrences = [&entropy, n](size_t count) {
+        entropy += - (count / n) * log2(count / n);
+    };
+    nbPatterns = 0;
+
+    if (strategy == HistogramStrategy::DENSE) {
+        size_t nbCodes = winningHintCode(static_cast<word_size>(std::size(guess))) + 1;
+        if (std::size(hintCounts.counts) < nbCodes)
+            hintCounts.counts.resize(nbCodes);
+
+        hintCounts.codes.clear();
+        for (std::string_view solution : solutions) {
+            auto code = Game::computeHintCode(guess, solution);
+            if (hintCounts.counts[code]++ == 0)
+                hintCounts.codes.push_back(code);
         }
-    }
 
-    double entropy{};
-    double n = static_cast<double>(std::size(getPotentialSolutions()));
+        // only the codes seen need to be reset for the next guess
+        std::sort(std::begin(hintCounts.codes), std::end(hintCounts.codes));
+        for (auto code : hintCounts.codes) {
+            addOccurrences(hintCounts.counts[code]);
+            hintCounts.counts[code] = 0;
+        }
+        nbPatterns = std::size(hintCounts.codes);
+    } else if (strategy == HistogramStrategy::SORTED) {
+        hintCounts.codes.clear();
+        for (std::string_view solution : solutions) {
+            hintCounts.codes.push_back(Game::computeHintCode(guess, solution));
+        }
+
+        std::sort(std::begin(hintCounts.codes), std::end(hintCounts.codes));
+        for (auto it = std::cbegin(hintCounts.codes); it != std::cend(hintCounts.codes); nbPatterns++) {
+            auto next = std::find_if(it, std::cend(hintCounts.codes), [it](HintCode code) { return code != *it; });
+            addOccurrences(static_cast<size_t>(next - it));
+            it = next;
+        }
+    } else {
+        std::map<std::vector<HintType>, size_t> occurrences;
 
-    for (const auto& pair : occurrences) {
-        entropy += - (pair.second / n) * log2(pair.second / n);
+        for (std::string_view solution : solutions) {
+            std::vector<HintType> hints = Game::computeHints(guess, solution);
+
+            try {
+                occurrences.at(hints)++;
+            } catch (const std::out_of_range& e) {
+                // first occurrence found
+                occurrences.emplace(hints, 1);
+            }
+        }
+
+        nbPatterns = std::size(occurrences);
+        for (const auto& pair : occurrences) {
+            addOccurrences(pair.second);
+        }
     }
 
     return entropy;
@@ -178,5 +268,114 @@ double EntropyMaximizer::computeCurrentEntropy() const {
     }
 }
 
-} /* namespace Alphadocte */
+std::vector<std::pair<std::string, double>> EntropyMaximizer::rankGuesses(size_t n) const {
+    std::vector<std::pair<std::string, double>> entropies;
+    const auto& solutions = getPotentialSolutions();
+    const auto& guesses = getPotentialGuesses();
+    LibraryMetrics::get().guessesScored.add(std::size(guesses));
+
+    // small states are not worth starting threads
+    auto strategy = getHistogramStrategy();
+    size_t nbThreads = std::size(guesses) * std::size(solutions) >= m_tuning.minParallelPatterns ? m_tuning.nbThreads : 1;
+    nbThreads = std::max<size_t>(std::min(nbThreads, std::size(guesses)), 1);
+
+    // evaluate all guesses, before ranking them (both phases are traced separately)
+    std::vector<double> scores(std::size(guesses));
+    std::vector<size_t> maxPatterns(nbThreads);     // by thread
+    std::vector<size_t> histogramMemory(nbThreads); // by thread
+    {
+        // each thread scores a contiguous block of guesses
+        auto scoreBlock = [&](size_t t) {
+            ALPHADOCTE_TRACE_SCOPE("scoreGuesses", "solver");
+            HintCounts hintCounts;
+            size_t nbPatterns{};
+            for (size_t i = std::size(guesses) * t / nbThreads; i < std::size(guesses) * (t + 1) / nbThreads; i++) {
+                scores[i] = computeExpectedEntropy(guesses[i], strategy, hintCounts, nbPatterns);
+                maxPatterns[t] = std::max(maxPatterns[t], nbPatterns);
+            }
+            histogramMemory[t] = hintCounts.counts.capacity() * sizeof(std::uint32_t) + hintCounts.codes.capacity() * sizeof(HintCode);
+        };
+
+        std::vector<std::exception_ptr> errors(nbThreads);
+        {
+            // joined when leaving the scope, even if a thread cannot be started
+            std::vector<std::jthread> threads;
+            for (size_t t = 1; t < nbThreads; t++) {
+                threads.emplace_back([&scoreBlock, &errors, t]() {
+                    AllocationPhase allocationPhase{MemoryPhase::COMPUTE_GUESSES};
+                    try {
+                        scoreBlock(t);
+                    } catch (...) {
+                        errors[t] = std::current_exception();
+                    }
+                });
+            }
+
+            scoreBlock(0);
+        }
+
+        for (const auto& error : errors) {
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
 
+    ALPHADOCTE_TRACE_SCOPE("rankGuesses", "solver");
+    for (size_t i = 0; i < std::size(guesses); i++) {
+        const auto& guess = guesses[i];
+        double expectedEntropy = scores[i];
+
+        // insert guess in the sorted array (sort by descending order of entropy,
+        // and favor potential solutions in case of equality)
+        bool inserted{false};
+        for (auto it = std::begin(entropies); it != std::end(entropies); it++) {
+            if (it->second < expectedEntropy) {
+                // this guess has a better entropy than the next guess in array
+                inserted = true;
+                entropies.insert(it, std::make_pair(std::string(guess), expectedEntropy));
+                break;
+            } else if (it->second == expectedEntropy &&
+                    std::find(std::cbegin(solutions), std::cend(solutions), guess) != std::cend(solutions)) {
+                // this guess has the same entropy than the next guess in array,
+                // but this is also a potential solution -> prioritizes it
+                inserted = true;
+                entropies.insert(it, std::make_pair(std::string(guess), expectedEntropy));
+                break;
+            }
+        }
+
+        if (!inserted) {
+            entropies.emplace_back(std::make_pair(guess, expectedEntropy));
+        }
+    }
+
+    // the MAP strategy counts the hints of a guess in a map, whose nodes hold the hints and three pointers
+    auto& stats = getMutableStats();
+    stats.nbGuessesScored = std::size(guesses);
+    stats.nbPatternsEvaluated = std::size(guesses) * std::size(solutions);
+    stats.nbThreads = static_cast<unsigned int>(nbThreads);
+    stats.peakScratchMemory = scores.capacity() * sizeof(double)
+            + entropies.capacity() * sizeof(std::pair<std::string, double>);
+    for (size_t t = 0; t < nbThreads; t++) {
+        stats.peakScratchMemory += strategy != HistogramStrategy::MAP ? histogramMemory[t]
+                : maxPatterns[t] * (sizeof(std::pair<const std::vector<HintType>, size_t>) + 3 * sizeof(void*)
+                                    + std::size(getTemplate()) * sizeof(HintType));
+    }
+
+    // keep only top n entries, or less if array is smaller
+    entropies.erase(std::begin(entropies) + std::min(n, std::size(entropies)), std::end(entropies));
+
+    return entropies;
+}
+
+EntropyMaximizer::HistogramStrategy EntropyMaximizer::getHistogramStrategy() const {
+    auto nbLetters = std::size(getTemplate());
+    if (m_tuning.histogram == HistogramStrategy::MAP || nbLetters > MAX_PACKED_HINTS)
+        return HistogramStrategy::MAP;
+    if (m_tuning.histogram == HistogramStrategy::DENSE && nbLetters > DENSE_HISTOGRAM_MAX_LETTERS)
+        return HistogramStrategy::SORTED;
+
+    return m_tuning.histogram;
+}
+
+} /* namespace Alphadocte */
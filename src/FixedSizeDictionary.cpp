@@ -20,6 +20,7 @@
  */
 
 #include <Alphadocte/FixedSizeDictionary.h>
+#include <Alphadocte/Memory.h>
 #include <utility>
 #include <algorithm>
 #include <iterator>
@@ -45,6 +46,8 @@ bool FixedSizeDictionary::load() {
         return false;
     }
 
+    AllocationPhase allocationPhase{MemoryPhase::DICTIONARY_LOAD};
+
     if (!m_internalDict->isLoaded() && !m_internalDict->load()) {
         // Abort if internal dictionary is not loaded and fail to load
         return false;
@@ -69,6 +72,7 @@ bool FixedSizeDictionary::load() {
 
     // Update probabilistic distribution
     m_distribution = boost::uniform_int<size_t>{0, m_words.size() - 1};
+    updateContentHash();
 
     return true;
 }
@@ -23,6 +23,7 @@
 #include <Alphadocte/Game.h>
 #include <Alphadocte/IGameRules.h>
 #include <algorithm>
+#include <array>
 
 
 namespace Alphadocte {
@@ -177,6 +178,39 @@ std::vector<HintType> Game::computeHints(std::string_view word, std::string_view
     return hints;
 }
 
+HintCode Game::computeHintCode(std::string_view word, std::string_view solution) {
+    if (std::size(word) != std::size(solution) || std::size(word) > MAX_PACKED_HINTS) {
+        throw InvalidArgException("Cannot compute hint code: words \"" + std::string(word) +
+                "\" and \"" + std::string(solution) + "\" does not have the same size, or are too long",
+                "Alphadocte::Game::computeHintCode(std::string_view, std::string_view)");
+    }
+
+    // Count the letters of the solution which are not at their correct position
+    std::array<unsigned char, 256> remainingLetters{};
+    for (word_size i = 0; i < std::size(word); i++) {
+        if (word[i] != solution[i]) {
+            remainingLetters[static_cast<unsigned char>(solution[i])]++;
+        }
+    }
+
+    // Then assign the hints from left to right, as computeHints does
+    HintCode code{};
+    for (word_size i = 0; i < std::size(word); i++) {
+        HintType hint{HintType::WRONG};
+
+        if (word[i] == solution[i]) {
+            hint = HintType::CORRECT;
+        } else if (auto& count = remainingLetters[static_cast<unsigned char>(word[i])]; count > 0) {
+            hint = HintType::MISPLACED;
+            count--;
+        }
+
+        code = code * 3 + static_cast<HintCode>(hint);
+    }
+
+    return code;
+}
+
 std::string Game::computeTemplate(size_t wordSize, const std::vector<std::string>& guesses, const std::vector<std::vector<HintType>>& hints){
     std::string pattern;
     std::fill_n(std::back_inserter(pattern), wordSize, '.');
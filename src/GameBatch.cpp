@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: GameBatch.cpp
+ */
+
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Game.h>
+#include <Alphadocte/GameBatch.h>
+#include <Alphadocte/IGameRules.h>
+#include <algorithm>
+
+
+namespace Alphadocte {
+
+// Constructors
+GameBatch::GameBatch(std::shared_ptr<IGameRules> rules, size_t nbGames, unsigned int turnCapacity)
+        : m_rules{std::move(rules)}, m_dictionary{}, m_turnCapacity{turnCapacity},
+          m_solutions{}, m_nbGuesses{}, m_won{}, m_guesses{}, m_hints{} {
+    if (!m_rules) {
+        throw InvalidArgException("rules cannot be null",
+                "Alphadocte::GameBatch::GameBatch(std::shared_ptr<Alphadocte::IGameRules>, size_t, unsigned int)");
+    }
+
+    m_dictionary = m_rules->getDictionary();
+
+    if (std::size(m_dictionary->getAllWords()) >= NO_WORD) {
+        throw InvalidArgException("too many words in the dictionary to be identified",
+                "Alphadocte::GameBatch::GameBatch(std::shared_ptr<Alphadocte::IGameRules>, size_t, unsigned int)");
+    }
+
+    if (m_rules->getMaxGuesses() != 0) {
+        // rules already bound the number of guesses
+        m_turnCapacity = m_rules->getMaxGuesses();
+    } else if (m_turnCapacity == 0) {
+        throw InvalidArgException("turn capacity must be set when rules do not limit the number of guesses",
+                "Alphadocte::GameBatch::GameBatch(std::shared_ptr<Alphadocte::IGameRules>, size_t, unsigned int)");
+    }
+
+    // allocate everything once
+    m_solutions.assign(nbGames, NO_WORD);
+    m_nbGuesses.assign(nbGames, 0);
+    m_won.assign(nbGames, false);
+    m_guesses.assign(nbGames * m_turnCapacity, NO_WORD);
+    m_hints.assign(nbGames * m_turnCapacity, 0);
+}
+
+// Getters/Setters
+size_t GameBatch::size() const {
+    return std::size(m_solutions);
+}
+
+unsigned int GameBatch::getTurnCapacity() const {
+    return m_turnCapacity;
+}
+
+size_t GameBatch::getRetainedBytes() const {
+    return sizeof(GameBatch) + m_solutions.capacity() * sizeof(word_id) + m_nbGuesses.capacity() * sizeof(unsigned int)
+            + m_won.capacity() * sizeof(unsigned char) + m_guesses.capacity() * sizeof(word_id)
+            + m_hints.capacity() * sizeof(HintCode);
+}
+
+std::shared_ptr<const IGameRules> GameBatch::getRules() const {
+    return m_rules;
+}
+
+const std::vector<std::string>& GameBatch::getWords() const {
+    return m_dictionary->getAllWords();
+}
+
+std::string_view GameBatch::getWord(word_id id) const {
+    const auto& words = getWords();
+
+    if (id >= std::size(words)) {
+        throw InvalidArgException("word id " + std::to_string(id) + " does not identify a word",
+                "Alphadocte::GameBatch::getWord(Alphadocte::GameBatch::word_id) const");
+    }
+
+    return words[id];
+}
+
+GameBatch::word_id GameBatch::getWordId(std::string_view word) const {
+    auto id = findWordId(word);
+
+    if (!id) {
+        throw InvalidArgException("the word " + std::string(word) + " is not in the dictionary",
+                "Alphadocte::GameBatch::getWordId(std::string_view) const");
+    }
+
+    return *id;
+}
+
+std::optional<GameBatch::word_id> GameBatch::findWordId(std::string_view word) const {
+    if (auto index = m_dictionary->findWord(word))
+        return static_cast<word_id>(*index);
+
+    return std::nullopt;
+}
+
+GameBatch::word_id GameBatch::getSolution(size_t game) const {
+    checkGame(game, "Alphadocte::GameBatch::getSolution(size_t) const");
+    return m_solutions[game];
+}
+
+void GameBatch::setSolution(size_t game, word_id solution) {
+    checkGame(game, "Alphadocte::GameBatch::setSolution(size_t, Alphadocte::GameBatch::word_id)");
+
+    if (solution >= std::size(getWords()) || !m_rules->isSolutionValid(getWords()[solution])) {
+        throw InvalidArgException("the word id " + std::to_string(solution) + " is not a valid solution",
+                "Alphadocte::GameBatch::setSolution(size_t, Alphadocte::GameBatch::word_id)");
+    }
+
+    reset(game);
+    m_solutions[game] = solution;
+}
+
+bool GameBatch::hasStarted(size_t game) const {
+    checkGame(game, "Alphadocte::GameBatch::hasStarted(size_t) const");
+    return m_solutions[game] != NO_WORD;
+}
+
+bool GameBatch::isOver(size_t game) const {
+    checkGame(game, "Alphadocte::GameBatch::isOver(size_t) const");
+    return m_won[game] || m_nbGuesses[game] >= m_turnCapacity;
+}
+
+bool GameBatch::isWon(size_t game) const {
+    checkGame(game, "Alphadocte::GameBatch::isWon(size_t) const");
+    return m_won[game];
+}
+
+unsigned int GameBatch::getNbGuess(size_t game) const {
+    checkGame(game, "Alphadocte::GameBatch::getNbGuess(size_t) const");
+    return m_nbGuesses[game];
+}
+
+GameBatch::word_id GameBatch::getGuess(size_t game, unsigned int turn) const {
+    checkGame(game, "Alphadocte::GameBatch::getGuess(size_t, unsigned int) const");
+
+    if (turn >= m_nbGuesses[game]) {
+        throw InvalidArgException("turn " + std::to_string(turn) + " has not been played",
+                "Alphadocte::GameBatch::getGuess(size_t, unsigned int) const");
+    }
+
+    return m_guesses[game * m_turnCapacity + turn];
+}
+
+HintCode GameBatch::getHints(size_t game, unsigned int turn) const {
+    checkGame(game, "Alphadocte::GameBatch::getHints(size_t, unsigned int) const");
+
+    if (turn >= m_nbGuesses[game]) {
+        throw InvalidArgException("turn " + std::to_string(turn) + " has not been played",
+                "Alphadocte::GameBatch::getHints(size_t, unsigned int) const");
+    }
+
+    return m_hints[game * m_turnCapacity + turn];
+}
+
+size_t GameBatch::countOver() const {
+    size_t count{};
+
+    for (size_t game = 0; game < size(); game++) {
+        if (m_won[game] || m_nbGuesses[game] >= m_turnCapacity)
+            count++;
+    }
+
+    return count;
+}
+
+size_t GameBatch::countWon() const {
+    return std::count(std::cbegin(m_won), std::cend(m_won), true);
+}
+
+// Methods
+void GameBatch::reset(size_t game) {
+    checkGame(game, "Alphadocte::GameBatch::reset(size_t)");
+
+    m_solutions[game] = NO_WORD;
+    m_nbGuesses[game] = 0;
+    m_won[game] = false;
+}
+
+void GameBatch::reset() {
+    std::fill(std::begin(m_solutions), std::end(m_solutions), NO_WORD);
+    std::fill(std::begin(m_nbGuesses), std::end(m_nbGuesses), 0);
+    std::fill(std::begin(m_won), std::end(m_won), false);
+}
+
+HintCode GameBatch::tryGuess(size_t game, word_id guess) {
+    checkGame(game, "Alphadocte::GameBatch::tryGuess(size_t, Alphadocte::GameBatch::word_id)");
+
+    // same checks as Game::tryGuess
+    if (m_solutions[game] == NO_WORD)
+        throw Exception("Cannot try a guess: game has not been started",
+                "Alphadocte::GameBatch::tryGuess(size_t, Alphadocte::GameBatch::word_id)");
+    if (m_won[game] || m_nbGuesses[game] >= m_turnCapacity)
+        throw Exception("Cannot try a guess: game is over",
+                "Alphadocte::GameBatch::tryGuess(size_t, Alphadocte::GameBatch::word_id)");
+
+    const auto& words = getWords();
+    std::string_view solution = words[m_solutions[game]];
+
+    if (guess >= std::size(words) || !m_rules->isGuessValid(words[guess], solution))
+        throw Exception("Cannot try a guess: invalid guess",
+                "Alphadocte::GameBatch::tryGuess(size_t, Alphadocte::GameBatch::word_id)");
+
+    HintCode hints = Game::computeHintCode(words[guess], solution);
+    size_t turnIndex = game * m_turnCapacity + m_nbGuesses[game];
+
+    m_guesses[turnIndex] = guess;
+    m_hints[turnIndex] = hints;
+    m_nbGuesses[game]++;
+    m_won[game] = hints == winningHintCode(std::size(solution));
+
+    return hints;
+}
+
+void GameBatch::checkGame(size_t game, const char* functionName) const {
+    if (game >= size()) {
+        throw InvalidArgException("game " + std::to_string(game) + " is out of range", functionName);
+    }
+}
+
+} /* namespace Alphadocte */
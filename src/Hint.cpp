@@ -19,8 +19,10 @@
  * File: Hint.cpp
  */
 
+#include <Alphadocte/Exceptions.h>
 #include <Alphadocte/Hint.h>
 #include <set>
+#include <string>
 
 #include <Alphadocte/Alphadocte.h>
 
@@ -45,6 +47,51 @@ std::ostream& operator<<(std::ostream& os, HintType hintType) {
     return os;
 }
 
+HintCode packHints(const std::vector<HintType>& hints) {
+    if (std::size(hints) > MAX_PACKED_HINTS) {
+        throw InvalidArgException("cannot pack more than " + std::to_string(MAX_PACKED_HINTS) + " hints.",
+                "Alphadocte::packHints(const std::vector<Alphadocte::HintType>&)");
+    }
+
+    HintCode code{};
+    for (HintType hint : hints) {
+        code = code * 3 + static_cast<HintCode>(hint);
+    }
+
+    return code;
+}
+
+std::vector<HintType> unpackHints(HintCode code, word_size size) {
+    if (size > MAX_PACKED_HINTS) {
+        throw InvalidArgException("cannot unpack more than " + std::to_string(MAX_PACKED_HINTS) + " hints.",
+                "Alphadocte::unpackHints(Alphadocte::HintCode, Alphadocte::word_size)");
+    }
+
+    if (code > winningHintCode(size)) {
+        throw InvalidArgException("hint code " + std::to_string(code) + " does not fit in " + std::to_string(size) + " hints.",
+                "Alphadocte::unpackHints(Alphadocte::HintCode, Alphadocte::word_size)");
+    }
+
+    // fill from the least significant digit, ie the last letter
+    std::vector<HintType> hints(size, HintType::WRONG);
+    for (word_size i = size; i > 0; i--) {
+        hints[i-1] = static_cast<HintType>(code % 3);
+        code /= 3;
+    }
+
+    return hints;
+}
+
+HintCode winningHintCode(word_size size) {
+    // 22...2 in base 3 is 3^size - 1
+    HintCode power{1};
+    for (word_size i = 0; i < size; i++) {
+        power *= 3;
+    }
+
+    return power - 1;
+}
+
 bool matches(std::string_view word, std::string_view guess, const std::vector<HintType>& hints) {
     if (std::size(word) != std::size(guess) || std::size(guess) != std::size(hints)) {
         // All arguments must have the same length
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Memory.cpp
+ */
+
+#include <Alphadocte/Memory.h>
+#include <Alphadocte/Metrics.h>
+#include <array>
+#include <atomic>
+#include <string>
+
+
+namespace Alphadocte {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+// Counters of one phase, constant-initialized so that allocations can be recorded at any time
+struct PhaseCounters {
+    std::atomic<std::uint64_t> nbAllocations{};
+    std::atomic<std::uint64_t> allocatedBytes{};
+    std::atomic<std::uint64_t> currentBytes{};
+    std::atomic<std::uint64_t> peakBytes{};
+};
+
+std::array<PhaseCounters, NB_MEMORY_PHASES> phaseCounters{};
+PhaseCounters totalCounters{};
+std::atomic<bool> trackerEnabled{false};
+thread_local MemoryPhase currentPhase{MemoryPhase::OTHER};
+
+void countAllocation(PhaseCounters& counters, size_t size) {
+    counters.nbAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    auto current = counters.currentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+
+    auto peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (peak < current && !counters.peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+}
+
+AllocationStats loadStats(const PhaseCounters& counters) {
+    return AllocationStats{
+        counters.nbAllocations.load(std::memory_order_relaxed),
+        counters.allocatedBytes.load(std::memory_order_relaxed),
+        counters.currentBytes.load(std::memory_order_relaxed),
+        counters.peakBytes.load(std::memory_order_relaxed)
+    };
+}
+
+// Copy the counters of the phases into the metrics, before they are formatted
+void publishMetrics() {
+    auto& registry = MetricsRegistry::getGlobal();
+    for (size_t i = 0; i < NB_MEMORY_PHASES; i++) {
+        auto phase = static_cast<MemoryPhase>(i);
+        MetricLabels labels{{"phase", std::string(AllocationTracker::getPhaseName(phase))}};
+        auto stats = AllocationTracker::getStats(phase);
+
+        auto& nbAllocations = registry.registerCounter("alphadocte_allocations_total",
+                "Number of allocations, by phase of the library.", labels);
+        nbAllocations.add(stats.nbAllocations - nbAllocations.getValue());
+        auto& allocatedBytes = registry.registerCounter("alphadocte_allocated_bytes_total",
+                "Number of bytes allocated, by phase of the library.", labels);
+        allocatedBytes.add(stats.allocatedBytes - allocatedBytes.getValue());
+
+        registry.registerGauge("alphadocte_allocated_bytes", "Number of bytes allocated and not freed yet, by phase of the library.",
+                labels).set(static_cast<std::int64_t>(stats.currentBytes));
+        registry.registerGauge("alphadocte_allocated_bytes_peak", "Highest number of bytes allocated and not freed, by phase of the library.",
+                labels).set(static_cast<std::int64_t>(stats.peakBytes));
+    }
+}
+
+}
+
+size_t getHeapSize(const std::string& str) {
+    // short strings are stored in the object itself
+    const char* data = str.data();
+    const char* object = reinterpret_cast<const char*>(&str);
+    if (data >= object && data < object + sizeof(std::string))
+        return 0;
+
+    return str.capacity() + 1;
+}
+
+// AllocationTracker
+// Getters/Setters
+bool AllocationTracker::isEnabled() {
+    return trackerEnabled.load(std::memory_order_relaxed);
+}
+
+MemoryPhase AllocationTracker::getCurrentPhase() {
+    return currentPhase;
+}
+
+AllocationStats AllocationTracker::getStats(MemoryPhase phase) {
+    return loadStats(phaseCounters[static_cast<size_t>(phase)]);
+}
+
+AllocationStats AllocationTracker::getTotalStats() {
+    return loadStats(totalCounters);
+}
+
+std::string_view AllocationTracker::getPhaseName(MemoryPhase phase) {
+    switch (phase) {
+    case MemoryPhase::DICTIONARY_LOAD:
+        return "dictionary_load";
+    case MemoryPhase::SET_TEMPLATE:
+        return "set_template";
+    case MemoryPhase::ADD_HINT:
+        return "add_hint";
+    case MemoryPhase::COMPUTE_GUESSES:
+        return "compute_next_guesses";
+    default:
+        return "other";
+    }
+}
+
+// Methods
+void AllocationTracker::enable() {
+    if (trackerEnabled.exchange(true))
+        return;
+
+    MetricsRegistry::getGlobal().addCollector(publishMetrics);
+}
+
+void AllocationTracker::recordAllocation(size_t size, MemoryPhase phase) {
+    countAllocation(phaseCounters[static_cast<size_t>(phase)], size);
+    countAllocation(totalCounters, size);
+}
+
+void AllocationTracker::recordDeallocation(size_t size, MemoryPhase phase) {
+    phaseCounters[static_cast<size_t>(phase)].currentBytes.fetch_sub(size, std::memory_order_relaxed);
+    totalCounters.currentBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+// AllocationPhase
+AllocationPhase::AllocationPhase(MemoryPhase phase) : m_previous{currentPhase} {
+    currentPhase = phase;
+}
+
+AllocationPhase::~AllocationPhase() {
+    currentPhase = m_previous;
+}
+
+} /* namespace Alphadocte */
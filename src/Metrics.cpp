@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Metrics.cpp
+ */
+
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Metrics.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <iterator>
+
+
+namespace Alphadocte {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+// Whether a metric (allowColon) or label name is valid
+bool isValidName(const std::string& name, bool allowColon) {
+    auto isValidChar = [allowColon](char c, bool first) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || (allowColon && c == ':')
+                || (!first && c >= '0' && c <= '9');
+    };
+
+    if (name.empty() || !isValidChar(name.front(), true))
+        return false;
+
+    return std::all_of(std::cbegin(name) + 1, std::cend(name), [&isValidChar](char c) { return isValidChar(c, false); });
+}
+
+// Escape backslashes, line breaks, and double quotes if asked, as expected by the text format
+std::string escape(const std::string& text, bool escapeQuotes) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '\\')
+            escaped += "\\\\";
+        else if (c == '\n')
+            escaped += "\\n";
+        else if (c == '"' && escapeQuotes)
+            escaped += "\\\"";
+        else
+            escaped += c;
+    }
+
+    return escaped;
+}
+
+/*
+ * Format labels as name="value" pairs separated by commas, without braces.
+ *
+ * Throws:
+ * - InvalidArgException : if a label name is invalid.
+ */
+std::string formatLabels(const MetricLabels& labels) {
+    std::string formatted;
+    for (const auto& [name, value] : labels) {
+        if (!isValidName(name, false) || name.starts_with("__")) {
+            throw InvalidArgException("invalid label name " + name + '.',
+                    "Alphadocte::formatLabels(const Alphadocte::MetricLabels&)");
+        }
+
+        if (!formatted.empty())
+            formatted += ',';
+        formatted += name + "=\"" + escape(value, true) + '"';
+    }
+
+    return formatted;
+}
+
+std::string formatValue(double value) {
+    if (std::isnan(value))
+        return "NaN";
+    if (std::isinf(value))
+        return value > 0 ? "+Inf" : "-Inf";
+
+    char buffer[32];
+    auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return error == std::errc{} ? std::string(buffer, end) : "NaN";
+}
+
+// Append a sample line, with the labels of the metric and an extra one
+void appendSample(std::string& text, const std::string& name, const std::string& labels,
+        const std::string& extraLabel, const std::string& value) {
+    text += name;
+    if (!labels.empty() || !extraLabel.empty()) {
+        text += '{';
+        text += labels;
+        if (!labels.empty() && !extraLabel.empty())
+            text += ',';
+        text += extraLabel;
+        text += '}';
+    }
+    text += ' ';
+    text += value;
+    text += '\n';
+}
+
+}
+
+// Counter
+std::uint64_t Counter::getValue() const {
+    return m_value.load(std::memory_order_relaxed);
+}
+
+void Counter::add(std::uint64_t value) {
+    m_value.fetch_add(value, std::memory_order_relaxed);
+}
+
+// Gauge
+std::int64_t Gauge::getValue() const {
+    return m_value.load(std::memory_order_relaxed);
+}
+
+void Gauge::set(std::int64_t value) {
+    m_value.store(value, std::memory_order_relaxed);
+}
+
+void Gauge::add(std::int64_t value) {
+    m_value.fetch_add(value, std::memory_order_relaxed);
+}
+
+// Histogram
+Histogram::Histogram(std::vector<double> bounds)
+        : m_bounds{std::move(bounds)}, m_buckets{}, m_sum{} {
+    if (m_bounds.empty() || std::adjacent_find(std::cbegin(m_bounds), std::cend(m_bounds), std::greater_equal<double>{}) != std::cend(m_bounds)
+            || std::any_of(std::cbegin(m_bounds), std::cend(m_bounds), [](double bound) { return std::isnan(bound); })) {
+        throw InvalidArgException("bounds must be strictly increasing, and cannot be empty.",
+                "Alphadocte::Histogram::Histogram(std::vector<double>)");
+    }
+
+    m_buckets = std::make_unique<std::atomic<std::uint64_t>[]>(std::size(m_bounds) + 1);
+}
+
+const std::vector<double>& Histogram::getBounds() const {
+    return m_bounds;
+}
+
+std::vector<std::uint64_t> Histogram::getBucketCounts() const {
+    std::vector<std::uint64_t> counts(std::size(m_bounds) + 1);
+    for (size_t i = 0; i < std::size(counts); i++)
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+
+    return counts;
+}
+
+double Histogram::getSum() const {
+    return m_sum.load(std::memory_order_relaxed);
+}
+
+void Histogram::observe(double value) {
+    // buckets hold the values lower or equal to their bound
+    auto bucket = std::lower_bound(std::cbegin(m_bounds), std::cend(m_bounds), value) - std::cbegin(m_bounds);
+    m_buckets[static_cast<size_t>(bucket)].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::vector<double> Histogram::getLatencyBounds() {
+    return {1e-5, 1e-4, 1e-3, 0.01, 0.1, 1, 10, 100};
+}
+
+// LatencyTimer
+LatencyTimer::LatencyTimer(Histogram& histogram)
+        : m_histogram{histogram}, m_start{std::chrono::steady_clock::now()} {}
+
+LatencyTimer::~LatencyTimer() {
+    m_histogram.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count());
+}
+
+// MetricsRegistry
+Counter& MetricsRegistry::registerCounter(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    auto formattedLabels = formatLabels(labels);
+
+    std::lock_guard lock{m_mutex};
+    auto& counter = getFamily(name, help, MetricType::COUNTER).counters[formattedLabels];
+    if (!counter)
+        counter = std::make_unique<Counter>();
+
+    return *counter;
+}
+
+Gauge& MetricsRegistry::registerGauge(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    auto formattedLabels = formatLabels(labels);
+
+    std::lock_guard lock{m_mutex};
+    auto& gauge = getFamily(name, help, MetricType::GAUGE).gauges[formattedLabels];
+    if (!gauge)
+        gauge = std::make_unique<Gauge>();
+
+    return *gauge;
+}
+
+Histogram& MetricsRegistry::registerHistogram(const std::string& name, const std::string& help, std::vector<double> bounds,
+        const MetricLabels& labels) {
+    auto formattedLabels = formatLabels(labels);
+
+    std::lock_guard lock{m_mutex};
+    auto& histogram = getFamily(name, help, MetricType::HISTOGRAM).histograms[formattedLabels];
+    if (!histogram)
+        histogram = std::make_unique<Histogram>(std::move(bounds));
+
+    return *histogram;
+}
+
+size_t MetricsRegistry::addCollector(std::function<void()> collector) {
+    std::lock_guard lock{m_collectorsMutex};
+    m_collectors.emplace(m_nextCollectorId, std::move(collector));
+    return m_nextCollectorId++;
+}
+
+void MetricsRegistry::removeCollector(size_t collectorId) {
+    std::lock_guard lock{m_collectorsMutex};
+    m_collectors.erase(collectorId);
+}
+
+std::string MetricsRegistry::formatPrometheus() const {
+    std::string text;
+
+    {
+        // collectors may register their gauges, they are called without the registration lock
+        std::lock_guard collectorsLock{m_collectorsMutex};
+        for (const auto& [collectorId, collector] : m_collectors)
+            collector();
+    }
+
+    std::lock_guard lock{m_mutex};
+    for (const auto& [name, family] : m_families) {
+        text += "# HELP " + name + ' ' + escape(family.help, false) + '\n';
+        text += "# TYPE " + name + (family.type == MetricType::HISTOGRAM ? " histogram\n"
+                : family.type == MetricType::GAUGE ? " gauge\n" : " counter\n");
+
+        for (const auto& [labels, counter] : family.counters)
+            appendSample(text, name, labels, "", std::to_string(counter->getValue()));
+
+        for (const auto& [labels, gauge] : family.gauges)
+            appendSample(text, name, labels, "", std::to_string(gauge->getValue()));
+
+        for (const auto& [labels, histogram] : family.histograms) {
+            // buckets are cumulative, and their total is the count, even while being updated
+            auto counts = histogram->getBucketCounts();
+            const auto& bounds = histogram->getBounds();
+            std::uint64_t total = 0;
+            for (size_t i = 0; i < std::size(counts); i++) {
+                total += counts[i];
+                auto bound = i < std::size(bounds) ? formatValue(bounds[i]) : "+Inf";
+                appendSample(text, name + "_bucket", labels, "le=\"" + bound + '"', std::to_string(total));
+            }
+
+            appendSample(text, name + "_sum", labels, "", formatValue(histogram->getSum()));
+            appendSample(text, name + "_count", labels, "", std::to_string(total));
+        }
+    }
+
+    return text;
+}
+
+MetricsRegistry& MetricsRegistry::getGlobal() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Family& MetricsRegistry::getFamily(const std::string& name, const std::string& help, MetricType type) {
+    if (!isValidName(name, true)) {
+        throw InvalidArgException("invalid metric name " + name + '.',
+                "Alphadocte::MetricsRegistry::getFamily(const std::string&, const std::string&, Alphadocte::MetricsRegistry::MetricType)");
+    }
+
+    auto [it, inserted] = m_families.try_emplace(name, Family{type, help, {}, {}, {}});
+    if (it->second.type != type) {
+        throw InvalidArgException("metric " + name + " is already registered with another type.",
+                "Alphadocte::MetricsRegistry::getFamily(const std::string&, const std::string&, Alphadocte::MetricsRegistry::MetricType)");
+    }
+
+    return it->second;
+}
+
+// LibraryMetrics
+LibraryMetrics& LibraryMetrics::get() {
+    static LibraryMetrics metrics = []() {
+        auto& registry = MetricsRegistry::getGlobal();
+        auto registerPhase = [&registry](const std::string& phase) -> Histogram& {
+            return registry.registerHistogram("alphadocte_phase_duration_seconds", "Time spent in each phase of the solver.",
+                    Histogram::getLatencyBounds(), {{"phase", phase}});
+        };
+
+        return LibraryMetrics{
+            registry.registerCounter("alphadocte_patterns_evaluated_total", "Number of hints computed to score guesses."),
+            registry.registerCounter("alphadocte_guesses_scored_total", "Number of guesses scored by the solvers."),
+            registry.registerCounter("alphadocte_solutions_filtered_total",
+                    "Number of potential solutions removed by templates and hints."),
+            registry.registerCounter("alphadocte_cache_hits_total", "Number of lookups answered by a cache.", {{"cache", "memo"}}),
+            registry.registerCounter("alphadocte_cache_misses_total", "Number of lookups not answered by a cache.", {{"cache", "memo"}}),
+            registry.registerCounter("alphadocte_dictionary_loads_total", "Number of dictionaries loaded."),
+            registerPhase("set_template"),
+            registerPhase("add_hint"),
+            registerPhase("compute_next_guesses"),
+            registerPhase("dictionary_load")
+        };
+    }();
+
+    return metrics;
+}
+
+} /* namespace Alphadocte */
@@ -22,16 +22,31 @@
 #include <Alphadocte/Dictionary.h>
 #include <Alphadocte/Exceptions.h>
 #include <Alphadocte/IGameRules.h>
+#include <Alphadocte/Memory.h>
+#include <Alphadocte/Metrics.h>
 #include <Alphadocte/Solver.h>
+#include <Alphadocte/Trace.h>
+#include <Alphadocte/WorkloadRecorder.h>
 #include <algorithm>
+#include <chrono>
 
 
 namespace Alphadocte {
 
+namespace {
+
+// keep helper functions local to this translation unit
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
 Solver::Solver(std::shared_ptr<IGameRules> rules, std::string name, unsigned int version)
         : m_rules{std::move(rules)}, m_hints{},
           m_potentialGuesses{}, m_potentialSolutions{},
-          m_solverName{std::move(name)}, m_solverVersion{version} {
+          m_solverName{std::move(name)}, m_solverVersion{version}, m_memo{}, m_recorder{}, m_recordedGame{}, m_stats{} {
     if (!m_rules) {
         throw InvalidArgException("rules cannot be null",
                 "Alphadocte::Solver::Solver(std::shared_ptr<Alphadocte::IGameRules>, std::string, unsigned int)");
@@ -73,6 +88,10 @@ void Solver::setTemplate(std::string wordTemplate) {
                 "Alphadocte::Solver::setTemplate(std::string)");
     }
 
+    LatencyTimer timer{LibraryMetrics::get().setTemplateLatency};
+    ALPHADOCTE_TRACE_SCOPE("setTemplate", "solver");
+    AllocationPhase allocationPhase{MemoryPhase::SET_TEMPLATE};
+    auto start = std::chrono::steady_clock::now();
     reset();
     m_wordTemplate = std::move(wordTemplate);
 
@@ -82,6 +101,7 @@ void Solver::setTemplate(std::string wordTemplate) {
 
     populateGuesses();
     populateSolutions();
+    auto nbSolutions = std::size(m_potentialSolutions);
 
     // update solutions
     m_potentialSolutions.erase(
@@ -103,6 +123,13 @@ void Solver::setTemplate(std::string wordTemplate) {
         return false;
     }), std::end(m_potentialSolutions));
 
+    LibraryMetrics::get().solutionsFiltered.add(nbSolutions - std::size(m_potentialSolutions));
+    m_stats.nbSolutions = std::size(m_potentialSolutions);
+    m_stats.nbGuesses = std::size(m_potentialGuesses);
+    m_stats.setTemplateDuration = secondsSince(start);
+
+    if (m_recorder)
+        m_recordedGame = m_recorder->recordGame(*this);
 }
 
 const std::vector<std::string_view>& Solver::getPotentialGuesses() const {
@@ -130,6 +157,59 @@ unsigned int Solver::getSolverVersion() const {
     return m_solverVersion;
 }
 
+Solver::Stats Solver::getStats() const {
+    return m_stats;
+}
+
+size_t Solver::getRetainedBytes() const {
+    size_t size = sizeof(Solver) + getHeapSize(m_wordTemplate) + getHeapSize(m_solverName);
+    size += m_potentialGuesses.capacity() * sizeof(std::string_view);
+    size += m_potentialSolutions.capacity() * sizeof(std::string_view);
+
+    // hint map nodes (three links and the color)
+    for (const auto& [guess, hints] : m_hints) {
+        size += 4 * sizeof(void*) + sizeof(std::pair<const std::string, std::vector<HintType>>);
+        size += getHeapSize(guess) + hints.capacity() * sizeof(HintType);
+    }
+
+    return size;
+}
+
+std::shared_ptr<SolverMemo> Solver::getMemo() const {
+    return m_memo;
+}
+
+void Solver::setMemo(std::shared_ptr<SolverMemo> memo) {
+    m_memo = std::move(memo);
+}
+
+std::shared_ptr<WorkloadRecorder> Solver::getRecorder() const {
+    return m_recorder;
+}
+
+void Solver::setRecorder(std::shared_ptr<WorkloadRecorder> recorder) {
+    m_recorder = std::move(recorder);
+    m_recordedGame = 0;
+
+    if (!m_recorder || m_wordTemplate.empty())
+        return;
+
+    // the current game starts from its known hints
+    m_recordedGame = m_recorder->recordGame(*this);
+    for (const auto& [guess, hints] : m_hints) {
+        m_recorder->recordHint(m_recordedGame, guess, hints);
+    }
+}
+
+void Solver::setRecorder(std::shared_ptr<WorkloadRecorder> recorder, std::uint64_t recordedGame) {
+    m_recorder = std::move(recorder);
+    m_recordedGame = m_recorder ? recordedGame : 0;
+}
+
+std::uint64_t Solver::getRecordedGame() const {
+    return m_recordedGame;
+}
+
 // Methods
 void Solver::addHint(std::string_view guess, const std::vector<HintType>& hints) {
     if (m_wordTemplate.empty()) {
@@ -147,9 +227,14 @@ void Solver::addHint(std::string_view guess, const std::vector<HintType>& hints)
                 "Alphadocte::Solver::addHint(std::string_view, const std::vector<Alphadocte::HintType>&)");
     }
 
+    LatencyTimer timer{LibraryMetrics::get().addHintLatency};
+    ALPHADOCTE_TRACE_SCOPE("addHint", "solver");
+    AllocationPhase allocationPhase{MemoryPhase::ADD_HINT};
+    auto start = std::chrono::steady_clock::now();
     m_hints.emplace(guess, hints);
 
     // update solutions
+    auto nbSolutions = std::size(m_potentialSolutions);
     m_potentialSolutions.erase(
             std::remove_if(
                     std::begin(m_potentialSolutions),
@@ -157,6 +242,12 @@ void Solver::addHint(std::string_view guess, const std::vector<HintType>& hints)
                     [&hints, &guess](const auto& word){  return !matches(word, guess, hints);  }
     ), std::end(m_potentialSolutions));
 
+    LibraryMetrics::get().solutionsFiltered.add(nbSolutions - std::size(m_potentialSolutions));
+    m_stats.nbSolutions = std::size(m_potentialSolutions);
+    m_stats.addHintDuration = secondsSince(start);
+
+    if (m_recorder && m_recordedGame != 0)
+        m_recorder->recordHint(m_recordedGame, guess, hints);
 }
 
 void Solver::reset() {
@@ -164,6 +255,8 @@ void Solver::reset() {
     m_wordTemplate.clear();
     m_potentialGuesses.clear();
     m_potentialSolutions.clear();
+    m_stats = Stats{};
+    m_recordedGame = 0;
 }
 
 void Solver::populateGuesses() {
@@ -172,6 +265,8 @@ void Solver::populateGuesses() {
                 "Alphadocte::Solver::populateGuesses()");
     }
 
+    ALPHADOCTE_TRACE_SCOPE("populateGuesses", "solver");
+
     const auto& allWords = m_rules->getDictionary()->getAllWords();
 
     m_potentialGuesses.clear();
@@ -186,6 +281,8 @@ void Solver::populateSolutions() {
                 "Alphadocte::Solver::populateSolutions()");
     }
 
+    ALPHADOCTE_TRACE_SCOPE("populateSolutions", "solver");
+
     const auto& allWords = m_rules->getDictionary()->getAllWords();
 
     m_potentialSolutions.clear();
@@ -195,4 +292,13 @@ void Solver::populateSolutions() {
     });
 }
 
+Solver::Stats& Solver::getMutableStats() const {
+    return m_stats;
+}
+
+void Solver::recordComputation(size_t n, const std::vector<std::pair<std::string, double>>& guesses, double duration) const {
+    if (m_recorder && m_recordedGame != 0)
+        m_recorder->recordComputation(m_recordedGame, n, duration, guesses);
+}
+
 } /* namespace Alphadocte */
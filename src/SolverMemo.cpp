@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: SolverMemo.cpp
+ */
+
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/IGameRules.h>
+#include <Alphadocte/Memory.h>
+#include <Alphadocte/Metrics.h>
+#include <Alphadocte/Solver.h>
+#include <Alphadocte/SolverMemo.h>
+#include <Alphadocte/Trace.h>
+#include <algorithm>
+#include <iterator>
+#include <typeinfo>
+
+
+namespace Alphadocte {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+// Whether the guesses of an entry answer a request of n guesses
+bool answers(size_t nbRequested, size_t nbGuesses, size_t n) {
+    // less guesses than requested means that all the available guesses are known
+    return n <= nbRequested || nbGuesses < nbRequested;
+}
+
+}
+
+// Stats
+double SolverMemo::Stats::getHitRate() const {
+    size_t nbLookups = nbHits + nbCoalesced + nbMisses;
+    return nbLookups == 0 ? 0 : static_cast<double>(nbHits + nbCoalesced) / nbLookups;
+}
+
+// Constructors
+SolverMemo::SolverMemo(size_t capacity)
+        : m_capacity{capacity}, m_entries{}, m_usage{}, m_flights{}, m_stats{}, m_mutex{} {
+    if (m_capacity == 0) {
+        throw InvalidArgException("capacity must be strictly positive",
+                "Alphadocte::SolverMemo::SolverMemo(size_t)");
+    }
+}
+
+// Getters/Setters
+size_t SolverMemo::getCapacity() const {
+    return m_capacity;
+}
+
+SolverMemo::Stats SolverMemo::getStats() const {
+    std::lock_guard lock{m_mutex};
+    return m_stats;
+}
+
+// Methods
+std::string SolverMemo::computeStateKey(const Solver& solver) {
+    if (solver.getTemplate().empty()) {
+        throw Exception("cannot compute the state of a solver with an empty template.",
+                "Alphadocte::SolverMemo::computeStateKey(const Alphadocte::Solver&)");
+    }
+
+    auto rules = solver.getRules();
+    const auto& rulesRef = *rules;
+
+    // fields are separated by line breaks, which cannot appear in words
+    std::string key;
+    key.append(solver.getSolverName()).append(1, '\n');
+    key.append(std::to_string(solver.getSolverVersion())).append(1, '\n');
+    key.append(typeid(rulesRef).name()).append(1, '\n');
+    key.append(std::to_string(rules->getDictionary()->getContentHash())).append(1, '\n');
+    key.append(solver.getTemplate());
+
+    // hints are sorted by guess, whatever the order they were added
+    for (const auto& [guess, hints] : solver.getHints()) {
+        key.append(1, '\n').append(guess).append(1, ':');
+        for (HintType hint : hints)
+            key.append(1, static_cast<char>('0' + static_cast<char>(hint)));
+    }
+
+    return key;
+}
+
+std::optional<SolverMemo::Guesses> SolverMemo::find(const std::string& stateKey, size_t n) {
+    std::lock_guard lock{m_mutex};
+
+    auto guesses = lookup(stateKey, n);
+    if (!guesses) {
+        m_stats.nbMisses++;
+        LibraryMetrics::get().memoMisses.add();
+    }
+
+    return guesses;
+}
+
+void SolverMemo::insert(const std::string& stateKey, size_t n, const Guesses& guesses) {
+    std::lock_guard lock{m_mutex};
+    store(stateKey, n, guesses);
+}
+
+SolverMemo::Guesses SolverMemo::findOrCompute(const std::string& stateKey, size_t n, const std::function<Guesses()>& compute) {
+    std::unique_lock lock{m_mutex};
+
+    if (auto guesses = lookup(stateKey, n))
+        return std::move(*guesses);
+
+    // wait for the solver computing the same state, unless it computes less guesses
+    if (auto it = m_flights.find(stateKey); it != std::end(m_flights) && n <= it->second->nbRequested) {
+        auto flight = it->second;
+        m_stats.nbCoalesced++;
+        LibraryMetrics::get().memoHits.add();
+        {
+            ALPHADOCTE_TRACE_SCOPE("waitForState", "memo");
+            flight->finished.wait(lock, [&flight]() { return flight->done; });
+        }
+
+        if (flight->error)
+            std::rethrow_exception(flight->error);
+
+        auto last = std::cbegin(flight->guesses) + std::min(n, std::size(flight->guesses));
+        return Guesses(std::cbegin(flight->guesses), last);
+    }
+
+    // a computation of less guesses is left to its own waiters
+    m_stats.nbMisses++;
+    LibraryMetrics::get().memoMisses.add();
+    auto flight = std::make_shared<Flight>();
+    flight->nbRequested = n;
+    bool registered = m_flights.emplace(stateKey, flight).second;
+
+    // compute without blocking the other states
+    lock.unlock();
+    Guesses guesses;
+    std::exception_ptr error;
+    try {
+        guesses = compute();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    lock.lock();
+
+    if (!error)
+        store(stateKey, n, guesses);
+
+    if (registered) {
+        flight->done = true;
+        flight->guesses = guesses;
+        flight->error = error;
+        m_flights.erase(stateKey);
+        flight->finished.notify_all();
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+
+    return guesses;
+}
+
+void SolverMemo::clear() {
+    std::lock_guard lock{m_mutex};
+
+    m_usage.clear();
+    m_entries.clear();
+    m_stats = Stats{};
+}
+
+std::optional<SolverMemo::Guesses> SolverMemo::lookup(const std::string& stateKey, size_t n) {
+    auto it = m_entries.find(stateKey);
+    if (it == std::end(m_entries) || !answers(it->second.nbRequested, std::size(it->second.guesses), n))
+        return std::nullopt;
+
+    m_stats.nbHits++;
+    LibraryMetrics::get().memoHits.add();
+    Entry& entry = it->second;
+    m_usage.splice(std::begin(m_usage), m_usage, entry.usage);
+
+    auto last = std::cbegin(entry.guesses) + std::min(n, std::size(entry.guesses));
+    return Guesses(std::cbegin(entry.guesses), last);
+}
+
+void SolverMemo::store(const std::string& stateKey, size_t n, const Guesses& guesses) {
+    if (auto it = m_entries.find(stateKey); it != std::end(m_entries)) {
+        Entry& entry = it->second;
+        m_usage.splice(std::begin(m_usage), m_usage, entry.usage);
+
+        if (answers(entry.nbRequested, std::size(entry.guesses), n)) {
+            // already known, eg computed meanwhile by another solver
+            return;
+        }
+
+        m_stats.memoryUsage -= computeMemoryUsage(it->first, entry);
+        entry.nbRequested = n;
+        entry.guesses = guesses;
+        m_stats.memoryUsage += computeMemoryUsage(it->first, entry);
+        return;
+    }
+
+    if (std::size(m_entries) >= m_capacity) {
+        // evict the least recently used state
+        auto evicted = m_entries.find(*m_usage.back());
+        m_stats.memoryUsage -= computeMemoryUsage(evicted->first, evicted->second);
+        m_usage.pop_back();
+        m_entries.erase(evicted);
+        m_stats.nbEvictions++;
+    }
+
+    auto [it, inserted] = m_entries.emplace(stateKey, Entry{n, guesses, {}});
+    it->second.usage = m_usage.insert(std::begin(m_usage), &it->first);
+    m_stats.memoryUsage += computeMemoryUsage(it->first, it->second);
+    m_stats.nbEntries = std::size(m_entries);
+}
+
+size_t SolverMemo::computeMemoryUsage(const std::string& stateKey, const Entry& entry) {
+    // hash table node (next pointer and cached hash) and usage list node (two links and the key pointer)
+    size_t usage = sizeof(std::string) + sizeof(Entry) + 2 * sizeof(void*) + 3 * sizeof(void*);
+    usage += getHeapSize(stateKey);
+    usage += entry.guesses.capacity() * sizeof(Guesses::value_type);
+
+    for (const auto& guess : entry.guesses)
+        usage += getHeapSize(guess.first);
+
+    return usage;
+}
+
+} /* namespace Alphadocte */
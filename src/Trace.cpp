@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: Trace.cpp
+ */
+
+#include <Alphadocte/Trace.h>
+#include <algorithm>
+#include <charconv>
+#include <functional>
+#include <string_view>
+#include <system_error>
+
+
+namespace Alphadocte {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+// Write a string as a JSON string, names are literals but may still contain quotes
+void writeJsonString(std::ostream& stream, std::string_view str) {
+    stream << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            stream << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+            stream << ' ';
+        else
+            stream << c;
+    }
+    stream << '"';
+}
+
+// Write a duration in microseconds, the unit of the trace format
+void writeMicroseconds(std::ostream& stream, std::chrono::steady_clock::duration duration) {
+    char buffer[32];
+    auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer),
+            std::chrono::duration<double, std::micro>(duration).count());
+    if (error == std::errc{})
+        stream.write(buffer, end - buffer);
+    else
+        stream << '0';
+}
+
+} // namespace
+
+// Tracer
+// Getters/Setters
+bool Tracer::isRecording() const {
+    return m_recording.load(std::memory_order_relaxed);
+}
+
+size_t Tracer::getEventCount() const {
+    std::lock_guard lock{m_mutex};
+    size_t nbEvents{};
+    for (const auto& buffer : m_buffers) {
+        std::lock_guard bufferLock{buffer->mutex};
+        nbEvents += std::size(buffer->events);
+    }
+
+    return nbEvents;
+}
+
+// Methods
+void Tracer::start() {
+    std::lock_guard lock{m_mutex};
+
+    // only the tracer still holds the buffers of exited threads
+    std::erase_if(m_buffers, [this](const auto& buffer) {
+        if (buffer.use_count() > 1)
+            return false;
+
+        m_freeTrackIds.push_back(buffer->trackId);
+        return true;
+    });
+    std::sort(std::begin(m_freeTrackIds), std::end(m_freeTrackIds), std::greater<>{});
+
+    for (const auto& buffer : m_buffers) {
+        std::lock_guard bufferLock{buffer->mutex};
+        buffer->events.clear();
+    }
+
+    m_start = std::chrono::steady_clock::now();
+    m_recording.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::stop() {
+    m_recording.store(false, std::memory_order_relaxed);
+}
+
+void Tracer::record(const Event& event) {
+    if (!isRecording())
+        return;
+
+    auto& buffer = getThreadBuffer();
+    std::lock_guard lock{buffer.mutex};
+    buffer.events.push_back(event);
+}
+
+void Tracer::writeChromeTrace(std::ostream& stream) const {
+    std::lock_guard lock{m_mutex};
+    stream << "{\"traceEvents\":[\n";
+    stream << R"({"name":"process_name","ph":"M","pid":1,"tid":0,"args":{"name":"alphadocte"}})";
+
+    for (const auto& buffer : m_buffers) {
+        std::lock_guard bufferLock{buffer->mutex};
+        if (buffer->events.empty())
+            continue;
+
+        stream << ",\n" << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->trackId
+               << R"(,"args":{"name":"thread )" << buffer->trackId << "\"}}";
+
+        for (const auto& event : buffer->events) {
+            stream << ",\n{\"name\":";
+            writeJsonString(stream, event.name);
+            stream << ",\"cat\":";
+            writeJsonString(stream, event.category);
+            stream << ",\"ph\":\"X\",\"ts\":";
+            writeMicroseconds(stream, event.begin - m_start);
+            stream << ",\"dur\":";
+            writeMicroseconds(stream, event.end - event.begin);
+            stream << ",\"pid\":1,\"tid\":" << buffer->trackId << '}';
+        }
+    }
+
+    stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+Tracer& Tracer::getGlobal() {
+    static Tracer tracer;
+    return tracer;
+}
+
+// Private methods
+Tracer::ThreadBuffer& Tracer::getThreadBuffer() {
+    // the buffer is shared with the tracer, so that the events outlive their thread
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        std::lock_guard lock{m_mutex};
+
+        // take over the buffer of an exited thread, which only the tracer still holds
+        auto it = std::find_if(std::begin(m_buffers), std::end(m_buffers),
+                [](const auto& other) { return other.use_count() == 1; });
+        if (it != std::end(m_buffers)) {
+            buffer = *it;
+        } else {
+            buffer = std::make_shared<ThreadBuffer>();
+            if (m_freeTrackIds.empty()) {
+                buffer->trackId = std::size(m_buffers) + 1;
+            } else {
+                buffer->trackId = m_freeTrackIds.back();
+                m_freeTrackIds.pop_back();
+            }
+            m_buffers.push_back(buffer);
+        }
+    }
+
+    return *buffer;
+}
+
+// TraceScope
+TraceScope::TraceScope(const char* name, const char* category)
+        : m_name{name}, m_category{category}, m_recording{Tracer::getGlobal().isRecording()} {
+    // only read the clock when recording
+    if (m_recording)
+        m_begin = std::chrono::steady_clock::now();
+}
+
+TraceScope::~TraceScope() {
+    if (m_recording)
+        Tracer::getGlobal().record({m_name, m_category, m_begin, std::chrono::steady_clock::now()});
+}
+
+} /* namespace Alphadocte */
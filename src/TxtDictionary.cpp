@@ -19,6 +19,9 @@
  * File: TxtDictionary.cpp
  */
 
+#include <Alphadocte/Memory.h>
+#include <Alphadocte/Metrics.h>
+#include <Alphadocte/Trace.h>
 #include <Alphadocte/TxtDictionary.h>
 #include <fstream>
 #include <iostream>
@@ -42,6 +45,10 @@ bool TxtDictionary::load() {
     if (!std::filesystem::is_regular_file(m_filepath) || isLoaded())
         return false;
 
+    LatencyTimer timer{LibraryMetrics::get().dictionaryLoadLatency};
+    ALPHADOCTE_TRACE_SCOPE("loadDictionary", "dictionary");
+    AllocationPhase allocationPhase{MemoryPhase::DICTIONARY_LOAD};
+
     std::ifstream file{m_filepath};
 
     if (!file) {
@@ -87,16 +94,18 @@ bool TxtDictionary::load() {
     }
 
     // look for duplicated words in sorted vector
-    for (auto it = std::cbegin(m_words); (it+1) != std::cend(m_words); it++) {
-        if (*it == *(it+1)) {
-            //std::cerr << "Dictionary contains duplicated words." << std::endl;
-            // found duplicated words, invalid dictionary
-            m_words.clear();
-            return false;
-        }
+    if (std::adjacent_find(std::cbegin(m_words), std::cend(m_words)) != std::cend(m_words)) {
+        //std::cerr << "Dictionary contains duplicated words." << std::endl;
+        // found duplicated words, invalid dictionary
+        m_words.clear();
+        return false;
     }
 
     m_distribution = boost::uniform_int<size_t>{0, m_words.size() - 1};
+    updateContentHash();
+
+    if (success)
+        LibraryMetrics::get().dictionaryLoads.add();
 
     return success;
 }
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: WorkloadRecorder.cpp
+ */
+
+#include <Alphadocte/Dictionary.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/IGameRules.h>
+#include <Alphadocte/MotusGameRules.h>
+#include <Alphadocte/Solver.h>
+#include <Alphadocte/WordleGameRules.h>
+#include <Alphadocte/WorkloadRecorder.h>
+#include <iomanip>
+
+
+namespace Alphadocte {
+
+namespace {
+
+// keep helper functions local to this translation unit
+
+// Name of the rules, as parsed by the applications
+std::string_view getRulesName(const IGameRules& rules) {
+    if (dynamic_cast<const WordleGameRules*>(&rules))
+        return "wordle";
+    if (dynamic_cast<const MotusGameRules*>(&rules))
+        return "motus";
+
+    return "other";
+}
+
+}
+
+WorkloadRecorder::WorkloadRecorder(const std::filesystem::path& path)
+        : m_file{path, std::ios::out | std::ios::trunc}, m_output{&m_file}, m_nbGames{}, m_mutex{} {
+    if (!m_file) {
+        throw Exception("Cannot open the workload file " + path.string() + '.',
+                "Alphadocte::WorkloadRecorder::WorkloadRecorder(const std::filesystem::path&)");
+    }
+
+    m_file << HEADER << ' ' << FORMAT_VERSION << '\n';
+}
+
+WorkloadRecorder::WorkloadRecorder(std::ostream& output) : m_file{}, m_output{&output}, m_nbGames{}, m_mutex{} {
+    output << HEADER << ' ' << FORMAT_VERSION << '\n';
+}
+
+WorkloadRecorder::~WorkloadRecorder() {
+    flush();
+}
+
+// Getters/Setters
+std::uint64_t WorkloadRecorder::getGameCount() const {
+    std::lock_guard lock{m_mutex};
+    return m_nbGames;
+}
+
+// Methods
+std::uint64_t WorkloadRecorder::recordGame(const Solver& solver) {
+    auto rules = solver.getRules();
+    auto dictionary = rules->getDictionary();
+
+    std::lock_guard lock{m_mutex};
+    auto gameId = ++m_nbGames;
+    *m_output << "game " << gameId << ' ' << solver.getSolverName() << ' ' << solver.getSolverVersion()
+              << ' ' << getRulesName(*rules) << ' ' << rules->getMaxGuesses()
+              << ' ' << std::size(dictionary->getAllWords()) << ' ' << dictionary->getContentHash()
+              << ' ' << solver.getTemplate() << '\n';
+
+    return gameId;
+}
+
+void WorkloadRecorder::recordHint(std::uint64_t gameId, std::string_view guess, const std::vector<HintType>& hints) {
+    std::lock_guard lock{m_mutex};
+    *m_output << "hint " << gameId << ' ' << guess << ' ' << packHints(hints) << '\n';
+}
+
+void WorkloadRecorder::recordComputation(std::uint64_t gameId, size_t n, double duration,
+        const std::vector<std::pair<std::string, double>>& guesses) {
+    std::lock_guard lock{m_mutex};
+    auto precision = m_output->precision(9);
+    *m_output << "compute " << gameId << ' ' << n << ' ' << duration << ' ';
+    m_output->precision(precision);
+
+    if (guesses.empty())
+        *m_output << '-';
+    for (size_t i = 0; i < std::size(guesses); i++) {
+        *m_output << (i > 0 ? "," : "") << guesses[i].first;
+    }
+    *m_output << '\n';
+}
+
+void WorkloadRecorder::flush() {
+    std::lock_guard lock{m_mutex};
+    m_output->flush();
+}
+
+} /* namespace Alphadocte */
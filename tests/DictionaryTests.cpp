@@ -95,6 +95,12 @@ TEST_CASE("Checking dictionary base class", "[dictionary][Lib]") {
         REQUIRE_FALSE(dict.contains("o"));
         REQUIRE_FALSE(dict.contains("aa"));
         REQUIRE_FALSE(dict.contains("ab"));
+
+        REQUIRE(dict.findWord("a") == 0);
+        REQUIRE(dict.findWord("g") == std::size(SIMPLE_WORDLIST) - 1);
+        REQUIRE_FALSE(dict.findWord(""));
+        REQUIRE_FALSE(dict.findWord("aa"));
+        REQUIRE_FALSE(dict.findWord("z"));
     }
 
 
@@ -134,6 +140,7 @@ TEST_CASE("Checking dictionary loading text file", "[dictionary][Lib]") {
     // dictionary is not loaded and empty at first
     REQUIRE_FALSE(dict.isLoaded());
     REQUIRE(dict.getAllWords().empty());
+    REQUIRE(dict.getContentHash() == 0);
 
     // successfully load dictionary
     REQUIRE(dict.load());
@@ -143,6 +150,11 @@ TEST_CASE("Checking dictionary loading text file", "[dictionary][Lib]") {
     REQUIRE(dict.contains(SIMPLE_WORDLIST.front()));
     REQUIRE(dict.contains(SIMPLE_WORDLIST.back()));
 
+    // content hash only depends on the words
+    REQUIRE(dict.getContentHash() != 0);
+    REQUIRE(dict.getContentHash() == DictionaryStub{SIMPLE_WORDLIST}.getContentHash());
+    REQUIRE(dict.getContentHash() != DictionaryStub{COMPOSITE_WORDLIST}.getContentHash());
+
     SECTION("Cannot load twice a dictionary") {
         REQUIRE_FALSE(dict.load());
         REQUIRE(dict.isLoaded());
@@ -244,6 +256,7 @@ TEST_CASE("Checking fixed size dictionary", "[dictionary][lib]") {
     REQUIRE(fixed1.getAllWords() == COMPOSITE_WORDLIST_1);
     REQUIRE(fixed1.contains(COMPOSITE_WORDLIST_1.front()));
     REQUIRE(fixed1.contains(COMPOSITE_WORDLIST_1.back()));
+    REQUIRE(fixed1.getContentHash() == DictionaryStub{COMPOSITE_WORDLIST_1}.getContentHash());
 
     // cannot load twice the dictionary (only check once)
     REQUIRE_FALSE(fixed1.load());
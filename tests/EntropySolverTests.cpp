@@ -22,6 +22,7 @@
 #include <Alphadocte/EntropyMaximizer.h>
 #include <Alphadocte/Exceptions.h>
 #include <Alphadocte/Game.h>
+#include <Alphadocte/SolverMemo.h>
 #include <Alphadocte/WordleGameRules.h>
 #include <cmath>
 #include <filesystem>
@@ -186,6 +187,48 @@ TEST_CASE("Testing EntropyMaximizer solver", "[solver][Lib]") {
         checkGuesses(solver);
     }
 
+    SECTION("Solver stats") {
+        REQUIRE(solver.getStats().nbSolutions == 0);
+
+        solver.setTemplate(".....");
+        auto nbGuesses = std::size(solver.getPotentialGuesses());
+        REQUIRE(solver.getStats().nbSolutions == 67);
+        REQUIRE(solver.getStats().nbGuesses == nbGuesses);
+        REQUIRE(solver.getStats().setTemplateDuration >= 0);
+
+        solver.computeNextGuesses(GUESSES_CROP);
+        auto stats = solver.getStats();
+        REQUIRE(stats.nbGuessesScored == nbGuesses);
+        REQUIRE(stats.nbGuessesPruned == 0);
+        REQUIRE(stats.nbPatternsEvaluated == nbGuesses * 67);
+        REQUIRE(stats.nbThreads == 1);
+        REQUIRE_FALSE(stats.fromMemo);
+        REQUIRE(stats.peakScratchMemory >= nbGuesses * sizeof(double));
+
+        // a single solution needs no scoring
+        solver.addHint("amont", {CORRECT, CORRECT, CORRECT, CORRECT, CORRECT});
+        REQUIRE(solver.getStats().nbSolutions == 1);
+        solver.computeNextGuesses(GUESSES_CROP);
+        stats = solver.getStats();
+        REQUIRE(stats.nbGuessesScored == 0);
+        REQUIRE(stats.nbGuessesPruned == 0);
+        REQUIRE(stats.nbPatternsEvaluated == 0);
+        REQUIRE(stats.nbThreads == 0);
+
+        // the memo answers the second computation of a state
+        solver.setMemo(std::make_shared<SolverMemo>(10));
+        solver.setTemplate(".....");
+        solver.computeNextGuesses(GUESSES_CROP);
+        REQUIRE_FALSE(solver.getStats().fromMemo);
+        solver.computeNextGuesses(GUESSES_CROP);
+        REQUIRE(solver.getStats().fromMemo);
+        REQUIRE(solver.getStats().nbGuessesScored == 0);
+        REQUIRE(solver.getStats().nbGuessesPruned == 0);
+
+        solver.reset();
+        REQUIRE(solver.getStats().nbGuesses == 0);
+    }
+
     SECTION("Solve games without solution") {
         REQUIRE_THROWS_MATCHES(solver.computeNextGuess(), Exception, Message("cannot compute next guess with an empty template."));
         REQUIRE_THROWS_MATCHES(solver.computeNextGuesses(GUESSES_CROP), Exception, Message("cannot compute next guess with an empty template."));
@@ -279,6 +322,54 @@ void checkGuesses(const EntropyMaximizer& solver) {
 // We can then keep the hints, sort them and count the occurrences to
 // manually compute the mean expected entropy, ie in bash :
 // cat <file.txt> | awk -F: '{print $2;}' | sort | uniq -c
+TEST_CASE("Tuning EntropyMaximizer solver", "[solver][Lib]") {
+    using HistogramStrategy = EntropyMaximizer::HistogramStrategy;
+    std::shared_ptr<IGameRules> rules = std::make_shared<WordleGameRules>(getWordleDict());
+    EntropyMaximizer reference{rules};
+    REQUIRE(reference.getTuning().histogram == HistogramStrategy::MAP);
+    REQUIRE(reference.getTuning().nbThreads == 1);
+
+    std::string templateWord = GENERATE(".....", "b....");
+    reference.setTemplate(templateWord);
+    auto expected = reference.computeNextGuesses(GUESSES_CROP);
+
+    // every strategy and number of threads computes exactly the same guesses
+    auto histogram = GENERATE(HistogramStrategy::MAP, HistogramStrategy::DENSE, HistogramStrategy::SORTED);
+    unsigned int nbThreads = GENERATE(1u, 3u);
+    EntropyMaximizer solver{rules};
+    solver.setTuning({.histogram = histogram, .nbThreads = nbThreads, .minParallelPatterns = 0});
+    solver.setTemplate(templateWord);
+
+    REQUIRE(solver.computeNextGuesses(GUESSES_CROP) == expected);
+    REQUIRE(solver.getStats().nbThreads == nbThreads);
+    REQUIRE(solver.getStats().peakScratchMemory > 0);
+    REQUIRE(solver.computeExpectedEntropy("bruir") == reference.computeExpectedEntropy("bruir"));
+
+    // small states are scored by a single thread
+    solver.setTuning({.histogram = histogram, .nbThreads = nbThreads, .minParallelPatterns = 1000000});
+    REQUIRE(solver.computeNextGuesses(GUESSES_CROP) == expected);
+    REQUIRE(solver.getStats().nbThreads == 1);
+
+    REQUIRE_THROWS_AS(solver.setTuning({.histogram = histogram, .nbThreads = 0, .minParallelPatterns = 0}), InvalidArgException);
+}
+
+TEST_CASE("Setting the default tuning of EntropyMaximizer", "[solver][Lib]") {
+    std::shared_ptr<IGameRules> rules = std::make_shared<WordleGameRules>(getWordleDict());
+    auto defaultTuning = EntropyMaximizer::getDefaultTuning();
+
+    EntropyMaximizer::setDefaultTuning({.histogram = EntropyMaximizer::HistogramStrategy::DENSE,
+                                        .nbThreads = 2, .minParallelPatterns = 10});
+    EntropyMaximizer solver{rules};
+    EntropyMaximizer::setDefaultTuning(defaultTuning);
+
+    REQUIRE(solver.getTuning().histogram == EntropyMaximizer::HistogramStrategy::DENSE);
+    REQUIRE(solver.getTuning().nbThreads == 2);
+    REQUIRE(solver.getTuning().minParallelPatterns == 10);
+    REQUIRE(EntropyMaximizer{rules}.getTuning().nbThreads == defaultTuning.nbThreads);
+    REQUIRE_THROWS_AS(EntropyMaximizer::setDefaultTuning({.histogram = EntropyMaximizer::HistogramStrategy::MAP,
+                                                          .nbThreads = 0, .minParallelPatterns = 0}), InvalidArgException);
+}
+
 TEST_CASE("Generate hints for wordle (debug only)", "[.]") {
     const auto& wordleDict = getWordleDict();
     std::vector<std::tuple<std::string, std::string, std::vector<std::string>>> inputs = {
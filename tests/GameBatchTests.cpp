@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: GameBatchTests.cpp
+ */
+
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Game.h>
+#include <Alphadocte/GameBatch.h>
+#include <Alphadocte/MotusGameRules.h>
+#include <Alphadocte/WordleGameRules.h>
+#include <catch2/catch.hpp>
+
+#include "TestDefinitions.h"
+
+using namespace Alphadocte;
+using Catch::Matchers::Message;
+
+TEST_CASE("Check game batch with invalid arguments", "[game][Lib]") {
+    REQUIRE_THROWS_MATCHES(GameBatch({}, 1), InvalidArgException, Message("rules cannot be null"));
+
+    std::shared_ptr<IGameRules> rules = std::make_shared<MotusGameRules>(getMotusDict(), 0);
+    REQUIRE_THROWS_MATCHES(GameBatch(rules, 1), InvalidArgException,
+            Message("turn capacity must be set when rules do not limit the number of guesses"));
+    REQUIRE_NOTHROW(GameBatch(rules, 1, 10));
+}
+
+TEST_CASE("Check game batch hints match single games", "[game][Lib]") {
+    auto wordleDict = getWordleDict();
+    const auto& words = wordleDict->getAllWords();
+    std::shared_ptr<IGameRules> rules = std::make_shared<WordleGameRules>(wordleDict, 0);
+
+    // one game per solution, every word is tried in each of them
+    GameBatch batch{rules, std::size(words), static_cast<unsigned int>(std::size(words))};
+    REQUIRE(batch.size() == std::size(words));
+    REQUIRE(batch.getTurnCapacity() == std::size(words));
+    REQUIRE(batch.getRules() == rules);
+
+    for (size_t game = 0; game < batch.size(); game++) {
+        REQUIRE_FALSE(batch.hasStarted(game));
+        batch.setSolution(game, batch.getWordId(words[game]));
+        REQUIRE(batch.hasStarted(game));
+        REQUIRE(batch.getWord(batch.getSolution(game)) == words[game]);
+    }
+
+    for (size_t game = 0; game < batch.size(); game++) {
+        for (size_t guess = 0; guess < std::size(words) && !batch.isOver(game); guess++) {
+            HintCode code = batch.tryGuess(game, static_cast<GameBatch::word_id>(guess));
+            REQUIRE(code == packHints(Game::computeHints(words[guess], words[game])));
+        }
+
+        // the solution has been tried at some point
+        REQUIRE(batch.isWon(game));
+        REQUIRE(batch.getNbGuess(game) == game + 1);
+        REQUIRE(batch.getHints(game, game) == winningHintCode(5));
+    }
+
+    REQUIRE(batch.countWon() == batch.size());
+    REQUIRE(batch.countOver() == batch.size());
+
+    batch.reset();
+    REQUIRE(batch.countOver() == 0);
+    REQUIRE_FALSE(batch.hasStarted(0));
+}
+
+TEST_CASE("Check game batch follows the game rules", "[game][Lib]") {
+    auto motusDict = getMotusDict();
+    const auto& words = motusDict->getAllWords();
+    std::shared_ptr<IGameRules> rules = std::make_shared<MotusGameRules>(motusDict);
+    REQUIRE(rules->getMaxGuesses() == 6);
+
+    GameBatch batch{rules, 2};
+    REQUIRE(batch.getTurnCapacity() == 6);
+
+    SECTION("Invalid games and words") {
+        REQUIRE_THROWS_MATCHES(batch.isOver(2), InvalidArgException, Message("game 2 is out of range"));
+        REQUIRE_THROWS_MATCHES(batch.getWordId("zzzzzzz"), InvalidArgException,
+                Message("the word zzzzzzz is not in the dictionary"));
+        REQUIRE_FALSE(batch.findWordId("zzzzzzz"));
+        REQUIRE(batch.findWordId(batch.getWords().back()) == std::size(batch.getWords()) - 1);
+        REQUIRE_THROWS_MATCHES(batch.getWord(GameBatch::NO_WORD), InvalidArgException,
+                Message("word id " + std::to_string(GameBatch::NO_WORD) + " does not identify a word"));
+        REQUIRE_THROWS_MATCHES(batch.setSolution(0, GameBatch::NO_WORD), InvalidArgException,
+                Message("the word id " + std::to_string(GameBatch::NO_WORD) + " is not a valid solution"));
+        REQUIRE_THROWS_MATCHES(batch.tryGuess(0, 0), Exception,
+                Message("Cannot try a guess: game has not been started"));
+    }
+
+    SECTION("Lose a game") {
+        // find a solution and a guess with a different first letter
+        GameBatch::word_id solution = 0;
+        auto otherLetter = std::find_if(std::cbegin(words), std::cend(words), [&words](const auto& w) {
+            return w.front() != words.front().front();
+        });
+        REQUIRE(otherLetter != std::cend(words));
+        auto sameLetter = std::find_if(std::cbegin(words) + 1, std::cend(words), [&words](const auto& w) {
+            return w.front() == words.front().front() && std::size(w) == std::size(words.front());
+        });
+        REQUIRE(sameLetter != std::cend(words));
+
+        batch.setSolution(0, solution);
+        REQUIRE_THROWS_MATCHES(batch.tryGuess(0, batch.getWordId(*otherLetter)), Exception,
+                Message("Cannot try a guess: invalid guess"));
+        REQUIRE(batch.getNbGuess(0) == 0);
+
+        Game game{rules};
+        game.setWord(words.front());
+        game.start();
+
+        for (unsigned int i = 0; i < rules->getMaxGuesses(); i++) {
+            REQUIRE_FALSE(batch.isOver(0));
+            HintCode code = batch.tryGuess(0, batch.getWordId(*sameLetter));
+            REQUIRE(code == packHints(game.tryGuess(*sameLetter)));
+            REQUIRE(batch.isOver(0) == game.isOver());
+        }
+
+        REQUIRE(batch.isOver(0));
+        REQUIRE_FALSE(batch.isWon(0));
+        REQUIRE_FALSE(batch.hasStarted(1));
+        REQUIRE_THROWS_MATCHES(batch.tryGuess(0, solution), Exception, Message("Cannot try a guess: game is over"));
+        REQUIRE_THROWS_MATCHES(batch.getGuess(0, 6), InvalidArgException, Message("turn 6 has not been played"));
+
+        // setting a new solution restarts the game
+        batch.setSolution(0, solution);
+        REQUIRE(batch.getNbGuess(0) == 0);
+        REQUIRE_FALSE(batch.isOver(0));
+    }
+}
@@ -19,6 +19,8 @@
  * File: HintTests.cpp
  */
 
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Game.h>
 #include <Alphadocte/Hint.h>
 #include <sstream>
 
@@ -84,3 +86,34 @@ TEST_CASE("Check hint matching", "[hint][Lib]") {
 
 }
 
+
+TEST_CASE("Check hint packing", "[hint][Lib]") {
+    using enum HintType;
+
+    REQUIRE(packHints({}) == 0);
+    REQUIRE(packHints({WRONG, WRONG}) == 0);
+    REQUIRE(packHints({CORRECT}) == 2);
+    REQUIRE(packHints({MISPLACED, CORRECT, WRONG}) == 1*9 + 2*3 + 0);
+    REQUIRE(winningHintCode(5) == packHints({CORRECT, CORRECT, CORRECT, CORRECT, CORRECT}));
+
+    std::vector<HintType> hints{MISPLACED, CORRECT, WRONG, WRONG, MISPLACED};
+    REQUIRE(unpackHints(packHints(hints), 5) == hints);
+
+    // codes keep the lexical order of hint vectors
+    REQUIRE(packHints({WRONG, CORRECT, CORRECT}) < packHints({MISPLACED, WRONG, WRONG}));
+
+    REQUIRE_THROWS_AS(packHints(std::vector<HintType>(MAX_PACKED_HINTS + 1, WRONG)), InvalidArgException);
+    REQUIRE_THROWS_AS(unpackHints(winningHintCode(3) + 1, 3), InvalidArgException);
+}
+
+TEST_CASE("Check packed hints computation", "[hint][Lib]") {
+    std::vector<std::string> words{"maree", "email", "tarie", "marie", "eeeaa", "aaeee", "abcde"};
+
+    for (const auto& word : words) {
+        for (const auto& solution : words) {
+            REQUIRE(Game::computeHintCode(word, solution) == packHints(Game::computeHints(word, solution)));
+        }
+    }
+
+    REQUIRE_THROWS_AS(Game::computeHintCode("abc", "ab"), InvalidArgException);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: MemoryTests.cpp
+ */
+
+#include <Alphadocte/EntropyMaximizer.h>
+#include <Alphadocte/FixedSizeDictionary.h>
+#include <Alphadocte/GameBatch.h>
+#include <Alphadocte/Memory.h>
+#include <Alphadocte/Metrics.h>
+#include <Alphadocte/WordleGameRules.h>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+#include "TestDefinitions.h"
+
+using namespace Alphadocte;
+using enum HintType;
+
+TEST_CASE("Check retained memory", "[memory][Lib]") {
+    std::string shortString{"abc"};
+    std::string longString(100, 'a');
+    REQUIRE(getHeapSize(shortString) == 0);
+    REQUIRE(getHeapSize(longString) == longString.capacity() + 1);
+
+    auto dictionary = getWordleDict();
+    const auto& words = dictionary->getAllWords();
+    REQUIRE(dictionary->getRetainedBytes() >= std::size(words) * sizeof(std::string));
+
+    auto rules = std::make_shared<WordleGameRules>(dictionary);
+    EntropyMaximizer solver{rules};
+    solver.setTemplate(".....");
+    auto initialSize = solver.getRetainedBytes();
+    REQUIRE(initialSize >= std::size(solver.getPotentialGuesses()) * sizeof(std::string_view));
+
+    // each hint is kept by the solver
+    solver.addHint("bruir", {WRONG, WRONG, WRONG, WRONG, WRONG});
+    REQUIRE(solver.getRetainedBytes() != initialSize);
+
+    // the pattern matrix holds the guesses and hints of every turn of every game
+    GameBatch batch{rules, 10};
+    REQUIRE(batch.getRetainedBytes() >= 10 * batch.getTurnCapacity() * (sizeof(GameBatch::word_id) + sizeof(HintCode)));
+}
+
+TEST_CASE("Check allocation tracker", "[memory][Lib]") {
+    REQUIRE(AllocationTracker::getCurrentPhase() == MemoryPhase::OTHER);
+    REQUIRE(AllocationTracker::getPhaseName(MemoryPhase::SET_TEMPLATE) == "set_template");
+    REQUIRE(AllocationTracker::getPhaseName(MemoryPhase::OTHER) == "other");
+
+    SECTION("Nesting phases") {
+        {
+            AllocationPhase outer{MemoryPhase::COMPUTE_GUESSES};
+            {
+                AllocationPhase inner{MemoryPhase::ADD_HINT};
+                REQUIRE(AllocationTracker::getCurrentPhase() == MemoryPhase::ADD_HINT);
+
+                // the phase is local to each thread
+                MemoryPhase otherThreadPhase{MemoryPhase::ADD_HINT};
+                std::thread thread{[&otherThreadPhase]() { otherThreadPhase = AllocationTracker::getCurrentPhase(); }};
+                thread.join();
+                REQUIRE(otherThreadPhase == MemoryPhase::OTHER);
+            }
+            REQUIRE(AllocationTracker::getCurrentPhase() == MemoryPhase::COMPUTE_GUESSES);
+        }
+        REQUIRE(AllocationTracker::getCurrentPhase() == MemoryPhase::OTHER);
+    }
+
+    SECTION("Counting allocations") {
+        // the tests are not built with a counting allocator, only these allocations are recorded
+        auto before = AllocationTracker::getStats(MemoryPhase::ADD_HINT);
+        auto totalBefore = AllocationTracker::getTotalStats();
+
+        AllocationTracker::recordAllocation(100, MemoryPhase::ADD_HINT);
+        AllocationTracker::recordAllocation(50, MemoryPhase::ADD_HINT);
+        AllocationTracker::recordDeallocation(100, MemoryPhase::ADD_HINT);
+        AllocationTracker::recordAllocation(30, MemoryPhase::ADD_HINT);
+
+        auto after = AllocationTracker::getStats(MemoryPhase::ADD_HINT);
+        REQUIRE(after.nbAllocations == before.nbAllocations + 3);
+        REQUIRE(after.allocatedBytes == before.allocatedBytes + 180);
+        REQUIRE(after.currentBytes == before.currentBytes + 80);
+        REQUIRE(after.peakBytes >= before.currentBytes + 150);
+        REQUIRE(AllocationTracker::getTotalStats().allocatedBytes == totalBefore.allocatedBytes + 180);
+
+        AllocationTracker::recordDeallocation(50, MemoryPhase::ADD_HINT);
+        AllocationTracker::recordDeallocation(30, MemoryPhase::ADD_HINT);
+        REQUIRE(AllocationTracker::getStats(MemoryPhase::ADD_HINT).currentBytes == before.currentBytes);
+    }
+
+    SECTION("Publishing metrics") {
+        AllocationTracker::enable();
+        REQUIRE(AllocationTracker::isEnabled());
+
+        auto metrics = MetricsRegistry::getGlobal().formatPrometheus();
+        REQUIRE(metrics.find("alphadocte_allocations_total{phase=\"compute_next_guesses\"}") != std::string::npos);
+        REQUIRE(metrics.find("# TYPE alphadocte_allocated_bytes_peak gauge") != std::string::npos);
+    }
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: MetricsTests.cpp
+ */
+
+#include <Alphadocte/EntropyMaximizer.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/FixedSizeDictionary.h>
+#include <Alphadocte/Metrics.h>
+#include <Alphadocte/SolverMemo.h>
+#include <Alphadocte/WordleGameRules.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "TestDefinitions.h"
+
+using namespace Alphadocte;
+using enum HintType;
+
+TEST_CASE("Check metrics registry", "[metrics][Lib]") {
+    MetricsRegistry registry;
+
+    auto& counter = registry.registerCounter("test_requests_total", "Number of requests.", {{"op", "top"}});
+    REQUIRE(&registry.registerCounter("test_requests_total", "Ignored help.", {{"op", "top"}}) == &counter);
+    auto& other = registry.registerCounter("test_requests_total", "", {{"op", "new \"session\""}});
+    REQUIRE(&other != &counter);
+
+    SECTION("Updating from several threads") {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; i++) {
+            threads.emplace_back([&counter]() {
+                for (int j = 0; j < 1000; j++)
+                    counter.add();
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        REQUIRE(counter.getValue() == 4000);
+    }
+
+    SECTION("Counting values in buckets") {
+        REQUIRE_THROWS_AS(Histogram({}), InvalidArgException);
+        REQUIRE_THROWS_AS(Histogram({1, 1}), InvalidArgException);
+        REQUIRE_THROWS_AS(Histogram({2, 1}), InvalidArgException);
+
+        auto& histogram = registry.registerHistogram("test_duration_seconds", "Duration.", {0.1, 1});
+        histogram.observe(0.05);
+        histogram.observe(0.1);
+        histogram.observe(0.5);
+        histogram.observe(5);
+        REQUIRE(histogram.getBucketCounts() == std::vector<std::uint64_t>{2, 1, 1});
+        REQUIRE(histogram.getSum() == Approx(5.65));
+
+        {
+            LatencyTimer timer{histogram};
+        }
+        REQUIRE(histogram.getBucketCounts()[0] == 3);
+    }
+
+    SECTION("Collecting gauges") {
+        auto& gauge = registry.registerGauge("test_memory_bytes", "Memory.", {{"object", "dictionary"}});
+        gauge.set(10);
+        gauge.add(-4);
+        REQUIRE(gauge.getValue() == 6);
+        REQUIRE_THROWS_AS(registry.registerGauge("test_requests_total", ""), InvalidArgException);
+
+        int nbCalls{};
+        auto collectorId = registry.addCollector([&gauge, &nbCalls]() {
+            gauge.set(++nbCalls * 100);
+        });
+        REQUIRE(registry.formatPrometheus().find("# TYPE test_memory_bytes gauge\n"
+                "test_memory_bytes{object=\"dictionary\"} 100\n") != std::string::npos);
+
+        registry.removeCollector(collectorId);
+        registry.removeCollector(collectorId);
+        registry.formatPrometheus();
+        REQUIRE(nbCalls == 1);
+    }
+
+    SECTION("Rejecting invalid metrics") {
+        REQUIRE_THROWS_AS(registry.registerCounter("1_requests", ""), InvalidArgException);
+        REQUIRE_THROWS_AS(registry.registerCounter("test requests", ""), InvalidArgException);
+        REQUIRE_THROWS_AS(registry.registerCounter("test_total", "", {{"__name", "x"}}), InvalidArgException);
+        REQUIRE_THROWS_AS(registry.registerHistogram("test_requests_total", "", {1}), InvalidArgException);
+    }
+
+    SECTION("Formatting as Prometheus text") {
+        counter.add(3);
+        auto& histogram = registry.registerHistogram("test_duration_seconds", "Duration\nin seconds.", {0.5, 1});
+        histogram.observe(0.25);
+        histogram.observe(2);
+
+        REQUIRE(registry.formatPrometheus() ==
+                "# HELP test_duration_seconds Duration\\nin seconds.\n"
+                "# TYPE test_duration_seconds histogram\n"
+                "test_duration_seconds_bucket{le=\"0.5\"} 1\n"
+                "test_duration_seconds_bucket{le=\"1\"} 1\n"
+                "test_duration_seconds_bucket{le=\"+Inf\"} 2\n"
+                "test_duration_seconds_sum 2.25\n"
+                "test_duration_seconds_count 2\n"
+                "# HELP test_requests_total Number of requests.\n"
+                "# TYPE test_requests_total counter\n"
+                "test_requests_total{op=\"new \\\"session\\\"\"} 0\n"
+                "test_requests_total{op=\"top\"} 3\n");
+    }
+}
+
+TEST_CASE("Check library metrics", "[metrics][Lib]") {
+    auto& metrics = LibraryMetrics::get();
+    REQUIRE(&LibraryMetrics::get() == &metrics);
+
+    auto loads = metrics.dictionaryLoads.getValue();
+    auto scored = metrics.guessesScored.getValue();
+    auto patterns = metrics.patternsEvaluated.getValue();
+    auto memoHits = metrics.memoHits.getValue();
+    auto memoMisses = metrics.memoMisses.getValue();
+
+    auto dictionary = std::make_shared<TxtDictionary>(TEST_WORDLE_WORDS);
+    REQUIRE(dictionary->load());
+    REQUIRE(metrics.dictionaryLoads.getValue() == loads + 1);
+
+    auto wordleDictionary = std::make_shared<FixedSizeDictionary>(dictionary, 5);
+    REQUIRE(wordleDictionary->load());
+    EntropyMaximizer solver{std::make_shared<WordleGameRules>(wordleDictionary)};
+    solver.setMemo(std::make_shared<SolverMemo>(10));
+    solver.setTemplate(".....");
+    auto filtered = metrics.solutionsFiltered.getValue();
+    auto nbTemplateSolutions = std::size(solver.getPotentialSolutions());
+    solver.addHint("bruir", {WRONG, WRONG, WRONG, WRONG, WRONG});
+    auto nbSolutions = std::size(solver.getPotentialSolutions());
+    auto nbGuesses = std::size(solver.getPotentialGuesses());
+    REQUIRE(metrics.solutionsFiltered.getValue() == filtered + nbTemplateSolutions - nbSolutions);
+
+    solver.computeNextGuesses(3);
+    solver.computeNextGuesses(3);
+    REQUIRE(metrics.guessesScored.getValue() == scored + nbGuesses);
+    REQUIRE(metrics.patternsEvaluated.getValue() == patterns + nbGuesses * nbSolutions);
+    REQUIRE(metrics.memoMisses.getValue() == memoMisses + 1);
+    REQUIRE(metrics.memoHits.getValue() == memoHits + 1);
+
+    // the library metrics are in the global registry
+    auto text = MetricsRegistry::getGlobal().formatPrometheus();
+    REQUIRE(text.find("# TYPE alphadocte_guesses_scored_total counter\n") != std::string::npos);
+    REQUIRE(text.find("alphadocte_cache_hits_total{cache=\"memo\"} ") != std::string::npos);
+    REQUIRE(text.find("alphadocte_phase_duration_seconds_count{phase=\"compute_next_guesses\"} ") != std::string::npos);
+}
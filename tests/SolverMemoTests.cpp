@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: SolverMemoTests.cpp
+ */
+
+#include <Alphadocte/EntropyMaximizer.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/MotusGameRules.h>
+#include <Alphadocte/SolverMemo.h>
+#include <Alphadocte/WordleGameRules.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "TestDefinitions.h"
+
+using Catch::Message;
+using namespace Alphadocte;
+using namespace std::string_literals;
+using enum HintType;
+
+TEST_CASE("Check solver memo storage", "[solver][Lib]") {
+    REQUIRE_THROWS_MATCHES(SolverMemo(0), InvalidArgException, Message("capacity must be strictly positive"));
+
+    SolverMemo memo{2};
+    REQUIRE(memo.getCapacity() == 2);
+    REQUIRE(memo.getStats().nbEntries == 0);
+    REQUIRE(memo.getStats().getHitRate() == 0);
+
+    SolverMemo::Guesses guesses{{"aient", 3.5}, {"amont", 2.5}, {"arroi", 1.5}};
+    REQUIRE_FALSE(memo.find("a", 1));
+    memo.insert("a", 3, guesses);
+    REQUIRE(memo.getStats().nbEntries == 1);
+    REQUIRE(memo.getStats().memoryUsage > 0);
+
+    SECTION("Looking up guesses") {
+        REQUIRE(memo.find("a", 3) == guesses);
+        REQUIRE(memo.find("a", 1) == SolverMemo::Guesses{guesses.front()});
+        REQUIRE_FALSE(memo.find("a", 4));
+
+        // all the guesses are known when less guesses than requested are stored
+        memo.insert("b", 5, guesses);
+        REQUIRE(memo.find("b", 10) == guesses);
+
+        // more guesses replace the previous ones, but not less
+        memo.insert("a", 4, guesses);
+        REQUIRE(memo.find("a", 10) == guesses);
+        memo.insert("a", 1, {guesses.front()});
+        REQUIRE(memo.find("a", 3) == guesses);
+
+        auto stats = memo.getStats();
+        REQUIRE(stats.nbHits == 5);
+        REQUIRE(stats.nbMisses == 2);
+        REQUIRE(stats.getHitRate() == Approx(5 / 7.));
+        REQUIRE(stats.nbEntries == 2);
+    }
+
+    SECTION("Evicting the least recently used state") {
+        memo.insert("b", 3, guesses);
+        REQUIRE(memo.find("a", 1)); // "b" is now the least recently used
+        memo.insert("c", 3, guesses);
+
+        REQUIRE(memo.find("a", 1));
+        REQUIRE_FALSE(memo.find("b", 1));
+        REQUIRE(memo.find("c", 1));
+
+        auto stats = memo.getStats();
+        REQUIRE(stats.nbEvictions == 1);
+        REQUIRE(stats.nbEntries == 2);
+
+        memo.clear();
+        REQUIRE_FALSE(memo.find("a", 1));
+        stats = memo.getStats();
+        REQUIRE(stats.nbEntries == 0);
+        REQUIRE(stats.nbHits == 0);
+        REQUIRE(stats.nbMisses == 1);
+        REQUIRE(stats.memoryUsage == 0);
+    }
+}
+
+TEST_CASE("Check solver memo coalescing", "[solver][Lib]") {
+    SolverMemo memo{10};
+    SolverMemo::Guesses guesses{{"aient", 3.5}, {"amont", 2.5}, {"arroi", 1.5}};
+    std::atomic<bool> started{false}, released{false};
+    std::atomic<int> nbComputed{0};
+
+    // blocks until released, so that other lookups of the state happen meanwhile
+    auto compute = [&]() {
+        nbComputed++;
+        started = true;
+        while (!released)
+            std::this_thread::yield();
+        return guesses;
+    };
+    auto waitForCoalesced = [&memo](size_t nbCoalesced) {
+        while (memo.getStats().nbCoalesced < nbCoalesced)
+            std::this_thread::yield();
+    };
+
+    SECTION("Sharing a computation") {
+        SolverMemo::Guesses computed, waited;
+        std::thread computing{[&]() { computed = memo.findOrCompute("a", 3, compute); }};
+        while (!started)
+            std::this_thread::yield();
+
+        std::thread waiting{[&]() { waited = memo.findOrCompute("a", 2, compute); }};
+        waitForCoalesced(1);
+        released = true;
+        computing.join();
+        waiting.join();
+
+        REQUIRE(nbComputed == 1);
+        REQUIRE(computed == guesses);
+        REQUIRE(waited == SolverMemo::Guesses(std::cbegin(guesses), std::cbegin(guesses) + 2));
+
+        // the next lookups hit the memo
+        REQUIRE(memo.findOrCompute("a", 3, compute) == guesses);
+        REQUIRE(nbComputed == 1);
+
+        auto stats = memo.getStats();
+        REQUIRE(stats.nbMisses == 1);
+        REQUIRE(stats.nbCoalesced == 1);
+        REQUIRE(stats.nbHits == 1);
+        REQUIRE(stats.getHitRate() == Approx(2 / 3.));
+    }
+
+    SECTION("Computing more guesses than the computation in progress") {
+        SolverMemo::Guesses computed;
+        std::thread computing{[&]() { computed = memo.findOrCompute("a", 1, compute); }};
+        while (!started)
+            std::this_thread::yield();
+
+        released = true;
+        REQUIRE(memo.findOrCompute("a", 3, compute) == guesses);
+        computing.join();
+        REQUIRE(nbComputed == 2);
+        REQUIRE(memo.getStats().nbCoalesced == 0);
+    }
+
+    SECTION("Sharing errors") {
+        auto fail = [&]() -> SolverMemo::Guesses {
+            compute();
+            throw std::runtime_error("computation failed");
+        };
+
+        // Catch assertions are not thread-safe, failures are checked once joined
+        std::atomic<int> nbFailed{0};
+        auto findOrCompute = [&](const std::function<SolverMemo::Guesses()>& function) {
+            try {
+                memo.findOrCompute("a", 3, function);
+            } catch (const std::runtime_error&) {
+                nbFailed++;
+            }
+        };
+
+        std::thread computing{findOrCompute, fail};
+        while (!started)
+            std::this_thread::yield();
+
+        std::thread waiting{findOrCompute, compute};
+        waitForCoalesced(1);
+        released = true;
+        computing.join();
+        waiting.join();
+        REQUIRE(nbFailed == 2);
+
+        // failures are not stored
+        REQUIRE(memo.getStats().nbEntries == 0);
+        REQUIRE(memo.findOrCompute("a", 3, compute) == guesses);
+        REQUIRE(nbComputed == 2);
+    }
+}
+
+TEST_CASE("Check solver memo state keys", "[solver][Lib]") {
+    const auto& wordleDict = getWordleDict();
+    std::shared_ptr<IGameRules> rules = std::make_shared<WordleGameRules>(wordleDict);
+    EntropyMaximizer solver{rules}, other{rules};
+
+    REQUIRE_THROWS_AS(SolverMemo::computeStateKey(solver), Exception);
+
+    solver.setTemplate(".....");
+    other.setTemplate(".....");
+    REQUIRE(SolverMemo::computeStateKey(solver) == SolverMemo::computeStateKey(other));
+
+    // hints order does not matter
+    solver.addHint("agaca", {CORRECT, WRONG, WRONG, WRONG, WRONG});
+    solver.addHint("boita", {WRONG, MISPLACED, WRONG, MISPLACED, MISPLACED});
+    REQUIRE(SolverMemo::computeStateKey(solver) != SolverMemo::computeStateKey(other));
+    other.addHint("boita", {WRONG, MISPLACED, WRONG, MISPLACED, MISPLACED});
+    other.addHint("agaca", {CORRECT, WRONG, WRONG, WRONG, WRONG});
+    REQUIRE(SolverMemo::computeStateKey(solver) == SolverMemo::computeStateKey(other));
+
+    // but hints, template and rules do
+    other.reset();
+    other.setTemplate(".....");
+    other.addHint("agaca", {CORRECT, WRONG, WRONG, WRONG, WRONG});
+    other.addHint("boita", {WRONG, MISPLACED, WRONG, MISPLACED, WRONG});
+    REQUIRE(SolverMemo::computeStateKey(solver) != SolverMemo::computeStateKey(other));
+
+    other.setTemplate("a....");
+    solver.setTemplate(".....");
+    REQUIRE(SolverMemo::computeStateKey(solver) != SolverMemo::computeStateKey(other));
+
+    EntropyMaximizer motusSolver{std::make_shared<MotusGameRules>(wordleDict)};
+    motusSolver.setTemplate("a....");
+    REQUIRE(SolverMemo::computeStateKey(motusSolver) != SolverMemo::computeStateKey(other));
+}
+
+TEST_CASE("Check solver using a memo", "[solver][Lib]") {
+    const auto& wordleDict = getWordleDict();
+    std::shared_ptr<IGameRules> rules = std::make_shared<WordleGameRules>(wordleDict);
+    EntropyMaximizer solver{rules}, reference{rules};
+    auto memo = std::make_shared<SolverMemo>(10);
+
+    REQUIRE(solver.getMemo() == nullptr);
+    solver.setMemo(memo);
+    REQUIRE(solver.getMemo() == memo);
+
+    // a copy shares the memo
+    EntropyMaximizer copy{solver};
+    REQUIRE(copy.getMemo() == memo);
+
+    for (EntropyMaximizer* s : {&solver, &copy, &reference}) {
+        s->setTemplate(".....");
+        s->addHint("bruir", {WRONG, WRONG, WRONG, WRONG, WRONG});
+    }
+
+    auto expected = reference.computeNextGuesses(5);
+    REQUIRE(solver.computeNextGuesses(5) == expected);
+    REQUIRE(memo->getStats().nbMisses == 1);
+    REQUIRE(memo->getStats().nbEntries == 1);
+
+    REQUIRE(copy.computeNextGuesses(3) == std::vector(std::cbegin(expected), std::cbegin(expected) + 3));
+    REQUIRE(copy.computeNextGuess() == expected.front().first);
+    REQUIRE(memo->getStats().nbHits == 2);
+
+    // not computed for other states
+    for (EntropyMaximizer* s : {&copy, &reference}) {
+        s->setTemplate(".....");
+        s->addHint("agaca", {CORRECT, WRONG, WRONG, WRONG, WRONG}); // 3 solutions
+    }
+    REQUIRE(copy.computeNextGuesses(5) == reference.computeNextGuesses(5));
+    REQUIRE(memo->getStats().nbMisses == 2);
+    REQUIRE(memo->getStats().nbEntries == 2);
+
+    // disabling the memo
+    solver.setMemo({});
+    REQUIRE(solver.computeNextGuesses(5) == expected);
+    REQUIRE(memo->getStats().nbHits == 2);
+}
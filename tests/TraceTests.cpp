@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: TraceTests.cpp
+ */
+
+#include <Alphadocte/EntropyMaximizer.h>
+#include <Alphadocte/FixedSizeDictionary.h>
+#include <Alphadocte/Trace.h>
+#include <Alphadocte/TxtDictionary.h>
+#include <Alphadocte/WordleGameRules.h>
+#include <latch>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "TestDefinitions.h"
+
+using namespace Alphadocte;
+
+TEST_CASE("Check tracer", "[trace][Lib]") {
+    auto& tracer = Tracer::getGlobal();
+    REQUIRE(&Tracer::getGlobal() == &tracer);
+
+    // scopes opened while not recording are ignored
+    tracer.stop();
+    { TraceScope scope{"ignored", "test"}; }
+
+    tracer.start();
+    REQUIRE(tracer.isRecording());
+    REQUIRE(tracer.getEventCount() == 0);
+
+    {
+        TraceScope outer{"outer", "test"};
+        TraceScope inner{"inner \"quoted\"", "test"};
+    }
+
+    // the workers run at the same time
+    std::vector<std::thread> threads;
+    std::latch running{2};
+    for (int i = 0; i < 2; i++) {
+        threads.emplace_back([&running]() {
+            for (int j = 0; j < 10; j++)
+                TraceScope scope{"worker", "test"};
+            running.arrive_and_wait();
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    tracer.stop();
+    { TraceScope scope{"ignored", "test"}; }
+
+    std::ostringstream stream;
+    tracer.writeChromeTrace(stream);
+    auto trace = stream.str();
+
+    // the library may add its own events, when compiled with them
+    REQUIRE(tracer.getEventCount() >= 22);
+    REQUIRE(trace.rfind("{\"traceEvents\":[", 0) == 0);
+    REQUIRE(trace.find("\"name\":\"outer\",\"cat\":\"test\",\"ph\":\"X\",\"ts\":") != std::string::npos);
+    REQUIRE(trace.find("\"name\":\"inner \\\"quoted\\\"\"") != std::string::npos);
+    REQUIRE(trace.find("\"ignored\"") == std::string::npos);
+    REQUIRE(trace.find("\"displayTimeUnit\":\"ms\"}") != std::string::npos);
+
+    // the main thread and each worker have their own track
+    size_t nbTracks{};
+    for (auto pos = trace.find("\"thread_name\""); pos != std::string::npos; pos = trace.find("\"thread_name\"", pos + 1))
+        nbTracks++;
+    REQUIRE(nbTracks == 3);
+
+    // restarting discards the previous events
+    tracer.start();
+    REQUIRE(tracer.getEventCount() == 0);
+
+    // short-lived threads one after the other share the track of their slot
+    for (int i = 0; i < 10; i++) {
+        std::thread{[]() { TraceScope scope{"worker", "test"}; }}.join();
+    }
+    tracer.stop();
+
+    std::ostringstream restartedStream;
+    tracer.writeChromeTrace(restartedStream);
+    auto restartedTrace = restartedStream.str();
+    REQUIRE(tracer.getEventCount() >= 10);
+    REQUIRE(restartedTrace.find("\"thread_name\"") == restartedTrace.rfind("\"thread_name\""));
+    REQUIRE(restartedTrace.find("\"tid\":3") == std::string::npos);
+}
+
+TEST_CASE("Check library trace events", "[trace][Lib]") {
+    if (!Tracer::isAvailable())
+        return;
+
+    auto& tracer = Tracer::getGlobal();
+    tracer.start();
+
+    auto dictionary = std::make_shared<TxtDictionary>(TEST_WORDLE_WORDS);
+    REQUIRE(dictionary->load());
+    auto wordleDictionary = std::make_shared<FixedSizeDictionary>(dictionary, 5);
+    REQUIRE(wordleDictionary->load());
+    EntropyMaximizer solver{std::make_shared<WordleGameRules>(wordleDictionary)};
+    solver.setTemplate(".....");
+    solver.computeNextGuesses(3);
+    tracer.stop();
+
+    std::ostringstream stream;
+    tracer.writeChromeTrace(stream);
+    auto trace = stream.str();
+
+    for (std::string name : {"loadDictionary", "setTemplate", "populateGuesses", "populateSolutions",
+            "computeNextGuesses", "scoreGuesses", "rankGuesses"}) {
+        INFO(name);
+        REQUIRE(trace.find("\"name\":\"" + name + "\"") != std::string::npos);
+    }
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: WorkloadRecorderTests.cpp
+ */
+
+#include <Alphadocte/EntropyMaximizer.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/WordleGameRules.h>
+#include <Alphadocte/WorkloadRecorder.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "TestDefinitions.h"
+
+using namespace Alphadocte;
+using enum HintType;
+
+namespace {
+
+std::vector<std::string> readLines(const std::string& text) {
+    std::vector<std::string> lines;
+    std::istringstream stream{text};
+    std::string line;
+    while (std::getline(stream, line))
+        lines.push_back(line);
+
+    return lines;
+}
+
+}
+
+TEST_CASE("Check the recording of the solver calls", "[solver][Lib]") {
+    auto dictionary = getWordleDict();
+    auto rules = std::make_shared<WordleGameRules>(dictionary);
+    std::ostringstream output;
+    auto recorder = std::make_shared<WorkloadRecorder>(output);
+    const std::string gameLine = "game 1 entropy_maximizer " + std::to_string(EntropyMaximizer::SOLVER_VERSION)
+            + " wordle 6 " + std::to_string(std::size(dictionary->getAllWords())) + ' '
+            + std::to_string(dictionary->getContentHash()) + " .....";
+    std::vector<HintType> hints{WRONG, WRONG, WRONG, WRONG, WRONG};
+
+    EntropyMaximizer solver{rules};
+    REQUIRE_FALSE(solver.getRecorder());
+
+    SECTION("Recording a game from its template") {
+        solver.setRecorder(recorder);
+        REQUIRE(solver.getRecorder() == recorder);
+        REQUIRE(recorder->getGameCount() == 0);
+
+        solver.setTemplate(".....");
+        solver.addHint("bruir", hints);
+        auto guesses = solver.computeNextGuesses(2);
+        REQUIRE(std::size(guesses) == 2);
+        recorder->flush();
+
+        auto lines = readLines(output.str());
+        REQUIRE(std::size(lines) == 4);
+        REQUIRE(lines[0] == "alphadocte-workload 1");
+        REQUIRE(lines[1] == gameLine);
+        REQUIRE(lines[2] == "hint 1 bruir " + std::to_string(packHints(hints)));
+        REQUIRE(lines[3].starts_with("compute 1 2 "));
+        REQUIRE(lines[3].ends_with(' ' + guesses[0].first + ',' + guesses[1].first));
+        REQUIRE(recorder->getGameCount() == 1);
+
+        // a new template starts a new game, a reset stops recording the current one
+        solver.setTemplate(".....");
+        REQUIRE(recorder->getGameCount() == 2);
+        solver.reset();
+        solver.setRecorder(nullptr);
+        solver.setTemplate(".....");
+        REQUIRE(recorder->getGameCount() == 2);
+    }
+
+    SECTION("Recording a game already started") {
+        solver.setTemplate(".....");
+        solver.addHint("bruir", hints);
+        solver.setRecorder(recorder);
+        recorder->flush();
+
+        auto lines = readLines(output.str());
+        REQUIRE(std::size(lines) == 3);
+        REQUIRE(lines[1] == gameLine);
+        REQUIRE(lines[2] == "hint 1 bruir " + std::to_string(packHints(hints)));
+    }
+
+    REQUIRE_THROWS_AS(WorkloadRecorder(TEST_OUT_DIR / "missing_folder" / "workload.txt"), Exception);
+}
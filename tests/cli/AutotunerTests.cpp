@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: AutotunerTests.cpp
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Alphadocte/EntropyMaximizer.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/TxtDictionary.h>
+#include <catch2/catch.hpp>
+
+#include "../stubs/DictionaryStub.h"
+#include "../TestDefinitions.h"
+#include "../../apps/Autotuner.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+using enum EntropyMaximizer::HistogramStrategy;
+
+TEST_CASE("Picking the templates measured by the autotuner", "[tuning][CLI]") {
+    // 16 words starting with a, 5 with b, 4 with c and 1 with d
+    std::vector<std::string> words;
+    for (char c = 'a'; c < 'q'; c++)
+        words.push_back(std::string{"a"} + c + "bcd");
+    for (char c = 'a'; c < 'f'; c++)
+        words.push_back(std::string{"b"} + c + "cde");
+    for (char c = 'a'; c < 'e'; c++)
+        words.push_back(std::string{"c"} + c + "def");
+    words.push_back("dabcd");
+    DictionaryStub dictionary{words};
+
+    auto templates = pickTuningTemplates(dictionary, 100, false);
+    REQUIRE(std::size(templates) == 3);
+    REQUIRE(templates[0].templateWord == "a....");
+    REQUIRE(templates[1].templateWord == "c....");
+    REQUIRE(templates[2].templateWord == "d....");
+
+    // the Wordle template has every word
+    templates = pickTuningTemplates(dictionary, 100);
+    REQUIRE(templates[0].templateWord == ".....");
+    REQUIRE(templates[1].templateWord == "b....");
+
+    // templates too large are skipped
+    templates = pickTuningTemplates(dictionary, 10, false);
+    REQUIRE(std::size(templates) == 2);
+    REQUIRE(templates[0].templateWord == "b....");
+    REQUIRE(templates[1].templateWord == "d....");
+
+    REQUIRE(pickTuningTemplates(dictionary, 0).empty());
+}
+
+TEST_CASE("Choosing a tuning from its measures", "[tuning][CLI]") {
+    REQUIRE(chooseTuning({}).histogram == MAP);
+    REQUIRE(chooseTuning({}).nbThreads == 1);
+
+    std::vector<TuningMeasure> measures{
+        {"a.....", "motus", 1000000, MAP, 1, 1.0},
+        {"a.....", "motus", 1000000, DENSE, 1, 0.5},
+        {"a.....", "motus", 1000000, SORTED, 1, 0.6},
+        {"b.....", "motus", 10000, MAP, 1, 0.01},
+        {"b.....", "motus", 10000, DENSE, 1, 0.008},
+        {"b.....", "motus", 10000, SORTED, 1, 0.004},
+        {"c.....", "motus", 100, MAP, 1, 0.0001},
+        {"c.....", "motus", 100, DENSE, 1, 0.0001},
+        {"c.....", "motus", 100, SORTED, 1, 0.0001}
+    };
+
+    // dense : 1 + 2 + 1, sorted : 1.2 + 1 + 1
+    auto tuning = chooseTuning(measures);
+    REQUIRE(tuning.histogram == SORTED);
+    REQUIRE(tuning.nbThreads == 1);
+    REQUIRE(tuning.minParallelPatterns == 0);
+
+    measures.insert(std::end(measures), {
+        {"a.....", "motus", 1000000, SORTED, 2, 0.35},
+        {"a.....", "motus", 1000000, SORTED, 4, 0.2},
+        {"b.....", "motus", 10000, SORTED, 2, 0.003},
+        {"b.....", "motus", 10000, SORTED, 4, 0.003},
+        {"c.....", "motus", 100, SORTED, 2, 0.0002},
+        {"c.....", "motus", 100, SORTED, 4, 0.0004}
+    });
+
+    // fastest on the largest template, from the first template where it is always faster
+    tuning = chooseTuning(measures);
+    REQUIRE(tuning.histogram == SORTED);
+    REQUIRE(tuning.nbThreads == 4);
+    REQUIRE(tuning.minParallelPatterns == 10000);
+
+    // faster on every template
+    measures.back().duration = measures[measures.size() - 2].duration = 0.00005;
+    REQUIRE(chooseTuning(measures).minParallelPatterns == 0);
+
+    // slower on a medium template
+    measures[measures.size() - 3].duration = 0.005;
+    REQUIRE(chooseTuning(measures).minParallelPatterns == 1000000);
+}
+
+TEST_CASE("Autotuning the solver", "[tuning][CLI]") {
+    auto dictionary = std::make_shared<TxtDictionary>(TEST_WORDLE_WORDS);
+    REQUIRE(dictionary->load());
+
+    AutotuneOptions options;
+    options.maxThreads = 2;
+    options.maxCandidates = 100;
+    options.repetitions = 1;
+
+    size_t nbCalls{};
+    auto profile = autotune(dictionary, options, [&nbCalls](const TuningMeasure& measure, size_t nbDone, size_t nbToMeasure) {
+        REQUIRE(nbDone == ++nbCalls);
+        REQUIRE(nbDone <= nbToMeasure);
+        REQUIRE(measure.nbPatterns > 0);
+        REQUIRE(measure.duration >= 0);
+    });
+
+    auto nbTemplates = std::size(pickTuningTemplates(*dictionary, options.maxCandidates));
+    REQUIRE(nbTemplates > 0);
+    REQUIRE(std::size(profile.measures) == nbTemplates * 4);
+    REQUIRE(nbCalls == std::size(profile.measures));
+    REQUIRE(profile.measures.front().templateWord == ".....");
+    REQUIRE(profile.measures.front().rules == "wordle");
+    REQUIRE(profile.measures.back().nbThreads == 2);
+    REQUIRE(profile.tuning.nbThreads >= 1);
+    REQUIRE(profile.tuning.nbThreads <= 2);
+
+    options.repetitions = 0;
+    REQUIRE_THROWS_AS(autotune(dictionary, options), InvalidArgException);
+    options.repetitions = 1;
+    options.maxCandidates = 0;
+    REQUIRE_THROWS_AS(autotune(dictionary, options), InvalidArgException);
+}
@@ -0,0 +1,391 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: cli/BinaryCacheTests.cpp
+ */
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/TxtDictionary.h>
+#include <catch2/catch.hpp>
+
+#include "../TestDefinitions.h"
+#include "../../apps/BinaryCache.h"
+#include "../../apps/CacheConfig.h"
+
+#if defined ALPHADOCTE_OS_LINUX
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+constexpr char SOLVER_NAME[] = "entropy_maximizer";
+constexpr unsigned int SOLVER_VERSION = 1;
+
+static std::shared_ptr<Dictionary> loadWordleWords() {
+    auto dictionary = std::make_shared<TxtDictionary>(TEST_WORDLE_WORDS);
+    REQUIRE(dictionary->load());
+    return dictionary;
+}
+
+static std::filesystem::path prepareCachePath(std::string_view name) {
+    REQUIRE_NOTHROW(std::filesystem::create_directories(TEST_OUT_DIR));
+    auto path = TEST_OUT_DIR / name;
+    std::filesystem::remove(path);
+    return path;
+}
+
+TEST_CASE("Computing the identity of a dictionary", "[cache][CLI]") {
+    auto dictionary = loadWordleWords();
+    auto identity = DictionaryIdentity::compute(TEST_WORDLE_WORDS, *dictionary);
+
+    REQUIRE(identity.path == std::filesystem::absolute(TEST_WORDLE_WORDS).string());
+    REQUIRE(identity.contentHash == dictionary->getContentHash());
+    REQUIRE(identity.nbWords == std::size(dictionary->getAllWords()));
+    REQUIRE(identity == DictionaryIdentity::compute(TEST_WORDLE_WORDS, *dictionary));
+
+    // a copy of the dictionary, even touched, has the same identity
+    REQUIRE_NOTHROW(std::filesystem::create_directories(TEST_OUT_DIR));
+    auto copyPath = TEST_OUT_DIR / "wordle_copy.txt";
+    std::filesystem::copy_file(TEST_WORDLE_WORDS, copyPath, std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::last_write_time(copyPath, std::filesystem::file_time_type::clock::now());
+    TxtDictionary copy{copyPath};
+    REQUIRE(copy.load());
+    REQUIRE(DictionaryIdentity::compute(copyPath, copy) == identity);
+
+    // but not a different word list
+    TxtDictionary motus{TEST_MOTUS_WORDS};
+    REQUIRE(motus.load());
+    REQUIRE_FALSE(DictionaryIdentity::compute(TEST_MOTUS_WORDS, motus) == identity);
+
+    TxtDictionary notLoaded{TEST_WORDLE_WORDS};
+    REQUIRE_THROWS_AS(DictionaryIdentity::compute(TEST_WORDLE_WORDS, notLoaded), Exception);
+}
+
+TEST_CASE("Storing guesses in a binary cache", "[cache][CLI]") {
+    auto dictionary = loadWordleWords();
+    auto identity = DictionaryIdentity::compute(TEST_WORDLE_WORDS, *dictionary);
+    auto path = prepareCachePath("binary_cache.bin");
+    const auto& words = dictionary->getAllWords();
+
+    // scores are not rounded, unlike the text cache
+    const std::vector<std::pair<std::string, double>> guesses{
+        {words.at(3), 6.342236123456789},
+        {words.at(10), 6.299622},
+        {words.at(0), 0.1}
+    };
+
+    BinaryCache cache{path, dictionary, identity, SOLVER_NAME, SOLVER_VERSION};
+    REQUIRE(cache.size() == 0);
+    REQUIRE_FALSE(cache.contains("....."));
+    REQUIRE_THROWS_AS(cache.getTopGuesses(3, "....."), Exception);
+    REQUIRE_FALSE(std::filesystem::exists(path));
+
+    SECTION("Round trip") {
+        cache.setTopGuesses(".....", 3, guesses);
+        REQUIRE(std::filesystem::exists(path));
+        REQUIRE(cache.size() == 1);
+        REQUIRE(cache.contains("....."));
+        REQUIRE(cache.contains(".....", 3));
+        REQUIRE_FALSE(cache.contains(".....", 4));
+        REQUIRE_FALSE(cache.contains("a...."));
+        REQUIRE(cache.getTopGuesses(3, ".....") == guesses);
+        REQUIRE(cache.getTopGuesses(2, ".....") == std::vector(std::cbegin(guesses), std::cbegin(guesses) + 2));
+        REQUIRE_THROWS_AS(cache.getTopGuesses(4, "....."), Exception);
+        REQUIRE(cache.findTopGuesses(3, ".....") == guesses);
+        REQUIRE_FALSE(cache.findTopGuesses(4, "....."));
+        REQUIRE_FALSE(cache.findTopGuesses(1, "a...."));
+
+        // replace the record
+        cache.setTopGuesses(".....", 1, {guesses.at(1)});
+        REQUIRE(cache.size() == 1);
+        REQUIRE(cache.getTopGuesses(1, ".....") == std::vector{guesses.at(1)});
+
+        // fewer guesses than requested
+        cache.setTopGuesses("z....", 3, {});
+        REQUIRE(cache.getTopGuesses(3, "z....").empty());
+    }
+
+    SECTION("Storing the opening book") {
+        BookPosition position{".....", words.at(3), std::vector<HintType>(5, HintType::WRONG)};
+        REQUIRE_FALSE(cache.containsSecondGuesses(position));
+        REQUIRE_THROWS_AS(cache.getSecondGuesses(1, position), Exception);
+
+        cache.setTopGuesses(".....", 3, guesses);
+        cache.setSecondGuesses(position, 2, {guesses.at(1), guesses.at(2)});
+        REQUIRE(cache.size() == 2);
+        REQUIRE(cache.containsSecondGuesses(position, 2));
+        REQUIRE_FALSE(cache.containsSecondGuesses(position, 3));
+        REQUIRE(cache.getSecondGuesses(2, position) == std::vector{guesses.at(1), guesses.at(2)});
+        REQUIRE(cache.findSecondGuesses(2, position) == std::vector{guesses.at(1), guesses.at(2)});
+        REQUIRE_FALSE(cache.findSecondGuesses(3, position));
+        REQUIRE(cache.getTopGuesses(3, ".....") == guesses);
+
+        // positions are not templates
+        REQUIRE(cache.getTemplates() == std::vector<std::string>{"....."});
+        REQUIRE(cache.getBookPositions() == std::vector{position});
+
+        position.hints.front() = HintType::MISPLACED;
+        REQUIRE_FALSE(cache.containsSecondGuesses(position));
+        REQUIRE_THROWS_AS(cache.setSecondGuesses(position, 1, {{"zzzzz", 1.}}), InvalidArgException);
+    }
+
+    SECTION("Growing the index") {
+        for (int i = 0; i < 100; i++)
+            cache.setTopGuesses(std::to_string(i) + "....", 3, {guesses.at(i % 3)});
+
+        REQUIRE(cache.size() == 100);
+        REQUIRE(std::size(cache.getTemplates()) == 100);
+        for (int i = 0; i < 100; i++)
+            REQUIRE(cache.getTopGuesses(3, std::to_string(i) + "....") == std::vector{guesses.at(i % 3)});
+    }
+
+    SECTION("Reopening the cache") {
+        cache.setTopGuesses(".....", 3, guesses);
+        cache.setTopGuesses("a....", 3, guesses);
+
+        BinaryCache reopened{path, dictionary, identity, SOLVER_NAME, SOLVER_VERSION};
+        REQUIRE(reopened.size() == 2);
+        REQUIRE(reopened.getTopGuesses(3, "a....") == guesses);
+
+        // the cache is discarded when the solver or the dictionary changed
+        BinaryCache newVersion{path, dictionary, identity, SOLVER_NAME, SOLVER_VERSION + 1};
+        REQUIRE(newVersion.size() == 0);
+        BinaryCache otherSolver{path, dictionary, identity, "other_solver", SOLVER_VERSION};
+        REQUIRE(otherSolver.size() == 0);
+        auto modifiedIdentity = identity;
+        modifiedIdentity.contentHash++;
+        BinaryCache modifiedDictionary{path, dictionary, modifiedIdentity, SOLVER_NAME, SOLVER_VERSION};
+        REQUIRE(modifiedDictionary.size() == 0);
+
+        // and overwritten on the next write
+        newVersion.setTopGuesses("b....", 1, {guesses.at(0)});
+        REQUIRE(newVersion.size() == 1);
+        REQUIRE(BinaryCache{path, dictionary, identity, SOLVER_NAME, SOLVER_VERSION}.size() == 0);
+    }
+
+    SECTION("Writing from several caches") {
+        // each write maps the latest file first, so that no record is lost
+        BinaryCache other{path, dictionary, identity, SOLVER_NAME, SOLVER_VERSION};
+        std::thread thread{[&other, &guesses]() {
+            for (int i = 0; i < 50; i++)
+                other.setTopGuesses(std::to_string(i) + "a...", 3, guesses);
+        }};
+        for (int i = 0; i < 50; i++)
+            cache.setTopGuesses(std::to_string(i) + "b...", 3, guesses);
+        thread.join();
+
+        cache.reload();
+        REQUIRE(cache.size() == 100);
+        for (int i = 0; i < 50; i++) {
+            REQUIRE(cache.getTopGuesses(3, std::to_string(i) + "a...") == guesses);
+            REQUIRE(cache.getTopGuesses(3, std::to_string(i) + "b...") == guesses);
+        }
+    }
+
+#if defined ALPHADOCTE_OS_LINUX
+    SECTION("Writing from several processes") {
+        pid_t pid = fork();
+        REQUIRE(pid >= 0);
+
+        if (pid == 0) {
+            // child process, must not return to the test runner
+            try {
+                BinaryCache child{path, dictionary, identity, SOLVER_NAME, SOLVER_VERSION};
+                for (int i = 0; i < 50; i++)
+                    child.setTopGuesses(std::to_string(i) + "a...", 3, guesses);
+            } catch (...) {
+                _exit(1);
+            }
+            _exit(0);
+        }
+
+        for (int i = 0; i < 50; i++)
+            cache.setTopGuesses(std::to_string(i) + "b...", 3, guesses);
+
+        int status{};
+        REQUIRE(waitpid(pid, &status, 0) == pid);
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) == 0);
+
+        cache.reload();
+        REQUIRE(cache.size() == 100);
+        for (int i = 0; i < 50; i++) {
+            REQUIRE(cache.getTopGuesses(3, std::to_string(i) + "a...") == guesses);
+            REQUIRE(cache.getTopGuesses(3, std::to_string(i) + "b...") == guesses);
+        }
+    }
+#endif
+
+    SECTION("Compacting the cache") {
+        std::vector<std::pair<std::string, double>> manyGuesses;
+        for (const auto& word : words)
+            manyGuesses.emplace_back(word, 1.);
+
+        cache.setTopGuesses("a....", 3, guesses);
+        for (int i = 0; i < 200; i++)
+            cache.setTopGuesses(".....", static_cast<unsigned int>(std::size(words)), manyGuesses);
+
+        // replaced records have been dropped in the background
+        cache.waitForCompaction();
+        cache.reload();
+        auto recordSize = std::size(words) * 16;
+        REQUIRE(std::filesystem::file_size(path) < 100 * recordSize);
+        REQUIRE(cache.size() == 2);
+        REQUIRE(cache.getTopGuesses(3, "a....") == guesses);
+        REQUIRE(cache.getTopGuesses(static_cast<unsigned int>(std::size(words)), ".....") == manyGuesses);
+
+        cache.compact();
+        REQUIRE(cache.getWastedSize() == 0);
+        REQUIRE(std::filesystem::file_size(path) < 3 * recordSize); // header, index, and the 2 records
+        REQUIRE(cache.size() == 2);
+        REQUIRE(cache.getTopGuesses(3, "a....") == guesses);
+        REQUIRE(cache.getTopGuesses(static_cast<unsigned int>(std::size(words)), ".....") == manyGuesses);
+    }
+
+    SECTION("Looking up records from several threads") {
+        cache.setTopGuesses("a....", 3, guesses);
+        cache.setTopGuesses("b....", 3, guesses);
+        auto writeInfo = readCacheFileInfo(path);
+        REQUIRE(writeInfo);
+        std::this_thread::sleep_for(std::chrono::milliseconds{1100});
+
+        // lookups only note the records they read, and can run concurrently
+        std::atomic<int> nbMismatches{};
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&cache, &guesses, &nbMismatches, t]() {
+                for (int i = 0; i < 100; i++) {
+                    if (cache.getTopGuesses(3, (t + i) % 2 == 0 ? "a...." : "b....") != guesses)
+                        nbMismatches++;
+                }
+            });
+        }
+        threads.clear();
+        REQUIRE(nbMismatches == 0);
+        cache.flushAccessTimes();
+
+        auto info = readCacheFileInfo(path);
+        REQUIRE(info);
+        REQUIRE(std::size(info->records) == 2);
+        for (size_t i = 0; i < std::size(info->records); i++)
+            REQUIRE(info->records.at(i).accessTime > writeInfo->records.at(i).accessTime);
+    }
+
+    SECTION("Evicting the least recently used records") {
+        cache.setTopGuesses("a....", 3, guesses);
+        cache.setTopGuesses("b....", 3, guesses);
+
+        // access times are in seconds
+        std::this_thread::sleep_for(std::chrono::milliseconds{1100});
+        cache.setTopGuesses("c....", 3, guesses);
+        REQUIRE(cache.findTopGuesses(3, "a...."));
+        cache.flushAccessTimes();
+
+        auto info = readCacheFileInfo(path);
+        REQUIRE(info);
+        REQUIRE(info->solverName == SOLVER_NAME);
+        REQUIRE(info->solverVersion == SOLVER_VERSION);
+        REQUIRE(info->identity == identity);
+        REQUIRE(info->fileSize == std::filesystem::file_size(path));
+        REQUIRE(std::size(info->records) == 3);
+
+        std::map<std::string, std::uint32_t> accessTimes;
+        for (const auto& record : info->records)
+            accessTimes[record.key] = record.accessTime;
+        REQUIRE(accessTimes.at("b....") > 0);
+        REQUIRE(accessTimes.at("a....") > accessTimes.at("b...."));
+        REQUIRE(accessTimes.at("c....") > accessTimes.at("b...."));
+
+        compactCacheFile(path, accessTimes.at("b....") + 1);
+        cache.reload();
+        REQUIRE(cache.size() == 2);
+        REQUIRE_FALSE(cache.contains("b...."));
+        REQUIRE(cache.getTopGuesses(3, "a....") == guesses);
+        REQUIRE(cache.getTopGuesses(3, "c....") == guesses);
+
+        REQUIRE(removeCacheFile(path));
+        REQUIRE_FALSE(readCacheFileInfo(path));
+    }
+
+    SECTION("Clearing the cache") {
+        cache.setTopGuesses(".....", 3, guesses);
+        cache.clear();
+        REQUIRE(cache.size() == 0);
+        REQUIRE_FALSE(std::filesystem::exists(path));
+    }
+
+    SECTION("Rejecting invalid guesses") {
+        REQUIRE_THROWS_AS(cache.setTopGuesses(".....", 1, {{"zzzzz", 1.}}), InvalidArgException);
+        REQUIRE(cache.size() == 0);
+    }
+
+    SECTION("Rejecting a corrupted file") {
+        cache.setTopGuesses(".....", 3, guesses);
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+
+        BinaryCache corrupted{path, dictionary, identity, SOLVER_NAME, SOLVER_VERSION};
+        REQUIRE_THROWS_AS(corrupted.getTopGuesses(3, "....."), Exception);
+    }
+
+    REQUIRE_THROWS_AS(BinaryCache(path, nullptr, identity, SOLVER_NAME, SOLVER_VERSION), InvalidArgException);
+    REQUIRE_THROWS_AS(BinaryCache(path, std::make_shared<TxtDictionary>(TEST_WORDLE_WORDS), identity, SOLVER_NAME, SOLVER_VERSION), InvalidArgException);
+}
+
+TEST_CASE("Converting between binary and text caches", "[cache][config][CLI]") {
+    auto dictionary = loadWordleWords();
+    auto identity = DictionaryIdentity::compute(TEST_WORDLE_WORDS, *dictionary);
+    auto path = prepareCachePath("converted_cache.bin");
+    const auto& words = dictionary->getAllWords();
+
+    // the text cache only keeps 6 decimals
+    const std::vector<std::pair<std::string, double>> guesses{{words.at(1), 6.5}, {words.at(2), 5.25}};
+
+    CacheConfig textCache{TEST_WORDLE_WORDS, *dictionary};
+    textCache.setTopGuesses(SOLVER_NAME, SOLVER_VERSION, ".....", 2, guesses);
+    textCache.setTopGuesses(SOLVER_NAME, SOLVER_VERSION, "a....", 2, {guesses.at(1)});
+    textCache.setTopGuesses(SOLVER_NAME, SOLVER_VERSION, "b....", 1, {{"zzzzz", 1.}});    // not in the dictionary
+    textCache.setTopGuesses("other_solver", SOLVER_VERSION, "c....", 1, {guesses.at(0)});
+    BookPosition position{".....", words.at(1), std::vector<HintType>(5, HintType::MISPLACED)};
+    textCache.setSecondGuesses(SOLVER_NAME, SOLVER_VERSION, position, 1, {guesses.at(1)});
+
+    BinaryCache cache{path, dictionary, identity, SOLVER_NAME, SOLVER_VERSION};
+    REQUIRE(cache.importFrom(textCache) == 3);
+    REQUIRE(cache.size() == 3);
+    REQUIRE(cache.getSecondGuesses(1, position) == std::vector{guesses.at(1)});
+    REQUIRE(cache.getTopGuesses(2, ".....") == guesses);
+    REQUIRE(cache.getTopGuesses(2, "a....") == std::vector{guesses.at(1)});
+    REQUIRE_FALSE(cache.contains("b...."));
+    REQUIRE_FALSE(cache.contains("c...."));
+
+    CacheConfig exported{TEST_WORDLE_WORDS, *dictionary};
+    cache.exportTo(exported);
+    REQUIRE(exported.getTopGuesses(SOLVER_NAME, SOLVER_VERSION, 2, ".....") == guesses);
+    REQUIRE(exported.getTopGuesses(SOLVER_NAME, SOLVER_VERSION, 2, "a....") == std::vector{guesses.at(1)});
+    REQUIRE_THROWS_AS(exported.getTopGuesses(SOLVER_NAME, SOLVER_VERSION, 1, "b...."), Exception);
+    REQUIRE(exported.getSecondGuesses(SOLVER_NAME, SOLVER_VERSION, 1, position) == std::vector{guesses.at(1)});
+}
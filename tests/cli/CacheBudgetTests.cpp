@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: CacheBudgetTests.cpp
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include <Alphadocte/TxtDictionary.h>
+#include <catch2/catch.hpp>
+
+#include "../TestDefinitions.h"
+#include "../../apps/BinaryCache.h"
+#include "../../apps/CacheBudget.h"
+#include "../../apps/CacheConfig.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+TEST_CASE("Parsing cache sizes", "[cache][CLI]") {
+    REQUIRE(parseCacheSize("0") == 0u);
+    REQUIRE(parseCacheSize("512") == 512u);
+    REQUIRE(parseCacheSize("64K") == 64u * 1024);
+    REQUIRE(parseCacheSize("200M") == 200u * 1024 * 1024);
+    REQUIRE(parseCacheSize("2g") == 2ull * 1024 * 1024 * 1024);
+
+    REQUIRE_FALSE(parseCacheSize(""));
+    REQUIRE_FALSE(parseCacheSize("M"));
+    REQUIRE_FALSE(parseCacheSize("-1"));
+    REQUIRE_FALSE(parseCacheSize("12T"));
+    REQUIRE_FALSE(parseCacheSize("12MB"));
+    REQUIRE_FALSE(parseCacheSize("99999999999999999999G"));
+}
+
+TEST_CASE("Keeping the cache folder under a budget", "[cache][CLI]") {
+    auto folder = TEST_OUT_DIR / "cache_budget";
+    std::filesystem::remove_all(folder);
+    REQUIRE_NOTHROW(std::filesystem::create_directories(folder));
+
+    auto dictionary = std::make_shared<TxtDictionary>(TEST_WORDLE_WORDS);
+    REQUIRE(dictionary->load());
+    auto identity = DictionaryIdentity::compute(TEST_WORDLE_WORDS, *dictionary);
+    const auto& words = dictionary->getAllWords();
+    const std::vector<std::pair<std::string, double>> guesses{{words.at(0), 2.}, {words.at(1), 1.}};
+    const std::map<std::string, unsigned int, std::less<>> solverVersions{{"entropy_maximizer", 2}};
+
+    // binary caches of an outdated solver version, of an unknown solver, and of another format
+    auto outdatedPath = folder / "wordle.entropy_maximizer.bin";
+    BinaryCache{outdatedPath, dictionary, identity, "entropy_maximizer", 1}.setTopGuesses(".....", 2, guesses);
+    auto otherPath = folder / "wordle.other_solver.bin";
+    BinaryCache{otherPath, dictionary, identity, "other_solver", 1}.setTopGuesses(".....", 2, guesses);
+    auto invalidPath = folder / "invalid.bin";
+    std::ofstream{invalidPath} << "not a cache";
+
+    // text cache with an outdated and an unknown solver, and an unrelated file
+    auto textPath = folder / "wordle";
+    CacheConfig textCache{TEST_WORDLE_WORDS, *dictionary};
+    textCache.setTopGuesses("entropy_maximizer", 1, ".....", 2, guesses);
+    textCache.setTopGuesses("other_solver", 1, ".....", 2, guesses);
+    textCache.getConfig().writeToFile(textPath);
+    auto unrelatedPath = folder / "notes.txt";
+    std::ofstream{unrelatedPath} << "kept";
+
+    SECTION("Removing outdated caches") {
+        auto result = compactCacheFolder(folder, solverVersions, std::nullopt);
+        REQUIRE(result.nbRemovedFiles == 2);
+        REQUIRE(result.nbRemovedSections == 1);
+        REQUIRE(result.nbEvictedRecords == 0);
+        REQUIRE(result.sizeAfter < result.sizeBefore);
+        REQUIRE(result.sizeAfter == getFolderSize(folder));
+
+        REQUIRE_FALSE(std::filesystem::exists(outdatedPath));
+        REQUIRE_FALSE(std::filesystem::exists(invalidPath));
+        REQUIRE(std::filesystem::exists(otherPath));
+        REQUIRE(std::filesystem::exists(unrelatedPath));
+
+        Config config;
+        config.loadFromFile(textPath);
+        CacheConfig prunedCache{std::move(config)};
+        REQUIRE_FALSE(prunedCache.findTopGuesses("entropy_maximizer", 1, 2, "....."));
+        REQUIRE(prunedCache.findTopGuesses("other_solver", 1, 2, "....."));
+
+        // nothing left to do
+        result = compactCacheFolder(folder, solverVersions, std::nullopt);
+        REQUIRE(result.nbRemovedFiles == 0);
+        REQUIRE(result.nbRemovedSections == 0);
+        REQUIRE(result.sizeAfter == result.sizeBefore);
+    }
+
+    SECTION("Keeping the text caches of dictionaries missing on this host") {
+        // a text cache copied from another host, and one of a dictionary whose words changed
+        auto copiedPath = folder / "copied";
+        Config copiedConfig = textCache.getConfig();
+        copiedConfig.getRootSection().entries.at(0).value = std::filesystem::absolute(TEST_OUT_DIR / "missing_dictionary").string();
+        copiedConfig.writeToFile(copiedPath);
+
+        auto changedDictionaryPath = TEST_OUT_DIR / "changed_dictionary.txt";
+        std::filesystem::copy_file(TEST_WORDLE_WORDS, changedDictionaryPath, std::filesystem::copy_options::overwrite_existing);
+        auto changedPath = folder / "changed";
+        CacheConfig{changedDictionaryPath, *dictionary}.getConfig().writeToFile(changedPath);
+        std::ofstream{changedDictionaryPath, std::ios::app} << "\nzzzzz\n";
+
+        auto result = compactCacheFolder(folder, solverVersions, std::nullopt);
+        REQUIRE(result.nbRemovedFiles == 3);
+        REQUIRE(result.nbRemovedSections == 2);
+        REQUIRE_FALSE(std::filesystem::exists(changedPath));
+        REQUIRE(std::filesystem::exists(copiedPath));
+
+        // only the outdated solver section of the copied cache is removed
+        Config config;
+        config.loadFromFile(copiedPath);
+        CacheConfig prunedCache{std::move(config), dictionary.get()};
+        REQUIRE_FALSE(prunedCache.findTopGuesses("entropy_maximizer", 1, 2, "....."));
+        REQUIRE(prunedCache.findTopGuesses("other_solver", 1, 2, "....."));
+
+        std::filesystem::remove(changedDictionaryPath);
+    }
+
+    SECTION("Evicting the least recently used records") {
+        std::filesystem::remove(otherPath);
+        BinaryCache cache{folder / "wordle.entropy_maximizer.bin", dictionary, identity, "entropy_maximizer", 2};
+        cache.setTopGuesses("a....", 2, guesses);
+        cache.setTopGuesses("b....", 2, guesses);
+
+        // access times are in seconds
+        std::this_thread::sleep_for(std::chrono::milliseconds{1100});
+        cache.setTopGuesses("c....", 2, guesses);
+        REQUIRE(cache.findTopGuesses(2, "a...."));
+        cache.flushAccessTimes();
+
+        // a budget just below the size without outdated caches only evicts the oldest record
+        compactCacheFolder(folder, solverVersions, std::nullopt);
+        auto size = getFolderSize(folder);
+        auto result = compactCacheFolder(folder, solverVersions, size - 1);
+        REQUIRE(result.sizeBefore == size);
+        REQUIRE(result.sizeAfter < size);
+        REQUIRE(result.nbEvictedRecords == 1);
+
+        cache.reload();
+        REQUIRE(cache.size() == 2);
+        REQUIRE_FALSE(cache.contains("b...."));
+        REQUIRE(cache.contains("a...."));
+        REQUIRE(cache.contains("c...."));
+
+        // a budget below the text caches evicts everything
+        result = compactCacheFolder(folder, solverVersions, 0);
+        REQUIRE(result.nbEvictedRecords == 2);
+        cache.reload();
+        REQUIRE(cache.size() == 0);
+    }
+
+    std::filesystem::remove_all(folder);
+}
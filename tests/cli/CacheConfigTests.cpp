@@ -20,6 +20,7 @@
  */
 
 #include <Alphadocte/Exceptions.h>
+#include <Alphadocte/TxtDictionary.h>
 #include <catch2/catch.hpp>
 
 #include "../TestDefinitions.h"
@@ -67,20 +68,28 @@ static const Section CACHE1_SECTION{"root", {
 };
 
 TEST_CASE("Intialising an empty CacheConfig", "[config][CLI]") {
-    CacheConfig cache{TEST_WORDLE_WORDS};
+    TxtDictionary dictionary{TEST_WORDLE_WORDS};
+    REQUIRE(dictionary.load());
+
+    CacheConfig cache{TEST_WORDLE_WORDS, dictionary};
     auto timestamp = std::filesystem::last_write_time(TEST_WORDLE_WORDS);
 
     REQUIRE(cache.getConfig().getRootSection() == Section("root", {
             Entry("file_path", std::filesystem::absolute(TEST_WORDLE_WORDS).string()),
-            Entry("file_timestamp", std::to_string(timestamp.time_since_epoch().count()))
+            Entry("file_timestamp", std::to_string(timestamp.time_since_epoch().count())),
+            Entry("file_hash", std::to_string(dictionary.getContentHash()))
     }, {}));
     REQUIRE(cache.isCacheValid());
     REQUIRE(cache.getDictionaryPath().is_absolute());
     REQUIRE(cache.getDictionaryPath() == std::filesystem::absolute(TEST_WORDLE_WORDS));
     REQUIRE(cache.getDictionaryTimestamp() == timestamp);
+    REQUIRE(cache.getDictionaryHash() == dictionary.getContentHash());
+    REQUIRE(cache.findDictionaryPath() == cache.getDictionaryPath());
+    REQUIRE(cache.findDictionaryTimestamp() == timestamp);
+    REQUIRE(cache.findDictionaryHash() == dictionary.getContentHash());
 
     // calling constructor on a non existing file
-    REQUIRE_THROWS_MATCHES(CacheConfig(TEST_OUT_DIR / "invalid_file"), Exception, Message("Dictionary at " + (TEST_OUT_DIR / "invalid_file").string() + " is not a file."));
+    REQUIRE_THROWS_MATCHES(CacheConfig(TEST_OUT_DIR / "invalid_file", dictionary), Exception, Message("Dictionary at " + (TEST_OUT_DIR / "invalid_file").string() + " is not a file."));
 }
 
 TEST_CASE("Checking CacheConfig getters/setters", "[config][CLI]") {
@@ -146,6 +155,45 @@ TEST_CASE("Checking CacheConfig getters/setters", "[config][CLI]") {
         });
     }
 
+    SECTION("Retrieve and modify second guesses of the opening book") {
+        BookPosition position{".....", "raies", {HintType::WRONG, HintType::MISPLACED, HintType::CORRECT, HintType::WRONG, HintType::WRONG}};
+        REQUIRE_THROWS_MATCHES(cache.getSecondGuesses(SOLVER_NAME, SOLVER_VERSION, 1, position),
+                Exception, Message("Book section with position \"..... raies xovxx\" not found."));
+
+        // add section
+        REQUIRE_NOTHROW(cache.setSecondGuesses(SOLVER_NAME, SOLVER_VERSION, position, 2, std::vector{
+            std::pair("tarie"s, 3.5),
+            std::pair("taies"s, 3.25)
+        }));
+        REQUIRE(cache.getSecondGuesses(SOLVER_NAME, SOLVER_VERSION, 2, position) == std::vector{
+            std::pair("tarie"s, 3.5),
+            std::pair("taies"s, 3.25)
+        });
+        REQUIRE_THROWS_MATCHES(cache.getSecondGuesses(SOLVER_NAME, SOLVER_VERSION, 3, position),
+                Exception, Message("Not enough guesses in cache."));
+
+        // the top guesses of the template are untouched
+        REQUIRE(cache.getTopGuesses(SOLVER_NAME, SOLVER_VERSION, 1, ".....") == std::vector{
+            std::pair("raies"s, 6.342236)
+        });
+
+        // replace section
+        REQUIRE_NOTHROW(cache.setSecondGuesses(SOLVER_NAME, SOLVER_VERSION, position, 1, std::vector{
+            std::pair("taies"s, 3.25)
+        }));
+        REQUIRE(cache.getSecondGuesses(SOLVER_NAME, SOLVER_VERSION, 1, position) == std::vector{
+            std::pair("taies"s, 3.25)
+        });
+
+        // other hints are another position
+        REQUIRE(cache.findSecondGuesses(SOLVER_NAME, SOLVER_VERSION, 1, position));
+        position.hints.back() = HintType::CORRECT;
+        REQUIRE_THROWS_AS(cache.getSecondGuesses(SOLVER_NAME, SOLVER_VERSION, 1, position), Exception);
+        std::string reason;
+        REQUIRE_FALSE(cache.findSecondGuesses(SOLVER_NAME, SOLVER_VERSION, 1, position, &reason));
+        REQUIRE(reason == "Book section with position \"..... raies xovxv\" not found.");
+    }
+
     SECTION("Checking getter from invalid/incomplete cache.") {
         Config localConfig;
         Section& localSection = localConfig.getRootSection();
@@ -171,6 +219,20 @@ TEST_CASE("Checking CacheConfig getters/setters", "[config][CLI]") {
         REQUIRE_THROWS_MATCHES(cache.getTopGuesses(SOLVER_NAME, SOLVER_VERSION, 1, "......"),
                 Exception, Message("Guess section with template \"......\" not found."));
 
+        // same misses without exceptions
+        std::string reason;
+        REQUIRE_FALSE(cache.findTopGuesses(SOLVER_NAME, SOLVER_VERSION, 10, "....."));
+        REQUIRE_FALSE(cache.findTopGuesses(SOLVER_NAME, SOLVER_VERSION, 10, ".....", &reason));
+        REQUIRE(reason == "Not enough guesses in cache.");
+        REQUIRE_FALSE(cache.findTopGuesses(SOLVER_NAME, SOLVER_VERSION, 1, "......", &reason));
+        REQUIRE(reason == "Guess section with template \"......\" not found.");
+        REQUIRE_FALSE(cache.findTopGuesses(SOLVER_NAME, SOLVER_VERSION + 1, 1, ".....", &reason));
+        REQUIRE(reason == "Actual solver version is different from entry's solver_version : got 1, expected 2.");
+        REQUIRE_FALSE(cache.findTopGuesses("other_solver", SOLVER_VERSION, 1, ".....", &reason));
+        REQUIRE(reason == "Solver section with name \"other_solver\" not found.");
+        REQUIRE(cache.findTopGuesses(SOLVER_NAME, SOLVER_VERSION, 1, ".....")
+                == cache.getTopGuesses(SOLVER_NAME, SOLVER_VERSION, 1, "....."));
+
         // invalid guess in guess entry
 
         CHECK(guessSection.entries.at(2).name == "guess");
@@ -178,6 +240,7 @@ TEST_CASE("Checking CacheConfig getters/setters", "[config][CLI]") {
         REQUIRE_NOTHROW(cache.setConfig(localConfig));
         REQUIRE_THROWS_MATCHES(cache.getTopGuesses(SOLVER_NAME, SOLVER_VERSION, 1, "....."),
                 Exception, Message("Values of entry guess must be separated by a space."));
+        REQUIRE_FALSE(cache.findTopGuesses(SOLVER_NAME, SOLVER_VERSION, 1, "....."));
 
         // restore state
         cache.setConfig(config);
@@ -403,9 +466,68 @@ TEST_CASE("Checking CacheConfig getters/setters", "[config][CLI]") {
         REQUIRE_THROWS_MATCHES(cache.setConfig(invalidConfig), InvalidArgException, Message("Invalid configuration supplied as cache."));
         REQUIRE_THROWS_MATCHES(CacheConfig(invalidConfig), InvalidArgException, Message("Invalid configuration supplied as cache."));
         REQUIRE(cache.getConfig().getRootSection() == section);
+
+        // outdated timestamp and hash of another dictionary
+        TxtDictionary motusDictionary{TEST_MOTUS_WORDS};
+        REQUIRE(motusDictionary.load());
+        TxtDictionary wordleDictionary{TEST_WORDLE_WORDS};
+        REQUIRE(wordleDictionary.load());
+        invalidSection.entries.emplace_back(Entry{"file_hash", std::to_string(motusDictionary.getContentHash())});
+        REQUIRE_THROWS_MATCHES(cache.setConfig(invalidConfig, &wordleDictionary), InvalidArgException, Message("Invalid configuration supplied as cache."));
+        REQUIRE(cache.getConfig().getRootSection() == section);
+    }
+
+    SECTION("Keeping a cache of a touched dictionary") {
+        // the timestamp is outdated, but the words are the same
+        TxtDictionary dictionary{TEST_WORDLE_WORDS};
+        REQUIRE(dictionary.load());
+        Section touchedSection = CacheConfig{TEST_WORDLE_WORDS, dictionary}.getConfig().getRootSection();
+        touchedSection.entries.at(1).value = std::to_string(std::filesystem::file_time_type::min().time_since_epoch().count());
+        Config touchedConfig;
+        touchedConfig.setRootSection(touchedSection);
+
+        // the words are only compared with a loaded dictionary, the file is not read again
+        REQUIRE_THROWS_AS(cache.setConfig(touchedConfig), InvalidArgException);
+        REQUIRE_NOTHROW(cache.setConfig(touchedConfig, &dictionary));
+        REQUIRE(cache.isCacheValid(&dictionary));
+        REQUIRE_FALSE(cache.isCacheValid());
+    }
+
+    SECTION("Checking the words of the dictionary in use") {
+        TxtDictionary wordleDictionary{TEST_WORDLE_WORDS};
+        REQUIRE(wordleDictionary.load());
+        TxtDictionary motusDictionary{TEST_MOTUS_WORDS};
+        REQUIRE(motusDictionary.load());
+        Section copiedSection = CacheConfig{TEST_WORDLE_WORDS, wordleDictionary}.getConfig().getRootSection();
+        Config copiedConfig;
+        copiedConfig.setRootSection(copiedSection);
+
+        // the dictionary file is unchanged, but another dictionary is in use
+        REQUIRE_NOTHROW(cache.setConfig(copiedConfig));
+        REQUIRE_THROWS_AS(cache.setConfig(copiedConfig, &motusDictionary), InvalidArgException);
+
+        // the cache was copied to a host where the dictionary has another path
+        copiedSection.entries.at(0).value = std::filesystem::absolute(TEST_OUT_DIR / "missing_dictionary").string();
+        copiedConfig.setRootSection(copiedSection);
+        REQUIRE_THROWS_AS(cache.setConfig(copiedConfig), InvalidArgException);
+        REQUIRE_NOTHROW(cache.setConfig(copiedConfig, &wordleDictionary));
+        REQUIRE(cache.isCacheValid(&wordleDictionary));
     }
 }
 
+TEST_CASE("Formatting positions of the opening book", "[config][CLI]") {
+    BookPosition position{"a....", "arbre", {HintType::CORRECT, HintType::MISPLACED, HintType::WRONG, HintType::WRONG, HintType::CORRECT}};
+
+    REQUIRE(position.toString() == "a.... arbre voxxv");
+    REQUIRE(BookPosition::parse("a.... arbre voxxv") == position);
+    REQUIRE(BookPosition::parse(position.toString()) == position);
+
+    REQUIRE_THROWS_AS(BookPosition::parse("a.... arbre"), InvalidArgException);
+    REQUIRE_THROWS_AS(BookPosition::parse("a.... arbre voxx"), InvalidArgException);
+    REQUIRE_THROWS_AS(BookPosition::parse("a.... arbre voxxa"), InvalidArgException);
+    REQUIRE_THROWS_AS(BookPosition::parse("a.... arbres voxxvv"), InvalidArgException);
+}
+
 TEST_CASE("Loading/writing CacheConfig from/to file", "[config][CLI]") {
     Config config;
 
@@ -426,7 +548,9 @@ TEST_CASE("Loading/writing CacheConfig from/to file", "[config][CLI]") {
 }
 
 TEST_CASE("Populating a CacheConfig from scratch", "[config][CLI]") {
-    CacheConfig cache{TEST_WORDLE_WORDS};
+    TxtDictionary dictionary{TEST_WORDLE_WORDS};
+    REQUIRE(dictionary.load());
+    CacheConfig cache{TEST_WORDLE_WORDS, dictionary};
 
     cache.setTopGuesses(SOLVER_NAME, SOLVER_VERSION, ".....", 3, {
         {"raies"s, 6.342236}, {"taies"s, 6.299622}, {"tarie"s, 6.299398}
@@ -442,6 +566,8 @@ TEST_CASE("Populating a CacheConfig from scratch", "[config][CLI]") {
     Section expectedSection = CACHE1_SECTION;
     expectedSection.entries.at(0).value = std::filesystem::absolute(TEST_WORDLE_WORDS).string();
     expectedSection.entries.at(1).value = std::to_string(std::filesystem::last_write_time(TEST_WORDLE_WORDS).time_since_epoch().count());
+    expectedSection.entries.insert(std::begin(expectedSection.entries) + 2,
+            Entry{"file_hash", std::to_string(cache.getDictionaryHash())});
 
     REQUIRE(cache.getConfig().getRootSection() == expectedSection);
 }
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: cli/CacheWarmerTests.cpp
+ */
+
+#include <algorithm>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <Alphadocte/EntropyMaximizer.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Game.h>
+#include <Alphadocte/Solver.h>
+#include <catch2/catch.hpp>
+
+#include "../stubs/DictionaryStub.h"
+#include "../TestDefinitions.h"
+#include "../../apps/BinaryCache.h"
+#include "../../apps/CacheConfig.h"
+#include "../../apps/CacheWarmer.h"
+#include "../../apps/Parallel.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+using namespace std::string_literals;
+
+static const std::vector<std::string> WARMUP_WORDLIST{
+    "aimer", "arbre", "avion", "balle", "bateau", "blanc", "chat", "clou", "cube"
+};
+
+TEST_CASE("Listing the first templates of a dictionary", "[cache][CLI]") {
+    DictionaryStub dictionary{WARMUP_WORDLIST};
+
+    auto templates = listFirstTemplates(dictionary);
+    REQUIRE(std::size(templates) == 5);
+
+    // most expensive first
+    REQUIRE(templates[0].templateWord == ".....");
+    REQUIRE(templates[0].rulesType == RulesType::WORDLE);
+    REQUIRE(templates[0].nbCandidates == 5);
+    REQUIRE(templates[1].templateWord == "c...");
+    REQUIRE(templates[2].templateWord == "a....");
+    REQUIRE(templates[3].templateWord == "b....");
+    REQUIRE(templates[3].nbCandidates == 2);
+    REQUIRE(templates[4].templateWord == "b.....");
+    REQUIRE(templates[4].rulesType == RulesType::MOTUS);
+
+    auto motusTemplates = listFirstTemplates(dictionary, false);
+    REQUIRE(std::size(motusTemplates) == 4);
+    REQUIRE(motusTemplates[0].templateWord == "c...");
+}
+
+TEST_CASE("Warming up the first guesses cache", "[cache][CLI]") {
+    auto dictionary = std::make_shared<DictionaryStub>(WARMUP_WORDLIST);
+    auto motusSolver = createSolver("entropy_maximizer", createRules(RulesType::MOTUS, dictionary));
+
+    REQUIRE_NOTHROW(std::filesystem::create_directories(TEST_OUT_DIR));
+    auto path = TEST_OUT_DIR / "warm_cache.bin";
+    std::filesystem::remove(path);
+    BinaryCache cache{path, dictionary, DictionaryIdentity::compute("stub", *dictionary),
+            std::string(motusSolver->getSolverName()), motusSolver->getSolverVersion()};
+
+    WarmupOptions options;
+    options.nbGuesses = 2;
+    options.nbThreads = 2;
+
+    SECTION("Computing every template") {
+        // callbacks come from the worker threads, check them afterwards
+        std::vector<std::string> computed;
+        bool validProgress{true};
+        auto result = warmCache(cache, dictionary, options,
+                [&](std::string_view templateWord, std::string_view bestGuess, size_t nbDone, size_t nbToCompute) {
+            validProgress = validProgress && nbDone == std::size(computed) + 1 && nbToCompute == 5 && !bestGuess.empty();
+            computed.emplace_back(templateWord);
+        });
+
+        REQUIRE(result.nbTemplates == 5);
+        REQUIRE(result.nbCached == 0);
+        REQUIRE(result.nbComputed == 5);
+        REQUIRE(result.nbThreads == 2);
+        REQUIRE(std::size(computed) == 5);
+        REQUIRE(validProgress);
+        REQUIRE(cache.size() == 5);
+
+        // same guesses as the solver
+        motusSolver->setTemplate("a....");
+        REQUIRE(cache.getTopGuesses(2, "a....") == motusSolver->computeNextGuesses(2));
+
+        // nothing left to compute
+        auto again = warmCache(cache, dictionary, options);
+        REQUIRE(again.nbCached == 5);
+        REQUIRE(again.nbComputed == 0);
+    }
+
+    SECTION("Resuming an interrupted warmup") {
+        motusSolver->setTemplate("c...");
+        cache.setTopGuesses("c...", 2, motusSolver->computeNextGuesses(2));
+
+        options.withWordle = false;
+        auto result = warmCache(cache, dictionary, options);
+        REQUIRE(result.nbTemplates == 4);
+        REQUIRE(result.nbCached == 1);
+        REQUIRE(result.nbComputed == 3);
+        REQUIRE(cache.size() == 4);
+        REQUIRE_FALSE(cache.contains("....."));
+
+        // asking for more guesses computes them again
+        options.nbGuesses = 3;
+        REQUIRE(warmCache(cache, dictionary, options).nbComputed == 4);
+    }
+
+    SECTION("Filling the opening book") {
+        options.withWordle = false;
+
+        // nothing to do before the first guesses are cached
+        REQUIRE(warmOpeningBook(cache, dictionary, options).nbTemplates == 0);
+
+        warmCache(cache, dictionary, options);
+        auto result = warmOpeningBook(cache, dictionary, options);
+        REQUIRE(result.nbTemplates > 0);
+        REQUIRE(result.nbCached == 0);
+        REQUIRE(result.nbComputed == result.nbTemplates);
+        REQUIRE(std::size(cache.getBookPositions()) == result.nbTemplates);
+        REQUIRE(std::size(cache.getTemplates()) == 4);
+
+        // one position per distinct hints of the first guess, except the winning ones
+        auto firstGuess = cache.getTopGuesses(1, "a....").front().first;
+        std::set<std::vector<HintType>> expectedHints;
+        for (const auto& word : {"aimer"s, "arbre"s, "avion"s}) {
+            if (word != firstGuess)
+                expectedHints.insert(Game::computeHints(firstGuess, word));
+        }
+
+        std::set<std::vector<HintType>> bookHints;
+        for (const auto& position : cache.getBookPositions()) {
+            if (position.templateWord == "a....") {
+                REQUIRE(position.firstGuess == firstGuess);
+                bookHints.insert(position.hints);
+
+                // same guesses as the solver
+                motusSolver->setTemplate("a....");
+                motusSolver->addHint(firstGuess, position.hints);
+                REQUIRE(cache.getSecondGuesses(2, position) == motusSolver->computeNextGuesses(2));
+            }
+        }
+        REQUIRE(bookHints == expectedHints);
+
+        // nothing left to compute
+        auto again = warmOpeningBook(cache, dictionary, options);
+        REQUIRE(again.nbCached == result.nbTemplates);
+        REQUIRE(again.nbComputed == 0);
+    }
+
+    SECTION("Sharing the cores with the solvers") {
+        // a tuning which would start 4 threads for each computation
+        auto defaultTuning = EntropyMaximizer::getDefaultTuning();
+        EntropyMaximizer::setDefaultTuning({.histogram = defaultTuning.histogram, .nbThreads = 4, .minParallelPatterns = 0});
+        auto result = warmCache(cache, dictionary, options);
+        auto bookResult = warmOpeningBook(cache, dictionary, options);
+        EntropyMaximizer::setDefaultTuning(defaultTuning);
+
+        // the warmup threads times the solver threads stay within the cores
+        auto maxThreads = std::max(defaultThreadCount(), options.nbThreads);
+        REQUIRE(result.maxSolverThreads >= 1);
+        REQUIRE(result.nbThreads * result.maxSolverThreads <= maxThreads);
+        REQUIRE(bookResult.nbComputed > 0);
+        REQUIRE(bookResult.nbThreads * bookResult.maxSolverThreads <= maxThreads);
+    }
+
+    SECTION("Invalid solver") {
+        options.solverName = "unknown";
+        REQUIRE_THROWS_AS(warmCache(cache, dictionary, options), InvalidArgException);
+    }
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: cli/CommandLineTests.cpp
+ */
+
+#include <Alphadocte/Exceptions.h>
+#include <catch2/catch.hpp>
+
+#include "../../apps/CommandLine.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+TEST_CASE("Check command line parsing", "[commandline][CLI]") {
+    const char* const argv[] = {"program", "--dictionary=EN", "first", "--json", "--threads=4", "second", "--ratio=0.5"};
+    CommandLine args{static_cast<int>(std::size(argv)), argv};
+
+    REQUIRE(args.getProgramName() == "program");
+    REQUIRE(args.getPositionalArguments() == std::vector<std::string>{"first", "second"});
+
+    REQUIRE(args.has("dictionary"));
+    REQUIRE(args.has("json"));
+    REQUIRE_FALSE(args.has("output"));
+
+    REQUIRE(args.getString("dictionary") == "EN");
+    REQUIRE(args.getString("json", "default") == "");
+    REQUIRE(args.getString("output", "default") == "default");
+
+    REQUIRE(args.getUnsigned("threads", 1) == 4);
+    REQUIRE(args.getUnsigned("sample", 12) == 12);
+    REQUIRE_THROWS_AS(args.getUnsigned("dictionary", 0), InvalidArgException);
+    REQUIRE_THROWS_AS(args.getUnsigned("json", 0), InvalidArgException);
+
+    REQUIRE(args.getDouble("ratio", 1.) == 0.5);
+    REQUIRE(args.getDouble("tolerance", 1.5) == 1.5);
+    REQUIRE_THROWS_AS(args.getDouble("dictionary", 0), InvalidArgException);
+
+    REQUIRE_NOTHROW(args.checkOptions({"dictionary", "json", "threads", "ratio", "output"}));
+    REQUIRE_THROWS_AS(args.checkOptions({"dictionary", "json", "threads"}), InvalidArgException);
+
+    const char* const badArgv[] = {"program", "--=value"};
+    REQUIRE_THROWS_AS(CommandLine(static_cast<int>(std::size(badArgv)), badArgv), InvalidArgException);
+}
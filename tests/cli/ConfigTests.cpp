@@ -19,6 +19,10 @@
  * File: cli/ConfigTests.cpp
  */
 
+#include <fstream>
+#include <string_view>
+#include <utility>
+
 #include <Alphadocte/Exceptions.h>
 #include <catch2/catch.hpp>
 
@@ -85,6 +89,12 @@ TEST_CASE("Test changing root section", "[config][CLI]") {
     };
     config.setRootSection(s2);
     REQUIRE(config.getRootSection() == s2);
+
+    // the sections and entries, then the indexes built by the lookups
+    auto retainedBytes = config.getRetainedBytes();
+    REQUIRE(retainedBytes >= 2 * sizeof(Section) + 2 * sizeof(Entry));
+    REQUIRE(config.findSection(config.getRootSection(), "ss1", "e2", "v2") != nullptr);
+    REQUIRE(config.getRetainedBytes() > retainedBytes);
 }
 
 TEST_CASE("Loading config from files", "[config][CLI]") {
@@ -141,3 +151,124 @@ TEST_CASE("Writing config files", "[config][CLI]") {
         REQUIRE(files_identical(outputFile, TEST_CONFIG_EXAMPLE1_COPY));
     }
 }
+
+TEST_CASE("Looking up indexed sections", "[config][CLI]") {
+    Config config;
+    config.setRootSection(CONFIG1_SECTION);
+    Section& root = config.getRootSection();
+
+    // lookups by name and key entry
+    Section* solverSection = config.findSection(root, "solver_entry", "solver_name", "xxxxx");
+    REQUIRE(solverSection == &root.sections.at(0));
+    REQUIRE(config.findSection(root, "solver_entry", "solver_name", "yyyyy") == nullptr);
+    REQUIRE(config.findSection(root, "guess_entry", "solver_name", "xxxxx") == nullptr);
+    REQUIRE(config.findSection(root, "solver_entry", "solver_version", "1") == solverSection);
+
+    // lookups of entries
+    REQUIRE(findEntry(*solverSection, "solver_version") == &solverSection->entries.at(1));
+    REQUIRE(findEntry(std::as_const(*solverSection), "solver_name")->value == "xxxxx");
+    REQUIRE(findEntry(*solverSection, "template") == nullptr);
+
+    const Section* guessSection = config.findSection(*solverSection, "guess_entry", "template", ".....");
+    REQUIRE(guessSection == &solverSection->sections.at(0));
+
+    SECTION("Adding and removing sections") {
+        for (int i = 0; i < 1000; i++) {
+            config.addSection(*solverSection, Section{"guess_entry", {Entry{"template", std::to_string(i) + "...."}}, {}});
+        }
+
+        // the solver section is moved when the root section grows
+        config.addSection(root, Section{"solver_entry", {Entry{"solver_name", "yyyyy"}}, {}});
+        for (int i = 0; i < 10; i++) {
+            config.addSection(root, Section{"other", {}, {}});
+        }
+        solverSection = config.findSection(root, "solver_entry", "solver_name", "xxxxx");
+        REQUIRE(solverSection == &root.sections.at(0));
+        REQUIRE(config.findSection(root, "solver_entry", "solver_name", "yyyyy") == &root.sections.at(1));
+
+        for (int i = 0; i < 1000; i++) {
+            const Section* section = config.findSection(*solverSection, "guess_entry", "template", std::to_string(i) + "....");
+            REQUIRE(section == &solverSection->sections.at(i + 1));
+        }
+
+        config.removeSection(*solverSection, solverSection->sections.at(1));
+        REQUIRE(config.findSection(*solverSection, "guess_entry", "template", "0....") == nullptr);
+        REQUIRE(config.findSection(*solverSection, "guess_entry", "template", "1....") == &solverSection->sections.at(1));
+        REQUIRE(config.findSection(*solverSection, "guess_entry", "template", ".....") == &solverSection->sections.at(0));
+
+        config.removeSection(root, root.sections.at(0));
+        REQUIRE(config.findSection(root, "solver_entry", "solver_name", "xxxxx") == nullptr);
+        REQUIRE(config.findSection(root, "solver_entry", "solver_name", "yyyyy") == &root.sections.at(0));
+
+        REQUIRE_THROWS_AS(config.removeSection(root, CONFIG1_SECTION), InvalidArgException);
+    }
+
+    SECTION("Editing sections directly") {
+        // appended sections are indexed
+        solverSection->sections.push_back(Section{"guess_entry", {Entry{"template", "a...."}}, {}});
+        REQUIRE(config.findSection(*solverSection, "guess_entry", "template", "a....") == &solverSection->sections.back());
+
+        // the first section with a key is returned
+        solverSection->sections.push_back(Section{"guess_entry", {Entry{"template", "a...."}}, {}});
+        REQUIRE(config.findSection(*solverSection, "guess_entry", "template", "a....") == &solverSection->sections.at(1));
+
+        // edited sections are detected when found
+        solverSection->sections.at(1).entries.at(0).value = "b....";
+        REQUIRE(config.findSection(*solverSection, "guess_entry", "template", "a....") == &solverSection->sections.at(2));
+
+        // other edits require to invalidate indexes
+        solverSection->sections.at(0).entries.at(0).value = "c....";
+        config.invalidateIndexes();
+        REQUIRE(config.findSection(*solverSection, "guess_entry", "template", "c....") == &solverSection->sections.at(0));
+        REQUIRE(config.findSection(*solverSection, "guess_entry", "template", "b....") == &solverSection->sections.at(1));
+    }
+
+    SECTION("Copying configs") {
+        Config copy{config};
+        REQUIRE(copy.findSection(copy.getRootSection(), "solver_entry", "solver_name", "xxxxx") == &copy.getRootSection().sections.at(0));
+
+        config.setRootSection(Section{"root", {}, {}});
+        REQUIRE(config.findSection(config.getRootSection(), "solver_entry", "solver_name", "xxxxx") == nullptr);
+        REQUIRE(copy.findSection(copy.getRootSection(), "solver_entry", "solver_name", "xxxxx") != nullptr);
+    }
+}
+
+TEST_CASE("Parsing edge cases of config files", "[config][CLI]") {
+    REQUIRE_NOTHROW(std::filesystem::create_directories(TEST_OUT_DIR));
+    std::filesystem::path inputFile = TEST_OUT_DIR / "edge_config.txt";
+    Config config;
+
+    auto load = [&config, &inputFile](std::string_view content) {
+        {
+            std::ofstream file{inputFile, std::ios::binary};
+            file << content;
+        }
+        config.loadFromFile(inputFile);
+        return config.getRootSection();
+    };
+
+    SECTION("Empty files") {
+        REQUIRE(load("") == Section{"root", {}, {}});
+        REQUIRE(load("\n  \n# comment\n") == Section{"root", {}, {}});
+    }
+
+    SECTION("Keys and values") {
+        // keys and keywords are case insensitive, values keep their whitespaces but not comments
+        REQUIRE(load("KEY  two words  # comment\nBegin Sec\n\tother value\nEND Sec") == Section{"root",
+                {Entry{"key", " two words  "}},
+                {Section{"Sec", {Entry{"other", "value"}}, {}}}
+        });
+
+        // line breaks of Windows are kept in values
+        REQUIRE(load("key value\r\n") == Section{"root", {Entry{"key", "value\r"}}, {}});
+    }
+
+    SECTION("Errors") {
+        REQUIRE_THROWS_MATCHES(load("begin\n"), Exception, Message("Line 1: expected section name after begin, got nothing."));
+        REQUIRE_THROWS_MATCHES(load("\nbegin a b\nend a"), Exception, Message("Line 2: got b after section name, expected nothing."));
+        REQUIRE_THROWS_MATCHES(load("begin a\nend\n"), Exception, Message("Line 2: missing section name after end."));
+        REQUIRE_THROWS_MATCHES(load("end a\n"), Exception, Message("Line 1: got an end of section outside of a section."));
+        REQUIRE_THROWS_MATCHES(load("key\tvalue\nkey#value"), Exception, Message("Line 2: key key#value must have a value associated."));
+        REQUIRE_THROWS_MATCHES(load("key value\nkey\rvalue"), Exception, Message("Line 2: key key must have a space after."));
+    }
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: cli/DictionaryGeneratorTests.cpp
+ */
+
+#include <fstream>
+#include <set>
+
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/TxtDictionary.h>
+#include <catch2/catch.hpp>
+
+#include "../../apps/DictionaryGenerator.h"
+#include "../TestDefinitions.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+TEST_CASE("Check length distribution parsing", "[generator][CLI]") {
+    REQUIRE(parseLengthWeights("5") == std::map<word_size, double>{{5, 1.}});
+    REQUIRE(parseLengthWeights("4-6") == std::map<word_size, double>{{4, 1.}, {5, 1.}, {6, 1.}});
+    REQUIRE(parseLengthWeights("5:2,7-8:0.5") == std::map<word_size, double>{{5, 2.}, {7, 0.5}, {8, 0.5}});
+
+    REQUIRE_THROWS_AS(parseLengthWeights(""), InvalidArgException);
+    REQUIRE_THROWS_AS(parseLengthWeights("0"), InvalidArgException);
+    REQUIRE_THROWS_AS(parseLengthWeights("five"), InvalidArgException);
+    REQUIRE_THROWS_AS(parseLengthWeights("5:-1"), InvalidArgException);
+    REQUIRE_THROWS_AS(parseLengthWeights("5:x"), InvalidArgException);
+    REQUIRE_THROWS_AS(parseLengthWeights("100"), InvalidArgException);
+}
+
+TEST_CASE("Check synthetic dictionary generation", "[generator][CLI]") {
+    GeneratorOptions options;
+    options.nbWords = 2000;
+    options.lengthWeights = {{4, 1.}, {7, 3.}};
+
+    auto words = generateWords(options);
+    REQUIRE(std::size(words) == options.nbWords);
+    REQUIRE(std::is_sorted(std::cbegin(words), std::cend(words)));
+    REQUIRE(std::adjacent_find(std::cbegin(words), std::cend(words)) == std::cend(words));
+
+    size_t nbLength4{};
+    for (const auto& word : words) {
+        REQUIRE((std::size(word) == 4 || std::size(word) == 7));
+        REQUIRE(std::all_of(std::cbegin(word), std::cend(word), [](char c) { return c >= 'a' && c <= 'z'; }));
+        nbLength4 += std::size(word) == 4;
+    }
+    // about a quarter of the words
+    REQUIRE(nbLength4 > 350);
+    REQUIRE(nbLength4 < 650);
+
+    SECTION("Reproducibility") {
+        REQUIRE(generateWords(options) == words);
+
+        options.seed++;
+        REQUIRE(generateWords(options) != words);
+    }
+
+    SECTION("Duplicate letters") {
+        options.nbWords = 20;
+        options.lengthWeights = {{5, 1.}};
+        options.duplicateRate = 1.;
+
+        for (const auto& word : generateWords(options)) {
+            REQUIRE(std::set<char>(std::cbegin(word), std::cend(word)).size() == 1);
+        }
+
+        // only 26 words of 5 identical letters
+        options.nbWords = 27;
+        REQUIRE_THROWS_AS(generateWords(options), Exception);
+    }
+
+    SECTION("Invalid options") {
+        options.duplicateRate = 2.;
+        REQUIRE_THROWS_AS(generateWords(options), InvalidArgException);
+
+        options.duplicateRate = 0.;
+        options.letterSkew = -1.;
+        REQUIRE_THROWS_AS(generateWords(options), InvalidArgException);
+
+        options.letterSkew = 0.;
+        options.lengthWeights = {{5, 0.}};
+        REQUIRE_THROWS_AS(generateWords(options), InvalidArgException);
+    }
+
+    SECTION("Load generated dictionary") {
+        REQUIRE_NOTHROW(std::filesystem::create_directories(TEST_OUT_DIR));
+        auto path = TEST_OUT_DIR / "synthetic_wordlist.txt";
+        {
+            std::ofstream file{path};
+            writeTxtDictionary(file, words);
+        }
+
+        TxtDictionary dictionary{path};
+        REQUIRE(dictionary.load());
+        REQUIRE(dictionary.getAllWords() == words);
+    }
+}
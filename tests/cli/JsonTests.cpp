@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: JsonTests.cpp
+ */
+
+#include <Alphadocte/Exceptions.h>
+#include <catch2/catch.hpp>
+
+#include "../../apps/Json.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+TEST_CASE("Quoting JSON strings", "[json][CLI]") {
+    REQUIRE(quoteJson("") == "\"\"");
+    REQUIRE(quoteJson("abc") == "\"abc\"");
+    REQUIRE(quoteJson("a\"b\\c\nd\te") == "\"a\\\"b\\\\c\\nd\\te\"");
+    REQUIRE(quoteJson(std::string(1, '\x01')) == "\"\\u0001\"");
+    REQUIRE(quoteJson("é") == "\"é\"");
+}
+
+TEST_CASE("Parsing flat JSON objects", "[json][CLI]") {
+    SECTION("Members of every type") {
+        auto object = parseJsonObject(R"( { "op" : "top", "n":10, "score":-1.5e2, "ok":true, "no":false, "id":null } )");
+        REQUIRE(std::size(object) == 6);
+        REQUIRE(object.at("op") == JsonValue{JsonValue::Type::STRING, "top"});
+        REQUIRE(object.at("n") == JsonValue{JsonValue::Type::NUMBER, "10"});
+        REQUIRE(object.at("score") == JsonValue{JsonValue::Type::NUMBER, "-1.5e2"});
+        REQUIRE(object.at("ok") == JsonValue{JsonValue::Type::BOOLEAN, "true"});
+        REQUIRE(object.at("no") == JsonValue{JsonValue::Type::BOOLEAN, "false"});
+        REQUIRE(object.at("id") == JsonValue{JsonValue::Type::NULL_VALUE, "null"});
+    }
+
+    SECTION("Empty object and repeated members") {
+        REQUIRE(parseJsonObject("{}").empty());
+        REQUIRE(parseJsonObject(R"({"a":"1","a":"2"})").at("a").text == "2");
+    }
+
+    SECTION("Escaped strings") {
+        auto object = parseJsonObject(R"({"text":"a\"b\\c\/d\n\u00e9\ud83d\ude00"})");
+        REQUIRE(object.at("text").text == "a\"b\\c/d\né\xF0\x9F\x98\x80");
+
+        // quoted strings are read back
+        std::string str{"line\n\"quoted\"\t\x01"};
+        REQUIRE(parseJsonObject("{\"s\":" + quoteJson(str) + "}").at("s").text == str);
+    }
+
+    SECTION("Invalid objects") {
+        REQUIRE_THROWS_AS(parseJsonObject(""), InvalidArgException);
+        REQUIRE_THROWS_AS(parseJsonObject("[]"), InvalidArgException);
+        REQUIRE_THROWS_AS(parseJsonObject("{"), InvalidArgException);
+        REQUIRE_THROWS_AS(parseJsonObject(R"({"a":1,})"), InvalidArgException);
+        REQUIRE_THROWS_AS(parseJsonObject(R"({"a" 1})"), InvalidArgException);
+        REQUIRE_THROWS_AS(parseJsonObject(R"({a:1})"), InvalidArgException);
+        REQUIRE_THROWS_AS(parseJsonObject(R"({"a":[1]})"), InvalidArgException);
+        REQUIRE_THROWS_AS(parseJsonObject(R"({"a":{}})"), InvalidArgException);
+        REQUIRE_THROWS_AS(parseJsonObject(R"({"a":1.2.3})"), InvalidArgException);
+        REQUIRE_THROWS_AS(parseJsonObject(R"({"a":tru})"), InvalidArgException);
+        REQUIRE_THROWS_AS(parseJsonObject(R"({"a":"unterminated})"), InvalidArgException);
+        REQUIRE_THROWS_AS(parseJsonObject(R"({"a":"\x"})"), InvalidArgException);
+        REQUIRE_THROWS_AS(parseJsonObject(R"({"a":"\ud83d"})"), InvalidArgException);
+        REQUIRE_THROWS_AS(parseJsonObject(R"({"a":1} extra)"), InvalidArgException);
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: MetricsHttpServerTests.cpp
+ */
+
+#include <Alphadocte/Alphadocte.h>
+
+#if defined ALPHADOCTE_OS_LINUX
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Metrics.h>
+#include <catch2/catch.hpp>
+
+#include "../../apps/MetricsHttpServer.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+/*
+ * Send a raw HTTP request to the local port, and return the whole response.
+ */
+static std::string sendHttpRequest(std::uint16_t port, const std::string& request) {
+    int client = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    REQUIRE(::connect(client, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+    REQUIRE(::send(client, request.data(), std::size(request), MSG_NOSIGNAL) == static_cast<ssize_t>(std::size(request)));
+
+    // the server closes the connection after its response
+    std::string response;
+    char chunk[4096];
+    ssize_t received;
+    while ((received = ::recv(client, chunk, sizeof(chunk), 0)) > 0)
+        response.append(chunk, static_cast<size_t>(received));
+
+    ::close(client);
+    return response;
+}
+
+TEST_CASE("Serving metrics over HTTP", "[metrics][CLI]") {
+    MetricsRegistry registry;
+    registry.registerCounter("test_requests_total", "Number of requests.").add(2);
+
+    MetricsHttpServer server{0, &registry};
+    REQUIRE(server.getPort() != 0);
+    REQUIRE_THROWS_AS(MetricsHttpServer(server.getPort(), &registry), Exception);
+
+    std::string body = "# HELP test_requests_total Number of requests.\n"
+                       "# TYPE test_requests_total counter\n"
+                       "test_requests_total 2\n";
+    auto response = sendHttpRequest(server.getPort(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    REQUIRE(response.starts_with("HTTP/1.1 200 OK\r\n"));
+    REQUIRE(response.find("Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n") != std::string::npos);
+    REQUIRE(response.find("Content-Length: " + std::to_string(std::size(body)) + "\r\n") != std::string::npos);
+    REQUIRE(response.ends_with("\r\n\r\n" + body));
+
+    // metrics are read on each request
+    registry.registerCounter("test_requests_total", "").add();
+    REQUIRE(sendHttpRequest(server.getPort(), "GET /metrics?x=1 HTTP/1.0\r\n\r\n").ends_with("test_requests_total 3\n"));
+
+    REQUIRE(sendHttpRequest(server.getPort(), "HEAD /metrics HTTP/1.1\r\n\r\n").ends_with("\r\n\r\n"));
+    REQUIRE(sendHttpRequest(server.getPort(), "GET / HTTP/1.1\r\n\r\n").starts_with("HTTP/1.1 404 "));
+    REQUIRE(sendHttpRequest(server.getPort(), "POST /metrics HTTP/1.1\r\n\r\n").starts_with("HTTP/1.1 405 "));
+    REQUIRE(sendHttpRequest(server.getPort(), "nonsense\r\n\r\n").starts_with("HTTP/1.1 400 "));
+}
+#endif
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: PerfCountersTests.cpp
+ */
+
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+#include "../../apps/PerfCounters.h"
+
+using namespace Alphadocte::CLI;
+
+TEST_CASE("Check hardware counts", "[perf][CLI]") {
+    PerfCounts counts;
+    REQUIRE_FALSE(counts.hasCounts());
+    REQUIRE_FALSE(counts.getIpc());
+
+    counts.counts[static_cast<size_t>(PerfEvent::CYCLES)] = 200;
+    counts.counts[static_cast<size_t>(PerfEvent::INSTRUCTIONS)] = 300;
+    REQUIRE(counts.hasCounts());
+    REQUIRE(*counts.getIpc() == Approx(1.5));
+
+    PerfCounts other;
+    other.counts[static_cast<size_t>(PerfEvent::CYCLES)] = 100;
+    other.counts[static_cast<size_t>(PerfEvent::BRANCH_MISSES)] = 10;
+    counts.add(other);
+    REQUIRE(*counts.get(PerfEvent::CYCLES) == Approx(300));
+    REQUIRE(*counts.get(PerfEvent::BRANCH_MISSES) == Approx(10));
+    REQUIRE_FALSE(counts.get(PerfEvent::CACHE_MISSES));
+
+    auto perUnit = counts.divide(10);
+    REQUIRE(*perUnit.get(PerfEvent::CYCLES) == Approx(30));
+    REQUIRE(*perUnit.getIpc() == Approx(1));
+    REQUIRE_FALSE(counts.divide(0).hasCounts());
+
+    REQUIRE(PerfCounters::getEventName(PerfEvent::CACHE_MISSES) == "cache_misses");
+}
+
+TEST_CASE("Check hardware counters", "[perf][CLI]") {
+    // counters are often unavailable (virtual machines, containers), which must not be an error
+    PerfCounters counters;
+    counters.start();
+
+    volatile unsigned long sum{};
+    auto work = [&sum]() {
+        for (unsigned long i = 0; i < 1'000'000; i++)
+            sum = sum + i;
+    };
+    work();
+    std::thread worker{work};
+    worker.join();
+
+    auto counts = counters.getCounts();
+    if (!counters.isAvailable()) {
+        REQUIRE_FALSE(counters.getUnavailableReason().empty());
+        REQUIRE_FALSE(counts.hasCounts());
+        return;
+    }
+
+    // the worker thread is counted too
+    if (auto instructions = counts.get(PerfEvent::INSTRUCTIONS))
+        REQUIRE(*instructions >= 2'000'000);
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: SessionManagerTests.cpp
+ */
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <Alphadocte/EntropyMaximizer.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Game.h>
+#include <Alphadocte/WordleGameRules.h>
+#include <Alphadocte/WorkloadRecorder.h>
+#include <catch2/catch.hpp>
+
+#include "../TestDefinitions.h"
+#include "../../apps/Common.h"
+#include "../../apps/SessionManager.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+static std::unique_ptr<Solver> createTestSolver(std::shared_ptr<IGameRules> rules) {
+    return std::make_unique<EntropyMaximizer>(std::move(rules));
+}
+
+TEST_CASE("Managing the memory of game sessions", "[service][CLI]") {
+    auto rules = std::make_shared<WordleGameRules>(getWordleDict());
+    const auto& words = rules->getDictionary()->getAllWords();
+
+    // the same game, played by a local solver
+    EntropyMaximizer solver{rules};
+    solver.setTemplate(".....");
+    auto solverSize = solver.getRetainedBytes();
+    REQUIRE(solverSize > std::size(solver.getPotentialGuesses()) * sizeof(std::string_view));
+
+    // one resident solver at most
+    SessionManager sessions{createTestSolver, solverSize + solverSize / 2};
+    REQUIRE(sessions.getMemoryBudget() == solverSize + solverSize / 2);
+    REQUIRE(sessions.getSessionCount() == 0);
+    REQUIRE(sessions.getMemoryUsage() == 0);
+
+    auto first = sessions.createSession(rules, ".....");
+    REQUIRE(first == 1);
+    REQUIRE(sessions.getResidentSessionCount() == 1);
+    auto residentInfo = sessions.findSessionInfo(first);
+    REQUIRE(residentInfo);
+    REQUIRE(residentInfo->resident);
+    REQUIRE(residentInfo->memoryUsage > solverSize);
+    REQUIRE(sessions.getMemoryUsage() == residentInfo->memoryUsage);
+
+    const auto& guess = words.at(0);
+    auto hints = Game::computeHints(guess, words.at(3));
+    solver.addHint(guess, hints);
+
+    SECTION("Evicting idle sessions") {
+        auto second = sessions.createSession(rules, ".....");
+        REQUIRE(sessions.getSessionCount() == 2);
+        REQUIRE(sessions.getResidentSessionCount() == 1);
+
+        auto evictedInfo = sessions.findSessionInfo(first);
+        REQUIRE(evictedInfo);
+        REQUIRE_FALSE(evictedInfo->resident);
+        REQUIRE(evictedInfo->memoryUsage < residentInfo->memoryUsage / 10);
+        REQUIRE(sessions.findSessionInfo(second)->resident);
+
+        // the evicted session is restored, and the other one is evicted in turn
+        REQUIRE(sessions.addHint(first, guess, hints) == std::size(solver.getPotentialSolutions()));
+        REQUIRE(sessions.findSessionInfo(first)->resident);
+        REQUIRE_FALSE(sessions.findSessionInfo(second)->resident);
+
+        REQUIRE(sessions.evictIdleSessions() == 1);
+        REQUIRE(sessions.getResidentSessionCount() == 0);
+        sessions.useSession(first, [&](const Solver& restored, std::string_view state) {
+            REQUIRE(state == "..... " + guess + ' ' + formatHints(hints));
+            REQUIRE(restored.getTemplate() == solver.getTemplate());
+            REQUIRE(restored.getHints() == solver.getHints());
+            REQUIRE(restored.getPotentialSolutions() == solver.getPotentialSolutions());
+        });
+
+        auto infos = sessions.getSessionInfos();
+        REQUIRE(std::size(infos) == 2);
+        REQUIRE(infos[0].id == first);
+        REQUIRE(infos[1].id == second);
+        REQUIRE(sessions.getMemoryUsage() == infos[0].memoryUsage + infos[1].memoryUsage);
+    }
+
+    SECTION("Rejecting invalid requests") {
+        REQUIRE_THROWS_AS(sessions.createSession(rules, "ab1.."), InvalidArgException);
+        REQUIRE_THROWS_AS(sessions.addHint(first, "zzzzz", hints), InvalidArgException);
+        REQUIRE_THROWS_AS(sessions.addHint(42, guess, hints), InvalidArgException);
+        REQUIRE_THROWS_AS(sessions.useSession(42, [](const Solver&, std::string_view) {}), InvalidArgException);
+        REQUIRE_THROWS_AS(SessionManager(SessionManager::SolverFactory{}, 0), InvalidArgException);
+        REQUIRE_FALSE(sessions.findSessionInfo(42));
+
+        // the session is left unchanged
+        REQUIRE(sessions.getSessionCount() == 1);
+        sessions.useSession(first, [](const Solver& current, std::string_view state) {
+            REQUIRE(state == ".....");
+            REQUIRE(current.getHints().empty());
+        });
+    }
+
+    SECTION("Ending sessions") {
+        auto second = sessions.createSession(rules, ".....");
+        REQUIRE(sessions.endSession(first));
+        REQUIRE_FALSE(sessions.endSession(first));
+        REQUIRE(sessions.endSession(second));
+        REQUIRE(sessions.getSessionCount() == 0);
+        REQUIRE(sessions.getResidentSessionCount() == 0);
+        REQUIRE(sessions.getMemoryUsage() == 0);
+    }
+}
+
+TEST_CASE("Recording the games of evicted sessions", "[service][CLI]") {
+    auto rules = std::make_shared<WordleGameRules>(getWordleDict());
+    const auto& words = rules->getDictionary()->getAllWords();
+    std::ostringstream output;
+    auto recorder = std::make_shared<WorkloadRecorder>(output);
+
+    // every solver shares the recorder, and at most one session is resident
+    SessionManager sessions{[&](std::shared_ptr<IGameRules> gameRules) {
+        auto solver = createTestSolver(std::move(gameRules));
+        solver->setRecorder(recorder);
+        return solver;
+    }, 1};
+
+    auto id = sessions.createSession(rules, ".....");
+    const auto& guess = words.at(0);
+    auto hints = Game::computeHints(guess, words.at(3));
+    sessions.addHint(id, guess, hints);
+    REQUIRE(sessions.evictIdleSessions() == 1);
+
+    // restoring the session replays its hints without recording them again
+    sessions.useSession(id, [](const Solver& restored, std::string_view) {
+        REQUIRE(restored.getRecordedGame() == 1);
+    });
+    REQUIRE(recorder->getGameCount() == 1);
+
+    recorder->flush();
+    auto log = output.str();
+    REQUIRE(log.find("\ngame ") == log.rfind("\ngame "));
+    REQUIRE(log.find("\nhint 1 " + guess + ' ') != std::string::npos);
+    REQUIRE(log.find("\nhint ") == log.rfind("\nhint "));
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: cli/SimulationTests.cpp
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <Alphadocte/EntropyMaximizer.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/WordleGameRules.h>
+#include <catch2/catch.hpp>
+
+#include "../../apps/Parallel.h"
+#include "../../apps/Simulation.h"
+#include "../TestDefinitions.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+TEST_CASE("Check games simulation", "[simulation][CLI]") {
+    std::shared_ptr<IGameRules> rules = std::make_shared<WordleGameRules>(getWordleDict());
+    const auto& solutions = rules->getDictionary()->getAllWords();
+
+    SimulationOptions options;
+    options.nbThreads = 2;
+    auto result = simulateGames(rules, solutions, options);
+
+    REQUIRE(result.solverName == options.solverName);
+    REQUIRE(result.nbThreads == 2);
+    REQUIRE(result.nbGames == std::size(solutions));
+    REQUIRE(result.nbTemplates == 1);
+
+    size_t nbWon{};
+    for (const auto& [nbGuesses, count] : result.guessDistribution) {
+        REQUIRE(nbGuesses >= 1);
+        REQUIRE(nbGuesses <= rules->getMaxGuesses());
+        nbWon += count;
+    }
+    REQUIRE(nbWon == result.nbWon);
+    REQUIRE(result.nbWon <= result.nbGames);
+    REQUIRE(result.guessDistribution.count(1) <= 1);
+    REQUIRE_FALSE(result.turnLatencies.empty());
+
+    // every turn computes a guess, the shared first guesses included
+    const auto& work = result.solverWork;
+    REQUIRE(work.nbComputations == std::size(result.turnLatencies) + result.nbTemplates);
+    REQUIRE(work.nbFromMemo == 0);
+    REQUIRE(work.nbGuessesScored > 0);
+    REQUIRE(work.nbPatternsEvaluated >= work.nbGuessesScored);
+    REQUIRE(work.computeGuessesDuration > 0);
+    REQUIRE(work.peakScratchMemory > 0);
+
+    SECTION("Simulation is deterministic") {
+        options.nbThreads = 1;
+        options.shareFirstGuess = false;
+        auto other = simulateGames(rules, solutions, options);
+
+        REQUIRE(other.nbWon == result.nbWon);
+        REQUIRE(other.guessDistribution == result.guessDistribution);
+    }
+
+    SECTION("Memoizing solver states does not change the games") {
+        REQUIRE(result.memoStats.nbHits + result.memoStats.nbMisses == 0);
+
+        options.memoCapacity = 1000;
+        auto other = simulateGames(rules, solutions, options);
+
+        REQUIRE(other.nbWon == result.nbWon);
+        REQUIRE(other.guessDistribution == result.guessDistribution);
+        REQUIRE(other.memoStats.nbHits > 0);
+        REQUIRE(other.memoStats.nbEntries > 0);
+        REQUIRE(other.memoStats.nbEntries <= 1000);
+        REQUIRE(other.memoStats.memoryUsage > 0);
+        REQUIRE(other.solverWork.nbFromMemo == other.memoStats.nbHits + other.memoStats.nbCoalesced);
+        REQUIRE(other.solverWork.nbGuessesScored < result.solverWork.nbGuessesScored);
+    }
+
+    SECTION("Invalid arguments") {
+        REQUIRE_THROWS_AS(simulateGames(rules, {"zzzzz"}, options), InvalidArgException);
+
+        options.solverName = "unknown";
+        REQUIRE_THROWS_AS(simulateGames(rules, solutions, options), InvalidArgException);
+    }
+}
+
+TEST_CASE("Simulated games do not nest thread pools", "[simulation][CLI]") {
+    std::shared_ptr<IGameRules> rules = std::make_shared<WordleGameRules>(getWordleDict());
+    const auto& words = rules->getDictionary()->getAllWords();
+    std::vector<std::string> solutions(std::begin(words), std::begin(words) + 20);
+
+    // a tuning which would start 4 threads for each computation
+    auto defaultTuning = EntropyMaximizer::getDefaultTuning();
+    EntropyMaximizer::setDefaultTuning({.histogram = defaultTuning.histogram, .nbThreads = 4, .minParallelPatterns = 0});
+    SimulationOptions options;
+    options.nbThreads = 1;
+    auto sequential = simulateGames(rules, solutions, options);
+    options.nbThreads = 2;
+    auto parallel = simulateGames(rules, solutions, options);
+    EntropyMaximizer::setDefaultTuning(defaultTuning);
+
+    // a single game thread leaves the threads of the solver, several ones share the cores
+    REQUIRE(sequential.solverWork.maxSolverThreads == 4);
+    REQUIRE(parallel.solverWork.maxSolverThreads >= 1);
+    REQUIRE(parallel.nbThreads * parallel.solverWork.maxSolverThreads <= std::max(defaultThreadCount(), parallel.nbThreads));
+    REQUIRE(parallel.guessDistribution == sequential.guessDistribution);
+}
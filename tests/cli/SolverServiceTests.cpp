@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: SolverServiceTests.cpp
+ */
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Alphadocte/EntropyMaximizer.h>
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/Game.h>
+#include <Alphadocte/WordleGameRules.h>
+#include <catch2/catch.hpp>
+
+#include "../TestDefinitions.h"
+#include "../../apps/Json.h"
+#include "../../apps/SolverService.h"
+
+#if defined ALPHADOCTE_OS_LINUX
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../../apps/UnixSocketServer.h"
+#endif
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+static SolverServiceOptions getTestOptions() {
+    // the tests must not touch the user's cache
+    SolverServiceOptions options;
+    options.useCache = false;
+    options.memoCapacity = 1000;
+    return options;
+}
+
+static std::string newWordleSession() {
+    return R"({"op":"new_session","dictionary":)" + quoteJson(TEST_WORDLE_WORDS.string()) + R"(,"rules":"wordle"})";
+}
+
+TEST_CASE("Playing through the solver service", "[service][CLI]") {
+    SolverService service{getTestOptions()};
+    REQUIRE(service.getSessionCount() == 0);
+
+    // the same game, played by a local solver
+    auto rules = std::make_shared<WordleGameRules>(getWordleDict());
+    EntropyMaximizer solver{rules};
+    solver.setTemplate(".....");
+
+    auto created = parseJsonObject(service.handleRequest(newWordleSession()));
+    REQUIRE(created.at("ok").text == "true");
+    REQUIRE(created.at("session").text == "1");
+    REQUIRE(created.at("solutions").text == std::to_string(std::size(solver.getPotentialSolutions())));
+    REQUIRE(service.getSessionCount() == 1);
+
+    auto expected = solver.computeNextGuesses(3);
+    REQUIRE(std::size(expected) == 3);
+    auto top = service.handleRequest(R"({"op":"top","session":1,"n":3})");
+    REQUIRE(top.find(R"("ok":true)") != top.npos);
+    REQUIRE(top.find(R"("source":"solver")") != top.npos);
+    auto first = top.find("\"word\":" + quoteJson(expected[0].first));
+    auto second = top.find("\"word\":" + quoteJson(expected[1].first));
+    auto third = top.find("\"word\":" + quoteJson(expected[2].first));
+    REQUIRE(first < second);
+    REQUIRE(second < third);
+    REQUIRE(third != top.npos);
+
+    SECTION("Adding hints") {
+        const auto& solution = rules->getDictionary()->getAllWords().at(5);
+        auto guess = expected[0].first;
+        auto hints = Game::computeHints(guess, solution);
+        solver.addHint(guess, hints);
+
+        auto added = parseJsonObject(service.handleRequest(R"({"op":"add_hint","session":1,"guess":)" + quoteJson(guess)
+                + R"(,"hints":)" + quoteJson(formatHints(hints)) + "}"));
+        REQUIRE(added.at("ok").text == "true");
+        REQUIRE(added.at("solutions").text == std::to_string(std::size(solver.getPotentialSolutions())));
+
+        auto next = service.handleRequest(R"({"op":"top","session":1,"n":1})");
+        REQUIRE(next.find("\"word\":" + quoteJson(solver.computeNextGuesses(1).at(0).first)) != next.npos);
+    }
+
+    SECTION("Restoring evicted sessions") {
+        // every idle session is evicted
+        auto options = getTestOptions();
+        options.sessionMemoryBudget = 1;
+        options.memoCapacity = 0;
+        SolverService evicting{options};
+        REQUIRE(parseJsonObject(evicting.handleRequest(newWordleSession())).at("session").text == "1");
+        REQUIRE(parseJsonObject(evicting.handleRequest(newWordleSession())).at("session").text == "2");
+        REQUIRE(parseJsonObject(evicting.handleRequest(R"({"op":"stats"})")).at("resident").text == "1");
+        REQUIRE(parseJsonObject(evicting.handleRequest(R"({"op":"stats","session":1})")).at("resident").text == "false");
+        REQUIRE(evicting.handleRequest(R"({"op":"top","session":1,"n":3})") == top);
+    }
+
+    SECTION("Sharing the memo between sessions") {
+        auto nbHits = service.getMemo()->getStats().nbHits;
+        REQUIRE(parseJsonObject(service.handleRequest(newWordleSession())).at("session").text == "2");
+        REQUIRE(service.handleRequest(R"({"op":"top","session":2,"n":3})") == top);
+        REQUIRE(service.getMemo()->getStats().nbHits == nbHits + 1);
+    }
+
+    SECTION("Ending sessions") {
+        REQUIRE(service.handleRequest(R"({"op":"end_session","session":1,"id":"last"})") == R"({"id":"last","ok":true})");
+        REQUIRE(service.getSessionCount() == 0);
+
+        auto missing = parseJsonObject(service.handleRequest(R"({"op":"top","session":1})"));
+        REQUIRE(missing.at("ok").text == "false");
+        REQUIRE(missing.at("error").text.find("Unknown session") != std::string::npos);
+    }
+
+    SECTION("Reporting the memory of the sessions") {
+        auto stats = parseJsonObject(service.handleRequest(R"({"op":"stats"})"));
+        REQUIRE(stats.at("sessions").text == "1");
+        REQUIRE(stats.at("resident").text == "1");
+        REQUIRE(stats.at("budget").text == std::to_string(getTestOptions().sessionMemoryBudget));
+        REQUIRE(stats.at("dictionaries").text != "0");
+
+        auto sessionStats = parseJsonObject(service.handleRequest(R"({"op":"stats","session":1})"));
+        REQUIRE(sessionStats.at("resident").text == "true");
+        REQUIRE(sessionStats.at("memory").text == stats.at("memory").text);
+        REQUIRE(parseJsonObject(service.handleRequest(R"({"op":"stats","session":2})")).at("ok").text == "false");
+    }
+
+    SECTION("Running sessions concurrently") {
+        std::vector<std::thread> threads;
+        std::vector<std::string> responses(4);
+        for (size_t i = 0; i < std::size(responses); i++) {
+            threads.emplace_back([&service, &responses, i]() {
+                auto session = parseJsonObject(service.handleRequest(newWordleSession())).at("session").text;
+                responses[i] = service.handleRequest(R"({"op":"top","n":3,"session":)" + session + "}");
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        REQUIRE(service.getSessionCount() == 5);
+        for (const auto& response : responses)
+            REQUIRE(response == top);
+    }
+
+    SECTION("Reporting errors") {
+        auto checkError = [&service](std::string_view request, std::string_view error) {
+            auto response = parseJsonObject(service.handleRequest(request));
+            REQUIRE(response.at("ok").text == "false");
+            REQUIRE(response.at("error").text.find(error) != std::string::npos);
+        };
+
+        checkError("not json", "Invalid JSON");
+        checkError(R"({"id":1})", "Missing member op");
+        checkError(R"({"op":"play"})", "Unknown operation");
+        checkError(R"({"op":"new_session","dictionary":"no_such_dictionary"})", "Unknown dictionary");
+        checkError(R"({"op":"new_session","dictionary":)" + quoteJson(TEST_WORDLE_WORDS.string()) + "}", "Missing member template");
+        checkError(R"({"op":"new_session","dictionary":)" + quoteJson(TEST_WORDLE_WORDS.string()) + R"(,"rules":"scrabble"})", "rules");
+        checkError(R"({"op":"top","session":"1"})", "must be a non-negative integer");
+        checkError(R"({"op":"top","session":1,"n":0})", "must be positive");
+        checkError(R"({"op":"add_hint","session":1,"guess":"zzzzz","hints":"xxxxx"})", "not a valid guess");
+        checkError(R"({"op":"add_hint","session":1,"guess":)" + quoteJson(expected[0].first) + R"(,"hints":"xxzxx"})", "Invalid hint");
+
+        // the id is repeated, whatever its type
+        REQUIRE(service.handleRequest(R"({"id":7,"op":"play"})").rfind(R"({"id":7,"ok":false,)", 0) == 0);
+        REQUIRE(service.getSessionCount() == 1);
+    }
+
+    SolverServiceOptions unknownSolver;
+    unknownSolver.solverName = "no_such_solver";
+    REQUIRE_THROWS_AS(SolverService(unknownSolver), InvalidArgException);
+}
+
+#if defined ALPHADOCTE_OS_LINUX
+/*
+ * Client of the test server, sending requests and reading response lines.
+ */
+class TestClient {
+public:
+    explicit TestClient(const std::filesystem::path& socketPath) : m_socket{::socket(AF_UNIX, SOCK_STREAM, 0)}, m_buffer{} {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, socketPath.c_str());
+        REQUIRE(::connect(m_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+    }
+
+    ~TestClient() {
+        ::close(m_socket);
+    }
+
+    void send(std::string_view data) {
+        REQUIRE(::send(m_socket, data.data(), std::size(data), MSG_NOSIGNAL) == static_cast<ssize_t>(std::size(data)));
+    }
+
+    // empty once the server disconnected
+    std::string readLine() {
+        size_t end;
+        while ((end = m_buffer.find('\n')) == m_buffer.npos) {
+            char chunk[4096];
+            auto received = ::recv(m_socket, chunk, sizeof(chunk), 0);
+            if (received <= 0)
+                return {};
+            m_buffer.append(chunk, static_cast<size_t>(received));
+        }
+
+        auto line = m_buffer.substr(0, end);
+        m_buffer.erase(0, end + 1);
+        return line;
+    }
+
+private:
+    int m_socket;
+    std::string m_buffer;
+};
+
+TEST_CASE("Serving the solver service over a Unix socket", "[service][CLI]") {
+    REQUIRE_NOTHROW(std::filesystem::create_directories(TEST_OUT_DIR));
+    auto socketPath = TEST_OUT_DIR / "solverd_test.sock";
+    SolverService service{getTestOptions()};
+
+    {
+        UnixSocketServer server{socketPath, [&service](std::string_view request) { return service.handleRequest(request); }};
+        REQUIRE(std::filesystem::exists(socketPath));
+        REQUIRE_THROWS_AS(UnixSocketServer(socketPath, [](std::string_view) { return std::string(); }), Exception);
+
+        std::thread runner{[&server]() { server.run(); }};
+
+        // requests sent at once are answered in order, empty lines are ignored
+        TestClient client{socketPath};
+        client.send(newWordleSession() + "\n\r\n" + R"({"op":"top","session":1,"n":2,"id":"a"})" + "\r\n");
+        REQUIRE(parseJsonObject(client.readLine()).at("session").text == "1");
+        auto top = client.readLine();
+        REQUIRE(top.rfind(R"({"id":"a","ok":true,"source":"solver")", 0) == 0);
+
+        // a request can be split across several writes, and clients are served concurrently
+        TestClient other{socketPath};
+        other.send(R"({"op":"top",)");
+        client.send(R"({"op":"end_session","session":1})" "\n");
+        REQUIRE(client.readLine() == R"({"ok":true})");
+        other.send(R"("session":1})" "\n");
+        REQUIRE(parseJsonObject(other.readLine()).at("ok").text == "false");
+
+        // connected clients are disconnected on stop
+        server.stop();
+        runner.join();
+        REQUIRE(client.readLine().empty());
+    }
+
+    // the socket file is removed, and a stale one is replaced
+    REQUIRE_FALSE(std::filesystem::exists(socketPath));
+    std::ofstream{socketPath} << "stale";
+    UnixSocketServer restarted{socketPath, [](std::string_view request) { return std::string(request); }};
+    std::thread runner{[&restarted]() { restarted.run(); }};
+    TestClient client{socketPath};
+    client.send("echo\n");
+    REQUIRE(client.readLine() == "echo");
+    restarted.stop();
+    runner.join();
+}
+#endif
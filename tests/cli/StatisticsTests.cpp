@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: cli/StatisticsTests.cpp
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../apps/Statistics.h"
+
+using namespace Alphadocte::CLI;
+
+TEST_CASE("Check samples summary", "[statistics][CLI]") {
+    SECTION("No samples") {
+        auto summary = summarize({});
+        REQUIRE(summary.count == 0);
+        REQUIRE(summary.mean == 0);
+        REQUIRE(summary.p99 == 0);
+        REQUIRE(percentile({}, 50) == 0);
+    }
+
+    SECTION("Single sample") {
+        auto summary = summarize({3.});
+        REQUIRE(summary.count == 1);
+        REQUIRE(summary.min == 3.);
+        REQUIRE(summary.max == 3.);
+        REQUIRE(summary.mean == 3.);
+        REQUIRE(summary.stddev == 0.);
+        REQUIRE(summary.p50 == 3.);
+        REQUIRE(summary.p99 == 3.);
+    }
+
+    SECTION("Many samples") {
+        std::vector<double> samples;
+        for (int i = 100; i >= 1; i--)
+            samples.push_back(i);
+
+        auto summary = summarize(samples);
+        REQUIRE(summary.count == 100);
+        REQUIRE(summary.min == 1.);
+        REQUIRE(summary.max == 100.);
+        REQUIRE(summary.mean == Approx(50.5));
+        REQUIRE(summary.stddev == Approx(29.011492));
+        REQUIRE(summary.p50 == 50.);
+        REQUIRE(summary.p95 == 95.);
+        REQUIRE(summary.p99 == 99.);
+    }
+}
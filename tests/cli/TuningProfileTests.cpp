@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: TuningProfileTests.cpp
+ */
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <Alphadocte/EntropyMaximizer.h>
+#include <Alphadocte/Exceptions.h>
+#include <catch2/catch.hpp>
+
+#include "../TestDefinitions.h"
+#include "../../apps/Common.h"
+#include "../../apps/TuningProfile.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+using enum EntropyMaximizer::HistogramStrategy;
+
+TEST_CASE("Naming histogram strategies", "[tuning][CLI]") {
+    for (auto histogram : {MAP, DENSE, SORTED})
+        REQUIRE(parseHistogramStrategy(getHistogramName(histogram)) == histogram);
+
+    REQUIRE(parseHistogramStrategy("Dense") == DENSE);
+    REQUIRE_THROWS_AS(parseHistogramStrategy(""), InvalidArgException);
+    REQUIRE_THROWS_AS(parseHistogramStrategy("simd"), InvalidArgException);
+    REQUIRE_THROWS_AS(parseHistogramStrategy("d\xe9nse"), InvalidArgException);
+}
+
+TEST_CASE("Overriding a tuning", "[tuning][CLI]") {
+    const EntropyMaximizer::Tuning base{SORTED, 4, 1000};
+
+    auto tuning = parseTuningOverride("", base);
+    REQUIRE(tuning.histogram == SORTED);
+    REQUIRE(tuning.nbThreads == 4);
+    REQUIRE(tuning.minParallelPatterns == 1000);
+
+    tuning = parseTuningOverride("histogram=map,threads=2", base);
+    REQUIRE(tuning.histogram == MAP);
+    REQUIRE(tuning.nbThreads == 2);
+    REQUIRE(tuning.minParallelPatterns == 1000);
+
+    tuning = parseTuningOverride("min-parallel=0", base);
+    REQUIRE(tuning.histogram == SORTED);
+    REQUIRE(tuning.minParallelPatterns == 0);
+
+    REQUIRE_THROWS_AS(parseTuningOverride("threads=0", base), InvalidArgException);
+    REQUIRE_THROWS_AS(parseTuningOverride("threads=two", base), InvalidArgException);
+    REQUIRE_THROWS_AS(parseTuningOverride("threads", base), InvalidArgException);
+    REQUIRE_THROWS_AS(parseTuningOverride("histogram=simd", base), InvalidArgException);
+    REQUIRE_THROWS_AS(parseTuningOverride("vector=avx2", base), InvalidArgException);
+}
+
+TEST_CASE("Writing and reading tuning profiles", "[tuning][CLI]") {
+    auto folder = TEST_OUT_DIR / "tuning_profile";
+    std::filesystem::remove_all(folder);
+    REQUIRE_NOTHROW(std::filesystem::create_directories(folder));
+
+    TuningProfile profile;
+    profile.tuning = {DENSE, 3, 250000};
+    profile.nbCores = 8;
+    profile.measures = {
+        {"a.....", "motus", 1000000, MAP, 1, 0.5},
+        {".....", "wordle", 250000, DENSE, 3, 0.125}
+    };
+
+    auto path = folder / "tuning.txt";
+    writeTuningProfile(profile, path);
+    auto readProfile = readTuningProfile(path);
+
+    REQUIRE(readProfile.tuning.histogram == DENSE);
+    REQUIRE(readProfile.tuning.nbThreads == 3);
+    REQUIRE(readProfile.tuning.minParallelPatterns == 250000);
+    REQUIRE(readProfile.nbCores == 8);
+    REQUIRE(std::size(readProfile.measures) == 2);
+    REQUIRE(readProfile.measures[0].templateWord == "a.....");
+    REQUIRE(readProfile.measures[0].rules == "motus");
+    REQUIRE(readProfile.measures[0].nbPatterns == 1000000);
+    REQUIRE(readProfile.measures[0].histogram == MAP);
+    REQUIRE(readProfile.measures[1].nbThreads == 3);
+    REQUIRE(readProfile.measures[1].duration == Approx(0.125));
+
+    SECTION("Invalid profiles") {
+        auto invalidPath = folder / "invalid.txt";
+        std::ofstream{invalidPath} << "format_version 1\ncores 8\nhistogram simd\nthreads 2\nmin_parallel_patterns 0\n";
+        REQUIRE_THROWS_AS(readTuningProfile(invalidPath), Exception);
+
+        std::ofstream{invalidPath} << "format_version 1\ncores 8\nhistogram map\nthreads 0\nmin_parallel_patterns 0\n";
+        REQUIRE_THROWS_AS(readTuningProfile(invalidPath), Exception);
+
+        std::ofstream{invalidPath} << "format_version 2\ncores 8\nhistogram map\nthreads 2\nmin_parallel_patterns 0\n";
+        REQUIRE_THROWS_AS(readTuningProfile(invalidPath), Exception);
+
+        std::ofstream{invalidPath} << "format_version 1\ncores 8\nhistogram map\n";
+        REQUIRE_THROWS_AS(readTuningProfile(invalidPath), Exception);
+
+        REQUIRE_THROWS_AS(readTuningProfile(folder / "missing.txt"), Exception);
+    }
+}
+
+#if defined ALPHADOCTE_OS_LINUX
+TEST_CASE("Loading the tuning of the machine", "[tuning][CLI]") {
+    const char* cacheEnvValue = std::getenv("XDG_CACHE_HOME");
+    std::optional<std::string> previousCache = cacheEnvValue ? std::optional<std::string>{cacheEnvValue} : std::nullopt;
+    const char* tuningEnvValue = std::getenv(TUNING_ENV_VAR.c_str());
+    std::optional<std::string> previousTuning = tuningEnvValue ? std::optional<std::string>{tuningEnvValue} : std::nullopt;
+    auto previousDefault = EntropyMaximizer::getDefaultTuning();
+
+    auto folder = std::filesystem::absolute(TEST_OUT_DIR / "tuning_cache");
+    std::filesystem::remove_all(folder);
+    setenv("XDG_CACHE_HOME", folder.c_str(), true);
+    unsetenv(TUNING_ENV_VAR.c_str());
+    getCachePath(true);
+
+    // no profile : default tuning
+    auto tuning = loadTuning();
+    REQUIRE(tuning.histogram == MAP);
+    REQUIRE(tuning.nbThreads == 1);
+
+    TuningProfile profile;
+    profile.tuning = {SORTED, 2, 5000};
+    profile.nbCores = std::thread::hardware_concurrency();
+    writeTuningProfile(profile, getTuningPath());
+
+    tuning = loadTuning();
+    REQUIRE(tuning.histogram == SORTED);
+    REQUIRE(tuning.nbThreads == 2);
+    REQUIRE(EntropyMaximizer::getDefaultTuning().histogram == SORTED);
+    REQUIRE(EntropyMaximizer::getDefaultTuning().minParallelPatterns == 5000);
+
+    // the override applies on top of the profile
+    setenv(TUNING_ENV_VAR.c_str(), "threads=1", true);
+    tuning = loadTuning();
+    REQUIRE(tuning.histogram == SORTED);
+    REQUIRE(tuning.nbThreads == 1);
+
+    setenv(TUNING_ENV_VAR.c_str(), "none", true);
+    tuning = loadTuning();
+    REQUIRE(tuning.histogram == MAP);
+
+    // invalid overrides are ignored
+    setenv(TUNING_ENV_VAR.c_str(), "threads=0", true);
+    tuning = loadTuning();
+    REQUIRE(tuning.histogram == SORTED);
+    REQUIRE(tuning.nbThreads == 2);
+    unsetenv(TUNING_ENV_VAR.c_str());
+
+    // profiles of other machines are ignored
+    profile.nbCores++;
+    writeTuningProfile(profile, getTuningPath());
+    tuning = loadTuning();
+    REQUIRE(tuning.histogram == MAP);
+
+    // restore env
+    if (previousCache)
+        setenv("XDG_CACHE_HOME", previousCache->c_str(), true);
+    else
+        unsetenv("XDG_CACHE_HOME");
+
+    if (previousTuning)
+        setenv(TUNING_ENV_VAR.c_str(), previousTuning->c_str(), true);
+
+    getCachePath(true);
+    EntropyMaximizer::setDefaultTuning(previousDefault);
+}
+#endif
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2022  Mathieu Margier
+ *
+ *  This file is part of Alphadocte.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>. 
+ * 
+ * File: WorkloadReplayTests.cpp
+ */
+
+#include <Alphadocte/Exceptions.h>
+#include <Alphadocte/WordleGameRules.h>
+#include <Alphadocte/WorkloadRecorder.h>
+#include <algorithm>
+#include <sstream>
+#include <catch2/catch.hpp>
+
+#include "../../apps/Simulation.h"
+#include "../../apps/WorkloadReplay.h"
+#include "../TestDefinitions.h"
+
+using namespace Alphadocte;
+using namespace Alphadocte::CLI;
+
+TEST_CASE("Check workload replay", "[replay][CLI]") {
+    std::shared_ptr<IGameRules> rules = std::make_shared<WordleGameRules>(getWordleDict());
+    const auto& allWords = rules->getDictionary()->getAllWords();
+    std::vector<std::string> solutions(std::cbegin(allWords), std::cbegin(allWords) + 3);
+
+    // record a few simulated games
+    std::stringstream workload;
+    SimulationOptions options;
+    options.nbThreads = 1;
+    options.recorder = std::make_shared<WorkloadRecorder>(workload);
+    auto simulation = simulateGames(rules, solutions, options);
+    options.recorder->flush();
+
+    auto games = parseWorkload(workload);
+    REQUIRE(std::size(games) == options.recorder->getGameCount());
+    REQUIRE_FALSE(games.empty());
+
+    size_t nbComputations{};
+    for (const auto& game : games) {
+        REQUIRE(game.solverName == "entropy_maximizer");
+        REQUIRE(game.rules == "wordle");
+        REQUIRE(game.maxGuesses == rules->getMaxGuesses());
+        REQUIRE(game.nbWords == std::size(allWords));
+        REQUIRE(game.contentHash == rules->getDictionary()->getContentHash());
+        REQUIRE(game.templateWord == ".....");
+
+        for (const auto& step : game.steps) {
+            if (step.type == RecordedStep::Type::COMPUTE) {
+                REQUIRE(step.duration >= 0);
+                nbComputations++;
+            }
+        }
+    }
+    REQUIRE(nbComputations == simulation.solverWork.nbComputations);
+
+    RulesProvider getRules = [&rules](const RecordedGame&) { return rules; };
+
+    SECTION("Replaying the games") {
+        ReplayOptions replayOptions;
+        replayOptions.repetitions = 2;
+        replayOptions.compare = true;
+        auto result = replayWorkload(games, getRules, replayOptions);
+
+        REQUIRE(result.nbGames == std::size(games));
+        REQUIRE(result.nbSkippedGames == 0);
+        REQUIRE(result.nbComputations == nbComputations);
+        REQUIRE(std::size(result.computeDurations) == 2 * nbComputations);
+        REQUIRE(result.replayedDuration > 0);
+        REQUIRE(result.mismatches.empty());
+
+        replayOptions.repetitions = 0;
+        REQUIRE_THROWS_AS(replayWorkload(games, getRules, replayOptions), InvalidArgException);
+    }
+
+    SECTION("Comparing the guesses") {
+        auto& step = *std::find_if(std::begin(games.front().steps), std::end(games.front().steps), [](const auto& s) {
+            return s.type == RecordedStep::Type::COMPUTE;
+        });
+        auto expected = step.guesses;
+        step.guesses = {"zzzzz"};
+
+        auto result = replayWorkload(games, getRules, ReplayOptions{.repetitions = 1, .compare = true});
+        REQUIRE(std::size(result.mismatches) == 1);
+        REQUIRE(result.mismatches.front().gameId == games.front().id);
+        REQUIRE(result.mismatches.front().actual == expected);
+        REQUIRE(replayWorkload(games, getRules).mismatches.empty());
+    }
+
+    SECTION("Skipping the games of unknown dictionaries") {
+        auto result = replayWorkload(games, [](const RecordedGame&) { return std::shared_ptr<IGameRules>{}; });
+        REQUIRE(result.nbGames == 0);
+        REQUIRE(result.nbSkippedGames == std::size(games));
+
+        games.front().contentHash++;
+        result = replayWorkload(games, getRules);
+        REQUIRE(result.nbSkippedGames == 1);
+    }
+}
+
+TEST_CASE("Check workload parsing errors", "[replay][CLI]") {
+    auto parse = [](const std::string& text) {
+        std::istringstream input{text};
+        return parseWorkload(input);
+    };
+    const std::string header = "alphadocte-workload 1\n";
+    const std::string game = "game 1 entropy_maximizer 1 wordle 6 10 42 .....\n";
+
+    auto games = parse(header + game + "\nhint 1 bruir 0\ncompute 1 2 0.5 aient,amont\ncompute 1 1 0.1 -\n");
+    REQUIRE(std::size(games) == 1);
+    REQUIRE(std::size(games.front().steps) == 3);
+    REQUIRE(games.front().steps[0].guess == "bruir");
+    REQUIRE(games.front().steps[1].guesses == std::vector<std::string>{"aient", "amont"});
+    REQUIRE(games.front().steps[1].duration == Approx(0.5));
+    REQUIRE(games.front().steps[2].guesses.empty());
+
+    REQUIRE_THROWS_AS(parse(""), Exception);
+    REQUIRE_THROWS_AS(parse("alphadocte-workload 2\n"), Exception);
+    REQUIRE_THROWS_AS(parse(header + "hint 1 bruir 0\n"), Exception);      // unknown game
+    REQUIRE_THROWS_AS(parse(header + game + game), Exception);             // game defined twice
+    REQUIRE_THROWS_AS(parse(header + game + "hint 1 bruir\n"), Exception); // missing hints
+    REQUIRE_THROWS_AS(parse(header + game + "hint 1 bruir 1000\n"), Exception);
+    REQUIRE_THROWS_AS(parse(header + game + "compute 1 2 0.5 aient extra\n"), Exception);
+    REQUIRE_THROWS_AS(parse(header + game + "guess 1 aient\n"), Exception);
+    REQUIRE_THROWS_AS(loadWorkload(TEST_OUT_DIR / "missing_workload.txt"), Exception);
+}
@@ -30,6 +30,7 @@ DictionaryStub::DictionaryStub(std::vector<std::string> words)
     m_words = std::move(words);
     std::sort(std::begin(m_words), std::end(m_words));
     m_distribution = boost::uniform_int<size_t>{0, m_words.size() - 1};
+    updateContentHash();
 }
 
 bool DictionaryStub::load() {